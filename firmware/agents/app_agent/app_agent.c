@@ -12,11 +12,14 @@
  */
 
 #include <string.h>
+#include <math.h>
 #include "../../platform/sa_types.h"
 #include "../../platform/sa_utils.h"
+#include "../../platform/sa_pt.h"
 
 #include "../../include/agents_main.h"
 #include "../../configs/app_cfg.h"
+#include "../../configs/tuning_cfg.h"
 #include "../../include/sensor_agent.h"
 #include "../../include/trigger_agent.h"
 #include "../../include/app_agent.h"
@@ -30,11 +33,30 @@
  */
 
 /************************************** Defines **************************************************/
-#define APP_AGENT_AVERAGE_NUM           10u
 #define APP_AGENT_CONFIDENCE_DIV        3u
 
 
 /************************************** Typedef **************************************************/
+/**
+ * \brief  Neighbor overheard by the cooperative mode, with the averages of the pairs of its
+ *         samples and the own data.
+ *
+ */
+typedef struct {
+    uint16_t  Id;
+    bool_t    Known;            /* The entry is in use                              */
+    uint16_t  Pairs;            /* Pairs of samples averaged                        */
+    float32_t Data;             /* Last sample heard                                */
+    float32_t Mean;             /* Mean of the data of the neighbor                 */
+    float32_t OwnMean;          /* Mean of the own data of the pairs                */
+    float32_t Variance;
+    float32_t OwnVariance;
+    float32_t Covariance;
+    uint32_t  Period;           /* Periodicity of the neighbor, in its last sample  */
+    float32_t Charge;           /* Remaining charge of the neighbor in %            */
+    bool_t    Heard;            /* Heard since the last own sample                  */
+} APP_AGENT_NEIGHBOR_T;
+
 /**
  * \brief  Application model.
  *         The application model contains the following metrics:
@@ -48,13 +70,18 @@ typedef struct {
     float32_t Data;
     float32_t Rate;
     float32_t AvgData;
-    float32_t AvgDataBuffer[APP_AGENT_AVERAGE_NUM];
+    float32_t AvgDataBuffer[APP_CFG_AVERAGE_MAX];
     bool_t    AvgDataInitilized;
     uint16_t  AvgDataPointer;
+    uint16_t  AvgDataNum;       /* Samples of the average, see TuningCfg_Params    */
     float32_t AccuracyLevel;
     int8_t    RelevanceIndex;
     int8_t    Confidence;
     bool_t    Initialized;
+    SA_PT_T   ObservePt;        /* Resume point of the observation task */
+    bool_t    Cooperative;      /* Lower the relevance when a neighbor covers the data  */
+    uint16_t  Node;             /* Own identifier, breaks the ties of the turns         */
+    APP_AGENT_NEIGHBOR_T Neighbors[APP_CFG_NEIGHBORS];
 } APP_AGENT_MODEL_T;
 
 
@@ -78,6 +105,10 @@ static TRIGGER_AGENT_INTERFACE_T AppAgent_TriggerData;
  * \param  sensor_obs   Pointer to the observation function of the sensor agent.
  * \param  sensor_act   Pointer to the actuation funciton of the sensor agent.
  * \param  sensor_alrm  Pointer to the alarm function of the sensor agent.
+ * \param  sensor_start Pointer to the function that starts an acquisition, NULL for the serial
+ *                      loop.
+ * \param  sensor_ready Pointer to the function that tells if the sample can be observed, NULL if
+ *                      it is always ready.
  * \param  trigger_obs  Pointer to the observation function of the trigger agent.
  * \param  trigger_act  Pointer to the observation function of the trigger agent.
  * \param  trigger_alrm Pointer to the alarm function of the trigger agent.
@@ -86,12 +117,15 @@ static TRIGGER_AGENT_INTERFACE_T AppAgent_TriggerData;
  * \return DEF_TRUE if the agent could be initialized correctly; otherwise DEF_FALSE.
  *
  * \note List of notes:
- *       1. The alarm function is optional, so the NULL check is not performed.
+ *       1. The alarm, start and ready functions are optional, so the NULL check is not performed.
+ *       2. The number of samples of the average is taken from TuningCfg_Params.
  *
  */
 bool_t AppAgent_Init(SENSOR_AGENT_OBSERVATION_T sensor_obs,
                      SENSOR_AGENT_ACTUATION_T sensor_act,
                      SENSOR_AGENT_ALARM_T sensor_alrm,
+                     SENSOR_AGENT_START_T sensor_start,
+                     SENSOR_AGENT_READY_T sensor_ready,
                      TRIGGER_AGENT_OBSERVATION_T trigger_obs,
                      TRIGGER_AGENT_ACTUATION_T trigger_act,
                      TRIGGER_AGENT_ALARM_T trigger_alrm,
@@ -100,7 +134,7 @@ bool_t AppAgent_Init(SENSOR_AGENT_OBSERVATION_T sensor_obs,
 
     bool_t initialization = DEF_TRUE;
 
-    initialization = SensorAgent_Init(sensor_obs, sensor_act, sensor_alrm);
+    initialization = SensorAgent_Init(sensor_obs, sensor_act, sensor_alrm, sensor_start, sensor_ready);
     if (DEF_TRUE == initialization) {
         initialization = TriggerAgent_Init(trigger_obs, trigger_act, trigger_alrm);
     }
@@ -112,12 +146,43 @@ bool_t AppAgent_Init(SENSOR_AGENT_OBSERVATION_T sensor_obs,
     if (DEF_TRUE == initialization) {
         memset(&AppAgent_Model, 0x00, sizeof(APP_AGENT_MODEL_T));
         AppAgent_Model.AvgDataInitilized = DEF_FALSE;
+        AppAgent_Model.AvgDataNum = TuningCfg_Params.AverageNum;
     }
 
     return initialization;
 }
 
 /************* Observe **********************/
+/**
+ * \brief  Pairs the own sample with the last sample of each neighbor heard since the previous
+ *         one, and learns their correlation.
+ *
+ * \note List of notes:
+ *       1. The means, variances and covariance of the pairs are exponential averages of gain
+ *          APP_CFG_NEIGHBOR_GAIN, or the plain averages while there are fewer pairs.
+ */
+static void AppAgent_Pair(void)
+{
+    APP_AGENT_NEIGHBOR_T *p_neighbor;
+    float32_t gain, delta, own_delta;
+    uint8_t i;
+
+    for (i = 0; i < APP_CFG_NEIGHBORS; i++) {
+        p_neighbor = &AppAgent_Model.Neighbors[i];
+        if (DEF_FALSE == p_neighbor->Heard) continue;
+
+        if (UINT16_MAX > p_neighbor->Pairs) p_neighbor->Pairs++;
+        gain = SA_UTILS_MAX(1.0f / p_neighbor->Pairs, APP_CFG_NEIGHBOR_GAIN);
+        delta = p_neighbor->Data - p_neighbor->Mean;
+        own_delta = AppAgent_Model.Data - p_neighbor->OwnMean;
+        p_neighbor->Mean += gain * delta;
+        p_neighbor->OwnMean += gain * own_delta;
+        p_neighbor->Variance = (1.0f - gain) * (p_neighbor->Variance + gain * delta * delta);
+        p_neighbor->OwnVariance = (1.0f - gain) * (p_neighbor->OwnVariance + gain * own_delta * own_delta);
+        p_neighbor->Covariance = (1.0f - gain) * (p_neighbor->Covariance + gain * delta * own_delta);
+    }
+}
+
 /**
  * \brief  Learns.
  *         In this context learning is updating the model.
@@ -140,9 +205,11 @@ static void AppAgent_Learn(SENSOR_AGENT_INTERFACE_T *p_sensor)
     SaUtils_Average(&AppAgent_Model.AvgData,
                     current_data,
                     AppAgent_Model.AvgDataBuffer,
-                    APP_AGENT_AVERAGE_NUM,
+                    AppAgent_Model.AvgDataNum,
                     &AppAgent_Model.AvgDataPointer,
                     &AppAgent_Model.AvgDataInitilized);
+
+    AppAgent_Pair();
 }
 
 /**
@@ -169,12 +236,12 @@ static void AppAgent_Reflect(APP_AGENT_INTERFACE_T *p_data)
     if (DEF_TRUE == AppAgent_Model.Initialized) {
         /* Consistency      */
         consistency = Agents_Consistency(AppAgent_Model.Rate,
-                                        APP_CFG_MAXIMUM_RATE);
+                                        TuningCfg_Params.MaximumRate);
 
         /* Cross-validity   */
         cross_validity = Agents_CrossValidity(AppAgent_Model.Data,
                                               AppAgent_Model.AvgData,
-                                              APP_CFG_DEVIATION);
+                                              TuningCfg_Params.Deviation);
     } else {
         consistency = 0;
         cross_validity = 0;
@@ -186,6 +253,47 @@ static void AppAgent_Reflect(APP_AGENT_INTERFACE_T *p_data)
 }
 
 /************* Decide ***********************/
+/**
+ * \brief  Checks if a neighbor covers the data of the node, and starts a new turn.
+ *
+ * \param  charge:  Own remaining charge in %.
+ *
+ * \return DEF_TRUE if a neighbor covers the data; otherwise DEF_FALSE.
+ *
+ * \note List of notes:
+ *       1. A neighbor covers the data when it was heard since the last own sample, its
+ *          correlation with the own data is at least APP_CFG_COVER_CORRELATION over
+ *          APP_CFG_NEIGHBOR_PAIRS pairs, it samples at least as often, the lower identifier
+ *          on a tie, and its remaining charge is not APP_CFG_COVER_CHARGE below the own one.
+ *       2. The node with the most energy takes the turn: the covered node samples less, and
+ *          when the energy of the covering node drops, it becomes the covered one.
+ */
+static bool_t AppAgent_Covered(float32_t charge)
+{
+    APP_AGENT_NEIGHBOR_T *p_neighbor;
+    uint32_t period = TriggerAgent_GetConfig();
+    float32_t threshold;
+    bool_t covered = DEF_FALSE;
+    uint8_t i;
+
+    for (i = 0; i < APP_CFG_NEIGHBORS; i++) {
+        p_neighbor = &AppAgent_Model.Neighbors[i];
+        threshold  = APP_CFG_COVER_CORRELATION * APP_CFG_COVER_CORRELATION;
+        threshold *= p_neighbor->Variance * p_neighbor->OwnVariance;
+        if ((DEF_TRUE == p_neighbor->Heard) && (APP_CFG_NEIGHBOR_PAIRS <= p_neighbor->Pairs) &&
+            (0.0f < p_neighbor->Covariance) &&
+            (p_neighbor->Covariance * p_neighbor->Covariance >= threshold) &&
+            ((p_neighbor->Period < period) ||
+             ((p_neighbor->Period == period) && (p_neighbor->Id < AppAgent_Model.Node))) &&
+            (p_neighbor->Charge + APP_CFG_COVER_CHARGE >= charge)) {
+            covered = DEF_TRUE;
+        }
+        p_neighbor->Heard = DEF_FALSE;
+    }
+
+    return covered;
+}
+
 /**
  * \brief  Reason.
  *         In this context reasoning is using the available information:
@@ -196,6 +304,10 @@ static void AppAgent_Reflect(APP_AGENT_INTERFACE_T *p_data)
  * \param  p_sens  Pointer to the sensor interface data.
  * \param  p_trig  Pointer to the trigger interface data.
  *
+ * \note List of notes:
+ *       1. In cooperative mode, the relevance index is lowered to APP_CFG_COVER_RELEVANCE
+ *          while a neighbor covers the data, unless the own data is not trusted, see
+ *          AppAgent_Covered.
  */
 static void AppAgent_Reason(APP_AGENT_INTERFACE_T *p_app,
                             SENSOR_AGENT_INTERFACE_T *p_sens,
@@ -204,6 +316,11 @@ static void AppAgent_Reason(APP_AGENT_INTERFACE_T *p_app,
     //TODO app agent relevance index should translate sensor and trigger configs.
     AppAgent_Model.RelevanceIndex = AppAgent_Model.Confidence;
 
+    if ((DEF_TRUE == AppAgent_Covered(p_app->Inputs.Charge)) &&
+        (DEF_TRUE == AppAgent_Model.Cooperative) && (0 == AppAgent_Model.Confidence)) {
+        AppAgent_Model.RelevanceIndex = APP_CFG_COVER_RELEVANCE;
+    }
+
     /* Generate outputs         */
     p_app->Outputs.RelevanceIndex = AppAgent_Model.RelevanceIndex;
     p_app->Outputs.Data = AppAgent_Model.Data;
@@ -213,6 +330,16 @@ static void AppAgent_Reason(APP_AGENT_INTERFACE_T *p_app,
 }
 
 /************* Main ODA *********************/
+/**
+ * \brief  Sets the inputs of the sensor agent before its observation.
+ *
+ */
+static void AppAgent_SetSensorInputs(void)
+{
+    AppAgent_SensorData.Inputs.AccuracyTarget = 0;  // TODO sensor agent accuracy loop not implemented
+    AppAgent_SensorData.Inputs.PowerTarget = 0;     // TODO sensor agent power loop still not implemented
+}
+
 /**
  * \brief  Performs the ODA loop for the agent.
  *
@@ -222,8 +349,7 @@ static void AppAgent_Reason(APP_AGENT_INTERFACE_T *p_app,
 void AppAgent_Oda(APP_AGENT_INTERFACE_T *p_data)
 {
     /* Observe data     */
-    AppAgent_SensorData.Inputs.AccuracyTarget = 0;  // TODO sensor agent accuracy loop not implemented
-    AppAgent_SensorData.Inputs.PowerTarget = 0;     // TODO sensor agent power loop still not implemented
+    AppAgent_SetSensorInputs();
     SensorAgent_Oda(&AppAgent_SensorData);
 
     AppAgent_TriggerData.Inputs.SamplingTarget = p_data->Inputs.RelevanceTarget;
@@ -240,20 +366,13 @@ void AppAgent_Oda(APP_AGENT_INTERFACE_T *p_data)
 }
 
 /**
- * \brief  Runs the Observation task.
- *         The observation task perform the measurements, updates the model based on the
- *         observe data and compute the requried actuations to achieve its goals.
+ * \brief  Runs the part of the Observation task after the sensor observation.
  *
  * \param  p_data: Pointer to the interface data of the agent.
  *
  */
-void AppAgent_Observe(APP_AGENT_INTERFACE_T *p_data)
+static void AppAgent_ObserveApp(APP_AGENT_INTERFACE_T *p_data)
 {
-    /* Sensor       */
-    AppAgent_SensorData.Inputs.AccuracyTarget = 0;  // TODO sensor agent accuracy loop not implemented
-    AppAgent_SensorData.Inputs.PowerTarget = 0;     // TODO sensor agent power loop still not implemented
-    SensorAgent_Observe(&AppAgent_SensorData);
-
     /* Trigger      */
     AppAgent_TriggerData.Inputs.SamplingTarget = p_data->Inputs.RelevanceTarget;
     TriggerAgent_Observe(&AppAgent_TriggerData);
@@ -266,6 +385,47 @@ void AppAgent_Observe(APP_AGENT_INTERFACE_T *p_data)
     AppAgent_Reason(p_data, &AppAgent_SensorData, &AppAgent_TriggerData);
 }
 
+/**
+ * \brief  Runs the Observation task.
+ *         The observation task perform the measurements, updates the model based on the
+ *         observe data and compute the requried actuations to achieve its goals.
+ *
+ * \param  p_data: Pointer to the interface data of the agent.
+ *
+ */
+void AppAgent_Observe(APP_AGENT_INTERFACE_T *p_data)
+{
+    /* Sensor       */
+    AppAgent_SetSensorInputs();
+    SensorAgent_Observe(&AppAgent_SensorData);
+
+    AppAgent_ObserveApp(p_data);
+}
+
+/**
+ * \brief  Runs the Observation task as a resumable function.
+ *         The same as AppAgent_Observe, but the sensor observation yields until the sensor is
+ *         ready.
+ *
+ * \param  p_data: Pointer to the interface data of the agent.
+ *
+ * \return SA_PT_WAITING while waiting on the sensor, call again to resume; otherwise
+ *         SA_PT_DONE.
+ *
+ */
+SA_PT_STATUS_T AppAgent_ObservePt(APP_AGENT_INTERFACE_T *p_data)
+{
+    SA_PT_T *pt = &AppAgent_Model.ObservePt;
+
+    SA_PT_BEGIN(pt);
+    /* Sensor       */
+    AppAgent_SetSensorInputs();
+    SA_PT_WAIT_THREAD(pt, SensorAgent_ObservePt(&AppAgent_SensorData));
+
+    AppAgent_ObserveApp(p_data);
+    SA_PT_END(pt);
+}
+
 /**
  * \brief  Runs the Actuation task.
  *         The actuation task applies the selected adaptations and updates the model
@@ -286,5 +446,87 @@ void AppAgent_Act(APP_AGENT_INTERFACE_T *p_data)
     /* No actuations for this agent     */
 }
 
+/************* Cooperative sampling *********/
+/**
+ * \brief  Enables the cooperative mode, in which the node samples less while a correlated
+ *         neighbor covers its data.
+ *
+ * \param  enable:  DEF_TRUE to enable the cooperative mode.
+ * \param  node:    Own identifier, the one the neighbors see in the frames.
+ *
+ * \note List of notes:
+ *       1. The neighbors overheard are learned in both modes, see AppAgent_Pair.
+ */
+void AppAgent_SetCooperative(bool_t enable, uint16_t node)
+{
+    AppAgent_Model.Cooperative = enable;
+    AppAgent_Model.Node = node;
+}
+
+/**
+ * \brief  Keeps a sample of a neighbor, overheard by the radio.
+ *
+ * \param  neighbor:  Identifier of the neighbor.
+ * \param  data:      Data of the sample.
+ * \param  period:    Periodicity of the neighbor.
+ * \param  charge:    Remaining charge of the neighbor in %.
+ *
+ * \note List of notes:
+ *       1. The last sample heard is paired with the next own sample, see AppAgent_Pair.
+ *       2. A new neighbor takes a free entry, or the entry with the fewest pairs.
+ */
+void AppAgent_Overhear(uint16_t neighbor, float32_t data, uint32_t period, float32_t charge)
+{
+    APP_AGENT_NEIGHBOR_T *p_neighbor = &AppAgent_Model.Neighbors[0];
+    uint8_t i;
+
+    for (i = 0; i < APP_CFG_NEIGHBORS; i++) {
+        if ((DEF_TRUE == AppAgent_Model.Neighbors[i].Known) && (neighbor == AppAgent_Model.Neighbors[i].Id)) {
+            p_neighbor = &AppAgent_Model.Neighbors[i];
+            break;
+        }
+        if ((DEF_FALSE == AppAgent_Model.Neighbors[i].Known) ||
+            (AppAgent_Model.Neighbors[i].Pairs < p_neighbor->Pairs)) {
+            p_neighbor = &AppAgent_Model.Neighbors[i];
+        }
+    }
+    if ((DEF_FALSE == p_neighbor->Known) || (neighbor != p_neighbor->Id)) {
+        memset(p_neighbor, 0x00, sizeof(APP_AGENT_NEIGHBOR_T));
+        p_neighbor->Id = neighbor;
+        p_neighbor->Known = DEF_TRUE;
+    }
+
+    p_neighbor->Data = data;
+    p_neighbor->Period = period;
+    p_neighbor->Charge = charge;
+    p_neighbor->Heard = DEF_TRUE;
+}
+
+/**
+ * \brief  Gets the correlation learned with a neighbor.
+ *
+ * \param  neighbor:  Identifier of the neighbor.
+ *
+ * \return Correlation of the data of the neighbor with the own data, 0 if the neighbor is
+ *         unknown or its data is constant.
+ *
+ */
+float32_t AppAgent_GetCorrelation(uint16_t neighbor)
+{
+    APP_AGENT_NEIGHBOR_T *p_neighbor;
+    float32_t variance;
+    uint8_t i;
+
+    for (i = 0; i < APP_CFG_NEIGHBORS; i++) {
+        p_neighbor = &AppAgent_Model.Neighbors[i];
+        variance = p_neighbor->Variance * p_neighbor->OwnVariance;
+        if ((DEF_TRUE == p_neighbor->Known) && (neighbor == p_neighbor->Id) && (0.0f < variance)) {
+            return p_neighbor->Covariance / sqrtf(variance);
+        }
+    }
+
+    return 0.0f;
+}
+
 /** @} (end addtogroup AppAgent)    */
 /** @} (end addtogroup Agents)      */
@@ -12,7 +12,9 @@
  */
 
 /************* Includes *********************/
+#define __POWER_AGENT_C__                   /* Instantiates the battery tables  */
 #include <string.h>
+#include <math.h>
 #include "../../platform/sa_types.h"
 #include "../../platform/sa_utils.h"
 
@@ -36,19 +38,38 @@
 /************* Battery Model ****************/
 #define POWER_AGENT_NUM_AVERAGES            5u
 
+/************* SOC estimator ****************/
+#define POWER_AGENT_MS_TO_HOURS             (1.0f / SA_UTILS_HOURS_TO_MILLI_S)
+#define POWER_AGENT_PEUKERT_MAX_EXP         0.5f    /* Limit of the exponent of the Peukert correction  */
+
+/************* Lifetime forecast ************/
+#define POWER_AGENT_CONSUMPTION_GAIN        0.1f    /* Gain of the smoothed consumption model           */
+#define POWER_AGENT_MIN_CONSUMPTION         1.0e-6f /* Consumption below this is treated as no drain    */
+#define POWER_AGENT_MAX_FORECAST            4.0e9f  /* Forecast limit, fits in uint32_t                 */
+
+/************* Energy harvesting ************/
+#define POWER_AGENT_HARVEST_DAY_LENGTH      (POWER_AGENT_HARVEST_SLOTS * POWER_AGENT_HARVEST_SLOT_LENGTH)
+
 /************************************** Typedef **************************************************/
 
 /**
  * \brief  Battery model
  *         This struct stores all the relevant information to model de battery.
- *         At the moment only the charge will be modeled.
+ *         The state of charge (SOC) is estimated with a scalar extended Kalman filter.
  *
  * \note List of notes:
  *       1. For simplicity the Total charge will be considered as total effective charge,
  *          which is the battery charge that can actually be used, not the rating.
  *       2. It is also assumed that the Power Agent will update the node everytime the node
- *          wakes up, so there is no need to keep track of time. Also, the charge is read
- *          at the end of the activation process.
+ *          wakes up, so the time is only known through the period between activations.
+ *          Also, the charge and voltage are read at the end of the activation process,
+ *          with the battery at rest.
+ *       3. The remaining charge is the SOC times the temperature compensated capacity.
+ *       4. The consumption per activation is smoothed with an exponentially weighted mean and
+ *          variance, which are used to forecast the remaining life.
+ *       5. The harvested charge is predicted per slot of the day with an exponentially
+ *          weighted mean of the charge harvested in that slot. The sum of the slots, the daily
+ *          harvest, is kept updated so it is available without going through the profile.
  */
 typedef struct {
     float32_t BatteryChargeTotal;       /* Total charge of the battery                  */
@@ -58,6 +79,26 @@ typedef struct {
     float32_t PreviousChargeDelta;      /* Previous charge delta                        */
     float32_t Charge;                   /* Current charge measurement                   */
     float32_t ChargeDelta;              /* Current charge delta                         */
+    float32_t EffectiveChargeDelta;     /* Charge delta corrected by the Peukert effect */
+
+    float32_t Soc;                      /* Estimated state of charge [0, 1]             */
+    float32_t SocCovariance;            /* Covariance of the SOC estimation             */
+    float32_t Capacity;                 /* Temperature compensated capacity             */
+
+    float32_t ConsumptionMean;          /* Smoothed charge per activation               */
+    float32_t ConsumptionVariance;      /* Smoothed variance of the charge per act.     */
+    bool_t    ConsumptionInitialized;
+    POWER_AGENT_FORECAST_T Forecast;    /* Remaining life forecast                      */
+    bool_t    LowAlarm;                 /* The early depletion alarm has been raised    */
+
+    float32_t Harvested;                /* Accumulated harvested charge                 */
+    float32_t PreviousHarvested;
+    float32_t HarvestDelta;             /* Charge harvested in the last activation      */
+    float32_t HarvestProfile[POWER_AGENT_HARVEST_SLOTS];   /* Expected harvest per slot */
+    float32_t DailyHarvest;             /* Sum of the harvest profile                   */
+    float32_t SlotHarvest;              /* Charge harvested in the current slot         */
+    uint32_t  SlotTime;                 /* Time in the current slot in ms               */
+    uint8_t   Slot;                     /* Current slot of the day                      */
 
     float32_t ChargeAvg;                /* Average charge value                         */
     float32_t ChargeAvgAccum;           /* Accumulated value for the average            */
@@ -72,12 +113,18 @@ typedef struct {
 /************************************** Function prototypes **************************************/
 
 static void PowerAgent_UpdateAvgCharge(POWER_AGENT_OBS_T *p_obs);
-static int32_t PowerAgent_PredictBatteryLife(void);
+static float32_t PowerAgent_TempCapacity(float32_t temperature);
+static float32_t PowerAgent_PeukertFactor(float32_t charge_delta, uint32_t period);
+static float32_t PowerAgent_Ocv(float32_t soc, float32_t temperature, float32_t *p_slope);
+static void PowerAgent_EstimateSoc(POWER_AGENT_OBS_T *p_obs, uint32_t period);
+static void PowerAgent_UpdateConsumption(void);
+static void PowerAgent_UpdateHarvest(uint32_t period);
+static void PowerAgent_PredictBatteryLife(uint32_t period);
 float32_t PowerAgent_GetRemainingBatteryLife();
 float32_t PowerAgent_GetRemainingChargePerc();
 
 bool_t PowerAgent_Init(POWER_AGENT_OBSERVATION_T observe, POWER_AGENT_ACTUATION_T act,
-                       POWER_AGENT_BATTERY_DEPLETED_T battery_depleted);
+                       POWER_AGENT_ALARM_T alarm);
 void PowerAgent_Oda(POWER_AGENT_INTERFACE_T *p_data);
 
 
@@ -85,7 +132,7 @@ void PowerAgent_Oda(POWER_AGENT_INTERFACE_T *p_data);
 
 POWER_AGENT_OBSERVATION_T PowerAgent_ObserveEnv = NULL;
 POWER_AGENT_ACTUATION_T PowerAgent_ActuateEnv = NULL;
-POWER_AGENT_BATTERY_DEPLETED_T PowerAgent_BatteryDepleted = NULL;
+POWER_AGENT_ALARM_T PowerAgent_Alarm = NULL;
 
 bool_t PowerAgent_Initialized = DEF_FALSE;
 
@@ -96,6 +143,23 @@ POWER_AGENT_BATTERY_MODEL_T PowerAgent_BatteryModel = {
     .PreviousChargeDelta = 0,
     .Charge = 0.0,
     .ChargeDelta = 0.0,
+    .EffectiveChargeDelta = 0.0,
+    .Soc = 1.0,
+    .SocCovariance = POWER_AGENT_SOC_INITIAL_COVARIANCE,
+    .Capacity = (POWER_AGENT_MAX_BATTERY_MA  * POWER_AGENT_EFFECTIVE_CHARGE),
+    .ConsumptionMean = 0.0,
+    .ConsumptionVariance = 0.0,
+    .ConsumptionInitialized = DEF_FALSE,
+    .Forecast = {0, 0, 0},
+    .LowAlarm = DEF_FALSE,
+    .Harvested = 0.0,
+    .PreviousHarvested = 0.0,
+    .HarvestDelta = 0.0,
+    .HarvestProfile = {0},
+    .DailyHarvest = 0.0,
+    .SlotHarvest = 0.0,
+    .SlotTime = 0,
+    .Slot = 0,
     .ChargeAvg = 0.0,
     .ChargeAvgAccum = 0.0,
     .ChargeBuffPointer = 0,
@@ -133,21 +197,231 @@ static void PowerAgent_UpdateAvgCharge(POWER_AGENT_OBS_T *p_obs)  {
     PowerAgent_BatteryModel.ChargeAvg = PowerAgent_BatteryModel.ChargeAvgAccum / num;
  }
 
- /**
+/************* SOC estimator ****************/
+/**
+ * \brief  Computes the capacity of the battery relative to its rating at a given temperature.
+ *
+ * \param  temperature:  Temperature of the battery in C.
+ *
+ * \return Relative capacity.
+ *
+ */
+static float32_t PowerAgent_TempCapacity(float32_t temperature)
+{
+    float32_t factor;
+    factor = 1.0f + POWER_AGENT_TEMP_CAPACITY_COEF * (temperature - POWER_AGENT_TEMP_REF);
+    return SA_UTILS_SATURATE(POWER_AGENT_TEMP_CAPACITY_MIN, POWER_AGENT_TEMP_CAPACITY_MAX, factor);
+}
+
+/**
+ * \brief  Computes the Peukert correction for the charge drawn in the last activation.
+ *
+ * \param  charge_delta:  Charge drawn since the last activation.
+ * \param  period:        Time since the last activation in ms.
+ *
+ * \return Factor to apply to the charge drawn, 1 if the rate is unknown.
+ *
+ * \note List of notes:
+ *       1. The factor is (I / I_ref)^(k - 1), which is computed as exp((k - 1) * ln(I / I_ref)).
+ *          The exponent is small for any realistic cell, so the exponential is approximated
+ *          with its third order series and the exponent is saturated to keep it accurate.
+ */
+static float32_t PowerAgent_PeukertFactor(float32_t charge_delta, uint32_t period)
+{
+    float32_t current, y;
+
+    if ((0 == period) || (0.0f >= charge_delta)) {
+        return 1.0f;
+    }
+
+    current = charge_delta / (period * POWER_AGENT_MS_TO_HOURS);
+    y = (POWER_AGENT_PEUKERT_EXPONENT - 1.0f) * \
+        SaUtils_FastLn(current / POWER_AGENT_PEUKERT_REF_CURRENT);
+    y = SA_UTILS_SATURATE(-POWER_AGENT_PEUKERT_MAX_EXP, POWER_AGENT_PEUKERT_MAX_EXP, y);
+
+    return 1.0f + y * (1.0f + y * 0.5f * (1.0f + y * 0.33333333f));
+}
+
+/**
+ * \brief  Computes the open circuit voltage of the battery.
+ *
+ * \param  soc:          State of charge.
+ * \param  temperature:  Temperature of the battery in C.
+ * \param  p_slope:      Derivative of the OCV with respect to the SOC. This will be updated.
+ *
+ * \return Open circuit voltage in V.
+ *
+ * \note List of notes:
+ *       1. Bilinear interpolation of the OCV table: the SOC is interpolated in the two
+ *          closest temperature bands and the results are blended. Both steps are fixed,
+ *          so there is no search and no iteration.
+ */
+static float32_t PowerAgent_Ocv(float32_t soc, float32_t temperature, float32_t *p_slope)
+{
+    float32_t position, blend;
+    float32_t ocv_lo, ocv_hi, slope_lo, slope_hi;
+    uint32_t band;
+
+    position = (temperature - BATTERY_CFG_OCV_TEMP_MIN) * (1.0f / BATTERY_CFG_OCV_TEMP_STEP);
+    position = SA_UTILS_SATURATE(0.0f, (float32_t)(BATTERY_CFG_OCV_BANDS - 1u), position);
+    band = (uint32_t) position;
+    band -= (uint32_t)(band >= BATTERY_CFG_OCV_BANDS - 1u);
+    blend = position - band;
+
+    soc *= (float32_t)(BATTERY_CFG_OCV_POINTS - 1u);
+    ocv_lo = SaUtils_Interpolate(BatteryCfg_Ocv[band], BATTERY_CFG_OCV_POINTS, soc, &slope_lo);
+    ocv_hi = SaUtils_Interpolate(BatteryCfg_Ocv[band + 1u], BATTERY_CFG_OCV_POINTS, soc, &slope_hi);
+
+    *p_slope = (slope_lo + blend * (slope_hi - slope_lo)) * (float32_t)(BATTERY_CFG_OCV_POINTS - 1u);
+    return ocv_lo + blend * (ocv_hi - ocv_lo);
+}
+
+/**
+ * \brief  Updates the state of charge estimation.
+ *
+ * \param  p_obs:   Pointer to the observation data.
+ * \param  period:  Time since the last activation in ms.
+ *
+ * \note List of notes:
+ *       1. Prediction: coulomb counting of the Peukert corrected charge, minus the stored part
+ *          of the harvested charge, over the temperature compensated capacity. The coulomb
+ *          counter error is added as process noise.
+ *       2. Correction: the battery voltage is compared with the OCV of the predicted SOC.
+ *          A voltage of 0 or lower means that no measurement is available and the
+ *          correction is skipped.
+ *       3. The state is a scalar, so the filter has no matrix operations and only one
+ *          division is needed for the gain.
+ */
+static void PowerAgent_EstimateSoc(POWER_AGENT_OBS_T *p_obs, uint32_t period)
+{
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+    float32_t ocv, slope, gain, noise;
+
+    /* Predict          */
+    p_model->Capacity = p_model->BatteryChargeTotal * PowerAgent_TempCapacity(p_obs->Battery.Temperature);
+    p_model->EffectiveChargeDelta = p_model->ChargeDelta * \
+                                    PowerAgent_PeukertFactor(p_model->ChargeDelta, period);
+    p_model->Soc -= p_model->EffectiveChargeDelta / p_model->Capacity;
+    p_model->Soc += POWER_AGENT_CHARGE_EFFICIENCY * p_model->HarvestDelta / p_model->Capacity;
+
+    noise  = p_model->EffectiveChargeDelta + p_model->HarvestDelta;
+    noise *= POWER_AGENT_COULOMB_COUNTER_CONF / p_model->Capacity;
+    p_model->SocCovariance += noise * noise + POWER_AGENT_SOC_PROCESS_NOISE;
+
+    /* Correct          */
+    if (0.0f < p_obs->Battery.BatteryVoltage) {
+        ocv = PowerAgent_Ocv(p_model->Soc, p_obs->Battery.Temperature, &slope);
+        gain  = p_model->SocCovariance * slope;
+        gain /= slope * gain + POWER_AGENT_VOLTAGE_NOISE * POWER_AGENT_VOLTAGE_NOISE;
+        p_model->Soc += gain * (p_obs->Battery.BatteryVoltage - ocv);
+        p_model->SocCovariance -= gain * slope * p_model->SocCovariance;
+    }
+
+    p_model->Soc = SA_UTILS_SATURATE(0.0f, 1.0f, p_model->Soc);
+    p_model->BatteryChargeRemaining = p_model->Soc * p_model->Capacity;
+}
+
+/**
+ * \brief  Updates the smoothed consumption model with the last activation.
+ *
+ */
+static void PowerAgent_UpdateConsumption(void)
+{
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+    float32_t error;
+
+    if (DEF_FALSE == p_model->ConsumptionInitialized) {
+        p_model->ConsumptionMean = p_model->EffectiveChargeDelta;
+        p_model->ConsumptionVariance = 0.0f;
+        p_model->ConsumptionInitialized = DEF_TRUE;
+    } else {
+        error = p_model->EffectiveChargeDelta - p_model->ConsumptionMean;
+        p_model->ConsumptionMean += POWER_AGENT_CONSUMPTION_GAIN * error;
+        p_model->ConsumptionVariance = (1.0f - POWER_AGENT_CONSUMPTION_GAIN) * \
+            (p_model->ConsumptionVariance + POWER_AGENT_CONSUMPTION_GAIN * error * error);
+    }
+}
+
+/**
+ * \brief  Updates the daily harvest profile with the last activation.
+ *
+ * \param  period:  Time since the last activation in ms.
+ *
+ * \note List of notes:
+ *       1. When a slot ends, its expected harvest is updated with the charge harvested in it.
+ *          If the period spans several slots, the harvest is shared evenly between them.
+ */
+static void PowerAgent_UpdateHarvest(uint32_t period)
+{
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+    float32_t share, previous;
+    uint32_t slots;
+
+    p_model->SlotHarvest += p_model->HarvestDelta;
+    p_model->SlotTime += period;
+    slots = p_model->SlotTime / POWER_AGENT_HARVEST_SLOT_LENGTH;
+    if (0 == slots) {
+        return;
+    }
+
+    share = p_model->SlotHarvest / slots;
+    p_model->SlotTime %= POWER_AGENT_HARVEST_SLOT_LENGTH;
+    p_model->SlotHarvest = 0.0f;
+    while (0 != slots--) {
+        previous = p_model->HarvestProfile[p_model->Slot];
+        p_model->HarvestProfile[p_model->Slot] = SaUtils_UpdateValue(previous, share,
+                                                                     POWER_AGENT_HARVEST_GAIN);
+        p_model->DailyHarvest += p_model->HarvestProfile[p_model->Slot] - previous;
+        p_model->Slot = (uint8_t)((p_model->Slot + 1u) % POWER_AGENT_HARVEST_SLOTS);
+    }
+    p_model->DailyHarvest = SA_UTILS_MAX(p_model->DailyHarvest, 0.0f);
+}
+
+/**
  * \brief  Predicts the remaining battery life in number of activations.
+ *         The forecast is the remaining charge over the smoothed consumption net of the
+ *         expected harvest, with confidence bounds from the SOC covariance and the uncertainty
+ *         of the smoothed consumption.
  *
- * \return number of remaining activations.
+ * \param  period:  Time between activations in ms.
  *
  * \note List of notes:
  *       1. The number of remaining activations is rounded down (truncated), since the node
  *          cannot realy turn off.
+ *       2. The relative variance of the forecast is approximated as the sum of the relative
+ *          variances of the remaining charge (SOC covariance times the capacity squared) and
+ *          of the mean consumption (variance of an exponentially weighted mean).
+ *       3. Without net consumption the forecast saturates to the maximum number of activations.
+ *       4. The expected harvest per activation is the stored part of the daily harvest for the
+ *          period of the activation.
  */
-static int32_t PowerAgent_PredictBatteryLife(void)  {
-    float32_t life_raw;
-    life_raw = (PowerAgent_BatteryModel.BatteryChargeRemaining) / \
-               (PowerAgent_BatteryModel.ChargeDelta);
+static void PowerAgent_PredictBatteryLife(uint32_t period)  {
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+    float32_t life, remaining, deviation, variance, consumption;
+
+    consumption  = POWER_AGENT_CHARGE_EFFICIENCY * p_model->DailyHarvest;
+    consumption *= (float32_t) period / POWER_AGENT_HARVEST_DAY_LENGTH;
+    consumption  = p_model->ConsumptionMean - consumption;
+
+    if (POWER_AGENT_MIN_CONSUMPTION >= consumption) {
+        p_model->Forecast.Mean = (uint32_t) POWER_AGENT_MAX_FORECAST;
+        p_model->Forecast.Lower = (uint32_t) POWER_AGENT_MAX_FORECAST;
+        p_model->Forecast.Upper = (uint32_t) POWER_AGENT_MAX_FORECAST;
+        return;
+    }
+
+    remaining = SA_UTILS_MAX(p_model->BatteryChargeRemaining, POWER_AGENT_MIN_CONSUMPTION);
+    life = remaining / consumption;
 
-    return (int32_t) life_raw;
+    variance  = p_model->SocCovariance * p_model->Capacity * p_model->Capacity / (remaining * remaining);
+    variance += p_model->ConsumptionVariance * \
+                (POWER_AGENT_CONSUMPTION_GAIN / (2.0f - POWER_AGENT_CONSUMPTION_GAIN)) / \
+                (consumption * consumption);
+    deviation = POWER_AGENT_FORECAST_CONFIDENCE * life * sqrtf(variance);
+
+    p_model->Forecast.Mean  = (uint32_t) SA_UTILS_SATURATE(0.0f, POWER_AGENT_MAX_FORECAST, life);
+    p_model->Forecast.Lower = (uint32_t) SA_UTILS_SATURATE(0.0f, POWER_AGENT_MAX_FORECAST, life - deviation);
+    p_model->Forecast.Upper = (uint32_t) SA_UTILS_SATURATE(0.0f, POWER_AGENT_MAX_FORECAST, life + deviation);
 }
 
 /**
@@ -197,6 +471,60 @@ float32_t PowerAgent_GetPowerMeasurement()
     return PowerAgent_BatteryModel.ChargeDelta;
 }
 
+/**
+ * \brief  Gets the open circuit voltage of the battery for a given state.
+ *
+ * \param  soc:          State of charge [0, 1].
+ * \param  temperature:  Temperature of the battery in C.
+ *
+ * \return Open circuit voltage in V.
+ *
+ */
+float32_t PowerAgent_GetOcv(float32_t soc, float32_t temperature)
+{
+    float32_t slope;
+    return PowerAgent_Ocv(soc, temperature, &slope);
+}
+
+/**
+ * \brief  Gets the remaining life forecast.
+ *
+ * \param  p_forecast:  Pointer to where the forecast will be saved.
+ *
+ */
+void PowerAgent_GetLifeForecast(POWER_AGENT_FORECAST_T *p_forecast)
+{
+    *p_forecast = PowerAgent_BatteryModel.Forecast;
+}
+
+/**
+ * \brief  Gets the expected harvest over a day.
+ *
+ * \return Expected harvested charge stored in the battery per day.
+ *
+ */
+float32_t PowerAgent_GetDailyHarvest(void)
+{
+    return POWER_AGENT_CHARGE_EFFICIENCY * PowerAgent_BatteryModel.DailyHarvest;
+}
+
+/**
+ * \brief  Gets the estimated state of charge.
+ *
+ * \param  p_covariance:  Pointer to where the covariance of the estimation will be saved,
+ *                        it can be NULL.
+ *
+ * \return Estimated state of charge [0, 1].
+ *
+ */
+float32_t PowerAgent_GetSoc(float32_t *p_covariance)
+{
+    if (NULL != p_covariance) {
+        *p_covariance = PowerAgent_BatteryModel.SocCovariance;
+    }
+    return PowerAgent_BatteryModel.Soc;
+}
+
 /************* Initialization ***************/
 /**
  * \brief  Sets the effective battery charge and remaining battery charge.
@@ -209,6 +537,113 @@ void PowerAgent_SetBatteryCharge(float32_t charge)
 {
     PowerAgent_BatteryModel.BatteryChargeTotal = charge;
     PowerAgent_BatteryModel.BatteryChargeRemaining = charge;
+    PowerAgent_BatteryModel.Capacity = charge;
+    PowerAgent_BatteryModel.Soc = 1.0f;
+    PowerAgent_BatteryModel.LowAlarm = DEF_FALSE;
+}
+
+#ifdef SA_SIMULATION
+/**
+ * \brief  Advances the battery model over activations that repeat the last one, without
+ *         observing them. This is only for simulation, to fast-forward a steady state.
+ *
+ * \param  activations:  Number of activations skipped.
+ * \param  period:       Time between activations in ms.
+ *
+ * \note List of notes:
+ *       1. Every skipped activation draws and harvests the same charge as the last one, so
+ *          the coulomb counter reading expected in the next activation is advanced by the
+ *          whole amount, and the SOC prediction is applied once for all of them. The
+ *          consumption model is not updated, since its input does not change.
+ *       2. The life forecast is predicted again, the power index is only updated by the next
+ *          observation.
+ */
+void PowerAgent_Advance(uint32_t activations, uint32_t period)
+{
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+    float32_t noise;
+
+    if (0u == activations) return;
+
+    p_model->PreviousCharge += activations * p_model->ChargeDelta;
+    p_model->PreviousHarvested += activations * p_model->HarvestDelta;
+
+    p_model->Soc -= activations * p_model->EffectiveChargeDelta / p_model->Capacity;
+    p_model->Soc += activations * POWER_AGENT_CHARGE_EFFICIENCY * p_model->HarvestDelta / p_model->Capacity;
+    p_model->Soc = SA_UTILS_SATURATE(0.0f, 1.0f, p_model->Soc);
+    p_model->BatteryChargeRemaining = p_model->Soc * p_model->Capacity;
+
+    noise  = p_model->EffectiveChargeDelta + p_model->HarvestDelta;
+    noise *= POWER_AGENT_COULOMB_COUNTER_CONF / p_model->Capacity;
+    p_model->SocCovariance += activations * (noise * noise + POWER_AGENT_SOC_PROCESS_NOISE);
+
+    p_model->HarvestDelta *= activations;
+    PowerAgent_UpdateHarvest(activations * period);
+    p_model->HarvestDelta /= activations;
+
+    PowerAgent_PredictBatteryLife(period);
+}
+#endif
+
+/**
+ * \brief  Saves the learned state of the battery model.
+ *
+ * \param  p_checkpoint:  Pointer to where the state will be saved.
+ *
+ */
+void PowerAgent_SaveCheckpoint(POWER_AGENT_CHECKPOINT_T *p_checkpoint)
+{
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+
+    p_checkpoint->BatteryChargeTotal = p_model->BatteryChargeTotal;
+    p_checkpoint->BatteryChargeRemaining = p_model->BatteryChargeRemaining;
+    p_checkpoint->PreviousCharge = p_model->PreviousCharge;
+    p_checkpoint->PreviousHarvested = p_model->PreviousHarvested;
+    p_checkpoint->Soc = p_model->Soc;
+    p_checkpoint->SocCovariance = p_model->SocCovariance;
+    p_checkpoint->Capacity = p_model->Capacity;
+    p_checkpoint->ConsumptionMean = p_model->ConsumptionMean;
+    p_checkpoint->ConsumptionVariance = p_model->ConsumptionVariance;
+    memcpy(p_checkpoint->HarvestProfile, p_model->HarvestProfile, sizeof(p_model->HarvestProfile));
+    p_checkpoint->DailyHarvest = p_model->DailyHarvest;
+    p_checkpoint->SlotHarvest = p_model->SlotHarvest;
+    p_checkpoint->SlotTime = p_model->SlotTime;
+    p_checkpoint->PowerFeedback = p_model->PowerFeedback;
+    p_checkpoint->Slot = p_model->Slot;
+    p_checkpoint->ConsumptionInitialized = p_model->ConsumptionInitialized;
+}
+
+/**
+ * \brief  Restores the learned state of the battery model, after PowerAgent_Init.
+ *
+ * \param  p_checkpoint:  Pointer to the saved state.
+ *
+ * \note List of notes:
+ *       1. The coulomb counter is assumed to keep counting through the reset of the mote, so
+ *          the charge consumed while the mote was down is accounted in the first activation.
+ *       2. The moving average of the charge is not saved, it is filled again in a few
+ *          activations.
+ */
+void PowerAgent_RestoreCheckpoint(const POWER_AGENT_CHECKPOINT_T *p_checkpoint)
+{
+    POWER_AGENT_BATTERY_MODEL_T *p_model = &PowerAgent_BatteryModel;
+
+    p_model->BatteryChargeTotal = p_checkpoint->BatteryChargeTotal;
+    p_model->BatteryChargeRemaining = p_checkpoint->BatteryChargeRemaining;
+    p_model->PreviousCharge = p_checkpoint->PreviousCharge;
+    p_model->PreviousHarvested = p_checkpoint->PreviousHarvested;
+    p_model->Soc = p_checkpoint->Soc;
+    p_model->SocCovariance = p_checkpoint->SocCovariance;
+    p_model->Capacity = p_checkpoint->Capacity;
+    p_model->ConsumptionMean = p_checkpoint->ConsumptionMean;
+    p_model->ConsumptionVariance = p_checkpoint->ConsumptionVariance;
+    memcpy(p_model->HarvestProfile, p_checkpoint->HarvestProfile, sizeof(p_model->HarvestProfile));
+    p_model->DailyHarvest = p_checkpoint->DailyHarvest;
+    p_model->SlotHarvest = p_checkpoint->SlotHarvest;
+    p_model->SlotTime = p_checkpoint->SlotTime;
+    p_model->PowerFeedback = p_checkpoint->PowerFeedback;
+    p_model->Slot = p_checkpoint->Slot;
+    p_model->ConsumptionInitialized = p_checkpoint->ConsumptionInitialized;
 }
 
 /**
@@ -216,16 +651,17 @@ void PowerAgent_SetBatteryCharge(float32_t charge)
  *
  * \param  observe:   Pointer to the observe function.
  * \param  act:       Pointer to the actuation function.
- * \param  battery_depleted    Pointer to the battery depleted function.
+ * \param  alarm:     Pointer to the alarm function, called on early depletion forecast and
+ *                    on depletion.
  *
  * \return DEF_TRUE if the agent could be initialized correctly; otherwise DEF_FALSE.
  *
  * \note List of notes:
- *       1. The battery depleted function is optional, so it is not checked for NULL pointer.
+ *       1. The alarm function is optional, so it is not checked for NULL pointer.
  *
  */
 bool_t PowerAgent_Init(POWER_AGENT_OBSERVATION_T observe, POWER_AGENT_ACTUATION_T act,
-                      POWER_AGENT_BATTERY_DEPLETED_T battery_depleted) {
+                      POWER_AGENT_ALARM_T alarm) {
 
     bool_t initialization = DEF_TRUE;
 
@@ -240,13 +676,23 @@ bool_t PowerAgent_Init(POWER_AGENT_OBSERVATION_T observe, POWER_AGENT_ACTUATION_
     } else {
         PowerAgent_ActuateEnv = act;
     }
-    PowerAgent_BatteryDepleted = battery_depleted;
+    PowerAgent_Alarm = alarm;
 
     /* Initilize model      */
     memset(PowerAgent_BatteryModel.ChargeBuffer, 0x00,
            sizeof(float32_t) * POWER_AGENT_NUM_AVERAGES);
     PowerAgent_BatteryModel.Initialized = DEF_FALSE;
-    PowerAgent_SetBatteryCharge(POWER_AGENT_MAX_BATTERY_MA);
+    PowerAgent_BatteryModel.PreviousCharge = 0.0f;      /* The counter starts with the battery  */
+    PowerAgent_BatteryModel.PreviousHarvested = 0.0f;
+    PowerAgent_SetBatteryCharge(POWER_AGENT_MAX_BATTERY_MA * POWER_AGENT_EFFECTIVE_CHARGE);
+    PowerAgent_BatteryModel.SocCovariance = POWER_AGENT_SOC_INITIAL_COVARIANCE;
+    PowerAgent_BatteryModel.ConsumptionInitialized = DEF_FALSE;
+    memset(PowerAgent_BatteryModel.HarvestProfile, 0x00,
+           sizeof(PowerAgent_BatteryModel.HarvestProfile));
+    PowerAgent_BatteryModel.DailyHarvest = 0.0f;
+    PowerAgent_BatteryModel.SlotHarvest = 0.0f;
+    PowerAgent_BatteryModel.SlotTime = 0;
+    PowerAgent_BatteryModel.Slot = 0;
 
     PowerAgent_Initialized = DEF_TRUE;
 
@@ -261,22 +707,26 @@ bool_t PowerAgent_Init(POWER_AGENT_OBSERVATION_T observe, POWER_AGENT_ACTUATION_
  *         In this context learning is updating the battery model.
  *
  * \param  *p_obs    Pointer to the obervations data.
+ * \param  *p_data   Pointer to the interface data.
  *
  */
-static void PowerAgent_Learn(POWER_AGENT_OBS_T *p_obs)  {
+static void PowerAgent_Learn(POWER_AGENT_OBS_T *p_obs, POWER_AGENT_INTERFACE_T *p_data)  {
 
     /* Charge update                            */
     PowerAgent_BatteryModel.Charge = p_obs->Battery.Charge;
     PowerAgent_BatteryModel.ChargeDelta = p_obs->Battery.Charge - \
                                           PowerAgent_BatteryModel.PreviousCharge;
-
-    /* Update effective charge  (simplified)    */
-    if (PowerAgent_BatteryModel.BatteryChargeRemaining > PowerAgent_BatteryModel.ChargeDelta) {
-        PowerAgent_BatteryModel.BatteryChargeRemaining -= PowerAgent_BatteryModel.ChargeDelta;
-    } else {
-        // TODO: create an alarm to alert earlier (5 activations earlier).
-        if (NULL != PowerAgent_BatteryDepleted) {
-            PowerAgent_BatteryDepleted();
+    PowerAgent_BatteryModel.Harvested = p_obs->Battery.Harvested;
+    PowerAgent_BatteryModel.HarvestDelta = p_obs->Battery.Harvested - \
+                                           PowerAgent_BatteryModel.PreviousHarvested;
+
+    /* Update effective charge                  */
+    PowerAgent_EstimateSoc(p_obs, p_data->Inputs.Period);
+    PowerAgent_UpdateConsumption();
+    PowerAgent_UpdateHarvest(p_data->Inputs.Period);
+    if (PowerAgent_BatteryModel.BatteryChargeRemaining <= PowerAgent_BatteryModel.EffectiveChargeDelta) {
+        if (NULL != PowerAgent_Alarm) {
+            PowerAgent_Alarm(POWER_AGENT_BATTERY_DEPLETED);
         }
     }
 
@@ -291,6 +741,7 @@ static void PowerAgent_Learn(POWER_AGENT_OBS_T *p_obs)  {
 static void PowerAgent_Update(void)  {
     PowerAgent_BatteryModel.PreviousCharge = PowerAgent_BatteryModel.Charge;
     PowerAgent_BatteryModel.PreviousChargeDelta = PowerAgent_BatteryModel.ChargeDelta;
+    PowerAgent_BatteryModel.PreviousHarvested = PowerAgent_BatteryModel.Harvested;
 }
 
 
@@ -328,20 +779,57 @@ static void PowerAgent_Reflect(POWER_AGENT_INTERFACE_T *p_data)  {
  * \brief  Reason.
  *         In this context reasoning is using the available information:
  *             -) Predict the remaining life of the battery.
+ *             -) Raise the early depletion alarm.
  *             -) Compute the "power index".
  *             -) Decide the adaptations.
  *
  * \param  *p_data   Pointer to the interface data.
  *
+ * \note List of notes:
+ *       1. The early alarm is raised once, when the lower bound of the forecast reaches
+ *          POWER_AGENT_EARLY_ALARM_ACTIVATIONS.
+ *       2. The power index is the relative surplus of the forecast over the expected lifetime,
+ *          so the maximum index means twice the expected lifetime and the minimum index means
+ *          no life left. Using the smoothed forecast keeps the index stable.
+ *       3. In energy neutral mode the expected lifetime is not used. The power index is the
+ *          relative surplus of the stored daily harvest over the daily consumption, so zero
+ *          means zero net drain over a day. While no harvest has been learnt yet, the index is
+ *          the one of the expected lifetime.
  */
 static void PowerAgent_Reason(POWER_AGENT_INTERFACE_T *p_data)  {
 
-    int32_t life;
+    float32_t index, consumption;
+    uint32_t expected = p_data->Inputs.ExpectedLifetime;
+
+    PowerAgent_PredictBatteryLife(p_data->Inputs.Period);
 
-    life = PowerAgent_PredictBatteryLife();
-    life -= (int32_t)p_data->Inputs.ExpectedLifetime;
-    life = SA_UTILS_SATURATE(AGENTS_INDEX_MIN_VALUE, AGENTS_INDEX_MAX_VALUE, life);
-    p_data->Outputs.PowerIndex = life;
+    /* Early depletion alarm    */
+    if ((DEF_FALSE == PowerAgent_BatteryModel.LowAlarm) && \
+        (POWER_AGENT_EARLY_ALARM_ACTIVATIONS >= PowerAgent_BatteryModel.Forecast.Lower)) {
+        PowerAgent_BatteryModel.LowAlarm = DEF_TRUE;
+        if (NULL != PowerAgent_Alarm) {
+            PowerAgent_Alarm(POWER_AGENT_BATTERY_LOW);
+        }
+    }
+
+    /* Power index              */
+    if ((DEF_TRUE == p_data->Inputs.EnergyNeutral) && (0.0f < PowerAgent_BatteryModel.DailyHarvest)) {
+        consumption  = PowerAgent_BatteryModel.ConsumptionMean * POWER_AGENT_HARVEST_DAY_LENGTH;
+        consumption /= SA_UTILS_MAX(p_data->Inputs.Period, 1u);
+        if (POWER_AGENT_MIN_CONSUMPTION >= consumption) {
+            index = AGENTS_INDEX_MAX_VALUE;
+        } else {
+            index  = POWER_AGENT_CHARGE_EFFICIENCY * PowerAgent_BatteryModel.DailyHarvest - consumption;
+            index *= AGENTS_INDEX_MAX_VALUE / consumption;
+        }
+    } else if (0 == expected) {
+        index = AGENTS_INDEX_MAX_VALUE;
+    } else {
+        index  = (float32_t) PowerAgent_BatteryModel.Forecast.Mean - (float32_t) expected;
+        index *= (float32_t) AGENTS_INDEX_MAX_VALUE / expected;
+    }
+    index = SA_UTILS_SATURATE(AGENTS_INDEX_MIN_VALUE, AGENTS_INDEX_MAX_VALUE, index);
+    p_data->Outputs.PowerIndex = (int8_t) index;
 }
 
 
@@ -357,16 +845,16 @@ void PowerAgent_Oda(POWER_AGENT_INTERFACE_T *p_data)
     POWER_AGENT_ACTS_T actuations;
 
     /* Observe data */
-    PowerAgent_ObserveEnv(&observations);  /* Collect extarnal data        */
+    PowerAgent_ObserveEnv(&observations);       /* Collect extarnal data        */
 
     /* Decide       */
-    PowerAgent_Learn(&observations);    /* Update the model             */
-    PowerAgent_Reflect(p_data);         /* Check consistency            */
-    PowerAgent_Reason(p_data);          /* Compute index                */
-    PowerAgent_Update();                /* Final update to the model    */
+    PowerAgent_Learn(&observations, p_data);    /* Update the model             */
+    PowerAgent_Reflect(p_data);                 /* Check consistency            */
+    PowerAgent_Reason(p_data);                  /* Compute index                */
+    PowerAgent_Update();                        /* Final update to the model    */
 
     /* act          */
-    PowerAgent_ActuateEnv(&actuations);    /* Act                          */
+    PowerAgent_ActuateEnv(&actuations);         /* Act                          */
 }
 
 /**
@@ -380,12 +868,12 @@ void PowerAgent_Oda(POWER_AGENT_INTERFACE_T *p_data)
 void PowerAgent_Observe(POWER_AGENT_INTERFACE_T *p_data)
 {
     POWER_AGENT_OBS_T observations;
-    PowerAgent_ObserveEnv(&observations);   /* Collect extarnal data        */
+    PowerAgent_ObserveEnv(&observations);       /* Collect extarnal data        */
 
-    PowerAgent_Learn(&observations);        /* Update the model             */
-    PowerAgent_Reflect(p_data);             /* Check consistency            */
+    PowerAgent_Learn(&observations, p_data);    /* Update the model             */
+    PowerAgent_Reflect(p_data);                 /* Check consistency            */
 
-    PowerAgent_Reason(p_data);              /* Compute index                */
+    PowerAgent_Reason(p_data);                  /* Compute index                */
 }
 
 /**
@@ -11,9 +11,14 @@
  *
  */
 
+#include <string.h>
+#include <math.h>
 #include "../../platform/sa_types.h"
+#include "../../platform/sa_utils.h"
+#include "../../platform/sa_pt.h"
 
 #include "../../include/radio_agent.h"
+#include "../../include/sample_store.h"
 #include "../../configs/radio_cfg.h"
 
 /** \addtogroup Agents
@@ -25,8 +30,12 @@
  */
 
 /************************************** Defines **************************************************/
+#define RADIO_AGENT_RELAY_OBS   ((uint8_t)(1.0f / RADIO_CFG_FORWARDING_GAIN))  /* Observations averaged */
 
 /************************************** Typedef **************************************************/
+/* A drain transmits the samples waiting in RAM after the stored ones */
+typedef char RADIO_AGENT_DRAIN_FITS_BATCH[(RADIO_CFG_DRAIN_BATCH >= RADIO_CFG_MAX_BATCH) ? 1 : -1];
+
 /**
  * \brief  Radio model
  *         This struct stores all the relevant information to model the radio.
@@ -35,6 +44,27 @@
 typedef struct {
     RADIO_CFG_LIST_T CurrentConfig;
     float32_t PowerIncrement;
+    float32_t Batch[RADIO_CFG_MAX_BATCH];       /* Samples waiting for transmission */
+    uint8_t BatchSize;
+    uint8_t Sent;                               /* Frames transmitted since the last observation */
+    uint8_t Frames;                             /* Frames drawn at the last observation */
+    bool_t Transmitting;                        /* Transmission waiting to complete */
+    bool_t Store;                               /* Samples stored while not transmitted */
+    bool_t LinkUp;                              /* Link available in the last observation */
+    float32_t ForwardingRate;                   /* Frames relayed per ms, averaged */
+    uint32_t Period;                            /* Period given at the last observation in ms */
+    uint8_t RelayObs;                           /* Observations of the relays, saturated */
+    float32_t Acks[RADIO_CFG_CONFIGS_SIZE];     /* Acknowledgements per transmission, averaged */
+    float32_t Attempts[RADIO_CFG_CONFIGS_SIZE]; /* Attempts per transmission, averaged */
+    uint8_t Outcomes[RADIO_CFG_CONFIGS_SIZE];   /* Outcomes averaged, saturated */
+    bool_t Feedback;                            /* Delivery observed since the last selection */
+    bool_t Acknowledged;                        /* The radio reports the outcome of its transmissions */
+    CONFIG_POWER_T Expected;                    /* Power of a transmission with its retries */
+    CONFIG_POWER_T Reported;                    /* Expected as reported to the decision engine */
+    float32_t RetryCovariance;                  /* Relative covariance of the retries */
+    float32_t Retries;                          /* Expected charge of a transmission, of an attempt */
+    float32_t RetryCharge;                      /* Charge of the observed retries over the expected */
+    SA_PT_T ActPt;                              /* Resume point of the actuation task */
 } RADIO_AGENT_MODEL_T;
 
 
@@ -43,6 +73,7 @@ typedef struct {
 /************************************** Local Var ************************************************/
 RADIO_AGENT_OBSERVATION_T RadioAgent_ObserveEnv = NULL;
 RADIO_AGENT_ACTUATION_T RadioAgent_ActuateEnv = NULL;
+RADIO_AGENT_DONE_T RadioAgent_DoneEnv = NULL;
 
 RADIO_AGENT_MODEL_T RadioAgent_Model;
 
@@ -63,26 +94,147 @@ RADIO_CFG_LIST_T RadioAgent_GetConfig(void)
 /**
  * \brief  Gets the current power consumption
  *
- * \return Current power consumption.
+ * \return Current power consumption, the expected power of a transmission with its retries.
  *
  */
 float32_t RadioAgent_GetPower(void)
 {
-    return RadioCfg_Configs_Ptr[RadioAgent_Model.CurrentConfig].PowerCost.Power;
+    return RadioAgent_Model.Expected.Power;
 }
 
 /**
  * \brief  Gets a pointer to the power configuration
  *
- * \return Pointer to the power configuration.
+ * \return Pointer to the power configuration, the expected power of a transmission with its
+ *         retries. The corrections made through the pointer are learned by the power of an
+ *         attempt of the config in use.
  *
  */
 CONFIG_POWER_T *RadioAgent_GetPowerPtr(void)
  {
-     return &RadioCfg_Configs_Ptr[RadioAgent_Model.CurrentConfig].PowerCost;
+     return &RadioAgent_Model.Expected;
  }
 
+/**
+ * \brief  Gets the delivery probability of an attempt in a mode.
+ *
+ * \param  config:  Mode of the radio.
+ *
+ * \return Acknowledgements per attempt, averaged, at least RADIO_CFG_DELIVERY_MIN.
+ *
+ */
+float32_t RadioAgent_GetDelivery(RADIO_CFG_LIST_T config)
+{
+    return SA_UTILS_MAX(RadioAgent_Model.Acks[config] / RadioAgent_Model.Attempts[config],
+                        RADIO_CFG_DELIVERY_MIN);
+}
+
+/**
+ * \brief  Gets the forwarding load, the frames relayed for other nodes.
+ *
+ * \return Frames relayed until the next activation, from the averaged rate.
+ *
+ */
+float32_t RadioAgent_GetForwarding(void)
+{
+    return RadioAgent_Model.ForwardingRate * RadioAgent_Model.Period;
+}
+
+/**
+ * \brief  Gets the own frames whose charge is drawn at the last observation.
+ *
+ * \return Frames transmitted between the last two observations.
+ *
+ */
+uint8_t RadioAgent_GetFrames(void)
+{
+    return RadioAgent_Model.Frames;
+}
+
  /************* Tools ************************/
+/**
+ * \brief  Models the retries of a transmission in a mode.
+ *
+ * \param  config:       Mode of the radio.
+ * \param  p_variance:   Pointer to where the variance of the charge is saved.
+ * \param  p_delivered:  Pointer to where the delivery probability of the transmission is saved.
+ *
+ * \return Expected charge of a transmission, in charges of an attempt.
+ *
+ * \note List of notes:
+ *       1. Each attempt is delivered with the delivery probability of the mode, and the radio
+ *          stops at the first acknowledgement or after RADIO_CFG_MAX_ATTEMPTS attempts. Each
+ *          retry adds a backoff of RADIO_CFG_BACKOFF_SHARE of the charge of an attempt, which
+ *          includes its acknowledgement window.
+ *       2. Until the radio reports the outcome of a transmission, a transmission is one
+ *          attempt.
+ */
+static float32_t RadioAgent_Retries(RADIO_CFG_LIST_T config, float32_t *p_variance, float32_t *p_delivered)
+{
+    float32_t delivery = RadioAgent_GetDelivery(config);
+    float32_t reach = 1.0f, mean = 0.0f, square = 0.0f;
+    float32_t probability, charge;
+    uint8_t attempt;
+
+    if (DEF_FALSE == RadioAgent_Model.Acknowledged) {
+        *p_variance = 0.0f;
+        *p_delivered = 1.0f;
+        return 1.0f;
+    }
+
+    for (attempt = 1; attempt <= RADIO_CFG_MAX_ATTEMPTS; attempt++) {
+        probability = (RADIO_CFG_MAX_ATTEMPTS > attempt) ? reach * delivery : reach;
+        charge = attempt + RADIO_CFG_BACKOFF_SHARE * (attempt - 1);
+        mean += probability * charge;
+        square += probability * charge * charge;
+        reach *= 1.0f - delivery;
+    }
+    *p_variance = SA_UTILS_MAX(square - mean * mean, 0.0f);
+    *p_delivered = 1.0f - reach;
+
+    return mean;
+}
+
+/**
+ * \brief  Learns the corrections of the decision engine to the reported power.
+ *
+ * \note List of notes:
+ *       1. The decision engine corrects the expected power through RadioAgent_GetPowerPtr. The
+ *          correction of the power is applied to the power of an attempt of the config in use
+ *          over the expected retries, so the retries are not learned as the power of the radio.
+ *          The covariance is the one of the power of an attempt.
+ */
+static void RadioAgent_Correct(void)
+{
+    CONFIG_POWER_T *p_learned = &RadioCfg_Learned_Ptr[RadioAgent_Model.CurrentConfig];
+
+    p_learned->Power += (RadioAgent_Model.Expected.Power - RadioAgent_Model.Reported.Power) / RadioAgent_Model.Retries;
+    p_learned->Covariance += RadioAgent_Model.Expected.Covariance - RadioAgent_Model.Reported.Covariance;
+    RadioAgent_Model.Reported = RadioAgent_Model.Expected;
+}
+
+/**
+ * \brief  Computes the expected power of a transmission with its retries.
+ *
+ * \return Change of the expected power from the change of the retries.
+ *
+ */
+static float32_t RadioAgent_Expect(void)
+{
+    CONFIG_POWER_T *p_learned = &RadioCfg_Learned_Ptr[RadioAgent_Model.CurrentConfig];
+    float32_t variance, delivered, mean, increment;
+
+    mean = RadioAgent_Retries(RadioAgent_Model.CurrentConfig, &variance, &delivered);
+    increment = p_learned->Power * (mean - RadioAgent_Model.Retries);
+    RadioAgent_Model.Retries = mean;
+    RadioAgent_Model.Expected.Power = p_learned->Power * mean;
+    RadioAgent_Model.Expected.Covariance = p_learned->Covariance;
+    RadioAgent_Model.Reported = RadioAgent_Model.Expected;
+    RadioAgent_Model.RetryCovariance = variance / (mean * mean);
+
+    return increment;
+}
+
 /**
  * \brief  Updates the configuration.
  *
@@ -92,10 +244,66 @@ CONFIG_POWER_T *RadioAgent_GetPowerPtr(void)
 static void RadioAgent_SetCfg(RADIO_CFG_LIST_T cfg)
 {
     float32_t previous_power = RadioAgent_GetPower();
+    RadioAgent_Correct();
     RadioAgent_Model.CurrentConfig = cfg;
+    (void) RadioAgent_Expect();
     RadioAgent_Model.PowerIncrement =  RadioAgent_GetPower() - previous_power;
 }
 
+/**
+ * \brief  Sets the default values of the optional observations.
+ *
+ * \param  p_obs:  Pointer to the obervations data.
+ *
+ */
+static void RadioAgent_DefaultObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->LinkUp = DEF_TRUE;
+    p_obs->Forwarded = 0;
+    p_obs->Attempts = 0;
+    p_obs->Acked = DEF_FALSE;
+    p_obs->Rssi = RADIO_CFG_RSSI_UNKNOWN;
+}
+
+
+/************* Checkpoint *******************/
+/**
+ * \brief  Saves the learned state of the delivery of the radio.
+ *
+ * \param  p_checkpoint:  Pointer to where the state will be saved.
+ *
+ * \note List of notes:
+ *       1. The learned power of the modes is saved with the radio configs.
+ */
+void RadioAgent_SaveCheckpoint(RADIO_AGENT_CHECKPOINT_T *p_checkpoint)
+{
+    memcpy(p_checkpoint->Acks, RadioAgent_Model.Acks, sizeof(p_checkpoint->Acks));
+    memcpy(p_checkpoint->Attempts, RadioAgent_Model.Attempts, sizeof(p_checkpoint->Attempts));
+    memcpy(p_checkpoint->Outcomes, RadioAgent_Model.Outcomes, sizeof(p_checkpoint->Outcomes));
+    p_checkpoint->Config = RadioAgent_Model.CurrentConfig;
+    p_checkpoint->Acknowledged = RadioAgent_Model.Acknowledged;
+}
+
+/**
+ * \brief  Restores the learned state of the delivery of the radio, after RadioAgent_Init.
+ *
+ * \param  p_checkpoint:  Pointer to the saved state.
+ *
+ * \note List of notes:
+ *       1. The expected power is not recomputed, the learned power of the modes is restored
+ *          after it and RadioAgent_Refresh must be called then.
+ *       2. The mode is saturated to the configured modes, in case the checkpoint is from a
+ *          build with a different radio config.
+ */
+void RadioAgent_RestoreCheckpoint(const RADIO_AGENT_CHECKPOINT_T *p_checkpoint)
+{
+    memcpy(RadioAgent_Model.Acks, p_checkpoint->Acks, sizeof(RadioAgent_Model.Acks));
+    memcpy(RadioAgent_Model.Attempts, p_checkpoint->Attempts, sizeof(RadioAgent_Model.Attempts));
+    memcpy(RadioAgent_Model.Outcomes, p_checkpoint->Outcomes, sizeof(RadioAgent_Model.Outcomes));
+    RadioAgent_Model.CurrentConfig = (RADIO_CFG_LIST_T) SA_UTILS_MIN(p_checkpoint->Config,
+                                                                     RADIO_CFG_CONFIGS_SIZE - 1);
+    RadioAgent_Model.Acknowledged = p_checkpoint->Acknowledged;
+}
 
 /************* Initialization ***************/
 /**
@@ -103,13 +311,21 @@ static void RadioAgent_SetCfg(RADIO_CFG_LIST_T cfg)
  *
  * \param  observe:   Pointer to the observe function.
  * \param  act:       Pointer to the actuation function.
+ * \param  done:      Pointer to the function that tells if the transmission has completed, NULL
+ *                    if the actuation function is synchronous. Only used by RadioAgent_ActPt.
+ * \param  store:     DEF_TRUE to store the samples in NVM while the link is down or the radio is
+ *                    idled, and drain them later. The NVM must be initialized.
  *
  * \return DEF_TRUE if the agent could be initialized correctly; otherwise DEF_FALSE.
  *
+ * \note List of notes:
+ *       1. If the store can not be recovered from the NVM the agent runs without it.
  */
-bool_t RadioAgent_Init(RADIO_AGENT_OBSERVATION_T observe, RADIO_AGENT_ACTUATION_T act) {
+bool_t RadioAgent_Init(RADIO_AGENT_OBSERVATION_T observe, RADIO_AGENT_ACTUATION_T act,
+                       RADIO_AGENT_DONE_T done, bool_t store) {
 
     bool_t initialization = DEF_TRUE;
+    uint8_t config;
 
     /* Initialize functions     */
     if (NULL == observe) {
@@ -122,15 +338,129 @@ bool_t RadioAgent_Init(RADIO_AGENT_OBSERVATION_T observe, RADIO_AGENT_ACTUATION_
     } else {
         RadioAgent_ActuateEnv = act;
     }
+    RadioAgent_DoneEnv = done;
 
     /* Initilize model      */
+    RadioCfg_ResetLearned();
     RadioAgent_Model.CurrentConfig = RADIO_CFG_DEFAULT_CONFIG;
+    for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+        RadioAgent_Model.Acks[config] = RADIO_CFG_DELIVERY_PRIOR;
+        RadioAgent_Model.Attempts[config] = 1.0f;
+        RadioAgent_Model.Outcomes[config] = 0;
+    }
+    RadioAgent_Model.Feedback = DEF_FALSE;
+    RadioAgent_Model.Acknowledged = DEF_FALSE;
+    RadioAgent_Model.Retries = 1.0f;
+    RadioAgent_Model.RetryCharge = 0.0f;
+    (void) RadioAgent_Expect();
     RadioAgent_Model.PowerIncrement = RadioAgent_GetPower();
+    RadioAgent_Model.BatchSize = 0;
+    RadioAgent_Model.Sent = 0;
+    RadioAgent_Model.Frames = 0;
+    RadioAgent_Model.Transmitting = DEF_FALSE;
+    RadioAgent_Model.LinkUp = DEF_TRUE;
+    RadioAgent_Model.ForwardingRate = 0;
+    RadioAgent_Model.Period = 0;
+    RadioAgent_Model.RelayObs = 0;
+    RadioAgent_Model.Store = DEF_FALSE;
+    if (DEF_TRUE == store) {
+        RadioAgent_Model.Store = SampleStore_Init();
+    }
+    SA_PT_INIT(&RadioAgent_Model.ActPt);
 
     return initialization;
 }
 
+/**
+ * \brief  Recomputes the expected power after the learned power has been replaced, e.g. by a
+ *         reset to the datasheet or the restore of a checkpoint.
+ *
+ * \note List of notes:
+ *       1. The correction pending in the reported power belongs to the replaced power, so it
+ *          is discarded instead of learned.
+ */
+void RadioAgent_Refresh(void)
+{
+    (void) RadioAgent_Expect();
+}
+
+/**
+ * \brief  Learns the correction pending in the reported power, so the learned power of the
+ *         config in use is complete, e.g. before a checkpoint is saved.
+ *
+ * \note List of notes:
+ *       1. The expected power is recomputed from the learned power, as a restore of the
+ *          checkpoint would do.
+ */
+void RadioAgent_Sync(void)
+{
+    RadioAgent_Correct();
+    RadioAgent_Model.PowerIncrement += RadioAgent_Expect();
+}
+
 /************* Observe **********************/
+/**
+ * \brief  Averages an outcome in the delivery averages of a mode.
+ *
+ * \param  config:    Mode of the radio.
+ * \param  acks:      Acknowledgements of the outcome.
+ * \param  attempts:  Attempts of the outcome.
+ *
+ * \note List of notes:
+ *       1. The gain of the outcome is the inverse of the outcomes averaged, saturated to
+ *          RADIO_CFG_DELIVERY_GAIN.
+ */
+static void RadioAgent_AverageDelivery(RADIO_CFG_LIST_T config, float32_t acks, float32_t attempts)
+{
+    float32_t gain;
+
+    if (UINT8_MAX > RadioAgent_Model.Outcomes[config]) RadioAgent_Model.Outcomes[config]++;
+    gain = SA_UTILS_MAX(1.0f / (1.0f + RadioAgent_Model.Outcomes[config]), RADIO_CFG_DELIVERY_GAIN);
+
+    RadioAgent_Model.Acks[config] += gain * (acks - RadioAgent_Model.Acks[config]);
+    RadioAgent_Model.Attempts[config] += gain * (attempts - RadioAgent_Model.Attempts[config]);
+}
+
+/**
+ * \brief  Learns the delivery probability of the modes from the last transmission.
+ *
+ * \param  *p_obs  Pointer to the obervations data.
+ *
+ * \note List of notes:
+ *       1. The mode in use averages the acknowledgements and the attempts of its
+ *          transmissions, so their ratio is the delivery probability of an attempt.
+ *       2. The other modes average, as one attempt, the delivery predicted from the RSSI of
+ *          the acknowledgement, corrected by the difference of output power, with a logistic
+ *          model of the margin over RADIO_CFG_SENSITIVITY.
+ *       3. The first outcomes of a mode are averaged with the prior as a mean, until the gain
+ *          reaches RADIO_CFG_DELIVERY_GAIN, so the retries expected from the first outcomes
+ *          are not biased by the prior.
+ *       4. The charge of the attempts and backoffs of the transmission over the expected one
+ *          is reported to the decision engine, see RadioAgent_Retries.
+ */
+static void RadioAgent_LearnDelivery(const RADIO_AGENT_OBS_T *p_obs)
+{
+    RADIO_CFG_LIST_T current = RadioAgent_Model.CurrentConfig;
+    float32_t margin, charge;
+    uint8_t config;
+
+    charge = p_obs->Attempts + RADIO_CFG_BACKOFF_SHARE * (p_obs->Attempts - 1);
+    RadioAgent_Model.RetryCharge += RadioCfg_Learned_Ptr[current].Power * (charge - RadioAgent_Model.Retries);
+
+    RadioAgent_AverageDelivery(current, (DEF_TRUE == p_obs->Acked) ? 1.0f : 0.0f, p_obs->Attempts);
+
+    if ((DEF_TRUE == p_obs->Acked) && (RADIO_CFG_RSSI_UNKNOWN != p_obs->Rssi)) {
+        margin = (float32_t)(p_obs->Rssi - RADIO_CFG_SENSITIVITY - RadioCfg_TxPower_Ptr[current]);
+        for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+            if (config == current) continue;
+            RadioAgent_AverageDelivery((RADIO_CFG_LIST_T) config,
+                1.0f / (1.0f + expf(-(margin + RadioCfg_TxPower_Ptr[config]) / RADIO_CFG_LINK_SLOPE)), 1.0f);
+        }
+    }
+    RadioAgent_Model.Feedback = DEF_TRUE;
+    RadioAgent_Model.Acknowledged = DEF_TRUE;
+}
+
 /**
  * \brief  Learns.
  *         In this context learning is application and sensor models.
@@ -138,6 +468,15 @@ bool_t RadioAgent_Init(RADIO_AGENT_OBSERVATION_T observe, RADIO_AGENT_ACTUATION_
  * \param  *p_obs  Pointer to the obervations data.
  * \param  *p_int  Pointe to the interface data.
  *
+ * \note List of notes:
+ *       1. The forwarding load is the exponential average of the frames relayed per ms, with gain
+ *          RADIO_CFG_FORWARDING_GAIN. The relays arrive with the traffic of the other nodes and
+ *          not with the period of the node, so the frames observed are divided by the time since
+ *          the last observation, the period given then. Without a period the load is not
+ *          learned. The load predicted is the rate over the period until the next observation.
+ *          The first observations are averaged with equal weights, so the rate does not wait
+ *          for many periods to converge when the period is long.
+ *       2. The delivery is only learned when the outcome of a transmission is observed.
  */
 static void RadioAgent_Learn(RADIO_AGENT_OBS_T *p_obs, RADIO_AGENT_INTERFACE_T *p_int)
 {
@@ -145,6 +484,18 @@ static void RadioAgent_Learn(RADIO_AGENT_OBS_T *p_obs, RADIO_AGENT_INTERFACE_T *
     if (DEF_TRUE == p_obs->ConfigChange) {
         RadioAgent_SetCfg(p_obs->Config);
     }
+    RadioAgent_Model.LinkUp = p_obs->LinkUp;
+    if (0u != RadioAgent_Model.Period) {
+        if (RADIO_AGENT_RELAY_OBS > RadioAgent_Model.RelayObs) {
+            RadioAgent_Model.RelayObs++;
+        }
+        RadioAgent_Model.ForwardingRate += ((float32_t) p_obs->Forwarded / RadioAgent_Model.Period -
+                                            RadioAgent_Model.ForwardingRate) / RadioAgent_Model.RelayObs;
+    }
+    RadioAgent_Model.Period = p_int->Inputs.Period;
+    if (0u != p_obs->Attempts) {
+        RadioAgent_LearnDelivery(p_obs);
+    }
 }
 
 /**
@@ -167,24 +518,169 @@ static void RadioAgent_Reflect(RADIO_AGENT_INTERFACE_T *p_data)  {
 }
 
 /************* Decide ***********************/
+/**
+ * \brief  Gets the expected energy per delivered frame of a mode.
+ *
+ * \param  config:  Mode of the radio.
+ *
+ * \return Expected power of a transmission over the probability of delivering it.
+ *
+ */
+static float32_t RadioAgent_DeliveryCost(RADIO_CFG_LIST_T config)
+{
+    float32_t variance, delivered, mean;
+
+    mean = RadioAgent_Retries(config, &variance, &delivered);
+
+    return RadioCfg_Learned_Ptr[config].Power * mean / SA_UTILS_MAX(delivered, RADIO_CFG_DELIVERY_MIN);
+}
+
+/**
+ * \brief  Selects the mode with the least expected energy per delivered byte.
+ *
+ * \note List of notes:
+ *       1. The energy of a delivered frame is the expected power of a transmission with its
+ *          retries over the probability of delivering it, see RadioAgent_Retries. The bytes of
+ *          a frame are the same in every mode.
+ *       2. The mode only changes when it saves RADIO_CFG_MODE_HYSTERESIS of the energy, and
+ *          after the outcome of a transmission is observed, so a radio without
+ *          acknowledgements keeps its mode.
+ */
+static void RadioAgent_SelectMode(void)
+{
+    RADIO_CFG_LIST_T best = RadioAgent_Model.CurrentConfig;
+    float32_t cost, best_cost, current_cost;
+    uint8_t config;
+
+    if (DEF_FALSE == RadioAgent_Model.Feedback) return;
+    RadioAgent_Model.Feedback = DEF_FALSE;
+
+    current_cost = RadioAgent_DeliveryCost(best);
+    best_cost = current_cost;
+    for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+        cost = RadioAgent_DeliveryCost((RADIO_CFG_LIST_T) config);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = (RADIO_CFG_LIST_T) config;
+        }
+    }
+    if (best_cost < (1.0f - RADIO_CFG_MODE_HYSTERESIS) * current_cost) {
+        RadioAgent_SetCfg(best);
+    }
+}
+
 /**
  * \brief  Reason.
  *         In this context reasoning is using the available information:
  *           -) Predict the power consumption and the increment in the power consumption.
+ *           -) Report the forwarding load, which is drawn on top of the own transmissions.
+ *           -) Select the mode of the radio for the link quality.
+ *           -) Expect the retries of the transmissions, see RadioAgent_Retries.
  *
  * \param  *p_data   Pointer to the interface data.
  *
+ * \note List of notes:
+ *       1. A change of the expected retries is reported as an increment of the power.
+ *       2. The power is the expectation of the retries, used to plan. The charge of the retries
+ *          observed over it is reported apart, so the decision engine compares the charge
+ *          drawn with the one of the retries that took place.
+ *       3. The power is the one of a transmission. The frames transmitted since the last
+ *          observation are reported with it, since the charge drawn until this observation
+ *          only has those: none while a batch is filled or stored, one per drain, as the
+ *          power of a transmission is the one of a frame whatever its samples.
  */
 static void RadioAgent_Reason(RADIO_AGENT_INTERFACE_T *p_data)  {
 
+    uint8_t batch = SA_UTILS_SATURATE(1u, RADIO_CFG_MAX_BATCH, p_data->Inputs.Batch);
+
+    RadioAgent_SelectMode();
+    RadioAgent_Correct();
+    RadioAgent_Model.PowerIncrement += RadioAgent_Expect();
+    RadioAgent_Model.Frames = RadioAgent_Model.Sent;
+    RadioAgent_Model.Sent = 0;
+
     /* Generate outputs         */
     p_data->Outputs.PredictedPowerPtr = RadioAgent_GetPowerPtr();
     p_data->Outputs.PredictedPowerIncrement = RadioAgent_Model.PowerIncrement;
+    p_data->Outputs.Forwarding = RadioAgent_GetForwarding();
+    p_data->Outputs.Frames = RadioAgent_Model.Frames;
+    p_data->Outputs.RetryCovariance = RadioAgent_Model.RetryCovariance;
+    p_data->Outputs.RetryCharge = RadioAgent_Model.RetryCharge;
+    p_data->Outputs.DeliveryCost  = RadioAgent_DeliveryCost(RadioAgent_Model.CurrentConfig);
+    p_data->Outputs.DeliveryCost /= (float32_t)(RADIO_CFG_FRAME_HEADER + batch * sizeof(float32_t));
     RadioAgent_Model.PowerIncrement = 0;
+    RadioAgent_Model.RetryCharge = 0.0f;
 }
 
 /************* Act **************************/
-// TODO Radio Agent actuation loop.
+/**
+ * \brief  Moves the samples waiting for transmission to the sample store.
+ *
+ */
+static void RadioAgent_StoreBatch(void)
+{
+    uint8_t sample;
+
+    for (sample = 0; sample < RadioAgent_Model.BatchSize; sample++) {
+        SampleStore_Append(RadioAgent_Model.Batch[sample]);
+    }
+    RadioAgent_Model.BatchSize = 0;
+}
+
+/**
+ * \brief  Adds the data to the batch and transmits the batch when it is complete.
+ *
+ * \param  *p_data   Pointer to the interface data.
+ *
+ * \return DEF_TRUE if a transmission was started; otherwise DEF_FALSE.
+ *
+ * \note List of notes:
+ *       1. A batch of 0 or 1 transmits every activation. Batches larger than
+ *          RADIO_CFG_MAX_BATCH are saturated.
+ *       2. If the batch is reduced, the samples already waiting are transmitted in the next
+ *          activation.
+ *       3. With the sample store, the batch is stored instead of transmitted while the link is
+ *          down or the radio is idled. When the drain is enabled, the stored samples are
+ *          transmitted in large batches, up to RADIO_CFG_DRAIN_BATCH, followed by the samples
+ *          waiting in RAM, and released from the store once the transmission is started.
+ */
+static bool_t RadioAgent_Transmit(RADIO_AGENT_INTERFACE_T *p_data)
+{
+    RADIO_AGENT_ACTS_T actuations;
+    uint8_t batch;
+    uint16_t stored = 0;
+
+    batch = SA_UTILS_SATURATE(1u, RADIO_CFG_MAX_BATCH, p_data->Inputs.Batch);
+    RadioAgent_Model.Batch[RadioAgent_Model.BatchSize++] = p_data->Inputs.Data;
+
+    if (DEF_TRUE == RadioAgent_Model.Store) {
+        if ((DEF_FALSE == RadioAgent_Model.LinkUp) || (DEF_TRUE == p_data->Inputs.Idle)) {
+            RadioAgent_StoreBatch();
+            return DEF_FALSE;
+        }
+        if (DEF_TRUE == p_data->Inputs.Drain) {
+            stored = SampleStore_Peek(actuations.Batch,
+                                      RADIO_CFG_DRAIN_BATCH - RadioAgent_Model.BatchSize);
+        }
+    }
+    if ((batch > RadioAgent_Model.BatchSize) && (0u == stored)) {
+        return DEF_FALSE;
+    }
+
+    actuations.Data = p_data->Inputs.Data;
+    memcpy(&actuations.Batch[stored], RadioAgent_Model.Batch,
+           RadioAgent_Model.BatchSize * sizeof(float32_t));
+    actuations.BatchSize = (uint8_t)(stored + RadioAgent_Model.BatchSize);
+    actuations.Stored = (uint8_t) stored;
+    actuations.Config = RadioAgent_Model.CurrentConfig;
+    RadioAgent_Model.BatchSize = 0;
+    RadioAgent_Model.Sent++;
+    RadioAgent_ActuateEnv(&actuations);
+    if (0u != stored) {
+        SampleStore_Release(stored);
+    }
+    return DEF_TRUE;
+}
 
 /************* Main ODA *********************/
 /**
@@ -196,10 +692,10 @@ static void RadioAgent_Reason(RADIO_AGENT_INTERFACE_T *p_data)  {
 void RadioAgent_Oda(RADIO_AGENT_INTERFACE_T *p_data)
 {
     RADIO_AGENT_OBS_T observations;
-    RADIO_AGENT_ACTS_T actuations;
 
     /* Observe data     */
     observations.Data = p_data->Inputs.Data;
+    RadioAgent_DefaultObs(&observations);
     RadioAgent_ObserveEnv(&observations);
     RadioAgent_Learn(&observations, p_data);
     RadioAgent_Reflect(p_data);
@@ -208,8 +704,7 @@ void RadioAgent_Oda(RADIO_AGENT_INTERFACE_T *p_data)
     RadioAgent_Reason(p_data);
 
     /* act              */
-    actuations.Data = p_data->Inputs.Data;
-    RadioAgent_ActuateEnv(&actuations);
+    RadioAgent_Transmit(p_data);
 }
 
 /**
@@ -226,6 +721,7 @@ void RadioAgent_Observe(RADIO_AGENT_INTERFACE_T *p_data)
 
     /* Observe data     */
     observations.Data = p_data->Inputs.Data;
+    RadioAgent_DefaultObs(&observations);
     RadioAgent_ObserveEnv(&observations);
     RadioAgent_Learn(&observations, p_data);
     RadioAgent_Reflect(p_data);
@@ -244,11 +740,31 @@ void RadioAgent_Observe(RADIO_AGENT_INTERFACE_T *p_data)
  */
 void RadioAgent_Act(RADIO_AGENT_INTERFACE_T *p_data)
 {
-    RADIO_AGENT_ACTS_T actuations;
-
     /* act              */
-    actuations.Data = p_data->Inputs.Data;
-    RadioAgent_ActuateEnv(&actuations);
+    RadioAgent_Transmit(p_data);
+}
+
+/**
+ * \brief  Runs the Actuation task as a resumable function.
+ *         The task starts the transmission the same as RadioAgent_Act, and then waits, without
+ *         blocking, until the transmission has completed.
+ *
+ * \param  p_data:  Pointer the the interface data of the agent.
+ *
+ * \return SA_PT_WAITING while the transmission is in progress, call again to resume;
+ *         otherwise SA_PT_DONE.
+ *
+ */
+SA_PT_STATUS_T RadioAgent_ActPt(RADIO_AGENT_INTERFACE_T *p_data)
+{
+    SA_PT_T *pt = &RadioAgent_Model.ActPt;
+
+    SA_PT_BEGIN(pt);
+    RadioAgent_Model.Transmitting = RadioAgent_Transmit(p_data);
+    SA_PT_WAIT_UNTIL(pt, (DEF_FALSE == RadioAgent_Model.Transmitting) ||
+                         (NULL == RadioAgent_DoneEnv) || (DEF_TRUE == RadioAgent_DoneEnv()));
+    RadioAgent_Model.Transmitting = DEF_FALSE;
+    SA_PT_END(pt);
 }
 
 /** @} (end addtogroup RadioAgent)   */
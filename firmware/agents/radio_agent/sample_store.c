@@ -0,0 +1,475 @@
+/**
+ * \file    sample_store.c
+ *
+ * \brief   Store and forward of the samples in NVM, while the link is down or the radio is idled.
+ *          The store is a log in a ring of NVM sectors: the samples are only appended, and a
+ *          sector is only erased when all its samples have been drained, or when the log wraps
+ *          around and the oldest samples are dropped to keep the newest ones.
+ *          Every sector starts with a header with a sequence number, so the order of the log is
+ *          recovered after a reset. Every record holds one sample, its CRC, a mark written after
+ *          the sample and a mark written when the sample is drained. The marks only clear bits,
+ *          so they are written over the erased record without an erase.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SampleStore_
+ *
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "../../platform/sa_types.h"
+#include "../../platform/sa_utils.h"
+#include "../../platform/sa_nvm.h"
+
+#include "../../configs/radio_cfg.h"
+#include "../../configs/mote_cfg.h"
+
+#include "../../include/sample_store.h"
+
+/** \addtogroup Agents
+ *   @{
+ */
+
+/** \addtogroup SampleStore
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SAMPLE_STORE_MAGIC          0x5A3Cu     /* Marks an opened sector                   */
+#define SAMPLE_STORE_MARK           0x00u       /* Value of a written mark                  */
+
+/* Layout of a sector, a header followed by the records */
+#define SAMPLE_STORE_RECORDS        ((SA_NVM_SECTOR_SIZE - sizeof(SAMPLE_STORE_HEADER_T)) / \
+                                     sizeof(SAMPLE_STORE_RECORD_T))
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Header of a sector, written when the sector is opened for appending.
+ *
+ */
+typedef struct {
+    uint16_t Magic;                     /* SAMPLE_STORE_MAGIC, erased if the sector is free */
+    uint16_t Crc;                       /* CRC of the sequence                              */
+    uint32_t Sequence;                  /* Incremented on every opened sector               */
+} SAMPLE_STORE_HEADER_T;
+
+/**
+ * \brief  Record of a sample.
+ *
+ */
+typedef struct {
+    float32_t Data;
+    uint16_t Crc;                       /* CRC of the data                                  */
+    uint8_t  Written;                   /* SAMPLE_STORE_MARK when the record is complete    */
+    uint8_t  Sent;                      /* SAMPLE_STORE_MARK when the sample is drained     */
+} SAMPLE_STORE_RECORD_T;
+
+/**
+ * \brief  State of a record.
+ *
+ */
+typedef enum {
+    SAMPLE_STORE_FREE = 0,              /* Erased                                           */
+    SAMPLE_STORE_PENDING,               /* Waiting to be drained                            */
+    SAMPLE_STORE_SENT,                  /* Drained                                          */
+    SAMPLE_STORE_INVALID,               /* Incomplete, a write interrupted by a reset       */
+} SAMPLE_STORE_STATE_T;
+
+/* The sectors are tracked with a 16 bit mask, and the store must not overlap the checkpoints */
+typedef char SAMPLE_STORE_SECTORS_RANGE[((2u <= RADIO_CFG_STORE_SECTORS) &&
+                                         (16u >= RADIO_CFG_STORE_SECTORS)) ? 1 : -1];
+typedef char SAMPLE_STORE_SECTORS_FIT[(RADIO_CFG_STORE_FIRST_SECTOR + RADIO_CFG_STORE_SECTORS <=
+                                       SA_NVM_SECTORS) ? 1 : -1];
+typedef char SAMPLE_STORE_AFTER_CHECKPOINT[(RADIO_CFG_STORE_FIRST_SECTOR >=
+                                            MOTE_CFG_CHECKPOINT_FIRST_SECTOR +
+                                            MOTE_CFG_CHECKPOINT_SECTORS) ? 1 : -1];
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static SAMPLE_STORE_STATUS_T SampleStore_Status;
+static uint32_t SampleStore_Sequence;           /* Sequence of the head sector, 0 if none   */
+static uint16_t SampleStore_Head;               /* Sector being appended                    */
+static uint16_t SampleStore_HeadRecord;         /* Next free record of the head sector      */
+static uint16_t SampleStore_Tail;               /* Sector of the oldest pending sample      */
+static uint16_t SampleStore_TailRecord;         /* Oldest record that can be pending        */
+static uint16_t SampleStore_Clean;              /* Mask of the sectors known to be erased   */
+static uint16_t SampleStore_SectorPending[RADIO_CFG_STORE_SECTORS];  /* Pending records per sector */
+static bool_t SampleStore_Ready = DEF_FALSE;
+
+/************************************** Function implementation **********************************/
+
+/************* Layout ***********************/
+/**
+ * \brief  NVM address of a record.
+ *
+ * \param  sector:  Sector of the store.
+ * \param  record:  Record of the sector.
+ *
+ * \return Address of the record.
+ *
+ */
+static uint32_t SampleStore_Address(uint16_t sector, uint16_t record)
+{
+    return SA_NVM_SECTOR_ADDRESS(RADIO_CFG_STORE_FIRST_SECTOR + sector) +
+           sizeof(SAMPLE_STORE_HEADER_T) + (uint32_t) record * sizeof(SAMPLE_STORE_RECORD_T);
+}
+
+/**
+ * \brief  Reads the header of a sector.
+ *
+ * \param  sector:      Sector of the store.
+ * \param  p_sequence:  Pointer to where the sequence will be saved.
+ *
+ * \return DEF_TRUE if the sector has a valid header; otherwise DEF_FALSE.
+ *
+ */
+static bool_t SampleStore_ReadHeader(uint16_t sector, uint32_t *p_sequence)
+{
+    SAMPLE_STORE_HEADER_T header;
+
+    if (DEF_FAIL == SaNvm_Read(SA_NVM_SECTOR_ADDRESS(RADIO_CFG_STORE_FIRST_SECTOR + sector),
+                               &header, sizeof(SAMPLE_STORE_HEADER_T))) {
+        return DEF_FALSE;
+    }
+    *p_sequence = header.Sequence;
+
+    return ((SAMPLE_STORE_MAGIC == header.Magic) && (0u != header.Sequence) &&
+            (header.Crc == SaUtils_Crc16(&header.Sequence, sizeof(header.Sequence),
+                                         SA_UTILS_CRC16_INIT))) ? DEF_TRUE : DEF_FALSE;
+}
+
+/**
+ * \brief  Reads a record.
+ *
+ * \param  sector:  Sector of the store.
+ * \param  record:  Record of the sector.
+ * \param  p_data:  Pointer to where the sample will be saved.
+ *
+ * \return State of the record.
+ *
+ */
+static SAMPLE_STORE_STATE_T SampleStore_ReadRecord(uint16_t sector, uint16_t record,
+                                                   float32_t *p_data)
+{
+    SAMPLE_STORE_RECORD_T entry, erased;
+
+    if (DEF_FAIL == SaNvm_Read(SampleStore_Address(sector, record), &entry,
+                               sizeof(SAMPLE_STORE_RECORD_T))) {
+        return SAMPLE_STORE_INVALID;
+    }
+    memset(&erased, SA_NVM_ERASED, sizeof(SAMPLE_STORE_RECORD_T));
+    if (0 == memcmp(&entry, &erased, sizeof(SAMPLE_STORE_RECORD_T))) return SAMPLE_STORE_FREE;
+
+    if ((SAMPLE_STORE_MARK != entry.Written) ||
+        (entry.Crc != SaUtils_Crc16(&entry.Data, sizeof(entry.Data), SA_UTILS_CRC16_INIT))) {
+        return SAMPLE_STORE_INVALID;
+    }
+    *p_data = entry.Data;
+
+    return (SAMPLE_STORE_MARK == entry.Sent) ? SAMPLE_STORE_SENT : SAMPLE_STORE_PENDING;
+}
+
+/**
+ * \brief  Erases a sector whose samples have all been drained.
+ *
+ * \param  sector:  Sector of the store.
+ *
+ */
+static void SampleStore_Reclaim(uint16_t sector)
+{
+    if (0u != (SampleStore_Clean & (1u << sector))) return;
+    if (DEF_OK == SaNvm_EraseSector((uint16_t)(RADIO_CFG_STORE_FIRST_SECTOR + sector))) {
+        SampleStore_Clean |= (uint16_t)(1u << sector);
+        SampleStore_Status.Reclaimed++;
+    }
+}
+
+/**
+ * \brief  Opens the next sector of the ring for appending.
+ *
+ * \return DEF_OK if the sector is ready to be written; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. If the next sector still holds pending samples the store is full, and these samples,
+ *          the oldest ones, are dropped.
+ *       2. The sector is erased unless it is known to be erased already, after a reclaim.
+ */
+static bool_t SampleStore_Open(void)
+{
+    SAMPLE_STORE_HEADER_T header;
+    uint16_t sector = (uint16_t)((SampleStore_Head + 1u) % RADIO_CFG_STORE_SECTORS);
+
+    /* Full, drop the oldest sector */
+    if (0u != SampleStore_SectorPending[sector]) {
+        SampleStore_Status.Dropped += SampleStore_SectorPending[sector];
+        SampleStore_Status.Pending -= SampleStore_SectorPending[sector];
+        SampleStore_SectorPending[sector] = 0;
+    }
+    if (sector == SampleStore_Tail) {
+        SampleStore_Tail = (uint16_t)((sector + 1u) % RADIO_CFG_STORE_SECTORS);
+        SampleStore_TailRecord = 0;
+    }
+
+    if (0u == (SampleStore_Clean & (1u << sector))) {
+        if (DEF_FAIL == SaNvm_EraseSector((uint16_t)(RADIO_CFG_STORE_FIRST_SECTOR + sector))) {
+            return DEF_FAIL;
+        }
+    }
+    SampleStore_Clean &= (uint16_t) ~(1u << sector);
+
+    header.Magic = SAMPLE_STORE_MAGIC;
+    header.Sequence = SampleStore_Sequence + 1u;
+    header.Crc = SaUtils_Crc16(&header.Sequence, sizeof(header.Sequence), SA_UTILS_CRC16_INIT);
+    if (DEF_FAIL == SaNvm_Write(SA_NVM_SECTOR_ADDRESS(RADIO_CFG_STORE_FIRST_SECTOR + sector),
+                                &header, sizeof(SAMPLE_STORE_HEADER_T))) {
+        return DEF_FAIL;
+    }
+
+    SampleStore_Sequence = header.Sequence;
+    SampleStore_Head = sector;
+    SampleStore_HeadRecord = 0;
+    if (0u == SampleStore_Status.Pending) {
+        SampleStore_Tail = sector;
+        SampleStore_TailRecord = 0;
+    }
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Walks the pending samples from the oldest one.
+ *
+ * \param  p_data:   Pointer to where the samples will be saved, NULL if they are released.
+ * \param  max:      Maximum number of samples.
+ * \param  release:  DEF_TRUE to mark the samples as drained and reclaim the drained sectors.
+ *
+ * \return Number of samples walked.
+ *
+ */
+static uint16_t SampleStore_Walk(float32_t *p_data, uint16_t max, bool_t release)
+{
+    uint16_t sector = SampleStore_Tail;
+    uint16_t record = SampleStore_TailRecord;
+    uint16_t count = 0;
+    uint8_t mark = SAMPLE_STORE_MARK;
+    float32_t data;
+
+    for (;;) {
+        /* End of the log   */
+        if ((sector == SampleStore_Head) &&
+            ((record >= SampleStore_HeadRecord) || (0u == SampleStore_SectorPending[sector]))) {
+            record = SampleStore_HeadRecord;
+            break;
+        }
+        /* End of a sector, which is drained */
+        if ((record >= SAMPLE_STORE_RECORDS) || (0u == SampleStore_SectorPending[sector])) {
+            if (DEF_TRUE == release) SampleStore_Reclaim(sector);
+            sector = (uint16_t)((sector + 1u) % RADIO_CFG_STORE_SECTORS);
+            record = 0;
+            continue;
+        }
+        if (count >= max) break;
+
+        if (SAMPLE_STORE_PENDING == SampleStore_ReadRecord(sector, record, &data)) {
+            if (DEF_FALSE == release) {
+                p_data[count] = data;
+            } else {
+                SaNvm_Write(SampleStore_Address(sector, record) +
+                            offsetof(SAMPLE_STORE_RECORD_T, Sent), &mark, sizeof(mark));
+                SampleStore_SectorPending[sector]--;
+                SampleStore_Status.Pending--;
+                SampleStore_Status.Drained++;
+            }
+            count++;
+        }
+        record++;
+    }
+
+    if (DEF_TRUE == release) {
+        SampleStore_Tail = sector;
+        SampleStore_TailRecord = record;
+    }
+
+    return count;
+}
+
+/************* External *********************/
+/**
+ * \brief  Initializes the store, recovering the log from the NVM.
+ *
+ * \return DEF_OK if the NVM could be scanned; otherwise DEF_FAIL, and the store is disabled.
+ *
+ * \note List of notes:
+ *       1. The NVM must be initialized.
+ *       2. The sectors are opened in the order of the ring, so the log starts at the sector
+ *          after the head, the one with the highest sequence.
+ */
+bool_t SampleStore_Init(void)
+{
+    bool_t valid[RADIO_CFG_STORE_SECTORS];
+    uint32_t sequence;
+    uint16_t sector, record, last, i;
+    float32_t data;
+
+    memset(&SampleStore_Status, 0x00, sizeof(SAMPLE_STORE_STATUS_T));
+    memset(SampleStore_SectorPending, 0x00, sizeof(SampleStore_SectorPending));
+    SampleStore_Sequence = 0;
+    SampleStore_Head = RADIO_CFG_STORE_SECTORS - 1u;
+    SampleStore_HeadRecord = SAMPLE_STORE_RECORDS;      /* The first append opens sector 0 */
+    SampleStore_Clean = 0;
+    SampleStore_Ready = DEF_FALSE;
+
+    /* Head, the latest opened sector   */
+    for (sector = 0; sector < RADIO_CFG_STORE_SECTORS; sector++) {
+        valid[sector] = SampleStore_ReadHeader(sector, &sequence);
+        if ((DEF_TRUE == valid[sector]) && (sequence > SampleStore_Sequence)) {
+            SampleStore_Sequence = sequence;
+            SampleStore_Head = sector;
+        }
+    }
+
+    /* Pending samples  */
+    for (sector = 0; sector < RADIO_CFG_STORE_SECTORS; sector++) {
+        if (DEF_FALSE == valid[sector]) continue;
+        last = 0;
+        for (record = 0; record < SAMPLE_STORE_RECORDS; record++) {
+            switch (SampleStore_ReadRecord(sector, record, &data)) {
+                case SAMPLE_STORE_PENDING:
+                    SampleStore_SectorPending[sector]++;
+                    last = (uint16_t)(record + 1u);
+                    break;
+                case SAMPLE_STORE_SENT:
+                    last = (uint16_t)(record + 1u);
+                    break;
+                case SAMPLE_STORE_INVALID:
+                    SampleStore_Status.Discarded++;
+                    last = (uint16_t)(record + 1u);
+                    break;
+                default:
+                    break;
+            }
+        }
+        SampleStore_Status.Pending += SampleStore_SectorPending[sector];
+        if (sector == SampleStore_Head) SampleStore_HeadRecord = last;
+    }
+
+    /* Tail, the oldest sector with pending samples  */
+    SampleStore_Tail = SampleStore_Head;
+    SampleStore_TailRecord = SampleStore_HeadRecord;
+    for (i = 1; i <= RADIO_CFG_STORE_SECTORS; i++) {
+        sector = (uint16_t)((SampleStore_Head + i) % RADIO_CFG_STORE_SECTORS);
+        if (0u != SampleStore_SectorPending[sector]) {
+            SampleStore_Tail = sector;
+            SampleStore_TailRecord = 0;
+            break;
+        }
+    }
+
+    SampleStore_Ready = DEF_TRUE;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Appends a sample to the log.
+ *
+ * \param  data:  Sample.
+ *
+ * \return DEF_OK if the sample was stored; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The mark is written after the sample, so a reset during the write leaves an
+ *          incomplete record, which is discarded by the next scan.
+ */
+bool_t SampleStore_Append(float32_t data)
+{
+    SAMPLE_STORE_RECORD_T entry;
+    uint32_t address;
+
+    if (DEF_FALSE == SampleStore_Ready) return DEF_FAIL;
+
+    if ((SAMPLE_STORE_RECORDS <= SampleStore_HeadRecord) && (DEF_FAIL == SampleStore_Open())) {
+        return DEF_FAIL;
+    }
+
+    memset(&entry, SA_NVM_ERASED, sizeof(SAMPLE_STORE_RECORD_T));
+    entry.Data = data;
+    entry.Crc = SaUtils_Crc16(&entry.Data, sizeof(entry.Data), SA_UTILS_CRC16_INIT);
+    address = SampleStore_Address(SampleStore_Head, SampleStore_HeadRecord);
+    SampleStore_HeadRecord++;               /* The record is used even if the write fails */
+    entry.Written = SAMPLE_STORE_MARK;
+    if ((DEF_FAIL == SaNvm_Write(address, &entry, offsetof(SAMPLE_STORE_RECORD_T, Written))) ||
+        (DEF_FAIL == SaNvm_Write(address + offsetof(SAMPLE_STORE_RECORD_T, Written),
+                                 &entry.Written, sizeof(entry.Written)))) {
+        return DEF_FAIL;
+    }
+
+    SampleStore_SectorPending[SampleStore_Head]++;
+    SampleStore_Status.Pending++;
+    SampleStore_Status.Appended++;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Reads the oldest pending samples, without draining them.
+ *
+ * \param  p_data:  Pointer to where the samples will be saved, oldest first.
+ * \param  max:     Maximum number of samples.
+ *
+ * \return Number of samples read.
+ *
+ */
+uint16_t SampleStore_Peek(float32_t *p_data, uint16_t max)
+{
+    if (DEF_FALSE == SampleStore_Ready) return 0;
+
+    return SampleStore_Walk(p_data, max, DEF_FALSE);
+}
+
+/**
+ * \brief  Drains the oldest pending samples, once they have been transmitted.
+ *
+ * \param  count:  Number of samples, usually the number returned by SampleStore_Peek.
+ *
+ * \return DEF_OK if all the samples were drained; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The sectors left without pending samples are erased, so the space is reclaimed
+ *          sector by sector while the store is drained.
+ */
+bool_t SampleStore_Release(uint16_t count)
+{
+    if (DEF_FALSE == SampleStore_Ready) return DEF_FAIL;
+
+    return (count == SampleStore_Walk(NULL, count, DEF_TRUE)) ? DEF_OK : DEF_FAIL;
+}
+
+/**
+ * \brief  Gets the number of samples waiting to be drained.
+ *
+ * \return Number of pending samples.
+ *
+ */
+uint32_t SampleStore_GetPending(void)
+{
+    return SampleStore_Status.Pending;
+}
+
+/**
+ * \brief  Gets the status of the store.
+ *
+ * \param  p_status:  Pointer to where the status will be saved.
+ *
+ */
+void SampleStore_GetStatus(SAMPLE_STORE_STATUS_T *p_status)
+{
+    *p_status = SampleStore_Status;
+}
+
+/** @} (end addtogroup SampleStore)     */
+/** @} (end addtogroup Agents)          */
@@ -14,6 +14,7 @@
 #include <math.h>
 #include "../../platform/sa_types.h"
 #include "../../platform/sa_utils.h"
+#include "../../platform/sa_pt.h"
 
 #include "../../include/agents_main.h"
 #include "../../configs/config.h"
@@ -44,6 +45,7 @@ typedef struct {
     SENSOR_CFG_LIST_T CurrentConfig;
     float32_t PowerIncrement;
     float32_t Data;
+    SA_PT_T ObservePt;                  /* Resume point of the observation task     */
 } SENSOR_AGENT_MODEL_T;
 
 
@@ -53,6 +55,8 @@ typedef struct {
 SENSOR_AGENT_OBSERVATION_T SensorAgent_ObserveEnv = NULL;
 SENSOR_AGENT_ACTUATION_T SensorAgent_ActuateEnv = NULL;
 SENSOR_AGENT_ALARM_T SensorAgent_Alarm = NULL;
+SENSOR_AGENT_START_T SensorAgent_StartEnv = NULL;
+SENSOR_AGENT_READY_T SensorAgent_ReadyEnv = NULL;
 
 SENSOR_AGENT_MODEL_T SensorAgent_Model;
 
@@ -79,7 +83,7 @@ SENSOR_CFG_LIST_T SensorAgent_GetConfig(void)
  */
 float32_t SensorAgent_GetPower(void)
 {
-    return SensorCfg_Configs_Ptr[SensorAgent_Model.CurrentConfig].PowerCost.Power;
+    return SensorCfg_Learned_Ptr[SensorAgent_Model.CurrentConfig].Power;
 }
 
 /**
@@ -90,7 +94,7 @@ float32_t SensorAgent_GetPower(void)
  */
 CONFIG_POWER_T *SensorAgent_GetPowerPtr(void)
 {
-    return &SensorCfg_Configs_Ptr[SensorAgent_Model.CurrentConfig].PowerCost;
+    return &SensorCfg_Learned_Ptr[SensorAgent_Model.CurrentConfig];
 }
 
 /************* Utils  ***********************/
@@ -114,12 +118,23 @@ static void SensorAgent_SetConfig(SENSOR_CFG_LIST_T config)
  * \param  observe:   Pointer to the observe function.
  * \param  act:       Pointer to the actuation function.
  * \param  alarm:     Pointer to the alarm function.
+ * \param  start:     Pointer to the function that starts an acquisition, NULL for the serial loop.
+ * \param  ready:     Pointer to the function that tells if the sample can be observed, NULL if
+ *                    it is always ready. Only used by SensorAgent_ObservePt.
  *
  * \return DEF_TRUE if the agent could be initialized correctly; otherwise DEF_FALSE.
  *
+ * \note List of notes:
+ *       1. With a start function the agent runs pipelined: the next acquisition is started at
+ *          the end of the actuation, so the conversion runs while the MCU sleeps, and the
+ *          observation reads the sample that was completed meanwhile. The data observed is
+ *          one activation old.
+ *       2. The first acquisition of the pipeline is started here, so the first observation
+ *          has a completed sample.
  */
 bool_t SensorAgent_Init(SENSOR_AGENT_OBSERVATION_T observe, SENSOR_AGENT_ACTUATION_T act, \
-                       SENSOR_AGENT_ALARM_T alarm)
+                       SENSOR_AGENT_ALARM_T alarm, SENSOR_AGENT_START_T start,
+                       SENSOR_AGENT_READY_T ready)
 {
     bool_t initialization = DEF_TRUE;
 
@@ -135,11 +150,20 @@ bool_t SensorAgent_Init(SENSOR_AGENT_OBSERVATION_T observe, SENSOR_AGENT_ACTUATI
         SensorAgent_ActuateEnv = act;
     }
     SensorAgent_Alarm = alarm;
+    SensorAgent_StartEnv = start;
+    SensorAgent_ReadyEnv = ready;
 
     /* Initilize model      */
+    SensorCfg_ResetLearned();
     SensorAgent_Model.CurrentConfig = SENSOR_CFG_DEFAULT_CONFIG;
     SensorAgent_Model.PowerIncrement = SensorAgent_GetPower();
     SensorAgent_Model.Data = 0;
+    SA_PT_INIT(&SensorAgent_Model.ObservePt);
+
+    /* Prime the pipeline   */
+    if ((DEF_TRUE == initialization) && (NULL != SensorAgent_StartEnv)) {
+        SensorAgent_StartEnv();
+    }
 
     return initialization;
 }
@@ -211,6 +235,18 @@ static void SensorAgent_ManageActuation(SENSOR_AGENT_ACTS_T *p_acts)
     SensorAgent_SetConfig(p_acts->Config);
 }
 
+/**
+ * \brief  Starts the next acquisition when the agent runs pipelined.
+ *         The acquisition uses the configuration that was just applied.
+ *
+ */
+static void SensorAgent_StartAcquisition(void)
+{
+    if (NULL != SensorAgent_StartEnv) {
+        SensorAgent_StartEnv();
+    }
+}
+
 /************* Main ODA *********************/
 /**
  * \brief  Performs the ODA loop for the agent.
@@ -234,6 +270,7 @@ void SensorAgent_Oda(SENSOR_AGENT_INTERFACE_T *p_data)
     /* act              */
     SensorAgent_ManageActuation(&actuations);
     SensorAgent_ActuateEnv(&actuations);
+    SensorAgent_StartAcquisition();
 }
 
 /**
@@ -272,6 +309,28 @@ void SensorAgent_Act(SENSOR_AGENT_INTERFACE_T *p_data)
     /* act              */
     SensorAgent_ManageActuation(&actuations);
     SensorAgent_ActuateEnv(&actuations);
+    SensorAgent_StartAcquisition();
+}
+
+/**
+ * \brief  Runs the Observation task as a resumable function.
+ *         The task waits, without blocking, until the sensor is ready (warm-up finished or
+ *         conversion completed) and then runs the same as SensorAgent_Observe.
+ *
+ * \param  p_data: Pointer to the interface data of the agent.
+ *
+ * \return SA_PT_WAITING while the sensor is not ready, call again to resume; otherwise
+ *         SA_PT_DONE.
+ *
+ */
+SA_PT_STATUS_T SensorAgent_ObservePt(SENSOR_AGENT_INTERFACE_T *p_data)
+{
+    SA_PT_T *pt = &SensorAgent_Model.ObservePt;
+
+    SA_PT_BEGIN(pt);
+    SA_PT_WAIT_UNTIL(pt, (NULL == SensorAgent_ReadyEnv) || (DEF_TRUE == SensorAgent_ReadyEnv()));
+    SensorAgent_Observe(p_data);
+    SA_PT_END(pt);
 }
 
 
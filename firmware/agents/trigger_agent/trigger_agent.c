@@ -16,6 +16,7 @@
 
 #include "../../include/agents_main.h"
 #include "../../configs/trigger_cfg.h"
+#include "../../configs/tuning_cfg.h"
 #include "../../include/trigger_agent.h"
 
 /** \addtogroup Agents
@@ -40,6 +41,7 @@ typedef struct {
     uint8_t Config;
     uint32_t Periodicity;
     int8_t SamplingTarget;
+    uint16_t Generation;                /* Incremented when the periodicity changes */
 } TRIGGER_AGENT_MODEL_T;
 
 
@@ -67,6 +69,19 @@ uint32_t TriggerAgent_GetConfig(void)
     return TriggerAgent_Model.Periodicity;
 }
 
+/**
+ * \brief  Gets the change generation of the periodicity.
+ *         The generation changes every time the periodicity changes, so the users can cache
+ *         the values derived from it.
+ *
+ * \return Change generation of the periodicity.
+ *
+ */
+uint16_t TriggerAgent_GetGeneration(void)
+{
+    return TriggerAgent_Model.Generation;
+}
+
 /************* Utils  ***********************/
 /**
  * \brief  Updates the periodicity given a new configuration.
@@ -77,7 +92,10 @@ uint32_t TriggerAgent_GetConfig(void)
 static void TriggerAgent_UpdatePeriodicity(uint8_t cfg)
 {
     TriggerAgent_Model.Config = cfg;
-    TriggerAgent_Model.Periodicity = TriggerCfg_Periods_Ptr[cfg];
+    if (TriggerCfg_Periods_Ptr[cfg] != TriggerAgent_Model.Periodicity) {
+        TriggerAgent_Model.Periodicity = TriggerCfg_Periods_Ptr[cfg];
+        TriggerAgent_Model.Generation++;
+    }
 }
 
 /**
@@ -88,18 +106,46 @@ static void TriggerAgent_SetConfig(void)
 {
     if (0 != TriggerAgent_Model.SamplingTarget) {
         int16_t step;
-        step = SA_UTILS_ABS(TriggerAgent_Model.SamplingTarget) / TRIGGER_CFG_UPDATE_STEP;
+        step = SA_UTILS_ABS(TriggerAgent_Model.SamplingTarget) / TuningCfg_Params.UpdateStep;
         step++;
         step *= 0 <= TriggerAgent_Model.SamplingTarget ? -1 :  1;
         step += TriggerAgent_Model.Config;
-        step = SA_UTILS_SATURATE(TRIGGER_CFG_MAXIMUM_SAMPLING,
-                                 TRIGGER_CFG_MINIMUM_SAMPLING,
+        step = SA_UTILS_SATURATE((int16_t) TRIGGER_CFG_MAXIMUM_SAMPLING,
+                                 (int16_t) TRIGGER_CFG_MINIMUM_SAMPLING,
                                  step);
         TriggerAgent_UpdatePeriodicity((uint8_t)step);
         TriggerAgent_Model.SamplingTarget = 0;
     }
 }
 
+/************* Checkpoint *******************/
+/**
+ * \brief  Saves the learned state of the trigger.
+ *
+ * \param  p_checkpoint:  Pointer to where the state will be saved.
+ *
+ */
+void TriggerAgent_SaveCheckpoint(TRIGGER_AGENT_CHECKPOINT_T *p_checkpoint)
+{
+    p_checkpoint->Config = TriggerAgent_Model.Config;
+}
+
+/**
+ * \brief  Restores the learned state of the trigger, after TriggerAgent_Init.
+ *
+ * \param  p_checkpoint:  Pointer to the saved state.
+ *
+ * \note List of notes:
+ *       1. The index is saturated to the configured range, in case the checkpoint is from a
+ *          build with a different trigger config.
+ */
+void TriggerAgent_RestoreCheckpoint(const TRIGGER_AGENT_CHECKPOINT_T *p_checkpoint)
+{
+    TriggerAgent_UpdatePeriodicity(SA_UTILS_SATURATE(TRIGGER_CFG_MAXIMUM_SAMPLING,
+                                                     TRIGGER_CFG_MINIMUM_SAMPLING,
+                                                     p_checkpoint->Config));
+}
+
 /************* Initialization ***************/
 /**
  * \brief  Initializes the agent.
@@ -30,7 +30,17 @@
 #define APP_CFG_DEFAULT_RATE_LO          1.0   /* Lower threshold for the rate             */
 #define APP_CFG_RANGE_LOW                  0   /* Minimum value expected by the sensor     */
 #define APP_CFG_RANGE_HIGH               100   /* Maximum value expected by the sensor     */
-#define APP_CFG_DEVIATION               10.0
+#define APP_CFG_DEVIATION               10.0   /* Deviation from the average               */
+#define APP_CFG_AVERAGE_NUM               10u  /* Samples of the average of the data       */
+#define APP_CFG_AVERAGE_MAX               16u  /* Maximum samples of the average           */
+
+/* Cooperative sampling, see AppAgent_Overhear */
+#define APP_CFG_NEIGHBORS                  4u  /* Neighbors whose correlation is learned   */
+#define APP_CFG_NEIGHBOR_GAIN           0.05f  /* Gain of the averages of a neighbor       */
+#define APP_CFG_NEIGHBOR_PAIRS            16u  /* Pairs of samples to trust a correlation  */
+#define APP_CFG_COVER_CORRELATION        0.8f  /* Correlation of a covering neighbor       */
+#define APP_CFG_COVER_CHARGE            2.0f  /* Charge margin to cover the node, in %    */
+#define APP_CFG_COVER_RELEVANCE          -20   /* Relevance index of a covered node        */
 
 /************************************** Typedef **************************************************/
 
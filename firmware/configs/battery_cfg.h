@@ -13,6 +13,8 @@
 #define __BATTERY_CFG_H__
 
 #include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "battery_chem_cfg.h"
 
 /* The battery configuration should only be included from the power agent module        */
 #ifdef __POWER_AGENT_C__
@@ -33,11 +35,68 @@
 
 /************* Battery data *****************/
 #define POWER_AGENT_MAX_BATTERY_MA          5000.0f
-#define POWER_AGENT_EFFECTIVE_CHARGE           0.7f
+#define POWER_AGENT_EFFECTIVE_CHARGE           0.95f     /* Only the cut-off margin, rate and temperature
+                                                            losses are tracked by the SOC estimator     */
 
 /************* Coulomb Counter **************/
 #define POWER_AGENT_COULOMB_COUNTER_CONF      0.01f
 
+/************* Peukert effect ***************/
+/* The Peukert exponent depends on the chemistry, see battery_chem_cfg.h                                     */
+#define POWER_AGENT_PEUKERT_REF_CURRENT      250.0f      /* Current at which the capacity is rated (C/20) in mA  */
+
+/************* Temperature ******************/
+/* The capacity temperature coefficient depends on the chemistry, see battery_chem_cfg.h                     */
+#define POWER_AGENT_TEMP_REF                  25.0f      /* Temperature at which the capacity is rated in C      */
+#define POWER_AGENT_TEMP_CAPACITY_MIN          0.3f      /* Minimum relative capacity (cold cell)                */
+#define POWER_AGENT_TEMP_CAPACITY_MAX          1.1f      /* Maximum relative capacity (warm cell)                */
+
+/************* Open circuit voltage *********/
+/* OCV table, BatteryCfg_Ocv[band][point], with fixed steps in both SOC and temperature                      */
+#define BATTERY_CFG_OCV_POINTS                11u        /* SOC points, from 0% to 100%                          */
+#define BATTERY_CFG_OCV_BANDS                  4u        /* Temperature bands                                    */
+#define BATTERY_CFG_OCV_TEMP_MIN             -20.0f      /* Temperature of the first band in C                   */
+#define BATTERY_CFG_OCV_TEMP_STEP             20.0f      /* Temperature step between bands in C                  */
+
+/**
+ * \brief  Generates the OCV of one table entry from the curve at the reference temperature.
+ *         The OCV is shifted by the temperature coefficient and, below the reference
+ *         temperature, it sags more the lower the SOC.
+ *
+ * \param  soc:  SOC of the entry in %.
+ * \param  ocv:  OCV at the reference temperature in V.
+ * \param  t:    Temperature of the band in C.
+ */
+#define BATTERY_CFG_OCV_ENTRY(soc, ocv, t) \
+        ((ocv) + BATTERY_CFG_OCV_TEMP_COEF * ((t) - POWER_AGENT_TEMP_REF) - \
+         BATTERY_CFG_OCV_COLD_SAG * (POWER_AGENT_TEMP_REF > (t) ? POWER_AGENT_TEMP_REF - (t) : 0.0f) * \
+         (100 - (soc)) / 100.0f)
+
+/**
+ * \brief  Generates the OCV table row for a temperature band.
+ *
+ * \param  band:  Index of the band.
+ */
+#define BATTERY_CFG_OCV_ROW(band) \
+        { BATTERY_CFG_OCV_CURVE(BATTERY_CFG_OCV_ENTRY, \
+                                BATTERY_CFG_OCV_TEMP_MIN + (band) * BATTERY_CFG_OCV_TEMP_STEP) }
+
+/************* SOC estimator ****************/
+#define POWER_AGENT_SOC_INITIAL_COVARIANCE     0.01f     /* Initial SOC variance (10% standard deviation)        */
+#define POWER_AGENT_SOC_PROCESS_NOISE          1.0e-7f   /* Process noise added every activation                 */
+#define POWER_AGENT_VOLTAGE_NOISE              0.01f     /* Standard deviation of the voltage measurement in V   */
+#define POWER_AGENT_SOC_CYCLE_BUDGET         1500u       /* Cycle budget of the power agent per activation       */
+
+/************* Lifetime forecast ************/
+#define POWER_AGENT_EARLY_ALARM_ACTIVATIONS      5u      /* Alarm when the lower bound reaches this many acts    */
+#define POWER_AGENT_FORECAST_CONFIDENCE        2.0f      /* Standard deviations of the confidence bounds         */
+
+/************* Energy harvesting ************/
+#define POWER_AGENT_HARVEST_SLOTS               24u      /* Slots of the daily harvest profile                   */
+#define POWER_AGENT_HARVEST_SLOT_LENGTH      SA_UTILS_HOURS_TO_MILLI_S   /* Length of a slot in ms           */
+#define POWER_AGENT_HARVEST_GAIN               0.2f      /* Gain of the harvest profile, per day                 */
+#define POWER_AGENT_CHARGE_EFFICIENCY          0.9f      /* Fraction of the harvested charge that is stored      */
+
 /************* Node limits  *****************/
 #define POWER_AGENT_CHARGE_UPPER_RANGE      1000.0f      /* Upper range for the charge measurement               */
 #define POWER_AGENT_CHARGE_LOWER_RANGE         0.0f      /* Lower range for the charge measurement               */
@@ -50,6 +109,16 @@
 /************************************** Function prototypes **************************************/
 
 /************************************** Local Var ************************************************/
+BATTERY_DATA_EXT const float32_t BatteryCfg_Ocv[BATTERY_CFG_OCV_BANDS][BATTERY_CFG_OCV_POINTS]
+#ifdef __POWER_AGENT_C__
+= {
+    BATTERY_CFG_OCV_ROW(0),
+    BATTERY_CFG_OCV_ROW(1),
+    BATTERY_CFG_OCV_ROW(2),
+    BATTERY_CFG_OCV_ROW(3),
+}
+#endif
+;
 
 /************************************** Function prototypes **************************************/
 
@@ -0,0 +1,84 @@
+/**
+  * \file    battery_chem_cfg.h
+  *
+  * \brief   Header file with the battery chemistry profiles.
+  *          Each profile contains the open circuit voltage (OCV) curve at the reference
+  *          temperature and the parameters that depend on the chemistry. The profile is
+  *          selected at build time with BATTERY_CFG_CHEMISTRY, see battery_cfg.h.
+  *
+  * \author  David Arnaiz
+  *
+  */
+
+#ifndef __BATTERY_CHEM_CFG_H__
+#define __BATTERY_CHEM_CFG_H__
+
+/** \addtogroup Configs
+ *   @{
+ */
+
+/** \addtogroup BatteryConfig
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************* Chemistries ******************/
+#define BATTERY_CFG_CHEM_LISOCL2            0u      /* Lithium thionyl chloride, bobbin cell    */
+#define BATTERY_CFG_CHEM_LIFEPO4            1u      /* Lithium iron phosphate                   */
+#define BATTERY_CFG_CHEM_ALKALINE           2u      /* Two alkaline cells in series             */
+
+#ifndef BATTERY_CFG_CHEMISTRY
+#define BATTERY_CFG_CHEMISTRY               BATTERY_CFG_CHEM_LISOCL2
+#endif
+
+/************* Profiles *********************/
+/*
+ * BATTERY_CFG_OCV_CURVE(X, t) lists the OCV at the reference temperature, in V, for the SOC
+ * points 0%, 10%, ... 100%. X(soc, ocv, t) generates the table entry for temperature t.
+ */
+#if (BATTERY_CFG_CHEMISTRY == BATTERY_CFG_CHEM_LISOCL2)
+
+#define POWER_AGENT_PEUKERT_EXPONENT           1.20f     /* Peukert exponent of the cell                         */
+#define POWER_AGENT_TEMP_CAPACITY_COEF         0.004f    /* Relative capacity change per C                       */
+#define BATTERY_CFG_OCV_TEMP_COEF              0.0004f   /* OCV change per C in V                                */
+#define BATTERY_CFG_OCV_COLD_SAG               0.002f    /* OCV drop per C below the reference at 0% SOC in V    */
+#define BATTERY_CFG_OCV_CURVE(X, t) \
+    X(  0, 3.00f, t), X( 10, 3.40f, t), X( 20, 3.55f, t), X( 30, 3.60f, t), X( 40, 3.62f, t), \
+    X( 50, 3.63f, t), X( 60, 3.64f, t), X( 70, 3.65f, t), X( 80, 3.66f, t), X( 90, 3.67f, t), \
+    X(100, 3.68f, t)
+
+#elif (BATTERY_CFG_CHEMISTRY == BATTERY_CFG_CHEM_LIFEPO4)
+
+#define POWER_AGENT_PEUKERT_EXPONENT           1.03f
+#define POWER_AGENT_TEMP_CAPACITY_COEF         0.006f
+#define BATTERY_CFG_OCV_TEMP_COEF              0.0003f
+#define BATTERY_CFG_OCV_COLD_SAG               0.003f
+#define BATTERY_CFG_OCV_CURVE(X, t) \
+    X(  0, 2.50f, t), X( 10, 3.00f, t), X( 20, 3.20f, t), X( 30, 3.25f, t), X( 40, 3.27f, t), \
+    X( 50, 3.28f, t), X( 60, 3.29f, t), X( 70, 3.30f, t), X( 80, 3.32f, t), X( 90, 3.34f, t), \
+    X(100, 3.40f, t)
+
+#elif (BATTERY_CFG_CHEMISTRY == BATTERY_CFG_CHEM_ALKALINE)
+
+#define POWER_AGENT_PEUKERT_EXPONENT           1.30f
+#define POWER_AGENT_TEMP_CAPACITY_COEF         0.010f
+#define BATTERY_CFG_OCV_TEMP_COEF              0.0010f
+#define BATTERY_CFG_OCV_COLD_SAG               0.004f
+#define BATTERY_CFG_OCV_CURVE(X, t) \
+    X(  0, 2.00f, t), X( 10, 2.30f, t), X( 20, 2.40f, t), X( 30, 2.46f, t), X( 40, 2.52f, t), \
+    X( 50, 2.58f, t), X( 60, 2.64f, t), X( 70, 2.72f, t), X( 80, 2.82f, t), X( 90, 2.94f, t), \
+    X(100, 3.10f, t)
+
+#else
+#error "Unknown battery chemistry, check BATTERY_CFG_CHEMISTRY"
+#endif
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/** @} (end addtogroup BatteryConfig)   */
+/** @} (end addtogroup Configs)         */
+
+#endif /* __BATTERY_CHEM_CFG_H__       */
@@ -32,10 +32,25 @@
 /************************************** Function prototypes **************************************/
 
 /************************************** Local Var ************************************************/
-CONFIG_POWER_T MoteCfg_BasePower = {10.0, 10.0};
-CONFIG_POWER_T MoteCfg_IdlePower = {0.0,  0.1};
+/* Datasheet values, const so they stay in Flash        */
+static const CONFIG_POWER_T MoteCfg_BaseDatasheet = {10.0, 10.0};
+static const CONFIG_POWER_T MoteCfg_IdleDatasheet = {0.0,  0.1};
+
+/* Learned values, RAM      */
+CONFIG_POWER_T MoteCfg_BasePower;
+CONFIG_POWER_T MoteCfg_IdlePower;
 
 /************************************** Function implementation **********************************/
 
+/**
+ * \brief  Resets the learned base and idle power to the datasheet values.
+ *
+ */
+void MoteCfg_ResetLearned(void)
+{
+    MoteCfg_BasePower = MoteCfg_BaseDatasheet;
+    MoteCfg_IdlePower = MoteCfg_IdleDatasheet;
+}
+
 /** @} (end addtogroup MoteConfig)      */
 /** @} (end addtogroup Configs)         */
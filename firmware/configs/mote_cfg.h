@@ -27,8 +27,25 @@
  */
 
 /************************************** Defines **************************************************/
-#define MOTE_CFG_EXPECTED_BATTERY_LIFE      100 * SA_UTILS_DAYS_TO_HOURS * SA_UTILS_HOURS_TO_MINS * \
-                                            SA_UTILS_MINS_TO_S;
+#define MOTE_CFG_EXPECTED_BATTERY_LIFE      (100 * SA_UTILS_DAYS_TO_HOURS * SA_UTILS_HOURS_TO_MINS * \
+                                             SA_UTILS_MINS_TO_S)
+#define MOTE_CFG_ENERGY_NEUTRAL             DEF_FALSE   /* Target zero net drain, for harvesting nodes  */
+
+/************* Power loop *******************/
+#define MOTE_CFG_FEEDBACK_TOLERANCE         0.01f   /* Power feedback not learned, of the predicted charge */
+
+/************* Energy planner ***************/
+#define MOTE_CFG_PLANNER_SLOTS              24u     /* Budget slots per day                             */
+#define MOTE_CFG_PLANNER_SLOT_LENGTH        SA_UTILS_HOURS_TO_MILLI_S   /* Length of a slot in ms   */
+#define MOTE_CFG_PLANNER_PROFILE_GAIN       0.2f    /* Gain of the learned activity profile             */
+#define MOTE_CFG_PLANNER_ACTIVITY_FLOOR     0.1f    /* Minimum weight, so quiet slots still get budget  */
+#define MOTE_CFG_PLANNER_ACTIVITY_RATE      0.1f    /* Data change rate considered full activity        */
+#define MOTE_CFG_PLANNER_MIN_DATA           1.0f    /* Min data value used when computing the rate      */
+
+/************* Checkpoint *******************/
+#define MOTE_CFG_CHECKPOINT_PERIOD          96u     /* Loops between checkpoints of the models          */
+#define MOTE_CFG_CHECKPOINT_FIRST_SECTOR    0u      /* First NVM sector of the checkpoint ring          */
+#define MOTE_CFG_CHECKPOINT_SECTORS         4u      /* NVM sectors of the checkpoint ring, at least 2   */
 
 /************************************** Typedef **************************************************/
 
@@ -37,6 +54,7 @@ extern CONFIG_POWER_T MoteCfg_BasePower;
 extern CONFIG_POWER_T MoteCfg_IdlePower;
 
 /************************************** Function prototypes **************************************/
+void MoteCfg_ResetLearned(void);
 
 /** @} (end addtogroup MoteConfig)      */
 /** @} (end addtogroup Configs)         */
@@ -33,19 +33,38 @@
 
 /************************************** Local Var ************************************************/
 
-/* TODO store this function in Flash not in RAM     */
-
 /* Radio config array      */
 /* The power consumption is per message transmitted     */
-CONFIG_CONFIGURATION_T RadioCfg_Configs[RADIO_CFG_CONFIGS_SIZE] = {
+/* Datasheet values, const so they stay in Flash        */
+static const CONFIG_CONFIGURATION_T RadioCfg_Configs[RADIO_CFG_CONFIGS_SIZE] = {
     {RADIO_CFG_LOW_POWER_MODE,  { 50, 0.1},    0},
     {RADIO_CFG_STANDARD_MODE,   {100, 0.1},    0},
     {RADIO_CFG_HIGH_POWER_MODE, {150, 0.1},    0},
 };
-CONFIG_CONFIGURATION_T *RadioCfg_Configs_Ptr = RadioCfg_Configs;
+const CONFIG_CONFIGURATION_T * const RadioCfg_Configs_Ptr = RadioCfg_Configs;
+
+/* Output power of each config in dBm, indexed by the config id     */
+static const int8_t RadioCfg_TxPower[RADIO_CFG_CONFIGS_SIZE] = {-10, 0, 10};
+const int8_t * const RadioCfg_TxPower_Ptr = RadioCfg_TxPower;
+
+/* Learned power of each config, RAM overlay indexed by the config id   */
+static CONFIG_POWER_T RadioCfg_Learned[RADIO_CFG_CONFIGS_SIZE];
+CONFIG_POWER_T * const RadioCfg_Learned_Ptr = RadioCfg_Learned;
 
 /************************************** Function implementation **********************************/
 
+/**
+ * \brief  Resets the learned power of every config to the datasheet values.
+ *
+ */
+void RadioCfg_ResetLearned(void)
+{
+    uint8_t config;
+
+    for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+        RadioCfg_Learned[config] = RadioCfg_Configs[config].PowerCost;
+    }
+}
 
 
 /** @} (end addtogroup RadioConfig)   */
@@ -27,6 +27,27 @@
 /************************************** Defines **************************************************/
 #define RADIO_CFG_IDLE_POWER        0.01
 #define RADIO_CFG_DEFAULT_CONFIG    RADIO_CFG_STANDARD_MODE
+#define RADIO_CFG_MAX_BATCH         8u      /* Maximum number of samples per transmission   */
+#define RADIO_CFG_FORWARDING_GAIN   0.1f    /* Gain of the average of the relayed frames    */
+
+/* Sample store, kept while the link is down or the radio is idled */
+#define RADIO_CFG_STORE_FIRST_SECTOR    4u      /* First NVM sector, after the checkpoints      */
+#define RADIO_CFG_STORE_SECTORS         8u      /* NVM sectors of the store, at least 2         */
+#define RADIO_CFG_DRAIN_BATCH           32u     /* Maximum number of samples per drain          */
+#define RADIO_CFG_DRAIN_POWER_INDEX     0       /* Minimum power index to drain the store       */
+#define RADIO_CFG_IDLE_POWER_INDEX      (-50)   /* Power index below which the radio is idled   */
+
+/* Link quality, see RadioAgent_SelectMode */
+#define RADIO_CFG_RSSI_UNKNOWN          (-128)  /* RSSI not observed                            */
+#define RADIO_CFG_SENSITIVITY           (-90)   /* RSSI in dBm with half of the attempts lost   */
+#define RADIO_CFG_LINK_SLOPE            2.0f    /* dB of margin per unit of the logistic model  */
+#define RADIO_CFG_DELIVERY_PRIOR        0.5f    /* Delivery probability before any feedback     */
+#define RADIO_CFG_DELIVERY_MIN          0.01f   /* Minimum delivery probability of a mode       */
+#define RADIO_CFG_DELIVERY_GAIN         0.1f    /* Gain of the delivery probability averages    */
+#define RADIO_CFG_MODE_HYSTERESIS       0.1f    /* Relative saving to change the mode           */
+#define RADIO_CFG_FRAME_HEADER          12u     /* Bytes of a frame besides the samples         */
+#define RADIO_CFG_MAX_ATTEMPTS          4u      /* Attempts of a transmission, the retries + 1  */
+#define RADIO_CFG_BACKOFF_SHARE         0.2f    /* Charge of a backoff, of an attempt           */
 
 /************************************** Typedef **************************************************/
 
@@ -40,9 +61,12 @@ typedef enum {
 
 /************************************** Var ******************************************************/
 
-extern CONFIG_CONFIGURATION_T *RadioCfg_Configs_Ptr;
+extern const CONFIG_CONFIGURATION_T * const RadioCfg_Configs_Ptr;     /* Datasheet, Flash     */
+extern CONFIG_POWER_T * const RadioCfg_Learned_Ptr;                      /* Learned power, RAM   */
+extern const int8_t * const RadioCfg_TxPower_Ptr;                        /* Output power, dBm    */
 
 /************************************** Function prototypes **************************************/
+void RadioCfg_ResetLearned(void);
 
 /** @} (end addtogroup RadioConfigs)    */
 /** @} (end addtogroup Configs)         */
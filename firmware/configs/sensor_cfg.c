@@ -33,18 +33,33 @@
 
 /************************************** Local Var ************************************************/
 
-/* TODO store this function in Flash not in RAM     */
-
 /* Sensor config array      */
-CONFIG_CONFIGURATION_T SensorCfg_Configs[SENSOR_CFG_CONFIGS_SIZE] = {
+/* Datasheet values, const so they stay in Flash        */
+static const CONFIG_CONFIGURATION_T SensorCfg_Configs[SENSOR_CFG_CONFIGS_SIZE] = {
     {SENSOR_CFG_LOW_POWER_MODE,  { 5, 0.1},    5},
     {SENSOR_CFG_STANDARD_MODE,   {10, 0.1},   10},
     {SENSOR_CFG_HIGH_POWER_MODE, {15, 0.1},   15},
 };
-CONFIG_CONFIGURATION_T *SensorCfg_Configs_Ptr = SensorCfg_Configs;
+const CONFIG_CONFIGURATION_T * const SensorCfg_Configs_Ptr = SensorCfg_Configs;
+
+/* Learned power of each config, RAM overlay indexed by the config id   */
+static CONFIG_POWER_T SensorCfg_Learned[SENSOR_CFG_CONFIGS_SIZE];
+CONFIG_POWER_T * const SensorCfg_Learned_Ptr = SensorCfg_Learned;
 
 /************************************** Function implementation **********************************/
 
+/**
+ * \brief  Resets the learned power of every config to the datasheet values.
+ *
+ */
+void SensorCfg_ResetLearned(void)
+{
+    uint8_t config;
+
+    for (config = 0; config < SENSOR_CFG_CONFIGS_SIZE; config++) {
+        SensorCfg_Learned[config] = SensorCfg_Configs[config].PowerCost;
+    }
+}
 
 
 /** @} (end addtogroup SensorConfig)   */
@@ -42,9 +42,11 @@ typedef enum {
 
 /************************************** Var ******************************************************/
 
-extern CONFIG_CONFIGURATION_T *SensorCfg_Configs_Ptr;
+extern const CONFIG_CONFIGURATION_T * const SensorCfg_Configs_Ptr;     /* Datasheet, Flash     */
+extern CONFIG_POWER_T * const SensorCfg_Learned_Ptr;                      /* Learned power, RAM   */
 
 /************************************** Function prototypes **************************************/
+void SensorCfg_ResetLearned(void);
 
 /** @} (end addtogroup Configs)       */
 /** @} (end addtogroup SensorConfig)  */
@@ -0,0 +1,47 @@
+/**
+ * \file    supervisory_cfg.h
+ *
+ * \brief   Header file with the supervisory agent parameters.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SUPERVISORY_CFG_H__
+#define __SUPERVISORY_CFG_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Configs
+ *   @{
+ */
+/** \addtogroup SupervisoryConfig
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************* Loop deadline ****************/
+#define SUPERVISORY_CFG_LOOP_DEADLINE       2000000u    /* Deadline of a loop in cycles                 */
+#define SUPERVISORY_CFG_OVERRUN_LIMIT             3u    /* Consecutive overruns to degrade the mode     */
+
+/************* Alarms ***********************/
+#define SUPERVISORY_CFG_ALARM_REPEATS             3u    /* Repeated alarms of an agent to degrade       */
+
+/************* Recovery *********************/
+#define SUPERVISORY_CFG_RECOVERY_LOOPS            8u    /* Clean loops to go back one mode              */
+
+/************* Degraded modes ***************/
+#define SUPERVISORY_CFG_REDUCED_TARGET          -50     /* Maximum relevance target, reduced sampling   */
+#define SUPERVISORY_CFG_RADIO_BATCH               8u    /* Activations per transmission when batching   */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Var ******************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/** @} (end addtogroup SupervisoryConfig)   */
+/** @} (end addtogroup Configs)             */
+
+#endif /* __SUPERVISORY_CFG_H__       */
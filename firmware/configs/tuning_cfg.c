@@ -0,0 +1,87 @@
+/**
+ * \file    tuning_cfg.c
+ *
+ * \brief   Tuning parameters of the policy.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: TuningCfg_
+ *
+ */
+
+#include "../platform/sa_types.h"
+
+#include "config.h"
+#include "tuning_cfg.h"
+
+/** \addtogroup Configs
+ *   @{
+ */
+/** \addtogroup TuningConfig
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+/* Defaults, const so they stay in Flash    */
+static const TUNING_CFG_PARAMS_T TuningCfg_Defaults = {
+    .PowerLoopGain = TUNING_CFG_POWER_LOOP_GAIN,
+    .UpdateStep = TRIGGER_CFG_UPDATE_STEP,
+    .MaximumRate = APP_CFG_MAXIMUM_RATE,
+    .Deviation = APP_CFG_DEVIATION,
+    .AverageNum = APP_CFG_AVERAGE_NUM,
+};
+
+/* Parameters in use, RAM   */
+TUNING_CFG_PARAMS_T TuningCfg_Params = {
+    .PowerLoopGain = TUNING_CFG_POWER_LOOP_GAIN,
+    .UpdateStep = TRIGGER_CFG_UPDATE_STEP,
+    .MaximumRate = APP_CFG_MAXIMUM_RATE,
+    .Deviation = APP_CFG_DEVIATION,
+    .AverageNum = APP_CFG_AVERAGE_NUM,
+};
+
+/************************************** Function implementation **********************************/
+
+/**
+ * \brief  Resets the parameters to the defaults.
+ *
+ */
+void TuningCfg_Reset(void)
+{
+    TuningCfg_Params = TuningCfg_Defaults;
+}
+
+/**
+ * \brief  Sets the parameters.
+ *
+ * \param  p_params:  Pointer to the new parameters.
+ *
+ * \return DEF_OK if the parameters are in range and were set; otherwise DEF_FAIL and the
+ *         parameters in use are kept.
+ *
+ * \note List of notes:
+ *       1. The average length is applied by AppAgent_Init, which resets the average.
+ */
+bool_t TuningCfg_Set(const TUNING_CFG_PARAMS_T *p_params)
+{
+    if ((0.0f >= p_params->PowerLoopGain) || (TUNING_CFG_MAX_POWER_LOOP_GAIN < p_params->PowerLoopGain) ||
+        (0u == p_params->UpdateStep) || (TUNING_CFG_MAX_UPDATE_STEP < p_params->UpdateStep) ||
+        (0.0f >= p_params->MaximumRate) || (0.0f >= p_params->Deviation) ||
+        (0u == p_params->AverageNum) || (TUNING_CFG_MAX_AVERAGE_NUM < p_params->AverageNum)) {
+        return DEF_FAIL;
+    }
+    TuningCfg_Params = *p_params;
+
+    return DEF_OK;
+}
+
+/** @} (end addtogroup TuningConfig)    */
+/** @} (end addtogroup Configs)         */
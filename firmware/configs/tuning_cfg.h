@@ -0,0 +1,60 @@
+/**
+ * \file    tuning_cfg.h
+ *
+ * \brief   Header file with the tuning parameters of the policy.
+ *          The control constants of the decision engine, the trigger and the application agent
+ *          are kept in a parameter block in RAM, so they can be tuned at run time, e.g. by a
+ *          parameter sweep of the simulator, without a rebuild. The defines are the defaults.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __TUNING_CFG_H__
+#define __TUNING_CFG_H__
+
+#include "../platform/sa_types.h"
+
+#include "config.h"
+#include "trigger_cfg.h"
+#include "app_cfg.h"
+
+/** \addtogroup Configs
+ *   @{
+ */
+/** \addtogroup TuningConfig
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define TUNING_CFG_POWER_LOOP_GAIN      1.0f    /* Correction of the gain of the power predictions  */
+
+/* Limits of the parameters     */
+#define TUNING_CFG_MAX_POWER_LOOP_GAIN  1.0f
+#define TUNING_CFG_MAX_UPDATE_STEP      100u    /* Range of the relevance index                     */
+#define TUNING_CFG_MAX_AVERAGE_NUM      APP_CFG_AVERAGE_MAX
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Tuning parameters of the policy.
+ *
+ */
+typedef struct {
+    float32_t PowerLoopGain;            /* Correction of the gain of the power predictions  */
+    uint8_t UpdateStep;                 /* Relevance target per step of the periodicity     */
+    float32_t MaximumRate;              /* Rate of change of the data still consistent      */
+    float32_t Deviation;                /* Deviation from the average still cross-valid     */
+    uint16_t AverageNum;                /* Samples of the average of the data               */
+} TUNING_CFG_PARAMS_T;
+
+/************************************** Var ******************************************************/
+extern TUNING_CFG_PARAMS_T TuningCfg_Params;
+
+/************************************** Function prototypes **************************************/
+void TuningCfg_Reset(void);
+bool_t TuningCfg_Set(const TUNING_CFG_PARAMS_T *p_params);
+
+/** @} (end addtogroup TuningConfig)    */
+/** @} (end addtogroup Configs)         */
+
+#endif /* __TUNING_CFG_H__       */
@@ -0,0 +1,344 @@
+/**
+ * \file    checkpoint.c
+ *
+ * \brief   Checkpoints of the learned models in NVM, for the warm restart of the mote.
+ *          The checkpoints are records in a ring of NVM sectors. Every checkpoint is written to
+ *          the slot after the previous one, and a sector is only erased when the ring gets back
+ *          to it, so the erases are spread evenly over the sectors (wear leveling) and the
+ *          previous checkpoints are kept until then.
+ *          Every record has a header with the version of the layout, a sequence number and a
+ *          CRC. After a reset the latest valid record is restored, so a record corrupted by a
+ *          power loss while it was written falls back to the previous one.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: Checkpoint_
+ *
+ */
+
+#include <string.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../platform/sa_nvm.h"
+
+#include "../configs/config.h"
+#include "../configs/mote_cfg.h"
+#include "../configs/radio_cfg.h"
+#include "../configs/sensor_cfg.h"
+
+#include "../include/power_agent.h"
+#include "../include/trigger_agent.h"
+#include "../include/radio_agent.h"
+#include "../include/energy_planner.h"
+#include "../include/checkpoint.h"
+
+/** \addtogroup DecisionEngine
+ *   @{
+ */
+/** \addtogroup Checkpoint
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define CHECKPOINT_MAGIC            0xC4E5u     /* Marks a written record                   */
+#define CHECKPOINT_ERASED_MAGIC     0xFFFFu     /* Magic of a free slot                     */
+#define CHECKPOINT_CHUNK            32u         /* Bytes read per NVM access                */
+
+/* Layout of the ring, every slot holds a record and is aligned to 4 bytes   */
+#define CHECKPOINT_SLOT_SIZE        ((sizeof(CHECKPOINT_HEADER_T) + sizeof(CHECKPOINT_DATA_T) + 3u) & ~3u)
+#define CHECKPOINT_SLOTS_PER_SECTOR (SA_NVM_SECTOR_SIZE / CHECKPOINT_SLOT_SIZE)
+#define CHECKPOINT_SLOTS            (CHECKPOINT_SLOTS_PER_SECTOR * MOTE_CFG_CHECKPOINT_SECTORS)
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Header of a record, written after the data so a record is only valid when complete.
+ *
+ */
+typedef struct {
+    uint16_t Magic;                     /* CHECKPOINT_MAGIC, erased if the slot is free */
+    uint16_t Version;                   /* CHECKPOINT_VERSION                           */
+    uint32_t Sequence;                  /* Incremented on every checkpoint              */
+    uint16_t Size;                      /* Size of the data                             */
+    uint16_t Crc;                       /* CRC of the version, sequence, size and data  */
+} CHECKPOINT_HEADER_T;
+
+/* The ring needs at least one record per sector, and two sectors so the latest record is
+ * never erased                                                                          */
+typedef char CHECKPOINT_SLOT_FITS_SECTOR[(CHECKPOINT_SLOT_SIZE <= SA_NVM_SECTOR_SIZE) ? 1 : -1];
+typedef char CHECKPOINT_RING_SECTORS[(2u <= MOTE_CFG_CHECKPOINT_SECTORS) ? 1 : -1];
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static CHECKPOINT_STATUS_T Checkpoint_Status;
+static uint16_t Checkpoint_Slot;                /* Slot of the last checkpoint              */
+
+/************************************** Function implementation **********************************/
+
+/************* Layout ***********************/
+/**
+ * \brief  NVM address of a slot.
+ *
+ * \param  slot:  Slot of the ring.
+ *
+ * \return Address of the slot.
+ *
+ */
+static uint32_t Checkpoint_Address(uint16_t slot)
+{
+    return SA_NVM_SECTOR_ADDRESS(MOTE_CFG_CHECKPOINT_FIRST_SECTOR +
+                                 slot / CHECKPOINT_SLOTS_PER_SECTOR) +
+           (slot % CHECKPOINT_SLOTS_PER_SECTOR) * CHECKPOINT_SLOT_SIZE;
+}
+
+/**
+ * \brief  CRC of a record.
+ *
+ * \param  p_header:  Pointer to the header.
+ * \param  address:   NVM address of the data, or 0 if p_data is used.
+ * \param  p_data:    Pointer to the data in RAM, or NULL if it is read from the NVM.
+ *
+ * \return CRC of the version, sequence, size and data.
+ *
+ */
+static uint16_t Checkpoint_Crc(const CHECKPOINT_HEADER_T *p_header, uint32_t address,
+                               const CHECKPOINT_DATA_T *p_data)
+{
+    uint8_t chunk[CHECKPOINT_CHUNK];
+    uint32_t offset, length;
+    uint16_t crc;
+
+    crc = SaUtils_Crc16(&p_header->Version, sizeof(p_header->Version), SA_UTILS_CRC16_INIT);
+    crc = SaUtils_Crc16(&p_header->Sequence, sizeof(p_header->Sequence), crc);
+    crc = SaUtils_Crc16(&p_header->Size, sizeof(p_header->Size), crc);
+
+    if (NULL != p_data) return SaUtils_Crc16(p_data, sizeof(CHECKPOINT_DATA_T), crc);
+
+    for (offset = 0; offset < sizeof(CHECKPOINT_DATA_T); offset += length) {
+        length = SA_UTILS_MIN(CHECKPOINT_CHUNK, sizeof(CHECKPOINT_DATA_T) - offset);
+        if (DEF_FAIL == SaNvm_Read(address + offset, chunk, length)) return (uint16_t) ~p_header->Crc;
+        crc = SaUtils_Crc16(chunk, length, crc);
+    }
+    return crc;
+}
+
+/**
+ * \brief  Checks the record of a slot.
+ *
+ * \param  slot:      Slot of the ring.
+ * \param  p_header:  Pointer to where the header will be saved.
+ *
+ * \return DEF_TRUE if the slot holds a complete record of this version; otherwise DEF_FALSE.
+ *
+ */
+static bool_t Checkpoint_Valid(uint16_t slot, CHECKPOINT_HEADER_T *p_header)
+{
+    uint32_t address = Checkpoint_Address(slot);
+
+    if (DEF_FAIL == SaNvm_Read(address, p_header, sizeof(CHECKPOINT_HEADER_T))) {
+        p_header->Magic = CHECKPOINT_ERASED_MAGIC;
+        return DEF_FALSE;
+    }
+
+    return ((CHECKPOINT_MAGIC == p_header->Magic) &&
+            (CHECKPOINT_VERSION == p_header->Version) &&
+            (sizeof(CHECKPOINT_DATA_T) == p_header->Size) &&
+            (p_header->Crc == Checkpoint_Crc(p_header, address + sizeof(CHECKPOINT_HEADER_T),
+                                             NULL))) ? DEF_TRUE : DEF_FALSE;
+}
+
+/**
+ * \brief  Checks that a slot is erased, so it can be written.
+ *
+ * \param  slot:  Slot of the ring.
+ *
+ * \return DEF_TRUE if every byte of the slot is erased; otherwise DEF_FALSE.
+ *
+ */
+static bool_t Checkpoint_Blank(uint16_t slot)
+{
+    uint8_t chunk[CHECKPOINT_CHUNK];
+    uint32_t address = Checkpoint_Address(slot);
+    uint32_t offset, length, i;
+
+    for (offset = 0; offset < CHECKPOINT_SLOT_SIZE; offset += length) {
+        length = SA_UTILS_MIN(CHECKPOINT_CHUNK, CHECKPOINT_SLOT_SIZE - offset);
+        if (DEF_FAIL == SaNvm_Read(address + offset, chunk, length)) return DEF_FALSE;
+        for (i = 0; i < length; i++) {
+            if (SA_NVM_ERASED != chunk[i]) return DEF_FALSE;
+        }
+    }
+    return DEF_TRUE;
+}
+
+/**
+ * \brief  Gets the slot for the next checkpoint, erasing its sector when the ring gets to it.
+ *
+ * \param  p_slot:  Pointer to where the slot will be saved.
+ *
+ * \return DEF_OK if the slot is ready to be written; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. A slot which is not blank, after a write interrupted by a reset, is skipped
+ *          together with the rest of its sector, since it can not be written again without
+ *          an erase.
+ */
+static bool_t Checkpoint_NextSlot(uint16_t *p_slot)
+{
+    uint16_t slot = 0;
+
+    if (0u != Checkpoint_Status.Sequence) {
+        slot = (uint16_t)((Checkpoint_Slot + 1u) % CHECKPOINT_SLOTS);
+    }
+    if ((0u != slot % CHECKPOINT_SLOTS_PER_SECTOR) && (DEF_FALSE == Checkpoint_Blank(slot))) {
+        slot = (uint16_t)(((slot / CHECKPOINT_SLOTS_PER_SECTOR + 1u) * CHECKPOINT_SLOTS_PER_SECTOR) %
+                          CHECKPOINT_SLOTS);
+    }
+    if (0u == slot % CHECKPOINT_SLOTS_PER_SECTOR) {
+        if (DEF_FAIL == SaNvm_EraseSector((uint16_t)(MOTE_CFG_CHECKPOINT_FIRST_SECTOR +
+                                                     slot / CHECKPOINT_SLOTS_PER_SECTOR))) {
+            return DEF_FAIL;
+        }
+    }
+    *p_slot = slot;
+
+    return DEF_OK;
+}
+
+/************* External *********************/
+/**
+ * \brief  Initializes the checkpoints, finding the latest valid record in the ring.
+ *
+ * \return DEF_OK if the NVM could be scanned; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The NVM must be initialized.
+ */
+bool_t Checkpoint_Init(void)
+{
+    CHECKPOINT_HEADER_T header;
+    uint16_t slot;
+
+    memset(&Checkpoint_Status, 0x00, sizeof(CHECKPOINT_STATUS_T));
+    Checkpoint_Slot = 0;
+
+    for (slot = 0; slot < CHECKPOINT_SLOTS; slot++) {
+        if (DEF_TRUE == Checkpoint_Valid(slot, &header)) {
+            if (header.Sequence > Checkpoint_Status.Sequence) {
+                Checkpoint_Status.Sequence = header.Sequence;
+                Checkpoint_Status.Address = Checkpoint_Address(slot);
+                Checkpoint_Slot = slot;
+            }
+        } else if (CHECKPOINT_ERASED_MAGIC != header.Magic) {
+            Checkpoint_Status.Discarded++;
+        }
+    }
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Restores the models from the latest checkpoint.
+ *
+ * \return DEF_OK if the models were restored; otherwise DEF_FAIL, and the models are kept.
+ *
+ * \note List of notes:
+ *       1. The agents must be initialized, the checkpoint overwrites their learned state.
+ *       2. The data is read in a local copy, so it only takes RAM during the restore.
+ */
+bool_t Checkpoint_Restore(void)
+{
+    CHECKPOINT_DATA_T data;
+    uint8_t config;
+
+    if ((0u == Checkpoint_Status.Sequence) ||
+        (DEF_FAIL == SaNvm_Read(Checkpoint_Status.Address + sizeof(CHECKPOINT_HEADER_T),
+                                &data, sizeof(CHECKPOINT_DATA_T)))) {
+        return DEF_FAIL;
+    }
+
+    PowerAgent_RestoreCheckpoint(&data.Power);
+    EnergyPlanner_RestoreCheckpoint(&data.Planner);
+    TriggerAgent_RestoreCheckpoint(&data.Trigger);
+    RadioAgent_RestoreCheckpoint(&data.Radio);
+    for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+        RadioCfg_Learned_Ptr[config] = data.RadioLearned[config];
+    }
+    for (config = 0; config < SENSOR_CFG_CONFIGS_SIZE; config++) {
+        SensorCfg_Learned_Ptr[config] = data.SensorLearned[config];
+    }
+    MoteCfg_BasePower = data.BasePower;
+    MoteCfg_IdlePower = data.IdlePower;
+    Checkpoint_Status.Restored = DEF_TRUE;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Saves a checkpoint of the models in the next slot of the ring.
+ *
+ * \return DEF_OK if the checkpoint was saved; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The data is written before the header, so a reset during the write leaves a record
+ *          without a valid header, which is discarded by the next scan.
+ */
+bool_t Checkpoint_Save(void)
+{
+    CHECKPOINT_DATA_T data;
+    CHECKPOINT_HEADER_T header;
+    uint32_t address;
+    uint16_t slot;
+    uint8_t config;
+
+    memset(&data, 0x00, sizeof(CHECKPOINT_DATA_T));     /* Deterministic padding for the CRC */
+    PowerAgent_SaveCheckpoint(&data.Power);
+    EnergyPlanner_SaveCheckpoint(&data.Planner);
+    TriggerAgent_SaveCheckpoint(&data.Trigger);
+    RadioAgent_SaveCheckpoint(&data.Radio);
+    for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+        data.RadioLearned[config] = RadioCfg_Learned_Ptr[config];
+    }
+    for (config = 0; config < SENSOR_CFG_CONFIGS_SIZE; config++) {
+        data.SensorLearned[config] = SensorCfg_Learned_Ptr[config];
+    }
+    data.BasePower = MoteCfg_BasePower;
+    data.IdlePower = MoteCfg_IdlePower;
+
+    header.Magic = CHECKPOINT_MAGIC;
+    header.Version = CHECKPOINT_VERSION;
+    header.Sequence = Checkpoint_Status.Sequence + 1u;
+    header.Size = sizeof(CHECKPOINT_DATA_T);
+    header.Crc = Checkpoint_Crc(&header, 0u, &data);
+
+    if (DEF_FAIL == Checkpoint_NextSlot(&slot)) return DEF_FAIL;
+    address = Checkpoint_Address(slot);
+    if ((DEF_FAIL == SaNvm_Write(address + sizeof(CHECKPOINT_HEADER_T), &data,
+                                 sizeof(CHECKPOINT_DATA_T))) ||
+        (DEF_FAIL == SaNvm_Write(address, &header, sizeof(CHECKPOINT_HEADER_T)))) {
+        return DEF_FAIL;
+    }
+
+    Checkpoint_Slot = slot;
+    Checkpoint_Status.Sequence = header.Sequence;
+    Checkpoint_Status.Address = address;
+    Checkpoint_Status.Saved++;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Gets the status of the checkpoints.
+ *
+ * \param  p_status:  Pointer to where the status will be saved.
+ *
+ */
+void Checkpoint_GetStatus(CHECKPOINT_STATUS_T *p_status)
+{
+    *p_status = Checkpoint_Status;
+}
+
+/** @} (end addtogroup Checkpoint)      */
+/** @} (end addtogroup DecisionEngine)  */
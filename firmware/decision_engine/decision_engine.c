@@ -12,11 +12,18 @@
  */
 
 #include <string.h>
+#include <math.h>
 #include "../platform/sa_types.h"
 #include "../platform/sa_utils.h"
+#include "../platform/sa_pt.h"
+#include "../platform/sa_nvm.h"
+#ifdef DECISION_ENGINE_WCET
+#include "../platform/sa_timing.h"
+#endif
 
 #include "../configs/config.h"
 #include "../configs/mote_cfg.h"
+#include "../configs/tuning_cfg.h"
 
 #include "../include/agents_main.h"
 #include "../include/power_agent.h"
@@ -25,6 +32,8 @@
 #include "../include/trigger_agent.h"
 #include "../include/app_agent.h"
 
+#include "../include/energy_planner.h"
+#include "../include/checkpoint.h"
 #include "../include/decision_engine.h"
 
 /** \addtogroup DecisionEngine
@@ -32,10 +41,26 @@
  */
 
 /************************************** Defines **************************************************/
-#define DECISION_ENGINE_POWER_LOOP_GAIN_CORRECTION  0.5f
 #define DECISION_ENGINE_POWER_LOOP_NUM_SOURCES      5u      /* Number of sources of noise in the power estimation   */
                                                             /* Sensor Agent, Radio Agent, Base power, Idle power,
                                                                Coulomb counter    */
+
+/**
+ * \brief  Runs a phase of the loop, measuring its cycles in WCET mode.
+ *
+ * \param  phase:  Phase of the loop, DECISION_ENGINE_PHASE_T.
+ * \param  call:   Code of the phase.
+ */
+#ifdef DECISION_ENGINE_WCET
+#define DECISION_ENGINE_MEASURE(phase, call)                                    \
+    do {                                                                        \
+        uint32_t wcet_start = SaTiming_GetCycles();                             \
+        call;                                                                   \
+        DecisionEng_RecordWcet((phase), SA_TIMING_ELAPSED(wcet_start));         \
+    } while (0)
+#else
+#define DECISION_ENGINE_MEASURE(phase, call)    call
+#endif
 /************************************** Typedef **************************************************/
 /**
  * \brief  Decision engine model.
@@ -45,8 +70,32 @@
 typedef struct {
     int8_t RelevanceIndex;
     int8_t PowerIndex;
+    int8_t BudgetIndex;                 /* Spending against the energy plan     */
+    float32_t PreviousData;             /* Data of the previous activation      */
+    uint32_t PreviousPeriod;            /* Period set at the previous activation*/
     uint32_t ExpectedLifetime;          /* Expected lifetime in s               */
     uint32_t ExpectedLifetimeActs;      /* Expected lifetime in activations     */
+    bool_t EnergyNeutral;               /* Target zero net drain over a day     */
+    int8_t MaxRelevanceTarget;          /* Limit of the relevance target        */
+    DECISION_ENGINE_POLICY_T Policy;    /* Sampling policy                      */
+    uint32_t AssignedPeriod;            /* Period assigned by the sink, 0 if not*/
+    uint8_t RadioBatch;                 /* Activations per radio transmission   */
+
+    /* Change generations of the cached values  */
+    uint16_t LifeGeneration;            /* Changes with the expected lifetime   */
+    uint16_t ActsLifeGeneration;        /* Used for ExpectedLifetimeActs        */
+    uint16_t ActsTriggerGeneration;     /* Used for ExpectedLifetimeActs        */
+    uint16_t PowerGeneration;           /* Changes with the power models        */
+    uint16_t ChargeGeneration;          /* Used for PredictedPower              */
+    CONFIG_POWER_T *AppPowerPtr;        /* Used for PredictedPower              */
+    CONFIG_POWER_T *RadioPowerPtr;      /* Used for PredictedPower              */
+    float32_t RadioPower;               /* Used for PredictedPower              */
+    float32_t Forwarding;               /* Used for PredictedPower              */
+    uint8_t RadioFrames;                /* Used for PredictedPower              */
+    DECISION_ENGINE_SKIPS_T Skips;
+    SA_PT_T LoopPt;                     /* Resume point of the resumable loop   */
+    bool_t Checkpoint;                  /* The models are saved in NVM          */
+    uint32_t CheckpointLoops;           /* Loops since the last checkpoint      */
 
     float32_t PredictedPower;
     float32_t PredictedIncrement;
@@ -60,6 +109,10 @@ typedef struct {
 /************************************** Local Var ************************************************/
 static DECISION_ENGINE_INTERFACES_T DecisionEng_Interfaces;
 static DECISION_ENGINE_MODEL_T DecisionEng_Model;
+#ifdef DECISION_ENGINE_WCET
+static DECISION_ENGINE_WCET_T DecisionEng_Wcet;
+static uint32_t DecisionEng_LoopCycles;         /* Cycles of the resumes of the current loop    */
+#endif
 
 
 /************************************** Function implementation **********************************/
@@ -96,6 +149,57 @@ void DecisionEng_GetFeedbackValues(float32_t *predicted_power, float32_t *predic
     *power_feedback = DecisionEng_Interfaces.PowerInterface.Outputs.PowerFeedbackPtr->Power;
 }
 
+#ifdef DECISION_ENGINE_WCET
+/************* WCET *************************/
+/**
+ * \brief  Clears the worst case execution times.
+ *
+ */
+void DecisionEng_ResetWcet(void)
+{
+    memset(&DecisionEng_Wcet, 0x00, sizeof(DECISION_ENGINE_WCET_T));
+    DecisionEng_LoopCycles = 0;
+    SaTiming_Init();
+}
+
+/**
+ * \brief  Gets the worst case execution times measured since the last reset.
+ *
+ * \param  p_wcet:  Pointer to where the times will be saved.
+ *
+ */
+void DecisionEng_GetWcet(DECISION_ENGINE_WCET_T *p_wcet)
+{
+    *p_wcet = DecisionEng_Wcet;
+}
+
+/**
+ * \brief  Records the cycles of a phase of the current loop.
+ *
+ * \param  phase:   Phase of the loop.
+ * \param  cycles:  Cycles spent in the phase.
+ *
+ */
+static void DecisionEng_RecordWcet(DECISION_ENGINE_PHASE_T phase, uint32_t cycles)
+{
+    if (DecisionEng_Wcet.Cycles[phase] < cycles) {
+        DecisionEng_Wcet.Cycles[phase] = cycles;
+        DecisionEng_Wcet.Loop[phase] = DecisionEng_Wcet.Loops;
+    }
+}
+#endif
+
+/**
+ * \brief  Gets the counters of the work skipped since the initialization.
+ *
+ * \param  p_skips:  Pointer to where the counters will be saved.
+ *
+ */
+void DecisionEng_GetSkips(DECISION_ENGINE_SKIPS_T *p_skips)
+{
+    *p_skips = DecisionEng_Model.Skips;
+}
+
 /************* Tools ************************/
 /**
  * \brief  Gets a pointer to the base power configuration.
@@ -135,16 +239,57 @@ float32_t DecisionEng_GetPower(void)
  *
  * \return Number of expected activations.
  *
+ * \note List of notes:
+ *       1. The value is only recomputed when the expected lifetime or the periodicity have
+ *          changed since the last call, tracked with their change generations.
  */
 static uint32_t DecisionEng_ExpectedActivations()
 {
-    uint32_t sampling = TriggerAgent_GetConfig();
+    DECISION_ENGINE_MODEL_T *p_model = &DecisionEng_Model;
+    uint16_t trigger_generation = TriggerAgent_GetGeneration();
+    uint32_t sampling;
     float32_t expected;
-    expected = DecisionEng_Model.ExpectedLifetime;
+
+    if ((p_model->ActsLifeGeneration == p_model->LifeGeneration) &&
+        (p_model->ActsTriggerGeneration == trigger_generation)) {
+        p_model->Skips.ActivationsSkipped++;
+        return p_model->ExpectedLifetimeActs;
+    }
+
+    sampling = TriggerAgent_GetConfig();
+    expected = p_model->ExpectedLifetime;
     expected /= sampling;
     expected *= SA_UTILS_S_TO_MILLI_S;
     expected = SA_UTILS_SATURATE(0, SA_UTILS_MAX_UINT32_T, expected);
-    return (uint32_t) expected;
+
+    p_model->ExpectedLifetimeActs = (uint32_t) expected;
+    p_model->ActsLifeGeneration = p_model->LifeGeneration;
+    p_model->ActsTriggerGeneration = trigger_generation;
+    return p_model->ExpectedLifetimeActs;
+}
+
+/**
+ * \brief  Updates the energy planner with the last activation.
+ *
+ * \note List of notes:
+ *       1. The activity of the signal is its rate of change, normalized so
+ *          MOTE_CFG_PLANNER_ACTIVITY_RATE is full activity.
+ *       2. The trigger agent has already set the period of the next activation, so the time
+ *          since the previous activation is the period set then.
+ */
+static void DecisionEng_UpdatePlanner(void)
+{
+    float32_t activity;
+    float32_t data = DecisionEng_Interfaces.AppInterface.Outputs.Data;
+
+    activity  = SaUtils_ChangeRate(data, DecisionEng_Model.PreviousData, MOTE_CFG_PLANNER_MIN_DATA);
+    activity /= MOTE_CFG_PLANNER_ACTIVITY_RATE;
+    DecisionEng_Model.PreviousData = data;
+
+    EnergyPlanner_Update(PowerAgent_GetPowerMeasurement(), activity, DecisionEng_Model.PreviousPeriod,
+                         PowerAgent_GetRemainingBatteryLife(), PowerAgent_GetDailyHarvest());
+    DecisionEng_Model.PreviousPeriod = TriggerAgent_GetConfig();
+    DecisionEng_Model.BudgetIndex = EnergyPlanner_GetBudgetIndex();
 }
 
 /************* Main *************************/
@@ -155,20 +300,34 @@ static uint32_t DecisionEng_ExpectedActivations()
  *
  * \return DEF_TRUE if the initialization is successfull; otherwise DEF_FALSE.
  *
+ * \note List of notes:
+ *       1. With p_init->Checkpoint the learned models are restored from the latest checkpoint
+ *          in NVM, if any, and saved periodically by the loop. If the NVM is not available the
+ *          module runs without checkpoints.
+ *       2. With p_init->RadioInit.Store the samples are stored in NVM while the radio can not
+ *          transmit them. If the NVM is not available the radio runs without the store.
  */
 bool_t DecisionEng_Init(DECISION_ENGINE_INIT_T *p_init)
 {
     bool_t initialization;
+    bool_t store = DEF_FALSE;
+
     initialization = PowerAgent_Init(p_init->PowerInit.Obs,
                                      p_init->PowerInit.Act,
                                      p_init->PowerInit.Alarm);
+    if (DEF_TRUE == p_init->RadioInit.Store) {
+        store = SaNvm_Init();
+    }
     if (DEF_TRUE == initialization) {
-        RadioAgent_Init(p_init->RadioInit.Obs, p_init->RadioInit.Act);
+        RadioAgent_Init(p_init->RadioInit.Obs, p_init->RadioInit.Act, p_init->RadioInit.Done,
+                        store);
     }
     if (DEF_TRUE == initialization) {
         AppAgent_Init(p_init->AppInit.Sensor.Obs,
                   p_init->AppInit.Sensor.Act,
                   p_init->AppInit.Sensor.Alarm,
+                  p_init->AppInit.Sensor.Start,
+                  p_init->AppInit.Sensor.Ready,
                   p_init->AppInit.Trigger.Obs,
                   p_init->AppInit.Trigger.Act,
                   p_init->AppInit.Trigger.Alarm,
@@ -176,13 +335,47 @@ bool_t DecisionEng_Init(DECISION_ENGINE_INIT_T *p_init)
     }
     memset(&DecisionEng_Interfaces, 0x00, sizeof(DECISION_ENGINE_INTERFACES_T));
     memset(&DecisionEng_Model, 0x00, sizeof(DECISION_ENGINE_MODEL_T));
+    MoteCfg_ResetLearned();
     DecisionEng_Model.BasePowerPtr = &MoteCfg_BasePower;
     DecisionEng_Model.IdlePowerPtr = &MoteCfg_IdlePower;
     DecisionEng_Model.ExpectedLifetime = MOTE_CFG_EXPECTED_BATTERY_LIFE;
+    DecisionEng_Model.LifeGeneration = 1u;      /* Invalidates the cached values    */
+    DecisionEng_Model.PowerGeneration = 1u;
+    EnergyPlanner_Init(DecisionEng_Model.ExpectedLifetime);
+    DecisionEng_SetEnergyNeutral(MOTE_CFG_ENERGY_NEUTRAL);
+    DecisionEng_SetSamplingLimit(AGENTS_INDEX_MAX_VALUE);
+    DecisionEng_SetPolicy(DECISION_ENGINE_POLICY_RELEVANCE);
+    DecisionEng_SetAssignedPeriod(0u);
+    DecisionEng_SetRadioBatch(1u);
+
+    /* Warm restart     */
+    if (DEF_TRUE == p_init->Checkpoint) {
+        if ((DEF_OK == SaNvm_Init()) && (DEF_OK == Checkpoint_Init())) {
+            DecisionEng_Model.Checkpoint = DEF_TRUE;
+            Checkpoint_Restore();
+            RadioAgent_Refresh();
+        }
+    }
 
     return initialization;
 }
 
+/**
+ * \brief  Saves a checkpoint of the learned models in NVM now, e.g. before a planned reset.
+ *
+ * \return DEF_OK if the checkpoint was saved; otherwise DEF_FAIL, also when the checkpoints
+ *         are not enabled.
+ *
+ */
+bool_t DecisionEng_SaveCheckpoint(void)
+{
+    if (DEF_FALSE == DecisionEng_Model.Checkpoint) return DEF_FAIL;
+
+    DecisionEng_Model.CheckpointLoops = 0;
+    RadioAgent_Sync();
+    return Checkpoint_Save();
+}
+
 /**
  * \brief  Set expected battery life.
  *
@@ -192,6 +385,82 @@ bool_t DecisionEng_Init(DECISION_ENGINE_INIT_T *p_init)
 void DecisionEng_SetExpectedLife(uint32_t expected_life)
 {
     DecisionEng_Model.ExpectedLifetime = expected_life;
+    DecisionEng_Model.LifeGeneration++;
+    EnergyPlanner_SetExpectedLife(expected_life);
+}
+
+/**
+ * \brief  Enables or disables the energy neutral mode.
+ *         In energy neutral mode the engine targets zero net drain over a day, using the
+ *         expected harvest, instead of the expected battery life.
+ *
+ * \param  enable:  DEF_TRUE to enable the energy neutral mode.
+ *
+ */
+void DecisionEng_SetEnergyNeutral(bool_t enable)
+{
+    DecisionEng_Model.EnergyNeutral = enable;
+    EnergyPlanner_SetEnergyNeutral(enable);
+}
+
+/**
+ * \brief  Limits the relevance target, which limits the sampling rate.
+ *
+ * \param  max_target:  Maximum relevance target. AGENTS_INDEX_MAX_VALUE removes the limit.
+ *
+ */
+void DecisionEng_SetSamplingLimit(int8_t max_target)
+{
+    DecisionEng_Model.MaxRelevanceTarget = max_target;
+}
+
+/**
+ * \brief  Sets the sampling policy, the inputs of the relevance target.
+ *
+ * \param  policy:  Sampling policy. DECISION_ENGINE_POLICY_RELEVANCE is the default; the others
+ *                  are the baselines that measure what the relevance index is worth.
+ *
+ */
+void DecisionEng_SetPolicy(DECISION_ENGINE_POLICY_T policy)
+{
+    DecisionEng_Model.Policy = policy;
+}
+
+/**
+ * \brief  Sets the sampling period assigned by the sink, which shares the energy of the
+ *         network between the nodes, see SinkCoord_Solve.
+ *
+ * \param  period:  Assigned period in ms, one of TriggerCfg_Periods. 0 removes the assignment.
+ *
+ */
+void DecisionEng_SetAssignedPeriod(uint32_t period)
+{
+    DecisionEng_Model.AssignedPeriod = period;
+}
+
+/**
+ * \brief  Sets the number of activations per radio transmission.
+ *
+ * \param  batch:  Activations per transmission, 1 transmits every activation.
+ *
+ */
+void DecisionEng_SetRadioBatch(uint8_t batch)
+{
+    DecisionEng_Model.RadioBatch = batch;
+}
+
+/**
+ * \brief  Discards the learned power of the mote, the sensor and the radio configs, going back
+ *         to the datasheet values.
+ *
+ */
+void DecisionEng_ResetToDatasheet(void)
+{
+    MoteCfg_ResetLearned();
+    SensorCfg_ResetLearned();
+    RadioCfg_ResetLearned();
+    RadioAgent_Refresh();
+    DecisionEng_Model.PowerGeneration++;
 }
 
 /************* Agents ***********************/
@@ -199,41 +468,121 @@ void DecisionEng_SetExpectedLife(uint32_t expected_life)
 /**
  * \brief  Sets the inputs for the Application agent.
  *
+ * \note List of notes:
+ *       1. The budget index raises the relevance target while the spending is below the plan
+ *          of the slot, and lowers it when the plan is overspent.
+ *       2. The target is limited by the sampling limit, see DecisionEng_SetSamplingLimit.
+ *       3. The budget policy ignores the relevance index, and the fixed policy keeps the
+ *          target at 0, so the trigger agent stays at its periodicity.
+ *       4. With a period assigned by the sink, the target steps the trigger agent towards it,
+ *          and the node only samples faster for a positive relevance index. The budget index
+ *          is left out, as the sink plans the energy of the network from the battery state
+ *          the nodes report.
+ *       5. The remaining charge is given to the application agent, which compares it with
+ *          the charge the neighbors send with their samples, see AppAgent_Overhear.
+ *       6. A negative relevance index, data covered by a neighbor, does not spend the surplus
+ *          of the budget, only its overspending is added.
  */
 void DecisionEng_SetAppInputs(void)
 {
-    DecisionEng_Interfaces.AppInterface.Inputs.RelevanceTarget = \
-        DecisionEng_Model.RelevanceIndex;
+    uint32_t period = TriggerAgent_GetConfig();
+    int16_t target;
+
+    if (DECISION_ENGINE_POLICY_FIXED == DecisionEng_Model.Policy) {
+        target = 0;
+    } else if (0u != DecisionEng_Model.AssignedPeriod) {
+        target  = (period > DecisionEng_Model.AssignedPeriod) ? 1 :
+                  (period < DecisionEng_Model.AssignedPeriod) ? -1 : 0;
+        target += SA_UTILS_MAX(DecisionEng_Model.RelevanceIndex, 0);
+    } else if (DECISION_ENGINE_POLICY_BUDGET == DecisionEng_Model.Policy) {
+        target = DecisionEng_Model.BudgetIndex;
+    } else if (0 > DecisionEng_Model.RelevanceIndex) {
+        target = (int16_t) DecisionEng_Model.RelevanceIndex + SA_UTILS_MIN(DecisionEng_Model.BudgetIndex, 0);
+    } else {
+        target = (int16_t) DecisionEng_Model.RelevanceIndex + DecisionEng_Model.BudgetIndex;
+    }
+    target = SA_UTILS_SATURATE(AGENTS_INDEX_MIN_VALUE, DecisionEng_Model.MaxRelevanceTarget, target);
+    DecisionEng_Interfaces.AppInterface.Inputs.RelevanceTarget = (int8_t) target;
+    DecisionEng_Interfaces.AppInterface.Inputs.Charge = PowerAgent_GetRemainingChargePerc();
 }
 
 /**
  * \brief  Sets the inputs for the Radio agent.
  *
+ * \note List of notes:
+ *       1. The radio is idled when the power index is low, and the stored samples are only
+ *          drained when the power index is high and the energy plan is not overspent. Both
+ *          only apply if the radio has a sample store.
+ *       2. The trigger agent has already set the period of the next activation.
  */
 void DecisionEng_SetRadioInputs(void)
 {
-    DecisionEng_Interfaces.RadioInterface.Inputs.Data = DecisionEng_Interfaces.AppInterface.Outputs.Data;
+    RADIO_AGENT_INPUTS_T *p_inputs = &DecisionEng_Interfaces.RadioInterface.Inputs;
+
+    p_inputs->Data = DecisionEng_Interfaces.AppInterface.Outputs.Data;
+    p_inputs->Batch = DecisionEng_Model.RadioBatch;
+    p_inputs->Idle = (RADIO_CFG_IDLE_POWER_INDEX > DecisionEng_Model.PowerIndex) ?
+                     DEF_TRUE : DEF_FALSE;
+    p_inputs->Drain = ((RADIO_CFG_DRAIN_POWER_INDEX <= DecisionEng_Model.PowerIndex) &&
+                       (0 <= DecisionEng_Model.BudgetIndex)) ? DEF_TRUE : DEF_FALSE;
+    p_inputs->Period = TriggerAgent_GetConfig();
 }
 
 /**
  * \brief  Sets the inputs for the Power agent.
  *
+ * \note List of notes:
+ *       1. The predicted charge is only recomputed when the power models have changed, either
+ *          by a power prediction update or by a new configuration of the sensor or the radio.
+ *          The base and idle power must be changed through the power predictions.
+ *       2. The frames relayed for other nodes are predicted at the power of a transmission of
+ *          the radio config, so the feedback of a relay is not spread over the other models.
+ *       3. The radio power is an expectation of its retries, which changes with the link
+ *          without a new config, so its value is also compared.
+ *       4. The charge compared with the one drawn adds the charge of the retries observed by
+ *          the radio over the expected one, which is not part of the predicted power.
+ *       5. The period is the time since the previous activation, which the charge drawn and
+ *          harvested was measured over, not the period already set for the next one.
+ *       6. The radio power is predicted for the frames transmitted since the previous
+ *          activation, so the activations that fill a batch do not predict a transmission.
  */
 void DecisionEng_SetPowerInputs(void)
 {
+    DECISION_ENGINE_MODEL_T *p_model = &DecisionEng_Model;
+    CONFIG_POWER_T *p_app = DecisionEng_Interfaces.AppInterface.Outputs.PredictedPowerPtr;
+    CONFIG_POWER_T *p_radio = DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr;
+    float32_t forwarding = DecisionEng_Interfaces.RadioInterface.Outputs.Forwarding;
+    uint8_t frames = DecisionEng_Interfaces.RadioInterface.Outputs.Frames;
     float32_t charge;
     float32_t increment;
 
-    charge  = DecisionEng_Model.IdlePowerPtr->Power;
-    charge += DecisionEng_Model.BasePowerPtr->Power;
-    charge += DecisionEng_Interfaces.AppInterface.Outputs.PredictedPowerPtr->Power;
-    charge += DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power;
+    if ((p_model->ChargeGeneration == p_model->PowerGeneration) &&
+        (p_model->AppPowerPtr == p_app) && (p_model->RadioPowerPtr == p_radio) &&
+        (p_model->RadioPower == p_radio->Power) && (p_model->Forwarding == forwarding) &&
+        (p_model->RadioFrames == frames)) {
+        charge = p_model->PredictedPower;
+        p_model->Skips.PowerInputsSkipped++;
+    } else {
+        charge  = p_model->IdlePowerPtr->Power;
+        charge += p_model->BasePowerPtr->Power;
+        charge += p_app->Power;
+        charge += p_radio->Power * (frames + forwarding);
+        p_model->ChargeGeneration = p_model->PowerGeneration;
+        p_model->AppPowerPtr = p_app;
+        p_model->RadioPowerPtr = p_radio;
+        p_model->RadioPower = p_radio->Power;
+        p_model->Forwarding = forwarding;
+        p_model->RadioFrames = frames;
+    }
 
     increment  = DecisionEng_Interfaces.AppInterface.Outputs.PredictedPowerIncrement;
     increment += DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerIncrement;
 
     DecisionEng_Interfaces.PowerInterface.Inputs.ExpectedLifetime = DecisionEng_ExpectedActivations();
-    DecisionEng_Interfaces.PowerInterface.Inputs.PredictedChargeDelta = charge;
+    DecisionEng_Interfaces.PowerInterface.Inputs.Period = DecisionEng_Model.PreviousPeriod;
+    DecisionEng_Interfaces.PowerInterface.Inputs.EnergyNeutral = DecisionEng_Model.EnergyNeutral;
+    DecisionEng_Interfaces.PowerInterface.Inputs.PredictedChargeDelta = charge +
+        DecisionEng_Interfaces.RadioInterface.Outputs.RetryCharge;
     DecisionEng_Interfaces.PowerInterface.Inputs.PredictedIncrement = increment;
 
     DecisionEng_Model.PredictedPower = charge;
@@ -243,22 +592,44 @@ void DecisionEng_SetPowerInputs(void)
 /**
  * \brief  Updates the power predictions.
  *
+ * \note List of notes:
+ *       1. A feedback within MOTE_CFG_FEEDBACK_TOLERANCE of the predicted charge is not
+ *          learned, so the gains are not computed, the predicted powers do not change, and the
+ *          power generation is kept so the predicted charge is not recomputed in the next loop.
+ *       2. The gains are scaled by the power loop gain of TuningCfg_Params. The default of 1
+ *          leaves them unchanged, a gain below 1 damps the corrections of the predictions.
+ *       3. The retries of the frames relayed are not observed, so their fluctuation is
+ *          measurement noise of the feedback, not uncertainty of a model. It lowers every
+ *          gain, so the energy of the retries is not learned by the base or idle power.
+ *       4. The radio power is only part of the feedback with the frames transmitted since the
+ *          previous activation, see DecisionEng_SetPowerInputs. Its gain is the one of the
+ *          charge of the frames, which corrects the power of a transmission by its share.
  */
 void DecisionEng_UpdatePowerPredictions(void)
 {
     float32_t confidence;
     float32_t gain;
     float32_t feedback;
+    uint8_t frames = DecisionEng_Interfaces.RadioInterface.Outputs.Frames;
+
+    feedback = DecisionEng_Interfaces.PowerInterface.Outputs.PowerFeedbackPtr->Power;
+    if (MOTE_CFG_FEEDBACK_TOLERANCE * DecisionEng_Model.PredictedPower >= fabsf(feedback)) {
+        DecisionEng_Model.Skips.PredictionsUnchanged++;
+        return;
+    }
+    DecisionEng_Model.PowerGeneration++;
 
     confidence  = DecisionEng_Model.BasePowerPtr->Covariance * DecisionEng_Model.BasePowerPtr->Power;
     confidence += DecisionEng_Model.IdlePowerPtr->Covariance * DecisionEng_Model.IdlePowerPtr->Power;
     confidence += DecisionEng_Interfaces.AppInterface.Outputs.PredictedPowerPtr->Covariance * \
                   DecisionEng_Interfaces.AppInterface.Outputs.PredictedPowerPtr->Power;
     confidence += DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Covariance * \
-                  DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power;
+                  DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power * frames;
+    confidence += DecisionEng_Interfaces.RadioInterface.Outputs.RetryCovariance * \
+                  DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power * \
+                  DecisionEng_Interfaces.RadioInterface.Outputs.Forwarding;
     confidence += DecisionEng_Interfaces.PowerInterface.Outputs.PowerFeedbackPtr->Covariance;
-
-    feedback = DecisionEng_Interfaces.PowerInterface.Outputs.PowerFeedbackPtr->Power;
+    confidence /= TuningCfg_Params.PowerLoopGain;
 
     /* Base power       */
     gain  = DecisionEng_Model.BasePowerPtr->Covariance;
@@ -283,10 +654,11 @@ void DecisionEng_UpdatePowerPredictions(void)
         DecisionEng_Interfaces.AppInterface.Outputs.PredictedPowerPtr->Covariance;
 
     /* Radio Agent      */
+    if (0u == frames) return;
     gain  = DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Covariance;
-    gain *= DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power;
+    gain *= DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power * frames;
     gain /= confidence;
-    DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power += gain * feedback;
+    DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Power += gain * feedback / frames;
     DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Covariance  -= gain * \
         DecisionEng_Interfaces.RadioInterface.Outputs.PredictedPowerPtr->Covariance;
 }
@@ -300,34 +672,85 @@ void DecisionEng_Decide(void)
     /* Log indexes  */
     DecisionEng_Model.RelevanceIndex = DecisionEng_Interfaces.AppInterface.Outputs.RelevanceIndex;
     DecisionEng_Model.PowerIndex = DecisionEng_Interfaces.PowerInterface.Outputs.PowerIndex;
+
+    /* Energy plan  */
+    DecisionEng_UpdatePlanner();
+
+    DecisionEng_Model.Skips.Loops++;
 }
 
 /**
- * \brief  Runs a complete self-aware loop.
+ * \brief  Saves a checkpoint of the learned models every MOTE_CFG_CHECKPOINT_PERIOD loops.
  *
- * \param  inp:
+ */
+static void DecisionEng_UpdateCheckpoint(void)
+{
+    if ((DEF_TRUE == DecisionEng_Model.Checkpoint) &&
+        (MOTE_CFG_CHECKPOINT_PERIOD <= ++DecisionEng_Model.CheckpointLoops)) {
+        DecisionEng_SaveCheckpoint();
+    }
+}
+
+/**
+ * \brief  Runs the observation of the application agent, measured in WCET mode.
  *
- * \return DEF_OK if successful, DEF_FAIL otherwise.
+ * \return SA_PT_WAITING while the sensor is not ready; otherwise SA_PT_DONE.
+ *
+ */
+static SA_PT_STATUS_T DecisionEng_AppObservePt(void)
+{
+    SA_PT_STATUS_T status;
+
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_APP_OBSERVE,
+                            status = AppAgent_ObservePt(&DecisionEng_Interfaces.AppInterface));
+    return status;
+}
+
+/**
+ * \brief  Runs the actuation of the radio agent, measured in WCET mode.
+ *
+ * \return SA_PT_WAITING while the transmission is in progress; otherwise SA_PT_DONE.
+ *
+ */
+static SA_PT_STATUS_T DecisionEng_RadioActPt(void)
+{
+    SA_PT_STATUS_T status;
+
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_RADIO_ACT,
+                            status = RadioAgent_ActPt(&DecisionEng_Interfaces.RadioInterface));
+    return status;
+}
+
+/**
+ * \brief  Runs the phases of a complete self-aware loop as a resumable function.
+ *
+ * \return SA_PT_WAITING while the loop is waiting on an agent; otherwise SA_PT_DONE.
  *
  * \note List of notes:
- *       1.
+ *       1. A phase that waits is measured in each of its resumes, so its WCET is the longest
+ *          resume and the waits are not execution time.
  */
-void DecisionEng_Loop(void)
+static SA_PT_STATUS_T DecisionEng_RunPhasesPt(void)
 {
+    SA_PT_T *pt = &DecisionEng_Model.LoopPt;
+
+    SA_PT_BEGIN(pt);
     /* --- Observe ---  */
     /* Agents   */
     DecisionEng_SetAppInputs();
-    AppAgent_Observe(&DecisionEng_Interfaces.AppInterface);
+    SA_PT_WAIT_THREAD(pt, DecisionEng_AppObservePt());
 
     DecisionEng_SetRadioInputs();
-    RadioAgent_Observe(&DecisionEng_Interfaces.RadioInterface);
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_RADIO_OBSERVE,
+                            RadioAgent_Observe(&DecisionEng_Interfaces.RadioInterface));
 
     DecisionEng_SetPowerInputs();
-    PowerAgent_Observe(&DecisionEng_Interfaces.PowerInterface);
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_POWER_OBSERVE,
+                            PowerAgent_Observe(&DecisionEng_Interfaces.PowerInterface));
 
     /* Engine   */
-    DecisionEng_Decide();
-    DecisionEng_UpdatePowerPredictions();
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_DECIDE,
+                            DecisionEng_Decide(); DecisionEng_UpdatePowerPredictions());
 
 
     /* --- Decide ---   */
@@ -335,11 +758,103 @@ void DecisionEng_Loop(void)
 
     /* --- Act ---      */
     /* Agents   */
-    AppAgent_Act(&DecisionEng_Interfaces.AppInterface);
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_APP_ACT,
+                            AppAgent_Act(&DecisionEng_Interfaces.AppInterface));
+
+    SA_PT_WAIT_THREAD(pt, DecisionEng_RadioActPt());
 
-    RadioAgent_Act(&DecisionEng_Interfaces.RadioInterface);
+    DECISION_ENGINE_MEASURE(DECISION_ENGINE_PHASE_POWER_ACT,
+                            PowerAgent_Act(&DecisionEng_Interfaces.PowerInterface));
+    SA_PT_END(pt);
+}
+
+/**
+ * \brief  Runs a complete self-aware loop.
+ *         The loop is the resumable loop, DecisionEng_LoopPt, resumed until it is done.
+ *
+ * \note List of notes:
+ *       1. When built with DECISION_ENGINE_WCET the cycles of each phase and of the whole loop
+ *          are measured, see DecisionEng_GetWcet. The whole loop includes the measurement
+ *          overhead of the phases.
+ *       2. When the sensor has a start function (DECISION_ENGINE_INIT_T.AppInit.Sensor.Start)
+ *          the loop is pipelined: the act stage starts the acquisition of sample k+1 and the
+ *          observe stage of the next loop works on it, so the MCU sleeps during the conversion
+ *          instead of waiting awake for it.
+ *       3. With the ready function of the sensor or the done function of the radio, the loop
+ *          polls them awake. Use DecisionEng_LoopPt to sleep on them instead.
+ */
+void DecisionEng_Loop(void)
+{
+    while (SA_PT_WAITING == DecisionEng_LoopPt()) {
+    }
+}
+
+#ifdef SA_SIMULATION
+/**
+ * \brief  Advances the models over loops that repeat the last one, without running them.
+ *         This is only for simulation, to fast-forward a steady state: the configs, the data
+ *         and the power predictions are not changing, so the skipped loops would only move the
+ *         battery model, the energy plan and the loop counters.
+ *
+ * \param  loops:  Number of loops skipped.
+ *
+ * \note List of notes:
+ *       1. The data repeats, so the activity of the skipped loops is zero.
+ *       2. The samples of the skipped loops do not reach the radio agent, so the radio batch
+ *          and the sample store are not advanced.
+ *       3. The indexes are updated by the next loop, from the advanced models.
+ */
+void DecisionEng_Advance(uint32_t loops)
+{
+    uint32_t period = TriggerAgent_GetConfig();
+
+    if (0u == loops) return;
+
+    EnergyPlanner_Advance(loops, PowerAgent_GetPowerMeasurement(), 0.0f, period,
+                          PowerAgent_GetRemainingBatteryLife(), PowerAgent_GetDailyHarvest());
+    DecisionEng_Model.BudgetIndex = EnergyPlanner_GetBudgetIndex();
+    PowerAgent_Advance(loops, period);
+
+    DecisionEng_Model.Skips.Loops += loops;
+    DecisionEng_Model.CheckpointLoops += loops - 1u;
+    DecisionEng_UpdateCheckpoint();
+}
+#endif
+
+/**
+ * \brief  Runs a complete self-aware loop as a resumable function.
+ *         The loop yields while the sensor is not ready and while the radio transmission is in
+ *         progress, so the scheduler can sleep until the next event and resume the loop.
+ *
+ * \return SA_PT_WAITING while the loop is waiting on an agent, call again to resume; otherwise
+ *         SA_PT_DONE.
+ *
+ * \note List of notes:
+ *       1. In WCET mode the whole loop is the sum of its resumes, so the waits are not
+ *          measured.
+ *       2. The periodic checkpoint is saved after the loop, out of the WCET measurement, since
+ *          its time is dominated by the NVM.
+ */
+SA_PT_STATUS_T DecisionEng_LoopPt(void)
+{
+    SA_PT_STATUS_T status;
+
+#ifdef DECISION_ENGINE_WCET
+    uint32_t start = SaTiming_GetCycles();
+
+    status = DecisionEng_RunPhasesPt();
+    DecisionEng_LoopCycles += SA_TIMING_ELAPSED(start);
+    if (SA_PT_DONE == status) {
+        DecisionEng_RecordWcet(DECISION_ENGINE_PHASE_LOOP, DecisionEng_LoopCycles);
+        DecisionEng_LoopCycles = 0;
+        DecisionEng_Wcet.Loops++;
+    }
+#else
+    status = DecisionEng_RunPhasesPt();
+#endif
+    if (SA_PT_DONE == status) DecisionEng_UpdateCheckpoint();
 
-    PowerAgent_Act(&DecisionEng_Interfaces.PowerInterface);
+    return status;
 }
 
 /** @} (end addtogroup DecisionEngine)   */
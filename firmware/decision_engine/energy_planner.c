@@ -0,0 +1,344 @@
+/**
+ * \file    energy_planner.c
+ *
+ * \brief   Energy planner for the decision engine.
+ *          The remaining charge is split into budgets for the slots of a day (hourly by
+ *          default), proportionally to a learned activity profile, so the node spends more
+ *          energy in the slots where the signal is usually interesting.
+ *          In energy neutral mode the expected daily harvest is split instead, so the net
+ *          drain over a day is zero.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: EnergyPlanner_
+ *
+ */
+
+#include <string.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+
+#include "../configs/mote_cfg.h"
+
+#include "../include/agents_main.h"
+#include "../include/energy_planner.h"
+
+/** \addtogroup DecisionEngine
+ *   @{
+ */
+/** \addtogroup EnergyPlanner
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define ENERGY_PLANNER_DAY_LENGTH           (MOTE_CFG_PLANNER_SLOTS * MOTE_CFG_PLANNER_SLOT_LENGTH)
+#define ENERGY_PLANNER_SLOT_LENGTH_S        (MOTE_CFG_PLANNER_SLOT_LENGTH / SA_UTILS_S_TO_MILLI_S)
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Energy planner model.
+ *
+ * \note List of notes:
+ *       1. The profile holds one weight per slot, the activity floor plus the smoothed mean
+ *          activity observed in that slot. The sum of the weights is kept updated, so the
+ *          budget of a slot is computed without going through the profile.
+ *       2. The time is kept as the number of completed slots plus the time in the current
+ *          slot, so it does not overflow within the battery life.
+ */
+typedef struct {
+    float32_t Profile[MOTE_CFG_PLANNER_SLOTS];  /* Activity weight per slot         */
+    float32_t ProfileSum;                       /* Sum of the weights               */
+
+    uint32_t  ExpectedLife;                     /* Expected lifetime in s           */
+    bool_t    EnergyNeutral;                    /* Budget the daily harvest         */
+    uint32_t  ElapsedSlots;                     /* Completed slots since the start  */
+    uint32_t  SlotTime;                         /* Time in the current slot in ms   */
+    uint8_t   Slot;                             /* Current slot of the day          */
+
+    float32_t DailyBudget;                      /* Charge budget of the day         */
+    float32_t SlotBudget;                       /* Charge budget of the slot        */
+    float32_t SlotSpent;                        /* Charge spent in the slot         */
+    float32_t SlotCarried;                      /* Budget of the time before it     */
+    float32_t SlotActivity;                     /* Accumulated activity in the slot */
+    uint32_t  SlotActivations;                  /* Activations in the slot          */
+    bool_t    BudgetValid;                      /* The budget of the slot is set    */
+
+    int8_t    BudgetIndex;
+} ENERGY_PLANNER_MODEL_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static ENERGY_PLANNER_MODEL_T EnergyPlanner_Model;
+
+/************************************** Function implementation **********************************/
+
+/************* Utils ************************/
+/**
+ * \brief  Computes the budget of the current slot.
+ *
+ * \param  remaining_charge:  Remaining charge of the battery.
+ * \param  daily_harvest:     Expected harvested charge per day.
+ *
+ * \note List of notes:
+ *       1. The daily budget is the remaining charge over the remaining days, with at least one
+ *          day left, and it is shared between the slots proportionally to their weight.
+ *       2. In energy neutral mode the daily budget is the expected daily harvest. While no
+ *          harvest is expected yet, the budget is the one of the battery life, otherwise the
+ *          node would start at the longest period and learn the harvest from a few readings.
+ */
+static void EnergyPlanner_SetSlotBudget(float32_t remaining_charge, float32_t daily_harvest)
+{
+    ENERGY_PLANNER_MODEL_T *p_model = &EnergyPlanner_Model;
+    float32_t elapsed, remaining_days;
+
+    if ((DEF_TRUE == p_model->EnergyNeutral) && (0.0f < daily_harvest)) {
+        p_model->DailyBudget = daily_harvest;
+    } else {
+        elapsed = (float32_t) p_model->ElapsedSlots * ENERGY_PLANNER_SLOT_LENGTH_S;
+        remaining_days  = (float32_t) p_model->ExpectedLife - elapsed;
+        remaining_days *= (float32_t) SA_UTILS_S_TO_MILLI_S / ENERGY_PLANNER_DAY_LENGTH;
+        remaining_days  = SA_UTILS_MAX(remaining_days, 1.0f);
+        p_model->DailyBudget = remaining_charge / remaining_days;
+    }
+    p_model->SlotBudget = p_model->DailyBudget * p_model->Profile[p_model->Slot] / p_model->ProfileSum;
+    p_model->BudgetValid = DEF_TRUE;
+}
+
+/**
+ * \brief  Closes the current slot: learns its activity and moves to the next slot.
+ *
+ */
+static void EnergyPlanner_CloseSlot(void)
+{
+    ENERGY_PLANNER_MODEL_T *p_model = &EnergyPlanner_Model;
+    float32_t weight, previous;
+
+    if (0 != p_model->SlotActivations) {
+        weight  = p_model->SlotActivity / p_model->SlotActivations;
+        weight += MOTE_CFG_PLANNER_ACTIVITY_FLOOR;
+        previous = p_model->Profile[p_model->Slot];
+        p_model->Profile[p_model->Slot] = SaUtils_UpdateValue(previous, weight,
+                                                              MOTE_CFG_PLANNER_PROFILE_GAIN);
+        p_model->ProfileSum += p_model->Profile[p_model->Slot] - previous;
+    }
+
+    p_model->SlotTime -= MOTE_CFG_PLANNER_SLOT_LENGTH;
+    p_model->ElapsedSlots++;
+    p_model->Slot = (uint8_t)((p_model->Slot + 1u) % MOTE_CFG_PLANNER_SLOTS);
+    p_model->SlotSpent = 0.0f;
+    p_model->SlotCarried = 0.0f;
+    p_model->SlotActivity = 0.0f;
+    p_model->SlotActivations = 0;
+    p_model->BudgetValid = DEF_FALSE;
+}
+
+/************* Interface ********************/
+/**
+ * \brief  Gets the budget index.
+ *
+ * \return Budget index, positive when the spending is below the budget of the slot.
+ *
+ */
+int8_t EnergyPlanner_GetBudgetIndex(void)
+{
+    return EnergyPlanner_Model.BudgetIndex;
+}
+
+/**
+ * \brief  Gets the status of the current slot.
+ *
+ * \param  p_status:  Pointer to where the status will be saved.
+ *
+ */
+void EnergyPlanner_GetStatus(ENERGY_PLANNER_STATUS_T *p_status)
+{
+    p_status->Slot = EnergyPlanner_Model.Slot;
+    p_status->Budget = EnergyPlanner_Model.SlotBudget;
+    p_status->Spent = EnergyPlanner_Model.SlotSpent;
+    p_status->Weight = EnergyPlanner_Model.Profile[EnergyPlanner_Model.Slot];
+}
+
+/**
+ * \brief  Sets the expected lifetime.
+ *
+ * \param  expected_life:  Expected lifetime from the start in s.
+ *
+ */
+void EnergyPlanner_SetExpectedLife(uint32_t expected_life)
+{
+    EnergyPlanner_Model.ExpectedLife = expected_life;
+    EnergyPlanner_Model.BudgetValid = DEF_FALSE;
+}
+
+/**
+ * \brief  Enables or disables the energy neutral mode.
+ *
+ * \param  enable:  DEF_TRUE to budget the daily harvest instead of the remaining charge.
+ *
+ */
+void EnergyPlanner_SetEnergyNeutral(bool_t enable)
+{
+    EnergyPlanner_Model.EnergyNeutral = enable;
+    EnergyPlanner_Model.BudgetValid = DEF_FALSE;
+}
+
+/**
+ * \brief  Initializes the energy planner.
+ *         The profile starts flat, so the charge is spent evenly until it is learned.
+ *
+ * \param  expected_life:  Expected lifetime from the start in s.
+ *
+ */
+void EnergyPlanner_Init(uint32_t expected_life)
+{
+    uint8_t slot;
+
+    memset(&EnergyPlanner_Model, 0x00, sizeof(ENERGY_PLANNER_MODEL_T));
+    for (slot = 0; slot < MOTE_CFG_PLANNER_SLOTS; slot++) {
+        EnergyPlanner_Model.Profile[slot] = 1.0f;
+    }
+    EnergyPlanner_Model.ProfileSum = (float32_t) MOTE_CFG_PLANNER_SLOTS;
+    EnergyPlanner_SetExpectedLife(expected_life);
+}
+
+/**
+ * \brief  Saves the learned state of the planner.
+ *
+ * \param  p_checkpoint:  Pointer to where the state will be saved.
+ *
+ */
+void EnergyPlanner_SaveCheckpoint(ENERGY_PLANNER_CHECKPOINT_T *p_checkpoint)
+{
+    memcpy(p_checkpoint->Profile, EnergyPlanner_Model.Profile, sizeof(EnergyPlanner_Model.Profile));
+    p_checkpoint->ProfileSum = EnergyPlanner_Model.ProfileSum;
+    p_checkpoint->ElapsedSlots = EnergyPlanner_Model.ElapsedSlots;
+    p_checkpoint->SlotTime = EnergyPlanner_Model.SlotTime;
+    p_checkpoint->Slot = EnergyPlanner_Model.Slot;
+}
+
+/**
+ * \brief  Restores the learned state of the planner, after EnergyPlanner_Init.
+ *         The budget of the slot is recomputed in the next update.
+ *
+ * \param  p_checkpoint:  Pointer to the saved state.
+ *
+ */
+void EnergyPlanner_RestoreCheckpoint(const ENERGY_PLANNER_CHECKPOINT_T *p_checkpoint)
+{
+    memcpy(EnergyPlanner_Model.Profile, p_checkpoint->Profile, sizeof(EnergyPlanner_Model.Profile));
+    EnergyPlanner_Model.ProfileSum = p_checkpoint->ProfileSum;
+    EnergyPlanner_Model.ElapsedSlots = p_checkpoint->ElapsedSlots;
+    EnergyPlanner_Model.SlotTime = p_checkpoint->SlotTime;
+    EnergyPlanner_Model.Slot = p_checkpoint->Slot;
+    EnergyPlanner_Model.BudgetValid = DEF_FALSE;
+}
+
+/**
+ * \brief  Updates the planner with the last activation and computes the budget index.
+ *
+ * \param  spent:             Charge spent in the activation.
+ * \param  activity:          Activity of the signal in the activation [0, 1].
+ * \param  period:            Time since the previous activation in ms.
+ * \param  remaining_charge:  Remaining charge of the battery.
+ * \param  daily_harvest:     Expected harvested charge per day.
+ *
+ * \note List of notes:
+ *       1. The budget index compares the charge spent in the slot with the part of the slot
+ *          budget that corresponds to the time elapsed in the slot. It is scaled to the budget
+ *          of the slot, so the maximum index means nothing spent yet and the minimum index means
+ *          the budget has been overspent by a whole slot budget.
+ *       2. The cost is constant per activation. The slot budget is only recomputed when a new
+ *          slot starts, or after a change in the expected lifetime.
+ *       3. The first activation of a slot pays for the time since the previous activation, so
+ *          the time before the slot is allowed the daily budget spread over the day, for the
+ *          rest of the slot. Otherwise a period longer than a slot only gets the budget of the
+ *          slot it ends in, which is small when little activity has been seen there, and the
+ *          period only gets longer.
+ */
+void EnergyPlanner_Update(float32_t spent, float32_t activity, uint32_t period,
+                          float32_t remaining_charge, float32_t daily_harvest)
+{
+    ENERGY_PLANNER_MODEL_T *p_model = &EnergyPlanner_Model;
+    float32_t allowed, index;
+
+    /* Time             */
+    p_model->SlotTime += period;
+    while (MOTE_CFG_PLANNER_SLOT_LENGTH <= p_model->SlotTime) {
+        EnergyPlanner_CloseSlot();
+    }
+    if (DEF_FALSE == p_model->BudgetValid) {
+        EnergyPlanner_SetSlotBudget(remaining_charge, daily_harvest);
+    }
+
+    /* Slot accounting  */
+    if (period > p_model->SlotTime) {
+        p_model->SlotCarried += p_model->DailyBudget * (period - p_model->SlotTime) / ENERGY_PLANNER_DAY_LENGTH;
+    }
+    p_model->SlotSpent += spent;
+    p_model->SlotActivity += SA_UTILS_SATURATE(0.0f, 1.0f, activity);
+    p_model->SlotActivations++;
+
+    /* Budget index     */
+    if (0.0f >= p_model->SlotBudget) {
+        index = AGENTS_INDEX_MIN_VALUE;
+    } else {
+        allowed  = p_model->SlotBudget * p_model->SlotTime / MOTE_CFG_PLANNER_SLOT_LENGTH;
+        allowed += p_model->SlotCarried;
+        index  = (allowed - p_model->SlotSpent) / p_model->SlotBudget;
+        index *= AGENTS_INDEX_MAX_VALUE;
+    }
+    index = SA_UTILS_SATURATE(AGENTS_INDEX_MIN_VALUE, AGENTS_INDEX_MAX_VALUE, index);
+    p_model->BudgetIndex = (int8_t) index;
+}
+
+#ifdef SA_SIMULATION
+/**
+ * \brief  Updates the planner with activations that repeat the same cost and activity,
+ *         without running them one by one. This is only for simulation, to fast-forward a
+ *         steady state.
+ *
+ * \param  activations:       Number of activations.
+ * \param  spent:             Charge spent in each activation.
+ * \param  activity:          Activity of the signal in each activation [0, 1].
+ * \param  period:            Time between activations in ms.
+ * \param  remaining_charge:  Remaining charge of the battery before the first activation.
+ * \param  daily_harvest:     Expected harvested charge per day.
+ *
+ * \note List of notes:
+ *       1. The activations inside a slot are accounted at once, and only the activations that
+ *          close a slot and the last one go through EnergyPlanner_Update, so the cost depends
+ *          on the number of slots crossed.
+ *       2. The remaining charge given to the new budgets is reduced by the charge spent up to
+ *          the slot.
+ */
+void EnergyPlanner_Advance(uint32_t activations, float32_t spent, float32_t activity, uint32_t period,
+                           float32_t remaining_charge, float32_t daily_harvest)
+{
+    ENERGY_PLANNER_MODEL_T *p_model = &EnergyPlanner_Model;
+    uint32_t bulk;
+
+    activity = SA_UTILS_SATURATE(0.0f, 1.0f, activity);
+    period = SA_UTILS_MAX(period, 1u);
+    while (0u != activations) {
+        /* Activations before the one that closes the slot  */
+        bulk  = (MOTE_CFG_PLANNER_SLOT_LENGTH - p_model->SlotTime + period - 1u) / period - 1u;
+        bulk  = SA_UTILS_MIN(bulk, activations - 1u);
+        p_model->SlotTime += bulk * period;
+        p_model->SlotSpent += bulk * spent;
+        p_model->SlotActivity += bulk * activity;
+        p_model->SlotActivations += bulk;
+        remaining_charge -= bulk * spent;
+        activations -= bulk;
+
+        EnergyPlanner_Update(spent, activity, period, remaining_charge, daily_harvest);
+        remaining_charge -= spent;
+        activations--;
+    }
+}
+#endif
+
+/** @} (end addtogroup EnergyPlanner)   */
+/** @} (end addtogroup DecisionEngine)  */
@@ -41,6 +41,7 @@ typedef struct {
 
 typedef struct {
     int8_t RelevanceTarget;
+    float32_t Charge;           /* Own remaining charge in %, sent with the samples */
 }  APP_AGENT_INPUTS_T;
 
 typedef struct {
@@ -71,6 +72,8 @@ typedef struct {
 bool_t AppAgent_Init(SENSOR_AGENT_OBSERVATION_T sensor_obs,
                      SENSOR_AGENT_ACTUATION_T sensor_act,
                      SENSOR_AGENT_ALARM_T sensor_alrm,
+                     SENSOR_AGENT_START_T sensor_start,
+                     SENSOR_AGENT_READY_T sensor_ready,
                      TRIGGER_AGENT_OBSERVATION_T trigger_obs,
                      TRIGGER_AGENT_ACTUATION_T trigger_act,
                      TRIGGER_AGENT_ALARM_T trigger_alrm,
@@ -78,6 +81,10 @@ bool_t AppAgent_Init(SENSOR_AGENT_OBSERVATION_T sensor_obs,
 void AppAgent_Oda(APP_AGENT_INTERFACE_T *p_data);
 void AppAgent_Observe(APP_AGENT_INTERFACE_T *p_data);
 void AppAgent_Act(APP_AGENT_INTERFACE_T *p_data);
+SA_PT_STATUS_T AppAgent_ObservePt(APP_AGENT_INTERFACE_T *p_data);
+void AppAgent_SetCooperative(bool_t enable, uint16_t node);
+void AppAgent_Overhear(uint16_t neighbor, float32_t data, uint32_t period, float32_t charge);
+float32_t AppAgent_GetCorrelation(uint16_t neighbor);
 
 
 /** @} (end addtogroup AppAgent)    */
@@ -0,0 +1,73 @@
+/**
+ * \file    checkpoint.h
+ *
+ * \brief   Header file for the checkpoints of the learned models in NVM.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include "../platform/sa_types.h"
+#include "../configs/config.h"
+#include "../configs/radio_cfg.h"
+#include "../configs/sensor_cfg.h"
+
+#include "power_agent.h"
+#include "trigger_agent.h"
+#include "radio_agent.h"
+#include "energy_planner.h"
+
+/** \addtogroup DecisionEngine
+ *   @{
+ */
+
+/** \addtogroup Checkpoint
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define CHECKPOINT_VERSION          3u          /* Increment on any change of CHECKPOINT_DATA_T */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Learned state of the models, saved in a checkpoint.
+ *
+ */
+typedef struct {
+    POWER_AGENT_CHECKPOINT_T Power;
+    ENERGY_PLANNER_CHECKPOINT_T Planner;
+    TRIGGER_AGENT_CHECKPOINT_T Trigger;
+    RADIO_AGENT_CHECKPOINT_T Radio;
+    CONFIG_POWER_T RadioLearned[RADIO_CFG_CONFIGS_SIZE];     /* Power of an attempt        */
+    CONFIG_POWER_T SensorLearned[SENSOR_CFG_CONFIGS_SIZE];
+    CONFIG_POWER_T BasePower;
+    CONFIG_POWER_T IdlePower;
+} CHECKPOINT_DATA_T;
+
+/**
+ * \brief  Status of the checkpoints.
+ *
+ */
+typedef struct {
+    uint32_t Sequence;                  /* Sequence of the last checkpoint, 0 if none   */
+    uint32_t Address;                   /* NVM address of the last checkpoint           */
+    uint32_t Saved;                     /* Checkpoints saved since the initialization   */
+    uint16_t Discarded;                 /* Records discarded by the scan, CRC or version*/
+    bool_t   Restored;                  /* The models were restored in the init         */
+} CHECKPOINT_STATUS_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t Checkpoint_Init(void);
+bool_t Checkpoint_Restore(void);
+bool_t Checkpoint_Save(void);
+void Checkpoint_GetStatus(CHECKPOINT_STATUS_T *p_status);
+
+/** @} (end addtogroup Checkpoint)      */
+/** @} (end addtogroup DecisionEngine)  */
+
+#endif /* __CHECKPOINT_H__         */
@@ -11,6 +11,7 @@
 #define __DECISION_ENGINE_H__
 
 #include "../platform/sa_types.h"
+#include "../platform/sa_pt.h"
 
 #include "power_agent.h"
 #include "radio_agent.h"
@@ -35,8 +36,58 @@ typedef struct {
     RADIO_AGENT_INIT_T RadioInit;
     POWER_AGENT_INIT_T PowerInit;
     APP_AGENT_INIT_T AppInit;
+    bool_t Checkpoint;                  /* Restore and save the learned models in NVM   */
 } DECISION_ENGINE_INIT_T;
 
+/**
+ * \brief  Sampling policies of the decision engine, see DecisionEng_SetPolicy.
+ *
+ */
+typedef enum {
+    DECISION_ENGINE_POLICY_RELEVANCE = 0,   /* Relevance index and energy budget        */
+    DECISION_ENGINE_POLICY_BUDGET,          /* Energy budget only                       */
+    DECISION_ENGINE_POLICY_FIXED,           /* Default periodicity of the trigger agent */
+} DECISION_ENGINE_POLICY_T;
+
+/**
+ * \brief  Work skipped by the decision engine because its inputs had not changed.
+ *
+ */
+typedef struct {
+    uint32_t Loops;                     /* Loops run since the initialization           */
+    uint32_t ActivationsSkipped;        /* Expected activations reused                  */
+    uint32_t PowerInputsSkipped;        /* Predicted charge of the mote reused          */
+    uint32_t PredictionsUnchanged;      /* Power updates with a feedback in tolerance   */
+} DECISION_ENGINE_SKIPS_T;
+
+#ifdef DECISION_ENGINE_WCET
+/**
+ * \brief  Phases of the self-aware loop measured in WCET mode.
+ *
+ */
+typedef enum {
+    DECISION_ENGINE_PHASE_APP_OBSERVE = 0,
+    DECISION_ENGINE_PHASE_RADIO_OBSERVE,
+    DECISION_ENGINE_PHASE_POWER_OBSERVE,
+    DECISION_ENGINE_PHASE_DECIDE,
+    DECISION_ENGINE_PHASE_APP_ACT,
+    DECISION_ENGINE_PHASE_RADIO_ACT,
+    DECISION_ENGINE_PHASE_POWER_ACT,
+    DECISION_ENGINE_PHASE_LOOP,             /* Whole DecisionEng_Loop           */
+    DECISION_ENGINE_PHASES,
+} DECISION_ENGINE_PHASE_T;
+
+/**
+ * \brief  Worst case execution times measured in WCET mode.
+ *
+ */
+typedef struct {
+    uint32_t Cycles[DECISION_ENGINE_PHASES];    /* Maximum cycles of each phase             */
+    uint32_t Loop[DECISION_ENGINE_PHASES];      /* Loop in which the maximum was measured   */
+    uint32_t Loops;                             /* Loops measured since the reset           */
+} DECISION_ENGINE_WCET_T;
+#endif
+
 
 /************************************** Local Var ************************************************/
 
@@ -48,10 +99,27 @@ void DecisionEng_GetFeedbackValues(float32_t *predicted_power, float32_t *predic
 CONFIG_POWER_T *DecisionEng_GetBasePowerPtr(void);
 CONFIG_POWER_T *DecisionEng_GetIdlePowerPtr(void);
 float32_t DecisionEng_GetPower(void);
+void DecisionEng_GetSkips(DECISION_ENGINE_SKIPS_T *p_skips);
 
 bool_t DecisionEng_Init(DECISION_ENGINE_INIT_T *p_init);
 void DecisionEng_SetExpectedLife(uint32_t expected_life);
+void DecisionEng_SetEnergyNeutral(bool_t enable);
+void DecisionEng_SetSamplingLimit(int8_t max_target);
+void DecisionEng_SetPolicy(DECISION_ENGINE_POLICY_T policy);
+void DecisionEng_SetAssignedPeriod(uint32_t period);
+void DecisionEng_SetRadioBatch(uint8_t batch);
+void DecisionEng_ResetToDatasheet(void);
+bool_t DecisionEng_SaveCheckpoint(void);
 void DecisionEng_Loop(void);
+#ifdef SA_SIMULATION
+void DecisionEng_Advance(uint32_t loops);
+#endif
+SA_PT_STATUS_T DecisionEng_LoopPt(void);
+
+#ifdef DECISION_ENGINE_WCET
+void DecisionEng_ResetWcet(void);
+void DecisionEng_GetWcet(DECISION_ENGINE_WCET_T *p_wcet);
+#endif
 
 
 /** @} (end addtogroup DecisionEngine)  */
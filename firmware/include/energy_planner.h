@@ -0,0 +1,66 @@
+/**
+ * \file    energy_planner.h
+ *
+ * \brief   Header file for the energy planner of the decision engine.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __ENERGY_PLANNER_H__
+#define __ENERGY_PLANNER_H__
+
+#include "../platform/sa_types.h"
+#include "../configs/mote_cfg.h"
+
+/** \addtogroup DecisionEngine
+ *   @{
+ */
+
+/** \addtogroup EnergyPlanner
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+typedef struct {
+    uint8_t   Slot;                     /* Current slot of the day                      */
+    float32_t Budget;                   /* Charge budget of the current slot            */
+    float32_t Spent;                    /* Charge spent in the current slot             */
+    float32_t Weight;                   /* Learned activity weight of the current slot  */
+} ENERGY_PLANNER_STATUS_T;
+
+/**
+ * \brief  Learned state of the planner, saved in the checkpoints.
+ *
+ */
+typedef struct {
+    float32_t Profile[MOTE_CFG_PLANNER_SLOTS];  /* Activity weight per slot         */
+    float32_t ProfileSum;
+    uint32_t  ElapsedSlots;
+    uint32_t  SlotTime;
+    uint8_t   Slot;
+} ENERGY_PLANNER_CHECKPOINT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void EnergyPlanner_Init(uint32_t expected_life);
+void EnergyPlanner_SetExpectedLife(uint32_t expected_life);
+void EnergyPlanner_SetEnergyNeutral(bool_t enable);
+void EnergyPlanner_Update(float32_t spent, float32_t activity, uint32_t period,
+                          float32_t remaining_charge, float32_t daily_harvest);
+#ifdef SA_SIMULATION
+void EnergyPlanner_Advance(uint32_t activations, float32_t spent, float32_t activity, uint32_t period,
+                           float32_t remaining_charge, float32_t daily_harvest);
+#endif
+int8_t EnergyPlanner_GetBudgetIndex(void);
+void EnergyPlanner_GetStatus(ENERGY_PLANNER_STATUS_T *p_status);
+void EnergyPlanner_SaveCheckpoint(ENERGY_PLANNER_CHECKPOINT_T *p_checkpoint);
+void EnergyPlanner_RestoreCheckpoint(const ENERGY_PLANNER_CHECKPOINT_T *p_checkpoint);
+
+/** @} (end addtogroup EnergyPlanner)   */
+/** @} (end addtogroup DecisionEngine)  */
+
+#endif /* __ENERGY_PLANNER_H__         */
@@ -12,6 +12,7 @@
 
 #include "../platform/sa_types.h"
 #include "../configs/config.h"
+#include "../configs/battery_cfg.h"
 
 /** \addtogroup Agents
  *   @{
@@ -24,10 +25,18 @@
 /************************************** Defines **************************************************/
 
 /************************************** Typedef **************************************************/
+typedef enum {
+    POWER_AGENT_ALL_OK = 0,
+    POWER_AGENT_BATTERY_LOW,            /* Depletion forecast within the alarm horizon  */
+    POWER_AGENT_BATTERY_DEPLETED,
+    POWER_AGENT_MAX_ERROR,
+} POWER_AGENT_ERROR_T;
+
 typedef struct {
     float32_t BatteryVoltage;
     float32_t Temperature;
     float32_t Charge;
+    float32_t Harvested;                /* Accumulated harvested charge, 0 if none      */
 }  POWER_AGENT_BATTERY_OBS_T;
 
 typedef struct {
@@ -42,6 +51,8 @@ typedef struct {
     float32_t PredictedChargeDelta;     /* Prediction of the charge consumption         */
     float32_t PredictedIncrement;       /* Predicted change in the charge consumption   */
     uint32_t  ExpectedLifetime;         /* Expected lifetime in activations             */
+    uint32_t  Period;                   /* Time between activations in ms               */
+    bool_t    EnergyNeutral;            /* Target zero net drain over a day             */
 }  POWER_AGENT_INPUTS_T;
 
 typedef struct {
@@ -54,15 +65,44 @@ typedef struct {
     POWER_AGENT_OUTPUTS_T Outputs;
 } POWER_AGENT_INTERFACE_T;
 
+typedef struct {
+    uint32_t Mean;                      /* Expected remaining activations               */
+    uint32_t Lower;                     /* Lower confidence bound                       */
+    uint32_t Upper;                     /* Upper confidence bound                       */
+} POWER_AGENT_FORECAST_T;
+
+/**
+ * \brief  Learned state of the battery model, saved in the checkpoints.
+ *
+ */
+typedef struct {
+    float32_t BatteryChargeTotal;
+    float32_t BatteryChargeRemaining;
+    float32_t PreviousCharge;           /* Last reading of the coulomb counter          */
+    float32_t PreviousHarvested;
+    float32_t Soc;
+    float32_t SocCovariance;
+    float32_t Capacity;
+    float32_t ConsumptionMean;
+    float32_t ConsumptionVariance;
+    float32_t HarvestProfile[POWER_AGENT_HARVEST_SLOTS];
+    float32_t DailyHarvest;
+    float32_t SlotHarvest;
+    uint32_t  SlotTime;
+    CONFIG_POWER_T PowerFeedback;
+    uint8_t   Slot;
+    bool_t    ConsumptionInitialized;
+} POWER_AGENT_CHECKPOINT_T;
+
 /************* External functions ***********/
 typedef void (*POWER_AGENT_OBSERVATION_T)(POWER_AGENT_OBS_T*);
 typedef void (*POWER_AGENT_ACTUATION_T)(POWER_AGENT_ACTS_T*);
-typedef void (*POWER_AGENT_BATTERY_DEPLETED_T)(void);
+typedef void (*POWER_AGENT_ALARM_T)(POWER_AGENT_ERROR_T);
 
 typedef struct {
     POWER_AGENT_OBSERVATION_T Obs;
     POWER_AGENT_ACTUATION_T Act;
-    POWER_AGENT_BATTERY_DEPLETED_T Alarm;
+    POWER_AGENT_ALARM_T Alarm;
 } POWER_AGENT_INIT_T;
 
 /************************************** Function prototypes **************************************/
@@ -70,10 +110,19 @@ float32_t PowerAgent_GetRemainingBatteryLife();
 float32_t PowerAgent_GetRemainingChargePerc();
 CONFIG_POWER_T *PowerAgent_GetPowerPtr();
 float32_t PowerAgent_GetPowerMeasurement();
+float32_t PowerAgent_GetSoc(float32_t *p_covariance);
+float32_t PowerAgent_GetOcv(float32_t soc, float32_t temperature);
+void PowerAgent_GetLifeForecast(POWER_AGENT_FORECAST_T *p_forecast);
+float32_t PowerAgent_GetDailyHarvest(void);
 
 void PowerAgent_SetBatteryCharge(float32_t charge);
+#ifdef SA_SIMULATION
+void PowerAgent_Advance(uint32_t activations, uint32_t period);
+#endif
+void PowerAgent_SaveCheckpoint(POWER_AGENT_CHECKPOINT_T *p_checkpoint);
+void PowerAgent_RestoreCheckpoint(const POWER_AGENT_CHECKPOINT_T *p_checkpoint);
 bool_t PowerAgent_Init(POWER_AGENT_OBSERVATION_T observe, POWER_AGENT_ACTUATION_T act,
-                       POWER_AGENT_BATTERY_DEPLETED_T battery_depleted);
+                       POWER_AGENT_ALARM_T alarm);
 
 void PowerAgent_Oda(POWER_AGENT_INTERFACE_T *p_data);
 void PowerAgent_Observe(POWER_AGENT_INTERFACE_T *p_data);
@@ -11,6 +11,7 @@
 #define __RADIO_AGENT_H__
 
 #include "../platform/sa_types.h"
+#include "../platform/sa_pt.h"
 #include "../configs/config.h"
 #include "../configs/radio_cfg.h"
 
@@ -29,19 +30,44 @@ typedef struct {
     bool_t ConfigChange;        /* Flag to state if the config has changed or not   */
     RADIO_CFG_LIST_T Config;
     float32_t Data;
+    bool_t LinkUp;              /* Link available, DEF_TRUE if not set              */
+    uint16_t Forwarded;         /* Frames relayed for other nodes since the last
+                                   observation, 0 if not set                        */
+    uint8_t Attempts;           /* Attempts of the last transmission, the retries
+                                   plus one, 0 if not set                           */
+    bool_t Acked;               /* Last transmission acknowledged                   */
+    int8_t Rssi;                /* RSSI of the acknowledgement in dBm,
+                                   RADIO_CFG_RSSI_UNKNOWN if not set                */
 } RADIO_AGENT_OBS_T;
 
 typedef struct {
-    float32_t Data;
+    float32_t Data;                             /* Last sample                  */
+    float32_t Batch[RADIO_CFG_DRAIN_BATCH];     /* Samples to transmit, oldest first            */
+    uint8_t   BatchSize;                        /* Number of samples to transmit                */
+    uint8_t   Stored;                           /* Samples of the batch drained from the store  */
+    RADIO_CFG_LIST_T Config;                    /* Mode of the transmission                     */
 } RADIO_AGENT_ACTS_T;
 
 typedef struct {
     float32_t Data;
+    uint8_t   Batch;            /* Activations per transmission, 0 or 1 transmits every activation  */
+    bool_t    Idle;             /* Radio idled to save energy, the samples are stored               */
+    bool_t    Drain;            /* Energy available to drain the stored samples                     */
+    uint32_t  Period;           /* Time until the next observation in ms, 0 if not set              */
 } RADIO_AGENT_INPUTS_T;
 
 typedef struct {
     CONFIG_POWER_T *PredictedPowerPtr;
     float32_t PredictedPowerIncrement;
+    float32_t Forwarding;       /* Frames relayed until the next activation,
+                                   each at the power of a transmission              */
+    uint8_t Frames;             /* Own frames transmitted since the last
+                                   observation, each at the power of a transmission */
+    float32_t DeliveryCost;     /* Expected energy per delivered byte of the mode   */
+    float32_t RetryCovariance;  /* Relative covariance of the power of a transmission
+                                   from its retries, see RadioAgent_Retries         */
+    float32_t RetryCharge;      /* Charge of the retries observed since the last
+                                   loop over the expected one                       */
 } RADIO_AGENT_OUTPUTS_T;
 
 typedef struct {
@@ -49,13 +75,28 @@ typedef struct {
     RADIO_AGENT_OUTPUTS_T Outputs;
 } RADIO_AGENT_INTERFACE_T;
 
+/**
+ * \brief  Learned state of the delivery of the radio, saved in the checkpoints.
+ *
+ */
+typedef struct {
+    float32_t Acks[RADIO_CFG_CONFIGS_SIZE];     /* Acknowledgements per transmission, averaged */
+    float32_t Attempts[RADIO_CFG_CONFIGS_SIZE]; /* Attempts per transmission, averaged */
+    uint8_t Outcomes[RADIO_CFG_CONFIGS_SIZE];   /* Outcomes averaged, saturated */
+    uint8_t Config;                             /* Mode selected */
+    bool_t Acknowledged;                        /* The radio reports the outcome of its transmissions */
+} RADIO_AGENT_CHECKPOINT_T;
+
 /************* External functions ***********/
 typedef void (*RADIO_AGENT_OBSERVATION_T)(RADIO_AGENT_OBS_T*);
 typedef void (*RADIO_AGENT_ACTUATION_T)(RADIO_AGENT_ACTS_T*);
+typedef bool_t (*RADIO_AGENT_DONE_T)(void);
 
 typedef struct {
     RADIO_AGENT_OBSERVATION_T Obs;
     RADIO_AGENT_ACTUATION_T Act;
+    RADIO_AGENT_DONE_T Done;            /* Transmission completed, NULL if synchronous  */
+    bool_t Store;                       /* Store the samples in NVM while not transmitted*/
 } RADIO_AGENT_INIT_T;
 
 /************************************** Local Var ************************************************/
@@ -64,11 +105,20 @@ typedef struct {
 RADIO_CFG_LIST_T RadioAgent_GetConfig(void);
 float32_t RadioAgent_GetPower(void);
 CONFIG_POWER_T *RadioAgent_GetPowerPtr(void);
-
-bool_t RadioAgent_Init(RADIO_AGENT_OBSERVATION_T observe, RADIO_AGENT_ACTUATION_T act);
+float32_t RadioAgent_GetForwarding(void);
+uint8_t RadioAgent_GetFrames(void);
+float32_t RadioAgent_GetDelivery(RADIO_CFG_LIST_T config);
+void RadioAgent_SaveCheckpoint(RADIO_AGENT_CHECKPOINT_T *p_checkpoint);
+void RadioAgent_RestoreCheckpoint(const RADIO_AGENT_CHECKPOINT_T *p_checkpoint);
+
+bool_t RadioAgent_Init(RADIO_AGENT_OBSERVATION_T observe, RADIO_AGENT_ACTUATION_T act,
+                       RADIO_AGENT_DONE_T done, bool_t store);
+void RadioAgent_Refresh(void);
+void RadioAgent_Sync(void);
 void RadioAgent_Oda(RADIO_AGENT_INTERFACE_T *p_data);
 void RadioAgent_Observe(RADIO_AGENT_INTERFACE_T *p_data);
 void RadioAgent_Act(RADIO_AGENT_INTERFACE_T *p_data);
+SA_PT_STATUS_T RadioAgent_ActPt(RADIO_AGENT_INTERFACE_T *p_data);
 
 /** @} (end addtogroup Agents)      */
 /** @} (end addtogroup RadioAgent)  */
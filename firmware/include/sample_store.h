@@ -0,0 +1,53 @@
+/**
+ * \file    sample_store.h
+ *
+ * \brief   Header file for the store and forward of the samples in NVM.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SAMPLE_STORE_H__
+#define __SAMPLE_STORE_H__
+
+#include "../platform/sa_types.h"
+#include "../configs/radio_cfg.h"
+
+/** \addtogroup Agents
+ *   @{
+ */
+
+/** \addtogroup SampleStore
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Status of the sample store.
+ *
+ */
+typedef struct {
+    uint32_t Pending;                   /* Samples waiting to be drained                */
+    uint32_t Appended;                  /* Samples stored since the initialization      */
+    uint32_t Drained;                   /* Samples released since the initialization    */
+    uint32_t Dropped;                   /* Oldest samples lost because the store was full*/
+    uint16_t Discarded;                 /* Records discarded by the scan, incomplete    */
+    uint16_t Reclaimed;                 /* Drained sectors erased                       */
+} SAMPLE_STORE_STATUS_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SampleStore_Init(void);
+bool_t SampleStore_Append(float32_t data);
+uint16_t SampleStore_Peek(float32_t *p_data, uint16_t max);
+bool_t SampleStore_Release(uint16_t count);
+uint32_t SampleStore_GetPending(void);
+void SampleStore_GetStatus(SAMPLE_STORE_STATUS_T *p_status);
+
+/** @} (end addtogroup SampleStore)     */
+/** @} (end addtogroup Agents)          */
+
+#endif /* __SAMPLE_STORE_H__         */
@@ -11,6 +11,7 @@
 #define __SENSOR_AGENT_H__
 
 #include "../platform/sa_types.h"
+#include "../platform/sa_pt.h"
 #include "../configs/config.h"
 #include "../configs/sensor_cfg.h"
 
@@ -58,11 +59,15 @@ typedef struct {
 typedef void (*SENSOR_AGENT_OBSERVATION_T)(SENSOR_AGENT_OBS_T*);
 typedef void (*SENSOR_AGENT_ACTUATION_T)(SENSOR_AGENT_ACTS_T*);
 typedef void (*SENSOR_AGENT_ALARM_T)(SENSOR_AGENT_ERROR_T);
+typedef void (*SENSOR_AGENT_START_T)(void);
+typedef bool_t (*SENSOR_AGENT_READY_T)(void);
 
 typedef struct {
     SENSOR_AGENT_OBSERVATION_T Obs;
     SENSOR_AGENT_ACTUATION_T Act;
     SENSOR_AGENT_ALARM_T Alarm;
+    SENSOR_AGENT_START_T Start;         /* Starts an acquisition, NULL for the serial loop  */
+    SENSOR_AGENT_READY_T Ready;         /* Sample ready to observe, NULL if always ready    */
 } SENSOR_AGENT_INIT_T;
 
 
@@ -72,10 +77,12 @@ float32_t SensorAgent_GetPower(void);
 CONFIG_POWER_T *SensorAgent_GetPowerPtr(void);
 
 bool_t SensorAgent_Init(SENSOR_AGENT_OBSERVATION_T observe, SENSOR_AGENT_ACTUATION_T act, \
-                        SENSOR_AGENT_ALARM_T alarm);
+                        SENSOR_AGENT_ALARM_T alarm, SENSOR_AGENT_START_T start,
+                        SENSOR_AGENT_READY_T ready);
 void SensorAgent_Oda(SENSOR_AGENT_INTERFACE_T *p_data);
 void SensorAgent_Observe(SENSOR_AGENT_INTERFACE_T *p_data);
 void SensorAgent_Act(SENSOR_AGENT_INTERFACE_T *p_data);
+SA_PT_STATUS_T SensorAgent_ObservePt(SENSOR_AGENT_INTERFACE_T *p_data);
 
 /** @} (end addtogroup SensorAgent)       */
 /** @} (end addtogroup Agents)            */
@@ -0,0 +1,37 @@
+/**
+ * \file    supervisory_agent.h
+ *
+ * \brief   Header file for the supervisory agent.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SUPERVISORY_AGENT_H__
+#define __SUPERVISORY_AGENT_H__
+
+#include "../platform/sa_types.h"
+#include "../supervisory_agent/error_handling.h"
+
+#include "decision_engine.h"
+
+/** \addtogroup SupervisoryAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SupervisoryAgent_GetHealth(ERROR_HANDLING_HEALTH_T *p_health);
+ERROR_HANDLING_MODE_T SupervisoryAgent_GetMode(void);
+
+bool_t SupervisoryAgent_Init(DECISION_ENGINE_INIT_T *p_init);
+void SupervisoryAgent_Loop(void);
+
+/** @} (end addtogroup SupervisoryAgent)    */
+
+#endif /* __SUPERVISORY_AGENT_H__       */
@@ -49,6 +49,14 @@ typedef struct {
     TRIGGER_AGENT_OUTPUTS_T Outputs;
 } TRIGGER_AGENT_INTERFACE_T;
 
+/**
+ * \brief  Learned state of the trigger, saved in the checkpoints.
+ *
+ */
+typedef struct {
+    uint8_t Config;                     /* Index of the periodicity     */
+} TRIGGER_AGENT_CHECKPOINT_T;
+
 /************* External functions ***********/
 typedef void (*TRIGGER_AGENT_OBSERVATION_T)(TRIGGER_AGENT_OBS_T*);
 typedef void (*TRIGGER_AGENT_ACTUATION_T)(TRIGGER_AGENT_ACTS_T*);
@@ -63,6 +71,9 @@ typedef struct {
 
 /************************************** Function prototypes **************************************/
 uint32_t TriggerAgent_GetConfig(void);
+uint16_t TriggerAgent_GetGeneration(void);
+void TriggerAgent_SaveCheckpoint(TRIGGER_AGENT_CHECKPOINT_T *p_checkpoint);
+void TriggerAgent_RestoreCheckpoint(const TRIGGER_AGENT_CHECKPOINT_T *p_checkpoint);
 bool_t TriggerAgent_Init(TRIGGER_AGENT_OBSERVATION_T observe, TRIGGER_AGENT_ACTUATION_T act, \
                          TRIGGER_AGENT_ALARM_T alarm);
 void TriggerAgent_Oda(TRIGGER_AGENT_INTERFACE_T *p_data);
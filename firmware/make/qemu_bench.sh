@@ -0,0 +1,57 @@
+#!/bin/sh
+###############################################################################
+# Instructions per loop of the decision engine on a Cortex-M target, under QEMU.
+###############################################################################
+
+# Created by: David Arnaiz
+
+# Usage (from make/, the arguments are passed to make):
+#               $ make qemu_bench TARGET=CM0PLUS OPT=s
+#               $ ./qemu_bench.sh TARGET=CM4 OPT=2 LTO=true
+#
+# The loop benchmark (TEST=LOOP_BENCH) is built twice, with 0 and with LOOPS
+# loops, and both builds run under QEMU user mode with the instruction counter
+# plugin (libinsn.so from the QEMU contrib plugins). The difference of the two
+# counts excludes the start-up, the initialization and the console, so it is
+# only the cost of the loops. The instruction count is deterministic, so any
+# change of the figure is a change of the code.
+#
+# Environment:
+#   MAKE        make command, default make.
+#   QEMU        QEMU user mode emulator, default qemu-arm.
+#   QEMU_CPU    CPU model, set by make from TARGET.
+#   QEMU_PLUGIN path to libinsn.so, default libinsn.so.
+#   LOOPS       loops of the measured build, default 1000.
+
+set -e
+
+MAKE=${MAKE:-make}
+QEMU=${QEMU:-qemu-arm}
+QEMU_PLUGIN=${QEMU_PLUGIN:-libinsn.so}
+LOOPS=${LOOPS:-1000}
+BUILD=build
+
+# Builds the benchmark with the number of loops and prints the instructions executed
+count_instructions() {
+    loops=$1
+    shift
+    $MAKE clean > /dev/null
+    $MAKE test TEST=LOOP_BENCH LOOPS="$loops" "$@" > /dev/null
+    $QEMU -cpu "$QEMU_CPU" -plugin "$QEMU_PLUGIN" -d plugin -D "$BUILD/qemu_bench_$loops.log" \
+        "$BUILD/test.elf" > /dev/null
+    awk '/insns/ { count = $NF } END { print count }' "$BUILD/qemu_bench_$loops.log"
+}
+
+if [ -z "$QEMU_CPU" ]; then
+    echo "QEMU_CPU is not set, run: make qemu_bench TARGET=CM0PLUS"
+    exit 1
+fi
+
+BASE=$(count_instructions 0 "$@")
+TOTAL=$(count_instructions "$LOOPS" "$@")
+
+echo "Decision engine loop on $QEMU_CPU ($*):"
+echo "  Instructions, baseline:        $BASE"
+echo "  Instructions, $LOOPS loops:     $TOTAL"
+awk -v base="$BASE" -v total="$TOTAL" -v loops="$LOOPS" \
+    'BEGIN { printf "  Instructions per loop:         %.1f\n", (total - base) / loops }'
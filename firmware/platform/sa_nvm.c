@@ -0,0 +1,185 @@
+/**
+ * \file    sa_nvm.c
+ *
+ * \brief   File backed stand-in of the non volatile memory, with the semantics of a Flash.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SaNvm_
+ *
+ */
+
+#include <string.h>
+#include "sa_types.h"
+#include "sa_nvm.h"
+
+/** \addtogroup Platform
+ *   @{
+ */
+/** \addtogroup Nvm
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#ifndef SA_NVM_FILE
+#define SA_NVM_FILE                 "sa_nvm.bin"    /* Set by the Makefile to the build folder  */
+#endif
+#define SA_NVM_CHUNK                32u             /* Bytes copied per file access             */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static FILE *SaNvm_File = NULL;
+static uint32_t SaNvm_EraseCount[SA_NVM_SECTORS];   /* Erases since the start of the process    */
+
+/************************************** Function implementation **********************************/
+
+/**
+ * \brief  Checks that an access is inside the NVM.
+ *
+ * \param  address:  Address of the access.
+ * \param  size:     Size of the access in bytes.
+ *
+ * \return DEF_TRUE if the NVM is open and the access is inside; otherwise DEF_FALSE.
+ *
+ */
+static bool_t SaNvm_Valid(uint32_t address, uint32_t size)
+{
+    return ((NULL != SaNvm_File) && (SA_NVM_SIZE >= size) &&
+            (SA_NVM_SIZE - size >= address)) ? DEF_TRUE : DEF_FALSE;
+}
+
+/**
+ * \brief  Initializes the NVM, opening the file or creating it erased.
+ *
+ * \return DEF_OK if the NVM is available; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. It can be called again after a simulated reset, the file is kept open.
+ */
+bool_t SaNvm_Init(void)
+{
+    uint16_t sector;
+
+    if (NULL != SaNvm_File) return DEF_OK;
+
+    SaNvm_File = fopen(SA_NVM_FILE, "r+b");
+    if (NULL == SaNvm_File) {
+        SaNvm_File = fopen(SA_NVM_FILE, "w+b");
+        if (NULL == SaNvm_File) return DEF_FAIL;
+        for (sector = 0; sector < SA_NVM_SECTORS; sector++) {
+            SaNvm_EraseSector(sector);
+        }
+    }
+    memset(SaNvm_EraseCount, 0x00, sizeof(SaNvm_EraseCount));
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Reads from the NVM.
+ *
+ * \param  address:  Address to read from.
+ * \param  p_data:   Pointer to where the data will be saved.
+ * \param  size:     Bytes to read.
+ *
+ * \return DEF_OK if the data could be read; otherwise DEF_FAIL.
+ *
+ */
+bool_t SaNvm_Read(uint32_t address, void *p_data, uint32_t size)
+{
+    if (DEF_FALSE == SaNvm_Valid(address, size)) return DEF_FAIL;
+
+    if ((0 != fseek(SaNvm_File, (long) address, SEEK_SET)) ||
+        (size != fread(p_data, 1u, size, SaNvm_File))) {
+        return DEF_FAIL;
+    }
+    return DEF_OK;
+}
+
+/**
+ * \brief  Writes to the NVM.
+ *
+ * \param  address:  Address to write to.
+ * \param  p_data:   Pointer to the data.
+ * \param  size:     Bytes to write.
+ *
+ * \return DEF_OK if the data could be written; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. As in a Flash, the write can only clear bits: the result is the data ANDed with the
+ *          current content, so writing to a location which is not erased corrupts it.
+ */
+bool_t SaNvm_Write(uint32_t address, const void *p_data, uint32_t size)
+{
+    const uint8_t *p_byte = (const uint8_t *) p_data;
+    uint8_t chunk[SA_NVM_CHUNK];
+    uint32_t length, i;
+
+    if (DEF_FALSE == SaNvm_Valid(address, size)) return DEF_FAIL;
+
+    while (0u < size) {
+        length = (SA_NVM_CHUNK < size) ? SA_NVM_CHUNK : size;
+        if (DEF_FAIL == SaNvm_Read(address, chunk, length)) return DEF_FAIL;
+        for (i = 0; i < length; i++) {
+            chunk[i] &= p_byte[i];
+        }
+        if ((0 != fseek(SaNvm_File, (long) address, SEEK_SET)) ||
+            (length != fwrite(chunk, 1u, length, SaNvm_File))) {
+            return DEF_FAIL;
+        }
+        address += length;
+        p_byte += length;
+        size -= length;
+    }
+    fflush(SaNvm_File);
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Erases a sector of the NVM.
+ *
+ * \param  sector:  Sector to erase.
+ *
+ * \return DEF_OK if the sector could be erased; otherwise DEF_FAIL.
+ *
+ */
+bool_t SaNvm_EraseSector(uint16_t sector)
+{
+    uint8_t chunk[SA_NVM_CHUNK];
+    uint32_t offset;
+
+    if ((NULL == SaNvm_File) || (SA_NVM_SECTORS <= sector) ||
+        (0 != fseek(SaNvm_File, (long) SA_NVM_SECTOR_ADDRESS(sector), SEEK_SET))) {
+        return DEF_FAIL;
+    }
+    memset(chunk, SA_NVM_ERASED, sizeof(chunk));
+    for (offset = 0; offset < SA_NVM_SECTOR_SIZE; offset += SA_NVM_CHUNK) {
+        if (SA_NVM_CHUNK != fwrite(chunk, 1u, SA_NVM_CHUNK, SaNvm_File)) return DEF_FAIL;
+    }
+    fflush(SaNvm_File);
+    SaNvm_EraseCount[sector]++;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Gets the number of erases of a sector since the start, to check the wear leveling.
+ *
+ * \param  sector:  Sector.
+ *
+ * \return Erases of the sector.
+ *
+ */
+uint32_t SaNvm_GetEraseCount(uint16_t sector)
+{
+    return (SA_NVM_SECTORS > sector) ? SaNvm_EraseCount[sector] : 0u;
+}
+
+/** @} (end addtogroup Nvm)       */
+/** @} (end addtogroup Platform)  */
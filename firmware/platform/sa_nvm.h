@@ -0,0 +1,58 @@
+/**
+ * \file    sa_nvm.h
+ *
+ * \brief   Non volatile memory (NVM) of the self-awareness module.
+ *          The NVM is a Flash split in sectors: a sector is erased as a whole to
+ *          SA_NVM_ERASED, and a write can only clear bits, so a location must be erased before
+ *          it is written again.
+ *
+ * \author  David Arnaiz
+ *
+ * \note List of notes:
+ *       1. sa_nvm.c is a stand-in backed by a file (SA_NVM_FILE), which keeps the Flash
+ *          semantics, so the NVM survives the restart of the process as the Flash survives a
+ *          reset. On the mote it is replaced by the Flash driver, with the same interface.
+ *
+ */
+
+#ifndef __SA_NVM_H__
+#define __SA_NVM_H__
+
+#include "sa_types.h"
+
+/** \addtogroup Platform
+ *   @{
+ */
+
+/** \addtogroup Nvm
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SA_NVM_SECTOR_SIZE          1024u       /* Bytes per sector                 */
+#define SA_NVM_SECTORS              16u         /* Sectors of the NVM               */
+#define SA_NVM_SIZE                 (SA_NVM_SECTOR_SIZE * SA_NVM_SECTORS)
+#define SA_NVM_ERASED               0xFFu       /* Value of an erased byte          */
+
+/**
+ * \brief  Address of the start of a sector.
+ *
+ * \param  sector:  Sector number.
+ */
+#define SA_NVM_SECTOR_ADDRESS(sector)   ((uint32_t)(sector) * SA_NVM_SECTOR_SIZE)
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SaNvm_Init(void);
+bool_t SaNvm_Read(uint32_t address, void *p_data, uint32_t size);
+bool_t SaNvm_Write(uint32_t address, const void *p_data, uint32_t size);
+bool_t SaNvm_EraseSector(uint16_t sector);
+uint32_t SaNvm_GetEraseCount(uint16_t sector);
+
+/** @} (end addtogroup Nvm)            */
+/** @} (end addtogroup Platform)       */
+
+#endif /* __SA_NVM_H__       */
@@ -0,0 +1,109 @@
+/**
+ * \file    sa_pt.h
+ *
+ * \brief   Stackless coroutines (protothreads) for the resumable entry points of the agents.
+ *          A resumable function returns SA_PT_WAITING while it waits on an event, and is
+ *          called again by the scheduler to resume from the same point, so the CPU can sleep
+ *          in between without an RTOS and without a stack per agent.
+ *
+ * \author  David Arnaiz
+ *
+ * \note List of notes:
+ *       1. The resume point is a line number used as a case label, so local variables are
+ *          not kept between calls: the state of a resumable function must be static or live
+ *          in the model of the agent.
+ *       2. A switch statement can not contain a wait of the enclosing coroutine.
+ *
+ */
+
+#ifndef __SA_PT_H__
+#define __SA_PT_H__
+
+#include "sa_types.h"
+
+/** \addtogroup Platform
+ *   @{
+ */
+
+/** \addtogroup Coroutines
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/**
+ * \brief  Initializes a coroutine, so the next call starts from the beginning.
+ *
+ * \param  pt:  Pointer to the coroutine state, SA_PT_T.
+ */
+#define SA_PT_INIT(pt)              ((pt)->Line = 0u)
+
+/**
+ * \brief  Starts the body of a coroutine, jumping to the resume point.
+ *
+ * \param  pt:  Pointer to the coroutine state, SA_PT_T.
+ */
+#define SA_PT_BEGIN(pt)             switch ((pt)->Line) { case 0u:
+
+/**
+ * \brief  Ends the body of a coroutine. The coroutine returns SA_PT_DONE and restarts in the
+ *         next call.
+ *
+ * \param  pt:  Pointer to the coroutine state, SA_PT_T.
+ */
+#define SA_PT_END(pt)               } SA_PT_INIT(pt); return SA_PT_DONE
+
+/**
+ * \brief  Waits until a condition is true, returning SA_PT_WAITING meanwhile.
+ *
+ * \param  pt:    Pointer to the coroutine state, SA_PT_T.
+ * \param  cond:  Condition evaluated every time the coroutine is resumed.
+ */
+#define SA_PT_WAIT_UNTIL(pt, cond)                                              \
+    do {                                                                        \
+        (pt)->Line = __LINE__; case __LINE__:                                   \
+        if (!(cond)) return SA_PT_WAITING;                                      \
+    } while (0)
+
+/**
+ * \brief  Waits while a condition is true.
+ *
+ * \param  pt:    Pointer to the coroutine state, SA_PT_T.
+ * \param  cond:  Condition evaluated every time the coroutine is resumed.
+ */
+#define SA_PT_WAIT_WHILE(pt, cond)  SA_PT_WAIT_UNTIL((pt), !(cond))
+
+/**
+ * \brief  Waits until a child coroutine is done.
+ *
+ * \param  pt:     Pointer to the coroutine state, SA_PT_T.
+ * \param  child:  Call to the child coroutine, resumed every time the coroutine is resumed.
+ */
+#define SA_PT_WAIT_THREAD(pt, child)    SA_PT_WAIT_WHILE((pt), SA_PT_WAITING == (child))
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Result of a call to a resumable function.
+ *
+ */
+typedef enum {
+    SA_PT_WAITING = 0,          /* Waiting on an event, call again to resume    */
+    SA_PT_DONE,                 /* Completed                                    */
+} SA_PT_STATUS_T;
+
+/**
+ * \brief  State of a coroutine.
+ *
+ */
+typedef struct {
+    uint16_t Line;              /* Resume point, 0 for the beginning            */
+} SA_PT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/** @} (end addtogroup Coroutines)     */
+/** @} (end addtogroup Platform)       */
+
+#endif /* __SA_PT_H__       */
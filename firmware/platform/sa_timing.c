@@ -0,0 +1,99 @@
+/**
+ * \file    sa_timing.c
+ *
+ * \brief   Cycle counter used to measure the execution time of the self-awareness module.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SaTiming_
+ *
+ */
+
+#include "sa_types.h"
+#include "sa_timing.h"
+
+#if (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)) && !defined(SA_TIMING_NO_DWT)
+#define SA_TIMING_DWT
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__) && !defined(__ARM_ARCH_6M__)
+#include <time.h>
+#endif
+
+/** \addtogroup Platform
+ *   @{
+ */
+/** \addtogroup Timing
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************* Cortex-M DWT *****************/
+#define SA_TIMING_DEMCR             (*(volatile uint32_t *)0xE000EDFCu)
+#define SA_TIMING_DWT_CTRL          (*(volatile uint32_t *)0xE0001000u)
+#define SA_TIMING_DWT_CYCCNT        (*(volatile uint32_t *)0xE0001004u)
+#define SA_TIMING_DEMCR_TRCENA      (1u << 24)
+#define SA_TIMING_DWT_CYCCNTENA     (1u << 0)
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function implementation **********************************/
+
+/**
+ * \brief  Initializes the cycle counter.
+ *
+ * \note List of notes:
+ *       1. Only the Cortex-M3/M4 targets need to enable the counter, the host counters are
+ *          always running.
+ *       2. With SA_TIMING_NO_DWT the debug registers are not touched, as QEMU user mode does
+ *          not map them and the access faults.
+ */
+void SaTiming_Init(void)
+{
+#ifdef SA_TIMING_DWT
+    SA_TIMING_DEMCR |= SA_TIMING_DEMCR_TRCENA;
+    SA_TIMING_DWT_CYCCNT = 0;
+    SA_TIMING_DWT_CTRL |= SA_TIMING_DWT_CYCCNTENA;
+#endif
+}
+
+/**
+ * \brief  Reads the cycle counter.
+ *
+ * \return Current value of the cycle counter.
+ *
+ * \note List of notes:
+ *       1. On Cortex-M3/M4 this is the DWT cycle counter.
+ *       2. On x86 hosts this is the time stamp counter, which counts reference cycles and not
+ *          core cycles, so the values are only an approximation of the target figures.
+ *       3. Cortex-M0/M0+ have no cycle counter, and neither has a Cortex-M3/M4 built with
+ *          SA_TIMING_NO_DWT, so 0 is returned. Their figures are the instruction counts of the
+ *          QEMU benchmark runner (make qemu_bench).
+ *       4. On any other target the monotonic clock in ns is used instead.
+ */
+uint32_t SaTiming_GetCycles(void)
+{
+#ifdef SA_TIMING_DWT
+    return SA_TIMING_DWT_CYCCNT;
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t) __rdtsc();
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    return 0u;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) (now.tv_sec * 1000000000ull + now.tv_nsec);
+#endif
+}
+
+/** @} (end addtogroup Timing)    */
+/** @} (end addtogroup Platform)  */
@@ -0,0 +1,44 @@
+/**
+ * \file    sa_timing.h
+ *
+ * \brief   Cycle counter used to measure the execution time of the self-awareness module.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SA_TIMING_H__
+#define __SA_TIMING_H__
+
+#include "sa_types.h"
+
+/** \addtogroup Platform
+ *   @{
+ */
+
+/** \addtogroup Timing
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/**
+ * \brief  Cycles elapsed since a previous reading of the cycle counter.
+ *
+ * \param  start:  Previous reading of SaTiming_GetCycles().
+ * \return Elapsed cycles, the counter wrap around is handled by the unsigned arithmetic.
+ */
+#define SA_TIMING_ELAPSED(start)    ((uint32_t)(SaTiming_GetCycles() - (uint32_t)(start)))
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SaTiming_Init(void);
+uint32_t SaTiming_GetCycles(void);
+
+/** @} (end addtogroup Timing)         */
+/** @} (end addtogroup Platform)       */
+
+#endif /* __SA_TIMING_H__       */
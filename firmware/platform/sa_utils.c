@@ -71,7 +71,7 @@ void SaUtils_Average(float32_t *p_avg, float32_t value, float32_t *p_buff, uint1
 
     if (DEF_FALSE == *p_init) {
         *p_avg = (((*p_avg) * (*p_point - 1)) + value)/(*p_point);
-        if (*p_point >= size) *p_init = DEF_FALSE;
+        if (*p_point >= size) *p_init = DEF_TRUE;
     } else {
         *p_avg += (value - prev_value) / size;
     }
@@ -118,5 +118,91 @@ float32_t SaUtils_UpdateValue(float32_t pred, float32_t obs, float32_t gain) {
     return (pred + gain * error);
 }
 
+/**
+ * \brief  Fast approximation of the natural logarithm.
+ *
+ * \param  value:  Value for which to compute the logarithm, must be positive.
+ *
+ * \return ln(value), with an absolute error below 2e-4.
+ *
+ * \note List of notes:
+ *       1. The exponent is taken from the float representation and the logarithm of the
+ *          mantissa m in [1, 2) is computed with the series ln(m) = 2*atanh((m-1)/(m+1)).
+ *       2. This avoids the cost of the math library logarithm in the per-activation path of
+ *          the agents.
+ */
+float32_t SaUtils_FastLn(float32_t value)
+{
+    union {
+        float32_t f;
+        uint32_t  i;
+    } bits;
+    float32_t exponent, s, s2;
+
+    bits.f = value;
+    exponent = (float32_t)((int32_t)((bits.i >> 23) & 0xFFu) - 127);
+    bits.i = (bits.i & 0x007FFFFFu) | 0x3F800000u;
+
+    s = (bits.f - 1.0f) / (bits.f + 1.0f);
+    s2 = s * s;
+
+    return (exponent * SA_UTILS_LN_2) + 2.0f * s * (1.0f + s2 * (0.33333333f + s2 * 0.2f));
+}
+
+/**
+ * \brief  Linear interpolation in a table with a fixed step.
+ *
+ * \param  p_table:   Pointer to the table.
+ * \param  size:      Number of points of the table, at least 2.
+ * \param  position:  Position in the table in units of the step, (x - x0) / step.
+ * \param  p_slope:   Pointer to where the slope per step will be saved.
+ *
+ * \return Interpolated value. Out of range positions are saturated to the table limits.
+ *
+ * \note List of notes:
+ *       1. The segment is found with a conversion instead of a search, and the saturation and
+ *          the last point correction are done without branches, so the time does not depend
+ *          on the position.
+ */
+float32_t SaUtils_Interpolate(const float32_t *p_table, uint16_t size, float32_t position,
+                              float32_t *p_slope)
+{
+    uint32_t index;
+
+    position = SA_UTILS_SATURATE(0.0f, (float32_t)(size - 1u), position);
+    index = (uint32_t) position;
+    index -= (uint32_t)(index >= (uint32_t)(size - 1u));
+
+    *p_slope = p_table[index + 1u] - p_table[index];
+    return p_table[index] + (position - index) * (*p_slope);
+}
+
+/**
+ * \brief  CRC-16-CCITT (polynomial 0x1021) of a buffer.
+ *
+ * \param  p_data:  Pointer to the data.
+ * \param  size:    Size of the data in bytes.
+ * \param  crc:     Initial value, SA_UTILS_CRC16_INIT, or the CRC of the previous part of the data.
+ *
+ * \return CRC of the data.
+ *
+ * \note List of notes:
+ *       1. Computed bit by bit, without a table, since it is only used on checkpoints and the
+ *          table would take 512 bytes of Flash.
+ */
+uint16_t SaUtils_Crc16(const void *p_data, uint32_t size, uint16_t crc)
+{
+    const uint8_t *p_byte = (const uint8_t *) p_data;
+    uint8_t bit;
+
+    while (0u < size--) {
+        crc ^= (uint16_t)(*p_byte++) << 8;
+        for (bit = 0; bit < 8u; bit++) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
 /** @} (end addtogroup Utils)     */
 /** @} (end addtogroup Platform)  */
@@ -39,6 +39,8 @@
 
 /* Values   */
 #define SA_UTILS_MAX_UINT32_T          0xFFFFFFFF
+#define SA_UTILS_LN_2                  0.69314718f
+#define SA_UTILS_CRC16_INIT            0xFFFFu
 
 /************* Utils ************************/
 /**
@@ -108,6 +110,10 @@ void SaUtils_Average(float32_t *p_avg, float32_t value, float32_t *p_buff, uint1
                      uint16_t *p_point, bool_t *p_init);
 float32_t SaUtils_ChangeRate(float32_t value, float32_t prev, float32_t min);
 float32_t SaUtils_UpdateValue(float32_t pred, float32_t obs, float32_t gain);
+float32_t SaUtils_FastLn(float32_t value);
+float32_t SaUtils_Interpolate(const float32_t *p_table, uint16_t size, float32_t position,
+                              float32_t *p_slope);
+uint16_t SaUtils_Crc16(const void *p_data, uint32_t size, uint16_t crc);
 
 /** @} (end addtogroup Utils)          */
 /** @} (end addtogroup Platform)       */
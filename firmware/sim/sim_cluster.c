@@ -0,0 +1,621 @@
+/**
+ * \file    sim_cluster.c
+ *
+ * \brief   Simulation of a cluster of neighboring nodes that overhear each other.
+ *          The decision engine keeps its state in static variables, so each node runs
+ *          SimNode in its own process, and the parent keeps the processes in lockstep in
+ *          virtual time: before each activation a node asks for the frames it heard up to
+ *          that time, and the parent only answers the node with the earliest activation, so
+ *          no node runs ahead of a frame it could hear. The samples a node transmits are
+ *          sent to the parent, which delivers them to the sink and, in the cooperative mode,
+ *          queues them for the neighbors of the node. Without it the nodes do not listen.
+ *          The sink rebuilds the field with the freshest sample of each node or of one of
+ *          its neighbors, the latter corrected by the offset between both nodes learned from
+ *          their samples, and the error of the rebuilt field is integrated over time against
+ *          the true data of every node.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimCluster_
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define SIM_CLUSTER_FORK                        /* Nodes as processes       */
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../include/trigger_agent.h"
+#include "../include/app_agent.h"
+#include "../include/power_agent.h"
+
+#include "sim_kernel.h"
+#include "sim_node.h"
+#include "sim_workers.h"
+#include "sim_cluster.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimCluster
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Messages between the parent and the node processes.
+ *
+ */
+typedef enum {
+    SIM_CLUSTER_LISTEN = 0,             /* Node waiting for its frames, or end of the frames    */
+    SIM_CLUSTER_FRAME,                  /* Sample transmitted by a node                         */
+    SIM_CLUSTER_DONE,                   /* Node finished, its result follows                    */
+} SIM_CLUSTER_MESSAGE_T;
+
+/**
+ * \brief  Frame of a sample, as heard by the neighbors and the sink.
+ *
+ */
+typedef struct {
+    uint8_t Type;                       /* See SIM_CLUSTER_MESSAGE_T                            */
+    uint16_t Node;
+    uint32_t Period;
+    float32_t Data;
+    float32_t Charge;                   /* Remaining charge of the node in %                    */
+    SIM_TIME_T Time;
+} SIM_CLUSTER_FRAME_T;
+
+/**
+ * \brief  Field rebuilt by the sink, and its error integrated over time.
+ *
+ */
+typedef struct {
+    SIM_TIME_T Time;                    /* Time of the last accounting                          */
+    uint16_t Input[SIM_CLUSTER_MAX_NODES];              /* Next input of each node              */
+    float32_t Truth[SIM_CLUSTER_MAX_NODES];             /* True data of each node               */
+    SIM_CLUSTER_FRAME_T Last[SIM_CLUSTER_MAX_NODES];    /* Last frame of each node              */
+    float64_t Offset[SIM_CLUSTER_MAX_NODES][SIM_CLUSTER_MAX_NODES]; /* Data of a node minus another */
+    bool_t Paired[SIM_CLUSTER_MAX_NODES][SIM_CLUSTER_MAX_NODES];    /* The offset is known          */
+    float64_t Error;                    /* Absolute and squared errors                          */
+    float64_t Squared;
+    float64_t Data;                     /* True data and its square, for the deviation          */
+    float64_t Squares;
+} SIM_CLUSTER_SINK_T;
+
+#ifdef SIM_CLUSTER_FORK
+/**
+ * \brief  Process of a node, as seen by the parent.
+ *
+ */
+typedef struct {
+    pid_t Pid;
+    int Up;                             /* Read end of the messages of the node                 */
+    int Down;                           /* Write end of the frames heard by the node            */
+    SIM_TIME_T Wait;                    /* Activation waiting, SIM_KERNEL_NEVER when finished   */
+    SIM_CLUSTER_FRAME_T Queue[SIM_CLUSTER_RX_QUEUE];    /* Frames heard, the newest kept        */
+    uint16_t Head;
+    uint16_t Count;
+} SIM_CLUSTER_PROCESS_T;
+#endif
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static const SIM_CLUSTER_CFG_T *SimCluster_Cfg;
+static SIM_CLUSTER_SINK_T SimCluster_Sink;
+#ifdef SIM_CLUSTER_FORK
+static SIM_CLUSTER_PROCESS_T SimCluster_Processes[SIM_CLUSTER_MAX_NODES];
+
+/* Node process */
+static uint16_t SimCluster_Node;
+static int SimCluster_Up = -1;                  /* Write end of the messages to the parent  */
+static int SimCluster_Down = -1;                /* Read end of the frames heard             */
+#endif
+
+/************************************** Function implementation **********************************/
+
+/************* Sink *************************/
+/**
+ * \brief  Applies the inputs of the true data up to a time.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ */
+static void SimCluster_Inputs(SIM_TIME_T time)
+{
+    SIM_CLUSTER_SINK_T *p_sink = &SimCluster_Sink;
+    const SIM_NODE_CFG_T *p_node;
+    uint16_t node;
+
+    for (node = 0; node < SimCluster_Cfg->Nodes; node++) {
+        p_node = &SimCluster_Cfg->Node[node];
+        while ((p_sink->Input[node] < p_node->NumInputs) && (p_node->Inputs[p_sink->Input[node]].Time <= time)) {
+            p_sink->Truth[node] = p_node->Inputs[p_sink->Input[node]].Data;
+            p_sink->Input[node]++;
+        }
+    }
+}
+
+/**
+ * \brief  Estimates the data of a node at the sink.
+ *
+ * \param  node:  Node.
+ *
+ * \return Estimated data.
+ *
+ * \note List of notes:
+ *       1. The freshest sample of the node or of a neighbor is used, the own sample on a tie.
+ *          Before any sample, the estimate is SIM_NODE_SENSOR_DATA, as in SimNode.
+ */
+static float64_t SimCluster_Estimate(uint16_t node)
+{
+    const SIM_CLUSTER_SINK_T *p_sink = &SimCluster_Sink;
+    const SIM_CLUSTER_FRAME_T *p_best = &p_sink->Last[node];
+    float64_t estimate = (SIM_CLUSTER_FRAME == p_best->Type) ? p_best->Data : SIM_NODE_SENSOR_DATA;
+    uint16_t neighbor;
+
+    for (neighbor = 0; neighbor < SimCluster_Cfg->Nodes; neighbor++) {
+        if ((0u == (SimCluster_Cfg->Neighbors[node] & (1uL << neighbor))) ||
+            (DEF_FALSE == p_sink->Paired[node][neighbor]) || (p_sink->Last[neighbor].Time <= p_best->Time)) {
+            continue;
+        }
+        p_best = &p_sink->Last[neighbor];
+        estimate = p_best->Data + p_sink->Offset[node][neighbor];
+    }
+
+    return estimate;
+}
+
+/**
+ * \brief  Accounts the error of the field at the sink from the last accounting up to a time.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ * \note List of notes:
+ *       1. The inputs hold the true data and the sink holds its estimates between the steps
+ *          and the frames, so each gap is a single term.
+ */
+static void SimCluster_Track(SIM_TIME_T time)
+{
+    SIM_CLUSTER_SINK_T *p_sink = &SimCluster_Sink;
+    const SIM_NODE_CFG_T *p_node;
+    SIM_TIME_T next;
+    float64_t error, gap;
+    uint16_t node;
+
+    while (p_sink->Time < time) {
+        next = time;
+        for (node = 0; node < SimCluster_Cfg->Nodes; node++) {
+            p_node = &SimCluster_Cfg->Node[node];
+            if (p_sink->Input[node] < p_node->NumInputs) {
+                next = SA_UTILS_MIN(next, p_node->Inputs[p_sink->Input[node]].Time);
+            }
+        }
+        gap = (float64_t)(next - p_sink->Time);
+        for (node = 0; node < SimCluster_Cfg->Nodes; node++) {
+            error = p_sink->Truth[node] - SimCluster_Estimate(node);
+            p_sink->Error += fabs(error) * gap;
+            p_sink->Squared += error * error * gap;
+            p_sink->Data += p_sink->Truth[node] * gap;
+            p_sink->Squares += (float64_t) p_sink->Truth[node] * p_sink->Truth[node] * gap;
+        }
+        p_sink->Time = next;
+        SimCluster_Inputs(next);
+    }
+}
+
+/**
+ * \brief  Receives a frame at the sink.
+ *
+ * \param  p_frame:  Pointer to the frame.
+ *
+ * \note List of notes:
+ *       1. The offset between the node and each neighbor is an exponential average of gain
+ *          SIM_CLUSTER_OFFSET_GAIN of the difference with the last sample of the neighbor,
+ *          when it is not older than SIM_CLUSTER_PAIR_AGE.
+ *       2. The frames arrive in the order of time, see SimCluster_Fork.
+ */
+static void SimCluster_Receive(const SIM_CLUSTER_FRAME_T *p_frame)
+{
+    SIM_CLUSTER_SINK_T *p_sink = &SimCluster_Sink;
+    uint16_t node = p_frame->Node, neighbor;
+    float64_t difference;
+
+    SimCluster_Track(p_frame->Time);
+    for (neighbor = 0; neighbor < SimCluster_Cfg->Nodes; neighbor++) {
+        if ((0u == (SimCluster_Cfg->Neighbors[node] & (1uL << neighbor))) ||
+            (SIM_CLUSTER_FRAME != p_sink->Last[neighbor].Type) ||
+            (SIM_CLUSTER_PAIR_AGE < p_frame->Time - p_sink->Last[neighbor].Time)) {
+            continue;
+        }
+        difference = p_frame->Data - p_sink->Last[neighbor].Data;
+        if (DEF_TRUE == p_sink->Paired[node][neighbor]) {
+            p_sink->Offset[node][neighbor] += SIM_CLUSTER_OFFSET_GAIN * (difference - p_sink->Offset[node][neighbor]);
+        } else {
+            p_sink->Offset[node][neighbor] = difference;
+            p_sink->Paired[node][neighbor] = DEF_TRUE;
+            p_sink->Paired[neighbor][node] = DEF_TRUE;
+        }
+        p_sink->Offset[neighbor][node] = -p_sink->Offset[node][neighbor];
+    }
+    p_sink->Last[node] = *p_frame;
+}
+
+#ifdef SIM_CLUSTER_FORK
+/************* Pipes ************************/
+/**
+ * \brief  Reads a message from a pipe.
+ *
+ * \param  fd:      Read end of the pipe.
+ * \param  p_data:  Pointer to where the message will be saved.
+ * \param  size:    Size of the message.
+ *
+ * \return DEF_OK if the whole message could be read; otherwise DEF_FAIL.
+ *
+ */
+static bool_t SimCluster_Read(int fd, void *p_data, size_t size)
+{
+    uint8_t *p_byte = (uint8_t *) p_data;
+    ssize_t count;
+
+    while (0u < size) {
+        count = read(fd, p_byte, size);
+        if (0 >= count) return DEF_FAIL;
+        p_byte += count;
+        size -= (size_t) count;
+    }
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Writes a message to a pipe.
+ *
+ * \param  fd:      Write end of the pipe.
+ * \param  p_data:  Pointer to the message.
+ * \param  size:    Size of the message, below PIPE_BUF so it is written at once.
+ *
+ * \return DEF_OK if the message could be written; otherwise DEF_FAIL.
+ *
+ */
+static bool_t SimCluster_Write(int fd, const void *p_data, size_t size)
+{
+    return ((ssize_t) size == write(fd, p_data, size)) ? DEF_OK : DEF_FAIL;
+}
+
+/************* Node process *****************/
+/**
+ * \brief  Waits for the frames heard up to an activation and gives them to the app agent.
+ *
+ * \param  time:  Virtual time of the activation in ms.
+ *
+ * \return Frames heard.
+ *
+ */
+static uint32_t SimCluster_Listen(SIM_TIME_T time)
+{
+    SIM_CLUSTER_FRAME_T frame;
+    uint32_t frames = 0;
+
+    memset(&frame, 0x00, sizeof(SIM_CLUSTER_FRAME_T));
+    frame.Type = SIM_CLUSTER_LISTEN;
+    frame.Node = SimCluster_Node;
+    frame.Time = time;
+    if (DEF_FAIL == SimCluster_Write(SimCluster_Up, &frame, sizeof(SIM_CLUSTER_FRAME_T))) _exit(EXIT_FAILURE);
+
+    while (1) {
+        if (DEF_FAIL == SimCluster_Read(SimCluster_Down, &frame, sizeof(SIM_CLUSTER_FRAME_T))) _exit(EXIT_FAILURE);
+        if (SIM_CLUSTER_FRAME != frame.Type) break;
+        AppAgent_Overhear(frame.Node, frame.Data, frame.Period, frame.Charge);
+        frames++;
+    }
+
+    return frames;
+}
+
+/**
+ * \brief  Sends a transmitted sample, with the periodicity and the remaining charge of the node.
+ *
+ * \param  time:  Virtual time of the transmission in ms.
+ * \param  data:  Sample.
+ *
+ */
+static void SimCluster_Send(SIM_TIME_T time, float32_t data)
+{
+    SIM_CLUSTER_FRAME_T frame;
+
+    memset(&frame, 0x00, sizeof(SIM_CLUSTER_FRAME_T));
+    frame.Type = SIM_CLUSTER_FRAME;
+    frame.Node = SimCluster_Node;
+    frame.Time = time;
+    frame.Data = data;
+    frame.Period = TriggerAgent_GetConfig();
+    frame.Charge = PowerAgent_GetRemainingChargePerc();
+    if (DEF_FAIL == SimCluster_Write(SimCluster_Up, &frame, sizeof(SIM_CLUSTER_FRAME_T))) _exit(EXIT_FAILURE);
+}
+
+/**
+ * \brief  Simulates a node in its process, and sends its result to the parent.
+ *
+ * \param  node:  Node.
+ * \param  up:    Write end of the messages to the parent.
+ * \param  down:  Read end of the frames heard.
+ *
+ * \return Exit status of the process.
+ *
+ */
+static int SimCluster_Process(uint16_t node, int up, int down)
+{
+    SIM_NODE_CFG_T cfg = SimCluster_Cfg->Node[node];
+    SIM_NODE_RESULT_T result;
+    SIM_CLUSTER_FRAME_T done;
+
+    SimCluster_Node = node;
+    SimCluster_Up = up;
+    SimCluster_Down = down;
+
+    cfg.Node = node;
+    cfg.Cooperative = SimCluster_Cfg->Cooperative;
+    cfg.Horizon = SimCluster_Cfg->Horizon;
+    cfg.Listen = SimCluster_Listen;
+    cfg.Send = SimCluster_Send;
+    if (DEF_FAIL == SimNode_Run(&cfg, &result)) return EXIT_FAILURE;
+
+    memset(&done, 0x00, sizeof(SIM_CLUSTER_FRAME_T));
+    done.Type = SIM_CLUSTER_DONE;
+    done.Node = node;
+    if ((DEF_FAIL == SimCluster_Write(up, &done, sizeof(SIM_CLUSTER_FRAME_T))) ||
+        (DEF_FAIL == SimCluster_Write(up, &result, sizeof(SIM_NODE_RESULT_T)))) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/************* Parent ***********************/
+/**
+ * \brief  Queues a frame for a node that hears it.
+ *
+ * \param  node:     Node.
+ * \param  p_frame:  Pointer to the frame.
+ *
+ * \note List of notes:
+ *       1. A node holds SIM_CLUSTER_RX_QUEUE frames between its activations, and a new frame
+ *          replaces the oldest one.
+ */
+static void SimCluster_Queue(uint16_t node, const SIM_CLUSTER_FRAME_T *p_frame)
+{
+    SIM_CLUSTER_PROCESS_T *p_process = &SimCluster_Processes[node];
+
+    if (SIM_KERNEL_NEVER == p_process->Wait) return;
+    p_process->Queue[(p_process->Head + p_process->Count) % SIM_CLUSTER_RX_QUEUE] = *p_frame;
+    if (SIM_CLUSTER_RX_QUEUE > p_process->Count) {
+        p_process->Count++;
+    } else {
+        p_process->Head = (p_process->Head + 1u) % SIM_CLUSTER_RX_QUEUE;
+    }
+}
+
+/**
+ * \brief  Delivers the queued frames to a waiting node, which then runs its activation.
+ *
+ * \param  node:  Node.
+ *
+ * \return DEF_OK if the frames could be delivered; otherwise DEF_FAIL.
+ *
+ */
+static bool_t SimCluster_Deliver(uint16_t node)
+{
+    SIM_CLUSTER_PROCESS_T *p_process = &SimCluster_Processes[node];
+    SIM_CLUSTER_FRAME_T end;
+
+    for (; 0u < p_process->Count; p_process->Count--) {
+        if (DEF_FAIL == SimCluster_Write(p_process->Down, &p_process->Queue[p_process->Head],
+                                         sizeof(SIM_CLUSTER_FRAME_T))) {
+            return DEF_FAIL;
+        }
+        p_process->Head = (p_process->Head + 1u) % SIM_CLUSTER_RX_QUEUE;
+    }
+    memset(&end, 0x00, sizeof(SIM_CLUSTER_FRAME_T));
+    end.Type = SIM_CLUSTER_LISTEN;
+
+    return SimCluster_Write(p_process->Down, &end, sizeof(SIM_CLUSTER_FRAME_T));
+}
+
+/**
+ * \brief  Serves a running node until it waits for its next activation or it finishes.
+ *
+ * \param  node:      Node.
+ * \param  p_result:  Pointer to the result of the cluster.
+ *
+ * \return DEF_OK if the messages of the node could be read; otherwise DEF_FAIL.
+ *
+ */
+static bool_t SimCluster_Serve(uint16_t node, SIM_CLUSTER_RESULT_T *p_result)
+{
+    SIM_CLUSTER_PROCESS_T *p_process = &SimCluster_Processes[node];
+    SIM_CLUSTER_FRAME_T frame;
+    uint16_t neighbor;
+
+    while (DEF_OK == SimCluster_Read(p_process->Up, &frame, sizeof(SIM_CLUSTER_FRAME_T))) {
+        if (SIM_CLUSTER_LISTEN == frame.Type) {
+            p_process->Wait = frame.Time;
+            return DEF_OK;
+        }
+        if (SIM_CLUSTER_DONE == frame.Type) {
+            p_process->Wait = SIM_KERNEL_NEVER;
+            return SimCluster_Read(p_process->Up, &p_result->Node[node], sizeof(SIM_NODE_RESULT_T));
+        }
+        SimCluster_Receive(&frame);
+        p_result->Frames++;
+        for (neighbor = 0; (DEF_TRUE == SimCluster_Cfg->Cooperative) && (neighbor < SimCluster_Cfg->Nodes); neighbor++) {
+            if (0u != (SimCluster_Cfg->Neighbors[neighbor] & (1uL << node))) SimCluster_Queue(neighbor, &frame);
+        }
+    }
+
+    return DEF_FAIL;
+}
+
+/**
+ * \brief  Runs the nodes in their processes, in lockstep.
+ *
+ * \param  p_result:  Pointer to the result of the cluster.
+ *
+ * \return DEF_OK if every node could run; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. All the nodes but the served one wait for their frames, so the served node has the
+ *          earliest activation, the lowest index on a tie, and the frames it sends are not
+ *          earlier than any frame sent before.
+ *       2. A node process closes the pipes of the nodes forked before it, so a node sees the
+ *          end of its pipe when the parent closes it.
+ */
+static bool_t SimCluster_Fork(SIM_CLUSTER_RESULT_T *p_result)
+{
+    SIM_CLUSTER_PROCESS_T *p_process;
+    uint16_t node, next, other;
+    int up[2], down[2], status;
+    bool_t result = DEF_OK;
+
+    fflush(stdout);                     /* Not printed again by the nodes   */
+    for (node = 0; node < SimCluster_Cfg->Nodes; node++) {
+        p_process = &SimCluster_Processes[node];
+        memset(p_process, 0x00, sizeof(SIM_CLUSTER_PROCESS_T));
+        p_process->Pid = -1;
+        p_process->Up = -1;
+        p_process->Down = -1;
+        p_process->Wait = SIM_KERNEL_NEVER;
+        if ((DEF_FAIL == result) || (0 != pipe(up))) {
+            result = DEF_FAIL;
+            continue;
+        }
+        if (0 != pipe(down)) {
+            close(up[0]);
+            close(up[1]);
+            result = DEF_FAIL;
+            continue;
+        }
+        p_process->Pid = fork();
+        if (0 == p_process->Pid) {
+            close(up[0]);
+            close(down[1]);
+            for (other = 0; other < node; other++) {
+                close(SimCluster_Processes[other].Up);
+                close(SimCluster_Processes[other].Down);
+            }
+            _exit(SimCluster_Process(node, up[1], down[0]));
+        }
+        close(up[1]);
+        close(down[0]);
+        if (0 > p_process->Pid) {
+            close(up[0]);
+            close(down[1]);
+            result = DEF_FAIL;
+        } else {
+            p_process->Up = up[0];
+            p_process->Down = down[1];
+            result = SimCluster_Serve(node, p_result);
+        }
+    }
+
+    while (DEF_OK == result) {
+        next = SimCluster_Cfg->Nodes;
+        for (node = 0; node < SimCluster_Cfg->Nodes; node++) {
+            if ((SIM_KERNEL_NEVER != SimCluster_Processes[node].Wait) &&
+                ((SimCluster_Cfg->Nodes == next) ||
+                 (SimCluster_Processes[node].Wait < SimCluster_Processes[next].Wait))) {
+                next = node;
+            }
+        }
+        if (SimCluster_Cfg->Nodes == next) break;
+        result = SimCluster_Deliver(next);
+        if (DEF_OK == result) result = SimCluster_Serve(next, p_result);
+    }
+
+    for (node = 0; node < SimCluster_Cfg->Nodes; node++) {
+        p_process = &SimCluster_Processes[node];
+        if (0 <= p_process->Up) close(p_process->Up);
+        if (0 <= p_process->Down) close(p_process->Down);
+        if (0 > p_process->Pid) continue;
+        if ((p_process->Pid != waitpid(p_process->Pid, &status, 0)) ||
+            (0 == WIFEXITED(status)) || (EXIT_SUCCESS != WEXITSTATUS(status))) {
+            result = DEF_FAIL;
+        }
+    }
+
+    return result;
+}
+#endif
+
+/************* External *********************/
+/**
+ * \brief  Simulates the cluster from fresh batteries until the horizon.
+ *
+ * \param  p_cfg:     Pointer to the configuration of the cluster.
+ * \param  p_result:  Pointer to where the result will be saved.
+ *
+ * \return DEF_OK if the simulation could run; otherwise DEF_FAIL, also without processes.
+ *
+ * \note List of notes:
+ *       1. Every node runs until the horizon of the cluster, with its identifier as index in
+ *          the cluster and without fast-forward, see SimNode_Activation.
+ *       2. The true data of a node are its inputs, so the nodes can not use a trace.
+ *       3. The charge per day of the cluster is the sum of the charge per day of each node
+ *          over its lifetime.
+ */
+bool_t SimCluster_Run(const SIM_CLUSTER_CFG_T *p_cfg, SIM_CLUSTER_RESULT_T *p_result)
+{
+    const SIM_NODE_RESULT_T *p_node;
+    float64_t start = SimWorkers_Wall(), time, mean;
+    bool_t result = DEF_FAIL;
+    uint16_t node;
+
+    if ((0u == p_cfg->Nodes) || (SIM_CLUSTER_MAX_NODES < p_cfg->Nodes) || (0u == p_cfg->Horizon)) {
+        return DEF_FAIL;
+    }
+    for (node = 0; node < p_cfg->Nodes; node++) {
+        if (NULL != p_cfg->Node[node].Trace) return DEF_FAIL;
+    }
+
+    SimCluster_Cfg = p_cfg;
+    memset(p_result, 0x00, sizeof(SIM_CLUSTER_RESULT_T));
+    memset(&SimCluster_Sink, 0x00, sizeof(SIM_CLUSTER_SINK_T));
+    for (node = 0; node < p_cfg->Nodes; node++) {
+        SimCluster_Sink.Truth[node] = SIM_NODE_SENSOR_DATA;
+    }
+    SimCluster_Inputs(0u);
+
+#ifdef SIM_CLUSTER_FORK
+    result = SimCluster_Fork(p_result);
+#endif
+    if (DEF_FAIL == result) return DEF_FAIL;
+    SimCluster_Track(p_cfg->Horizon);
+
+    time = (float64_t) p_cfg->Horizon * p_cfg->Nodes;
+    mean = SimCluster_Sink.Data / time;
+    p_result->Error = SimCluster_Sink.Error / time;
+    p_result->Rmse = sqrt(SimCluster_Sink.Squared / time);
+    p_result->Deviation = sqrt(SA_UTILS_MAX(SimCluster_Sink.Squares / time - mean * mean, 0.0));
+    for (node = 0; node < p_cfg->Nodes; node++) {
+        p_node = &p_result->Node[node];
+        if (0u == p_node->Lifetime) continue;
+        p_result->Charge += (p_node->ActiveCharge + p_node->IdleCharge) * SA_UTILS_DAYS_TO_MILLI_S /
+                            p_node->Lifetime;
+    }
+    p_result->Wall = SimWorkers_Wall() - start;
+
+    return DEF_OK;
+}
+
+/** @} (end addtogroup SimCluster)  */
+/** @} (end addtogroup Simulation)  */
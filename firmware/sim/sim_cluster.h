@@ -0,0 +1,67 @@
+/**
+ * \file    sim_cluster.h
+ *
+ * \brief   Header file for the simulation of a cluster of neighboring nodes.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_CLUSTER_H__
+#define __SIM_CLUSTER_H__
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+
+#include "sim_kernel.h"
+#include "sim_node.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimCluster
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SIM_CLUSTER_MAX_NODES       16u         /* Maximum nodes of a cluster                   */
+#define SIM_CLUSTER_RX_QUEUE        8u          /* Frames a node holds between its activations  */
+#define SIM_CLUSTER_OFFSET_GAIN     0.1         /* Gain of the offsets between the nodes at sink*/
+#define SIM_CLUSTER_PAIR_AGE        SA_UTILS_HOURS_TO_MILLI_S   /* Oldest sample paired for an offset, ms */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Configuration of the cluster simulation.
+ *
+ */
+typedef struct {
+    uint16_t Nodes;
+    SIM_NODE_CFG_T Node[SIM_CLUSTER_MAX_NODES];     /* Each node, the true data in its inputs   */
+    uint32_t Neighbors[SIM_CLUSTER_MAX_NODES];      /* Mask of the nodes each node hears        */
+    bool_t Cooperative;                 /* Cooperative sampling in every node               */
+    SIM_TIME_T Horizon;                 /* End of the simulation in ms                      */
+} SIM_CLUSTER_CFG_T;
+
+/**
+ * \brief  Result of the cluster simulation.
+ *
+ */
+typedef struct {
+    SIM_NODE_RESULT_T Node[SIM_CLUSTER_MAX_NODES];
+    uint32_t Frames;                    /* Frames received by the sink                      */
+    float64_t Charge;                   /* Charge per day of the cluster                    */
+    float64_t Error;                    /* Mean absolute error of the field at the sink     */
+    float64_t Rmse;                     /* Root mean square error of the field at the sink  */
+    float64_t Deviation;                /* Standard deviation of the true field             */
+    float64_t Wall;                     /* Wall time in s                                   */
+} SIM_CLUSTER_RESULT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SimCluster_Run(const SIM_CLUSTER_CFG_T *p_cfg, SIM_CLUSTER_RESULT_T *p_result);
+
+/** @} (end addtogroup SimCluster)  */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_CLUSTER_H__       */
@@ -0,0 +1,226 @@
+/**
+ * \file    sim_kernel.c
+ *
+ * \brief   Discrete-event simulation kernel with a virtual clock.
+ *          The events wait in a binary heap ordered by time, and the kernel jumps the clock
+ *          from one event to the next, so the time between the activations of a node costs
+ *          nothing to simulate. Events at the same time are dispatched in the order they were
+ *          scheduled.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimKernel_
+ *
+ */
+
+#include <string.h>
+#include "../platform/sa_types.h"
+
+#include "sim_kernel.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimKernel
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static SIM_EVENT_T SimKernel_Heap[SIM_KERNEL_MAX_EVENTS];
+static uint16_t SimKernel_Pending;
+static uint32_t SimKernel_Sequence;
+static SIM_TIME_T SimKernel_Now;
+static uint64_t SimKernel_Events;
+static bool_t SimKernel_Stopped;
+static SIM_KERNEL_HANDLER_T SimKernel_Handlers[SIM_EVENT_TYPES];
+
+/************************************** Function implementation **********************************/
+
+/************* Heap *************************/
+/**
+ * \brief  Compares two events.
+ *
+ * \param  p_a:  Pointer to the first event.
+ * \param  p_b:  Pointer to the second event.
+ *
+ * \return DEF_TRUE if the first event is dispatched before the second one; otherwise DEF_FALSE.
+ *
+ */
+static bool_t SimKernel_Before(const SIM_EVENT_T *p_a, const SIM_EVENT_T *p_b)
+{
+    if (p_a->Time != p_b->Time) return (p_a->Time < p_b->Time) ? DEF_TRUE : DEF_FALSE;
+    return (p_a->Sequence < p_b->Sequence) ? DEF_TRUE : DEF_FALSE;
+}
+
+/**
+ * \brief  Removes the first event of the heap.
+ *
+ * \param  p_event:  Pointer to where the event will be saved.
+ *
+ */
+static void SimKernel_Pop(SIM_EVENT_T *p_event)
+{
+    SIM_EVENT_T last;
+    uint16_t node = 0, child;
+
+    *p_event = SimKernel_Heap[0];
+    last = SimKernel_Heap[--SimKernel_Pending];
+
+    /* Sift down the last event from the root   */
+    for (;;) {
+        child = (uint16_t)(2u * node + 1u);
+        if (child >= SimKernel_Pending) break;
+        if ((child + 1u < SimKernel_Pending) &&
+            (DEF_TRUE == SimKernel_Before(&SimKernel_Heap[child + 1u], &SimKernel_Heap[child]))) {
+            child++;
+        }
+        if (DEF_FALSE == SimKernel_Before(&SimKernel_Heap[child], &last)) break;
+        SimKernel_Heap[node] = SimKernel_Heap[child];
+        node = child;
+    }
+    SimKernel_Heap[node] = last;
+}
+
+/************* External *********************/
+/**
+ * \brief  Initializes the kernel, with the clock at 0 and no events.
+ *
+ * \note List of notes:
+ *       1. The handlers are removed, so they must be set after the initialization.
+ */
+void SimKernel_Init(void)
+{
+    SimKernel_Pending = 0;
+    SimKernel_Sequence = 0;
+    SimKernel_Now = 0;
+    SimKernel_Events = 0;
+    SimKernel_Stopped = DEF_FALSE;
+    memset(SimKernel_Handlers, 0x00, sizeof(SimKernel_Handlers));
+}
+
+/**
+ * \brief  Sets the handler of a type of event.
+ *
+ * \param  type:     Type of event.
+ * \param  handler:  Function called when an event of this type is dispatched, NULL to ignore it.
+ *
+ */
+void SimKernel_SetHandler(SIM_EVENT_TYPE_T type, SIM_KERNEL_HANDLER_T handler)
+{
+    if (SIM_EVENT_TYPES > type) SimKernel_Handlers[type] = handler;
+}
+
+/**
+ * \brief  Schedules an event.
+ *
+ * \param  time:  Virtual time of the event in ms, not earlier than the current time.
+ * \param  type:  Type of event.
+ * \param  data:  Data of the event, for the handler.
+ *
+ * \return DEF_OK if the event was scheduled; otherwise DEF_FAIL, if the heap is full or the
+ *         time is in the past.
+ *
+ */
+bool_t SimKernel_Schedule(SIM_TIME_T time, SIM_EVENT_TYPE_T type, uint32_t data)
+{
+    SIM_EVENT_T event;
+    uint16_t node, parent;
+
+    if ((SIM_KERNEL_MAX_EVENTS <= SimKernel_Pending) || (time < SimKernel_Now)) return DEF_FAIL;
+
+    event.Time = time;
+    event.Sequence = SimKernel_Sequence++;
+    event.Type = type;
+    event.Data = data;
+
+    /* Sift up from the last leaf   */
+    for (node = SimKernel_Pending++; 0u < node; node = parent) {
+        parent = (uint16_t)((node - 1u) / 2u);
+        if (DEF_FALSE == SimKernel_Before(&event, &SimKernel_Heap[parent])) break;
+        SimKernel_Heap[node] = SimKernel_Heap[parent];
+    }
+    SimKernel_Heap[node] = event;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Gets the current virtual time.
+ *
+ * \return Virtual time in ms.
+ *
+ */
+SIM_TIME_T SimKernel_GetTime(void)
+{
+    return SimKernel_Now;
+}
+
+/**
+ * \brief  Gets the time of the next event.
+ *
+ * \return Virtual time in ms, SIM_KERNEL_NEVER if there are no events.
+ *
+ */
+SIM_TIME_T SimKernel_GetNextTime(void)
+{
+    return (0u == SimKernel_Pending) ? SIM_KERNEL_NEVER : SimKernel_Heap[0].Time;
+}
+
+/**
+ * \brief  Gets the number of events dispatched since the initialization.
+ *
+ * \return Number of events.
+ *
+ */
+uint64_t SimKernel_GetEvents(void)
+{
+    return SimKernel_Events;
+}
+
+/**
+ * \brief  Stops the simulation after the current event, e.g. when the battery is depleted.
+ *
+ */
+void SimKernel_Stop(void)
+{
+    SimKernel_Stopped = DEF_TRUE;
+}
+
+/**
+ * \brief  Runs the simulation, dispatching the events in order of time.
+ *
+ * \param  until:  Virtual time in ms at which the simulation ends, SIM_KERNEL_NEVER to run
+ *                 until there are no events or the simulation is stopped.
+ *
+ * \return Number of events dispatched.
+ *
+ * \note List of notes:
+ *       1. The events after the end are kept, so the simulation can be resumed.
+ */
+uint64_t SimKernel_Run(SIM_TIME_T until)
+{
+    SIM_EVENT_T event;
+    uint64_t events = SimKernel_Events;
+
+    SimKernel_Stopped = DEF_FALSE;
+    while ((DEF_FALSE == SimKernel_Stopped) && (0u < SimKernel_Pending) &&
+           (until >= SimKernel_Heap[0].Time)) {
+        SimKernel_Pop(&event);
+        SimKernel_Now = event.Time;
+        SimKernel_Events++;
+        if (NULL != SimKernel_Handlers[event.Type]) SimKernel_Handlers[event.Type](&event);
+    }
+
+    return SimKernel_Events - events;
+}
+
+/** @} (end addtogroup SimKernel)   */
+/** @} (end addtogroup Simulation)  */
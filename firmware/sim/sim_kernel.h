@@ -0,0 +1,60 @@
+/**
+ * \file    sim_kernel.h
+ *
+ * \brief   Header file for the discrete-event simulation kernel.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_KERNEL_H__
+#define __SIM_KERNEL_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimKernel
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SIM_KERNEL_MAX_EVENTS       64u                 /* Events pending at the same time  */
+#define SIM_KERNEL_NEVER            UINT64_MAX          /* Time of an event that never comes*/
+
+/************************************** Typedef **************************************************/
+typedef uint64_t SIM_TIME_T;            /* Virtual time in ms   */
+
+typedef enum {
+    SIM_EVENT_ACTIVATION = 0,           /* Activation of the node, set by the trigger       */
+    SIM_EVENT_INPUT,                    /* Change of an input of the environment            */
+    SIM_EVENT_END,                      /* End of the simulation                            */
+    SIM_EVENT_TYPES,
+} SIM_EVENT_TYPE_T;
+
+typedef struct {
+    SIM_TIME_T Time;                    /* Virtual time of the event                        */
+    uint32_t Sequence;                  /* Order of scheduling, for events at the same time */
+    SIM_EVENT_TYPE_T Type;
+    uint32_t Data;                      /* Data of the event, for the handler               */
+} SIM_EVENT_T;
+
+typedef void (*SIM_KERNEL_HANDLER_T)(const SIM_EVENT_T*);
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SimKernel_Init(void);
+void SimKernel_SetHandler(SIM_EVENT_TYPE_T type, SIM_KERNEL_HANDLER_T handler);
+bool_t SimKernel_Schedule(SIM_TIME_T time, SIM_EVENT_TYPE_T type, uint32_t data);
+SIM_TIME_T SimKernel_GetTime(void);
+SIM_TIME_T SimKernel_GetNextTime(void);
+uint64_t SimKernel_GetEvents(void);
+void SimKernel_Stop(void);
+uint64_t SimKernel_Run(SIM_TIME_T until);
+
+/** @} (end addtogroup SimKernel)   */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_KERNEL_H__       */
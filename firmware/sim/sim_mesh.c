@@ -0,0 +1,552 @@
+/**
+ * \file    sim_mesh.c
+ *
+ * \brief   Simulation of a multi-hop mesh network of battery powered nodes.
+ *          Every node generates a frame per period and forwards the frames of its children
+ *          to its parent, along the tree of the fewest hops to the sink. The time is divided
+ *          in slots of a frame, and a node with frames waiting transmits after a random
+ *          backoff in a contention window that doubles with every retransmission. A frame is
+ *          lost when the parent transmits in the same slot, when another neighbour of the
+ *          parent transmits in the same slot (a collision), or with the loss probability of
+ *          the link; after SIM_MESH_RETRIES retransmissions it is dropped.
+ *          Each transmission draws the charge of the radio config of the sender from
+ *          RadioCfg_Configs, and each reception SIM_NODE_RX_SHARE of the config of the
+ *          receiver. A depleted node stops, and the routes are rebuilt without it.
+ *          Only the nodes with a transmission in a slot are visited, through a timing wheel
+ *          of the next attempts, and the links are kept in compressed sparse rows, so the
+ *          cost of a slot follows the traffic and not the size of the mesh.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimMesh_
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/radio_cfg.h"
+
+#include "sim_random.h"
+#include "sim_workers.h"
+#include "sim_node.h"
+#include "sim_mesh.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimMesh
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+static int SimMesh_ComparePhase(const void *p_a, const void *p_b);
+
+/************************************** Local Var ************************************************/
+/* Random topology */
+static uint32_t SimMesh_Rows[SIM_MESH_MAX_NODES + 1u];
+static uint32_t SimMesh_Links[SIM_MESH_MAX_LINKS];
+static float32_t SimMesh_Loss[SIM_MESH_MAX_LINKS];
+static float64_t SimMesh_X[SIM_MESH_MAX_NODES];
+static float64_t SimMesh_Y[SIM_MESH_MAX_NODES];
+static uint32_t SimMesh_CellRows[SIM_MESH_MAX_CELLS + 1u];
+static uint32_t SimMesh_CellNodes[SIM_MESH_MAX_NODES];
+
+/* Simulation */
+static const SIM_MESH_CFG_T *SimMesh_Cfg;
+static SIM_MESH_RESULT_T *SimMesh_Result;
+static SIM_MESH_NODE_T SimMesh_Nodes[SIM_MESH_MAX_NODES];
+static uint32_t SimMesh_Phase[SIM_MESH_MAX_NODES];      /* Slot of the period of the own frames */
+static uint32_t SimMesh_Order[SIM_MESH_MAX_NODES];      /* Nodes sorted by phase                */
+static uint32_t SimMesh_Search[SIM_MESH_MAX_NODES];     /* Queue of the breadth-first search    */
+static uint32_t SimMesh_Next[SIM_MESH_MAX_NODES];       /* Next node in the same wheel slot     */
+static uint32_t SimMesh_Wheel[SIM_MESH_WHEEL];          /* First node attempting in each slot   */
+static uint64_t SimMesh_Stamp[SIM_MESH_MAX_NODES];      /* Slot + 1 of the last transmission    */
+static uint32_t SimMesh_Senders[SIM_MESH_MAX_NODES];    /* Nodes transmitting in the slot       */
+static bool_t SimMesh_Reroute;                          /* A node was depleted in the slot      */
+
+/************************************** Function implementation **********************************/
+
+/************* Topology *********************/
+/**
+ * \brief  Builds a random geometric topology: the nodes are placed uniformly in a square, and
+ *         two nodes are linked when they are within a range of 1.
+ *
+ * \param  nodes:       Number of nodes. Node 0 is placed at the center, for the sink.
+ * \param  degree:      Mean neighbours of a node, which sets the side of the square.
+ * \param  max_loss:    Loss probability of a link at the edge of the range.
+ * \param  seed:        Seed of the placement.
+ * \param  p_topology:  Pointer to where the topology will be saved, valid until the next call.
+ *
+ * \return DEF_OK if the topology fits in SIM_MESH_MAX_NODES, SIM_MESH_MAX_LINKS and
+ *         SIM_MESH_MAX_CELLS; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The loss of a link grows with the square of its length.
+ *       2. The nodes are sorted in cells of the size of the range, so only the neighbouring
+ *          cells are searched for links.
+ */
+bool_t SimMesh_RandomTopology(uint32_t nodes, float64_t degree, float64_t max_loss, uint64_t seed,
+                              SIM_MESH_TOPOLOGY_T *p_topology)
+{
+    float64_t side, dx, dy, distance;
+    uint32_t node, other, cell, cells, side_cells, links = 0, index;
+    int32_t x, y;
+
+    if ((0u == nodes) || (SIM_MESH_MAX_NODES < nodes) || (0.0 >= degree)) return DEF_FAIL;
+    side = sqrt(nodes * M_PI / degree);
+    side_cells = (uint32_t) ceil(side);
+    cells = side_cells * side_cells;
+    if (SIM_MESH_MAX_CELLS < cells) return DEF_FAIL;
+
+    /* Placement, sorted in cells   */
+    SimRandom_Seed(seed, 0u);
+    memset(SimMesh_CellRows, 0x00, (cells + 1u) * sizeof(uint32_t));
+    for (node = 0; node < nodes; node++) {
+        SimMesh_X[node] = (0u == node) ? side / 2.0 : side * SimRandom_Uniform();
+        SimMesh_Y[node] = (0u == node) ? side / 2.0 : side * SimRandom_Uniform();
+        cell = (uint32_t) SimMesh_Y[node] * side_cells + (uint32_t) SimMesh_X[node];
+        SimMesh_CellRows[cell + 1u]++;
+    }
+    for (cell = 0; cell < cells; cell++) {
+        SimMesh_CellRows[cell + 1u] += SimMesh_CellRows[cell];
+    }
+    for (node = 0; node < nodes; node++) {
+        cell = (uint32_t) SimMesh_Y[node] * side_cells + (uint32_t) SimMesh_X[node];
+        SimMesh_CellNodes[SimMesh_CellRows[cell]++] = node;
+    }
+    for (cell = cells; 0u < cell; cell--) {             /* Back to the start of each cell   */
+        SimMesh_CellRows[cell] = SimMesh_CellRows[cell - 1u];
+    }
+    SimMesh_CellRows[0] = 0;
+
+    /* Links                        */
+    for (node = 0; node < nodes; node++) {
+        SimMesh_Rows[node] = links;
+        for (y = (int32_t) SimMesh_Y[node] - 1; y <= (int32_t) SimMesh_Y[node] + 1; y++) {
+            for (x = (int32_t) SimMesh_X[node] - 1; x <= (int32_t) SimMesh_X[node] + 1; x++) {
+                if ((0 > x) || (0 > y) || ((int32_t) side_cells <= x) || ((int32_t) side_cells <= y)) {
+                    continue;
+                }
+                cell = (uint32_t) y * side_cells + (uint32_t) x;
+                for (index = SimMesh_CellRows[cell]; index < SimMesh_CellRows[cell + 1u]; index++) {
+                    other = SimMesh_CellNodes[index];
+                    dx = SimMesh_X[other] - SimMesh_X[node];
+                    dy = SimMesh_Y[other] - SimMesh_Y[node];
+                    distance = dx * dx + dy * dy;
+                    if ((other == node) || (1.0 <= distance)) continue;
+                    if (SIM_MESH_MAX_LINKS <= links) return DEF_FAIL;
+                    SimMesh_Links[links] = other;
+                    SimMesh_Loss[links] = (float32_t)(max_loss * distance);
+                    links++;
+                }
+            }
+        }
+    }
+    SimMesh_Rows[nodes] = links;
+
+    p_topology->Nodes = nodes;
+    p_topology->Rows = SimMesh_Rows;
+    p_topology->Links = SimMesh_Links;
+    p_topology->Loss = SimMesh_Loss;
+
+    return DEF_OK;
+}
+
+/************* Routes ***********************/
+/**
+ * \brief  Finds the link from a node to a neighbour.
+ *
+ * \param  node:   Node.
+ * \param  other:  Neighbour.
+ *
+ * \return Index of the link, or SIM_MESH_NONE if they are not linked.
+ *
+ */
+static uint32_t SimMesh_Link(uint32_t node, uint32_t other)
+{
+    const SIM_MESH_TOPOLOGY_T *p_topology = &SimMesh_Cfg->Topology;
+    uint32_t link;
+
+    for (link = p_topology->Rows[node]; link < p_topology->Rows[node + 1u]; link++) {
+        if (other == p_topology->Links[link]) return link;
+    }
+    return SIM_MESH_NONE;
+}
+
+/**
+ * \brief  Builds the routes to the sink through the nodes alive, a breadth-first search.
+ *
+ * \note List of notes:
+ *       1. The parent of a node is the neighbour one hop closer to the sink with the lowest
+ *          loss on the link to it.
+ *       2. The frames waiting in a node left without a route are orphaned.
+ */
+static void SimMesh_Route(void)
+{
+    const SIM_MESH_TOPOLOGY_T *p_topology = &SimMesh_Cfg->Topology;
+    SIM_MESH_NODE_T *p_node;
+    uint32_t node, other, link, to_parent, head = 0, tail = 0;
+
+    for (node = 0; node < p_topology->Nodes; node++) {
+        SimMesh_Nodes[node].Hops = SIM_MESH_NO_ROUTE;
+        SimMesh_Nodes[node].Parent = SIM_MESH_NONE;
+    }
+    SimMesh_Nodes[SimMesh_Cfg->Sink].Hops = 0;
+    SimMesh_Search[tail++] = SimMesh_Cfg->Sink;
+
+    while (head < tail) {
+        node = SimMesh_Search[head++];
+        for (link = p_topology->Rows[node]; link < p_topology->Rows[node + 1u]; link++) {
+            other = p_topology->Links[link];
+            p_node = &SimMesh_Nodes[other];
+            if ((DEF_FALSE == p_node->Alive) || (SimMesh_Nodes[node].Hops + 1u > p_node->Hops)) continue;
+            to_parent = SimMesh_Link(other, node);
+            if (SIM_MESH_NONE == to_parent) continue;
+            if (SIM_MESH_NO_ROUTE == p_node->Hops) {
+                p_node->Hops = SimMesh_Nodes[node].Hops + 1u;
+                SimMesh_Search[tail++] = other;
+            } else if (p_topology->Loss[to_parent] >= p_topology->Loss[p_node->ParentLink]) {
+                continue;
+            }
+            p_node->Parent = node;
+            p_node->ParentLink = to_parent;
+        }
+    }
+
+    for (node = 0; node < p_topology->Nodes; node++) {
+        p_node = &SimMesh_Nodes[node];
+        if ((SIM_MESH_NO_ROUTE == p_node->Hops) && (0u != p_node->Queue)) {
+            SimMesh_Result->Orphaned += p_node->Queue;
+            p_node->Queue = 0;
+            p_node->Retries = 0;
+        }
+    }
+}
+
+/************* Traffic **********************/
+/**
+ * \brief  Schedules the next transmission attempt of a node, after a random backoff.
+ *
+ * \param  node:  Node.
+ * \param  slot:  Current slot.
+ *
+ */
+static void SimMesh_Schedule(uint32_t node, uint64_t slot)
+{
+    uint32_t window, at;
+
+    window = SA_UTILS_MIN((uint32_t) SimMesh_Cfg->Backoff << SimMesh_Nodes[node].Retries,
+                          (uint32_t) SimMesh_Cfg->MaxBackoff);
+    at = (uint32_t)((slot + 1u + SimRandom_Next() % SA_UTILS_MAX(window, 1u)) & (SIM_MESH_WHEEL - 1u));
+    SimMesh_Next[node] = SimMesh_Wheel[at];
+    SimMesh_Wheel[at] = node;
+}
+
+/**
+ * \brief  Queues a frame in a node, the sink delivers it.
+ *
+ * \param  node:  Node.
+ * \param  slot:  Current slot.
+ *
+ */
+static void SimMesh_Enqueue(uint32_t node, uint64_t slot)
+{
+    SIM_MESH_NODE_T *p_node = &SimMesh_Nodes[node];
+
+    if (SimMesh_Cfg->Sink == node) {
+        SimMesh_Result->Delivered++;
+    } else if (SIM_MESH_NO_ROUTE == p_node->Hops) {
+        SimMesh_Result->Orphaned++;
+    } else if (SimMesh_Cfg->Queue <= p_node->Queue) {
+        SimMesh_Result->Overflows++;
+    } else if (0u == p_node->Queue++) {
+        SimMesh_Schedule(node, slot);
+    }
+}
+
+/**
+ * \brief  Draws a charge from a node, which is depleted when the charge runs out.
+ *
+ * \param  node:    Node.
+ * \param  charge:  Charge.
+ * \param  slot:    Current slot.
+ *
+ * \note List of notes:
+ *       1. The idle charge is accounted in closed form up to the slot.
+ */
+static void SimMesh_Draw(uint32_t node, float64_t charge, uint64_t slot)
+{
+    SIM_MESH_NODE_T *p_node = &SimMesh_Nodes[node];
+    float64_t idle = SimMesh_Cfg->IdleCurrent * (float64_t) slot * SIM_MESH_SLOT / SA_UTILS_S_TO_MILLI_S;
+
+    p_node->Charge += charge;
+    if (p_node->Charge + idle < SimMesh_Cfg->Capacity) return;
+
+    p_node->Alive = DEF_FALSE;
+    p_node->Death = slot;
+    SimMesh_Result->Lost += p_node->Queue;
+    p_node->Queue = 0;
+    p_node->Retries = 0;
+    if (0u == SimMesh_Result->Deaths++) {
+        SimMesh_Result->FirstDead = node;
+        SimMesh_Result->FirstDeath = slot;
+        SimMesh_Result->DeliveredAtDeath = SimMesh_Result->Delivered;
+    }
+    SimMesh_Reroute = DEF_TRUE;
+}
+
+/**
+ * \brief  Charge of a frame with the radio config of a node.
+ *
+ * \param  node:  Node.
+ *
+ * \return Charge of a transmission.
+ *
+ */
+static float64_t SimMesh_FrameCharge(uint32_t node)
+{
+    RADIO_CFG_LIST_T config = (NULL == SimMesh_Cfg->Configs) ? RADIO_CFG_DEFAULT_CONFIG :
+                                                                SimMesh_Cfg->Configs[node];
+
+    return RadioCfg_Configs_Ptr[config].PowerCost.Power;
+}
+
+/**
+ * \brief  Tells if a frame reaches the parent of a sender.
+ *
+ * \param  sender:  Sender.
+ * \param  slot:    Current slot.
+ *
+ * \return DEF_TRUE if the frame is received; otherwise DEF_FALSE, counted as a collision or a
+ *         loss.
+ *
+ */
+static bool_t SimMesh_Receive(uint32_t sender, uint64_t slot)
+{
+    const SIM_MESH_TOPOLOGY_T *p_topology = &SimMesh_Cfg->Topology;
+    const SIM_MESH_NODE_T *p_sender = &SimMesh_Nodes[sender];
+    uint32_t parent = p_sender->Parent, link;
+
+    if ((SIM_MESH_NONE == parent) || (DEF_FALSE == SimMesh_Nodes[parent].Alive)) {
+        SimMesh_Result->Losses++;
+        return DEF_FALSE;
+    }
+    if (SimMesh_Stamp[parent] == slot + 1u) {          /* Half duplex  */
+        SimMesh_Result->Collisions++;
+        return DEF_FALSE;
+    }
+    if (SimMesh_Cfg->Sink != parent) {
+        SimMesh_Nodes[parent].Receptions++;
+        SimMesh_Draw(parent, SIM_NODE_RX_SHARE * SimMesh_FrameCharge(parent), slot);
+        if (DEF_FALSE == SimMesh_Nodes[parent].Alive) {
+            SimMesh_Result->Losses++;
+            return DEF_FALSE;
+        }
+    }
+    for (link = p_topology->Rows[parent]; link < p_topology->Rows[parent + 1u]; link++) {
+        if ((sender != p_topology->Links[link]) && (SimMesh_Stamp[p_topology->Links[link]] == slot + 1u)) {
+            SimMesh_Result->Collisions++;
+            return DEF_FALSE;
+        }
+    }
+    if (SimRandom_Uniform() < p_topology->Loss[p_sender->ParentLink]) {
+        SimMesh_Result->Losses++;
+        return DEF_FALSE;
+    }
+    return DEF_TRUE;
+}
+
+/**
+ * \brief  Simulates a slot: the own frames of the slot, and the transmissions.
+ *
+ * \param  slot:     Slot.
+ * \param  p_cycle:  Pointer to the position in SimMesh_Order of the next own frame.
+ *
+ * \note List of notes:
+ *       1. All the transmissions of the slot are marked before any reception is resolved.
+ *       2. A frame forwarded by the parent waits at least a slot, and the routes are rebuilt
+ *          at the end of a slot with a depletion.
+ */
+static void SimMesh_Slot(uint64_t slot, uint32_t *p_cycle)
+{
+    const SIM_MESH_CFG_T *p_cfg = SimMesh_Cfg;
+    SIM_MESH_NODE_T *p_node;
+    uint32_t phase = (uint32_t)(slot % p_cfg->Period), node, sender, senders = 0, wheel;
+
+    /* Own frames                   */
+    if (0u == phase) *p_cycle = 0;
+    while ((*p_cycle < p_cfg->Topology.Nodes) && (SimMesh_Phase[SimMesh_Order[*p_cycle]] == phase)) {
+        node = SimMesh_Order[(*p_cycle)++];
+        if ((node == p_cfg->Sink) || (DEF_FALSE == SimMesh_Nodes[node].Alive)) continue;
+        SimMesh_Nodes[node].Generated++;
+        SimMesh_Result->Generated++;
+        SimMesh_Enqueue(node, slot);
+    }
+
+    /* Transmissions                */
+    wheel = (uint32_t)(slot & (SIM_MESH_WHEEL - 1u));
+    for (node = SimMesh_Wheel[wheel]; SIM_MESH_NONE != node; node = SimMesh_Next[node]) {
+        if (0u != SimMesh_Nodes[node].Queue) {
+            SimMesh_Stamp[node] = slot + 1u;
+            SimMesh_Senders[senders++] = node;
+        }
+    }
+    SimMesh_Wheel[wheel] = SIM_MESH_NONE;
+
+    for (sender = 0; sender < senders; sender++) {
+        node = SimMesh_Senders[sender];
+        p_node = &SimMesh_Nodes[node];
+        if (0u == p_node->Queue) continue;              /* Depleted in this slot    */
+        p_node->Transmissions++;
+        SimMesh_Result->Transmissions++;
+        if (DEF_TRUE == SimMesh_Receive(node, slot)) {
+            p_node->Queue--;
+            p_node->Retries = 0;
+            if (p_node->Parent != p_cfg->Sink) SimMesh_Nodes[p_node->Parent].Relayed++;
+            SimMesh_Enqueue(p_node->Parent, slot);
+        } else if (p_cfg->Retries < ++p_node->Retries) {
+            p_node->Queue--;
+            p_node->Retries = 0;
+            SimMesh_Result->Dropped++;
+        }
+        SimMesh_Draw(node, SimMesh_FrameCharge(node), slot);
+        if (0u != p_node->Queue) SimMesh_Schedule(node, slot);
+    }
+
+    if (DEF_TRUE == SimMesh_Reroute) {
+        SimMesh_Reroute = DEF_FALSE;
+        SimMesh_Route();
+    }
+}
+
+/**
+ * \brief  Orders two nodes by the phase of their own frames, for qsort.
+ *
+ * \param  p_a:  Pointer to the first node.
+ * \param  p_b:  Pointer to the second node.
+ *
+ * \return Negative, 0 or positive as the first phase is lower, equal or higher.
+ *
+ */
+static int SimMesh_ComparePhase(const void *p_a, const void *p_b)
+{
+    uint32_t a = SimMesh_Phase[*(const uint32_t*) p_a], b = SimMesh_Phase[*(const uint32_t*) p_b];
+
+    return (a > b) - (a < b);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Sets the default configuration of the mesh simulation: one hour of the default
+ *         radio config, frames every SIM_MESH_PERIOD and the battery of SimNode_DefaultCfg.
+ *
+ * \param  p_cfg:  Pointer to the configuration. The topology must be set by the caller.
+ *
+ */
+void SimMesh_DefaultCfg(SIM_MESH_CFG_T *p_cfg)
+{
+    SIM_NODE_CFG_T node;
+
+    SimNode_DefaultCfg(&node);
+    memset(p_cfg, 0x00, sizeof(SIM_MESH_CFG_T));
+    p_cfg->Sink = 0;
+    p_cfg->Configs = NULL;
+    p_cfg->Period = SIM_MESH_PERIOD;
+    p_cfg->Slots = (uint64_t) SA_UTILS_HOURS_TO_MILLI_S / SIM_MESH_SLOT;
+    p_cfg->Retries = SIM_MESH_RETRIES;
+    p_cfg->Queue = SIM_MESH_QUEUE;
+    p_cfg->Backoff = SIM_MESH_BACKOFF;
+    p_cfg->MaxBackoff = SIM_MESH_MAX_BACKOFF;
+    p_cfg->Capacity = node.Capacity;
+    p_cfg->IdleCurrent = node.IdleCurrent;
+    p_cfg->Seed = 1u;
+}
+
+/**
+ * \brief  Simulates the mesh.
+ *
+ * \param  p_cfg:     Pointer to the configuration.
+ * \param  p_result:  Pointer to where the result will be saved.
+ *
+ * \return DEF_OK if the configuration is valid; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The phases of the nodes are random in the period, so the mesh is not synchronised.
+ *       2. The state of the nodes is kept until the next run, see SimMesh_GetNodes.
+ */
+bool_t SimMesh_Run(const SIM_MESH_CFG_T *p_cfg, SIM_MESH_RESULT_T *p_result)
+{
+    const SIM_MESH_TOPOLOGY_T *p_topology = &p_cfg->Topology;
+    uint32_t node, cycle = 0;
+    uint64_t slot;
+    float64_t start;
+
+    if ((0u == p_topology->Nodes) || (SIM_MESH_MAX_NODES < p_topology->Nodes) ||
+        (p_cfg->Sink >= p_topology->Nodes) || (0u == p_cfg->Period) || (0u == p_cfg->Backoff) ||
+        (p_cfg->Backoff > p_cfg->MaxBackoff) || (SIM_MESH_WHEEL <= p_cfg->MaxBackoff)) {
+        return DEF_FAIL;
+    }
+
+    SimMesh_Cfg = p_cfg;
+    SimMesh_Result = p_result;
+    SimMesh_Reroute = DEF_FALSE;
+    memset(p_result, 0x00, sizeof(SIM_MESH_RESULT_T));
+    p_result->FirstDead = SIM_MESH_NONE;
+    memset(SimMesh_Nodes, 0x00, p_topology->Nodes * sizeof(SIM_MESH_NODE_T));
+    memset(SimMesh_Stamp, 0x00, p_topology->Nodes * sizeof(uint64_t));
+    for (slot = 0; slot < SIM_MESH_WHEEL; slot++) {
+        SimMesh_Wheel[slot] = SIM_MESH_NONE;
+    }
+
+    SimRandom_Seed(p_cfg->Seed, 1u);
+    for (node = 0; node < p_topology->Nodes; node++) {
+        SimMesh_Nodes[node].Alive = DEF_TRUE;
+        SimMesh_Phase[node] = (uint32_t)(SimRandom_Next() % p_cfg->Period);
+        SimMesh_Order[node] = node;
+    }
+    qsort(SimMesh_Order, p_topology->Nodes, sizeof(uint32_t), SimMesh_ComparePhase);
+
+    SimMesh_Route();
+    for (node = 0; node < p_topology->Nodes; node++) {
+        if ((node == p_cfg->Sink) || (SIM_MESH_NO_ROUTE == SimMesh_Nodes[node].Hops)) continue;
+        p_result->Reachable++;
+        p_result->MaxHops = SA_UTILS_MAX(p_result->MaxHops, SimMesh_Nodes[node].Hops);
+    }
+
+    start = SimWorkers_Wall();
+    for (slot = 0; slot < p_cfg->Slots; slot++) {
+        SimMesh_Slot(slot, &cycle);
+    }
+    p_result->Wall = SimWorkers_Wall() - start;
+    p_result->Throughput = (0.0 < p_result->Wall) ?
+                           (float64_t) p_topology->Nodes * p_cfg->Slots / p_result->Wall : 0.0;
+
+    for (node = 0; node < p_topology->Nodes; node++) {
+        p_result->Waiting += SimMesh_Nodes[node].Queue;
+    }
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Gets the nodes of the last simulation.
+ *
+ * \return Pointer to the nodes, in the order of the topology.
+ *
+ */
+const SIM_MESH_NODE_T *SimMesh_GetNodes(void)
+{
+    return SimMesh_Nodes;
+}
+
+/** @} (end addtogroup SimMesh)     */
+/** @} (end addtogroup Simulation)  */
@@ -0,0 +1,131 @@
+/**
+ * \file    sim_mesh.h
+ *
+ * \brief   Header file for the simulation of a multi-hop mesh network.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_MESH_H__
+#define __SIM_MESH_H__
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/radio_cfg.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimMesh
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SIM_MESH_MAX_NODES          16384u      /* Maximum nodes of a mesh                      */
+#define SIM_MESH_MAX_LINKS          (32u * SIM_MESH_MAX_NODES)  /* Maximum links, both ways     */
+#define SIM_MESH_MAX_CELLS          (4u * SIM_MESH_MAX_NODES)   /* Cells of the random topology */
+#define SIM_MESH_WHEEL              256u        /* Slots of the timing wheel, a power of 2      */
+#define SIM_MESH_SLOT               10u         /* Length of a slot in ms, a frame              */
+#define SIM_MESH_NO_ROUTE           UINT16_MAX  /* Hops of a node without a route to the sink   */
+#define SIM_MESH_NONE               UINT32_MAX  /* No node                                      */
+
+/* Default mesh */
+#define SIM_MESH_DEGREE             8.0         /* Mean neighbours of a random topology         */
+#define SIM_MESH_MAX_LOSS           0.3         /* Loss of a link at the edge of the range      */
+#define SIM_MESH_PERIOD             (15u * SA_UTILS_MINS_TO_MILLI_S / SIM_MESH_SLOT)   /* Slots */
+#define SIM_MESH_RETRIES            3u          /* Retransmissions of a frame before the drop   */
+#define SIM_MESH_QUEUE              16u         /* Frames waiting in a node                     */
+#define SIM_MESH_BACKOFF            8u          /* First contention window in slots             */
+#define SIM_MESH_MAX_BACKOFF        128u        /* Maximum contention window, below the wheel   */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Topology of the mesh, the links of each node in compressed sparse rows.
+ *
+ */
+typedef struct {
+    uint32_t Nodes;
+    const uint32_t *Rows;               /* Nodes + 1 offsets of the links of each node      */
+    const uint32_t *Links;              /* Neighbour of each link                           */
+    const float32_t *Loss;              /* Probability of losing a frame on each link       */
+} SIM_MESH_TOPOLOGY_T;
+
+/**
+ * \brief  Configuration of the mesh simulation.
+ *
+ */
+typedef struct {
+    SIM_MESH_TOPOLOGY_T Topology;
+    uint32_t Sink;                      /* Node collecting the frames, not battery powered  */
+    const RADIO_CFG_LIST_T *Configs;    /* Radio config of each node, NULL for the default  */
+    uint32_t Period;                    /* Slots between the frames of a node               */
+    uint64_t Slots;                     /* Simulated slots                                  */
+    uint8_t Retries;                    /* Retransmissions of a frame before the drop       */
+    uint16_t Queue;                     /* Frames waiting in a node                         */
+    uint16_t Backoff;                   /* First contention window in slots                 */
+    uint16_t MaxBackoff;                /* Maximum contention window, below SIM_MESH_WHEEL  */
+    float64_t Capacity;                 /* Charge of the battery of each node               */
+    float64_t IdleCurrent;              /* Charge drawn per s between the frames            */
+    uint64_t Seed;
+} SIM_MESH_CFG_T;
+
+/**
+ * \brief  State and counters of a node of the mesh.
+ *
+ */
+typedef struct {
+    uint32_t Parent;                    /* Next hop to the sink, SIM_MESH_NONE without route*/
+    uint32_t ParentLink;                /* Link to the parent                               */
+    uint16_t Hops;                      /* Hops to the sink, SIM_MESH_NO_ROUTE without route*/
+    uint16_t Queue;                     /* Frames waiting                                   */
+    uint8_t Retries;                    /* Retransmissions of the first frame               */
+    bool_t Alive;
+    uint32_t Generated;                 /* Own frames                                       */
+    uint32_t Relayed;                   /* Frames received from other nodes to forward      */
+    uint32_t Transmissions;             /* Transmission attempts                            */
+    uint32_t Receptions;                /* Frames addressed to the node, received or not    */
+    float64_t Charge;                   /* Charge of the transmissions and receptions       */
+    uint64_t Death;                     /* Slot of the depletion, 0 while alive             */
+} SIM_MESH_NODE_T;
+
+/**
+ * \brief  Result of the mesh simulation. Every generated frame ends delivered, dropped after
+ *         the retries, dropped by a full queue, orphaned without a route, lost with a
+ *         depleted node, or waiting in a queue.
+ *
+ */
+typedef struct {
+    uint64_t Generated;
+    uint64_t Delivered;
+    uint64_t Dropped;                   /* Retransmissions exhausted                        */
+    uint64_t Overflows;                 /* Queue full                                       */
+    uint64_t Orphaned;                  /* No route to the sink                             */
+    uint64_t Lost;                      /* Waiting in a node when it was depleted           */
+    uint64_t Waiting;                   /* Waiting in the queues at the end                 */
+    uint64_t Transmissions;
+    uint64_t Collisions;                /* Frames corrupted by another neighbour            */
+    uint64_t Losses;                    /* Frames lost on the link                          */
+    uint32_t Reachable;                 /* Nodes with a route at the start                  */
+    uint16_t MaxHops;
+    uint32_t Deaths;
+    uint32_t FirstDead;                 /* First depleted node, SIM_MESH_NONE if none       */
+    uint64_t FirstDeath;                /* Slot of the first depletion                      */
+    uint64_t DeliveredAtDeath;          /* Frames delivered before the first depletion      */
+    float64_t Wall;                     /* Wall time in s                                   */
+    float64_t Throughput;               /* Simulated node slots per s                       */
+} SIM_MESH_RESULT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SimMesh_RandomTopology(uint32_t nodes, float64_t degree, float64_t max_loss, uint64_t seed,
+                              SIM_MESH_TOPOLOGY_T *p_topology);
+void SimMesh_DefaultCfg(SIM_MESH_CFG_T *p_cfg);
+bool_t SimMesh_Run(const SIM_MESH_CFG_T *p_cfg, SIM_MESH_RESULT_T *p_result);
+const SIM_MESH_NODE_T *SimMesh_GetNodes(void);
+
+/** @} (end addtogroup SimMesh)     */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_MESH_H__       */
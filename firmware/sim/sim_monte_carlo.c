@@ -0,0 +1,260 @@
+/**
+ * \file    sim_monte_carlo.c
+ *
+ * \brief   Monte Carlo distribution of the battery lifetime.
+ *          Every trial is an independent node with a random true capacity around the rated
+ *          one, a random gain error of the coulomb counter, noisy counter readings and a
+ *          random daily sensor trace. The nodes are simulated to past the lifetime target,
+ *          and the report gives the percentiles of the lifetime and the probability of
+ *          depleting the battery before the target.
+ *          The trials are shared between worker processes, see SimWorkers. Each trial seeds
+ *          the random numbers from its index, so the result does not depend on the number of
+ *          workers.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimMonteCarlo_
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+
+#include "sim_kernel.h"
+#include "sim_random.h"
+#include "sim_workers.h"
+#include "sim_node.h"
+#include "sim_monte_carlo.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimMonteCarlo
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Daily sensor trace of a node.
+ *
+ */
+typedef struct {
+    float32_t Mean;
+    float32_t Amplitude;
+    float64_t Phase;                    /* Phase of the day [0, 1)                          */
+    float32_t Noise;                    /* Deviation of the noise of each sample            */
+} SIM_MONTE_CARLO_TRACE_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static const uint8_t SimMonteCarlo_Levels[SIM_MONTE_CARLO_PERCENTILES] = {1, 5, 10, 50, 90, 95, 99};
+static SIM_MONTE_CARLO_TRACE_T SimMonteCarlo_Trace;
+
+/************************************** Function implementation **********************************/
+
+/************* Trial ************************/
+/**
+ * \brief  Sensor trace of the current trial, a noisy sine with a period of a day.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ * \return Sensor data.
+ *
+ */
+static float32_t SimMonteCarlo_DailyTrace(SIM_TIME_T time)
+{
+    SIM_MONTE_CARLO_TRACE_T *p_trace = &SimMonteCarlo_Trace;
+    float64_t phase = (float64_t)(time % SA_UTILS_DAYS_TO_MILLI_S) / SA_UTILS_DAYS_TO_MILLI_S;
+    float32_t data;
+
+    data = p_trace->Mean + p_trace->Amplitude * (float32_t) sin(2.0 * M_PI * (phase + p_trace->Phase));
+    if (0.0f != p_trace->Noise) data += p_trace->Noise * (float32_t) SimRandom_Gaussian();
+
+    return data;
+}
+
+/**
+ * \brief  Simulates one node, with the random draws of its index.
+ *
+ * \param  p_cfg:     Pointer to the configuration.
+ * \param  trial:     Index of the trial.
+ * \param  p_sample:  Pointer to where the result will be saved.
+ *
+ * \return DEF_OK if the node could be simulated; otherwise DEF_FAIL.
+ *
+ */
+static bool_t SimMonteCarlo_Trial(const SIM_MONTE_CARLO_CFG_T *p_cfg, uint32_t trial,
+                                  SIM_MONTE_CARLO_SAMPLE_T *p_sample)
+{
+    SIM_NODE_CFG_T node = p_cfg->Node;
+    SIM_NODE_RESULT_T result;
+
+    SimRandom_Seed(p_cfg->Seed, trial);
+    node.RatedCapacity = p_cfg->Node.Capacity;
+    node.Capacity = p_cfg->Node.Capacity * SA_UTILS_MAX(1.0 + p_cfg->CapacitySpread * SimRandom_Gaussian(), 0.0);
+    node.CounterGain = p_cfg->GainSpread * SimRandom_Gaussian();
+    node.CounterNoise = p_cfg->CounterNoise;
+
+    SimMonteCarlo_Trace.Mean = p_cfg->TraceMean + p_cfg->TraceMeanSpread * (float32_t) SimRandom_Gaussian();
+    SimMonteCarlo_Trace.Amplitude = p_cfg->TraceAmplitude * (float32_t)(0.5 + SimRandom_Uniform());
+    SimMonteCarlo_Trace.Phase = SimRandom_Uniform();
+    SimMonteCarlo_Trace.Noise = p_cfg->TraceNoise;
+    node.Trace = SimMonteCarlo_DailyTrace;
+
+    if (DEF_FAIL == SimNode_Run(&node, &result)) return DEF_FAIL;
+
+    p_sample->Lifetime = result.Lifetime;
+    p_sample->Activations = result.Activations;
+    p_sample->Depleted = result.Depleted;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Job of a worker, the simulation of a node.
+ *
+ * \param  p_ctx:     Pointer to the configuration.
+ * \param  job:       Index of the trial.
+ * \param  p_record:  Pointer to where the sample will be saved.
+ *
+ * \return DEF_OK if the node could be simulated; otherwise DEF_FAIL.
+ *
+ */
+static bool_t SimMonteCarlo_Job(const void *p_ctx, uint32_t job, void *p_record)
+{
+    return SimMonteCarlo_Trial((const SIM_MONTE_CARLO_CFG_T *) p_ctx, job,
+                               (SIM_MONTE_CARLO_SAMPLE_T *) p_record);
+}
+
+/************* Statistics *******************/
+/**
+ * \brief  Compares two samples by lifetime, for qsort.
+ *
+ * \param  p_a:  Pointer to the first sample.
+ * \param  p_b:  Pointer to the second sample.
+ *
+ * \return Negative, zero or positive as the first lifetime is shorter, equal or longer.
+ *
+ */
+static int SimMonteCarlo_Compare(const void *p_a, const void *p_b)
+{
+    SIM_TIME_T a = ((const SIM_MONTE_CARLO_SAMPLE_T *) p_a)->Lifetime;
+    SIM_TIME_T b = ((const SIM_MONTE_CARLO_SAMPLE_T *) p_b)->Lifetime;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * \brief  Computes the distribution of the lifetime.
+ *
+ * \param  p_cfg:      Pointer to the configuration.
+ * \param  p_samples:  Pointer to the samples, sorted by lifetime on return.
+ * \param  p_result:   Pointer to where the distribution will be saved.
+ *
+ * \note List of notes:
+ *       1. The percentiles are nearest rank, and the interval of the early depletion
+ *          probability is the Wilson score interval, which holds for probabilities near 0.
+ */
+static void SimMonteCarlo_Statistics(const SIM_MONTE_CARLO_CFG_T *p_cfg,
+                                     SIM_MONTE_CARLO_SAMPLE_T *p_samples,
+                                     SIM_MONTE_CARLO_RESULT_T *p_result)
+{
+    float64_t trials = p_cfg->Trials, z2 = SIM_MONTE_CARLO_CONFIDENCE * SIM_MONTE_CARLO_CONFIDENCE;
+    float64_t p, center, half;
+    uint32_t trial, rank;
+    uint8_t level;
+
+    qsort(p_samples, p_cfg->Trials, sizeof(SIM_MONTE_CARLO_SAMPLE_T), SimMonteCarlo_Compare);
+
+    p_result->Trials = p_cfg->Trials;
+    p_result->Mean = 0.0;
+    for (trial = 0; trial < p_cfg->Trials; trial++) {
+        p_result->Mean += (float64_t) p_samples[trial].Lifetime / trials;
+        if (DEF_TRUE == p_samples[trial].Depleted) {
+            p_result->Depleted++;
+            if (p_cfg->Target > p_samples[trial].Lifetime) p_result->Early++;
+        }
+    }
+
+    for (level = 0; level < SIM_MONTE_CARLO_PERCENTILES; level++) {
+        rank = (uint32_t) ceil(SimMonteCarlo_Levels[level] * trials / 100.0);
+        p_result->Levels[level] = SimMonteCarlo_Levels[level];
+        p_result->Percentiles[level] = p_samples[SA_UTILS_MAX(rank, 1u) - 1u].Lifetime;
+    }
+
+    p = p_result->Early / trials;
+    center = (p + z2 / (2.0 * trials)) / (1.0 + z2 / trials);
+    half = SIM_MONTE_CARLO_CONFIDENCE * sqrt(p * (1.0 - p) / trials + z2 / (4.0 * trials * trials)) /
+           (1.0 + z2 / trials);
+    p_result->EarlyProbability = p;
+    p_result->EarlyLower = SA_UTILS_MAX(center - half, 0.0);
+    p_result->EarlyUpper = SA_UTILS_MIN(center + half, 1.0);
+}
+
+/************* External *********************/
+/**
+ * \brief  Gets the default configuration: the default node, with the expected battery life as
+ *         the target and one worker per core.
+ *
+ * \param  p_cfg:  Pointer to where the configuration will be saved.
+ *
+ */
+void SimMonteCarlo_DefaultCfg(SIM_MONTE_CARLO_CFG_T *p_cfg)
+{
+    SimNode_DefaultCfg(&p_cfg->Node);
+    p_cfg->Target = p_cfg->Node.Horizon;
+    p_cfg->Node.Horizon = SIM_MONTE_CARLO_HORIZON(p_cfg->Target);
+    p_cfg->Trials = 0;
+    p_cfg->Workers = 0;
+    p_cfg->Seed = 1u;
+    p_cfg->CapacitySpread = SIM_MONTE_CARLO_CAPACITY_SPREAD;
+    p_cfg->GainSpread = SIM_MONTE_CARLO_GAIN_SPREAD;
+    p_cfg->CounterNoise = SIM_MONTE_CARLO_COUNTER_NOISE;
+    p_cfg->TraceMean = SIM_MONTE_CARLO_TRACE_MEAN;
+    p_cfg->TraceMeanSpread = SIM_MONTE_CARLO_TRACE_MEAN_SPREAD;
+    p_cfg->TraceAmplitude = SIM_MONTE_CARLO_TRACE_AMPLITUDE;
+    p_cfg->TraceNoise = SIM_MONTE_CARLO_TRACE_NOISE;
+}
+
+/**
+ * \brief  Simulates the trials and computes the distribution of the lifetime.
+ *
+ * \param  p_cfg:      Pointer to the configuration.
+ * \param  p_samples:  Pointer to an array of p_cfg->Trials samples, where the result of each
+ *                     trial is saved, sorted by lifetime.
+ * \param  p_result:   Pointer to where the distribution will be saved.
+ *
+ * \return DEF_OK if every trial was simulated; otherwise DEF_FAIL.
+ *
+ */
+bool_t SimMonteCarlo_Run(const SIM_MONTE_CARLO_CFG_T *p_cfg, SIM_MONTE_CARLO_SAMPLE_T *p_samples,
+                         SIM_MONTE_CARLO_RESULT_T *p_result)
+{
+    float64_t start = SimWorkers_Wall();
+
+    memset(p_result, 0x00, sizeof(SIM_MONTE_CARLO_RESULT_T));
+    if (0u == p_cfg->Trials) return DEF_FAIL;
+
+    p_result->Workers = SimWorkers_Count(p_cfg->Workers);
+    if (DEF_FAIL == SimWorkers_Run(SimMonteCarlo_Job, p_cfg, p_cfg->Trials, p_result->Workers,
+                                   p_samples, sizeof(SIM_MONTE_CARLO_SAMPLE_T))) {
+        return DEF_FAIL;
+    }
+
+    p_result->Wall = SimWorkers_Wall() - start;
+    p_result->Throughput = (0.0 < p_result->Wall) ? p_cfg->Trials / p_result->Wall : 0.0;
+    SimMonteCarlo_Statistics(p_cfg, p_samples, p_result);
+
+    return DEF_OK;
+}
+
+/** @} (end addtogroup SimMonteCarlo)   */
+/** @} (end addtogroup Simulation)      */
@@ -0,0 +1,98 @@
+/**
+ * \file    sim_monte_carlo.h
+ *
+ * \brief   Header file for the Monte Carlo distribution of the battery lifetime.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_MONTE_CARLO_H__
+#define __SIM_MONTE_CARLO_H__
+
+#include "../platform/sa_types.h"
+
+#include "sim_kernel.h"
+#include "sim_node.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimMonteCarlo
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+/* Default spread of the nodes  */
+#define SIM_MONTE_CARLO_CAPACITY_SPREAD     0.05        /* Relative deviation of the capacity       */
+#define SIM_MONTE_CARLO_GAIN_SPREAD         0.02        /* Relative deviation of the counter gain   */
+#define SIM_MONTE_CARLO_COUNTER_NOISE       0.01        /* Relative noise of the counter readings   */
+#define SIM_MONTE_CARLO_TRACE_MEAN          20.0f       /* Mean of the daily sensor traces          */
+#define SIM_MONTE_CARLO_TRACE_MEAN_SPREAD   2.0f        /* Deviation of the mean between the nodes  */
+#define SIM_MONTE_CARLO_TRACE_AMPLITUDE     5.0f        /* Mean amplitude of the daily traces       */
+#define SIM_MONTE_CARLO_TRACE_NOISE         0.5f        /* Deviation of the noise of each sample    */
+#define SIM_MONTE_CARLO_HORIZON(target)     ((target) + (target) / 2u)  /* Horizon past the target */
+
+#define SIM_MONTE_CARLO_PERCENTILES         7u          /* Percentiles of the report                */
+#define SIM_MONTE_CARLO_CONFIDENCE          1.96        /* Normal quantile of the 95% interval      */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Configuration of the Monte Carlo simulation.
+ *
+ */
+typedef struct {
+    SIM_NODE_CFG_T Node;                /* Nominal node, its capacity is the rated one      */
+    uint32_t Trials;                    /* Simulated nodes                                  */
+    uint16_t Workers;                   /* Parallel processes, 0 for one per core           */
+    uint64_t Seed;
+    SIM_TIME_T Target;                  /* Lifetime target in ms                            */
+    float64_t CapacitySpread;           /* Relative deviation of the true capacity          */
+    float64_t GainSpread;               /* Relative deviation of the coulomb counter gain   */
+    float64_t CounterNoise;             /* Relative noise of each coulomb counter reading   */
+    float32_t TraceMean;                /* Daily sensor trace of each node                  */
+    float32_t TraceMeanSpread;
+    float32_t TraceAmplitude;
+    float32_t TraceNoise;
+} SIM_MONTE_CARLO_CFG_T;
+
+/**
+ * \brief  Result of one simulated node.
+ *
+ */
+typedef struct {
+    SIM_TIME_T Lifetime;                /* Time of the depletion, or the horizon, in ms     */
+    uint32_t Activations;
+    bool_t Depleted;
+} SIM_MONTE_CARLO_SAMPLE_T;
+
+/**
+ * \brief  Distribution of the battery lifetime.
+ *
+ */
+typedef struct {
+    uint32_t Trials;
+    uint32_t Depleted;                  /* Nodes depleted before the horizon                */
+    uint32_t Early;                     /* Nodes depleted before the target                 */
+    float64_t EarlyProbability;
+    float64_t EarlyLower;               /* 95% Wilson interval of the probability           */
+    float64_t EarlyUpper;
+    float64_t Mean;                     /* Mean lifetime in ms                              */
+    uint8_t Levels[SIM_MONTE_CARLO_PERCENTILES];            /* Percentile levels in %       */
+    SIM_TIME_T Percentiles[SIM_MONTE_CARLO_PERCENTILES];    /* Lifetime at each level in ms */
+    uint16_t Workers;
+    float64_t Wall;                     /* Wall time in s                                   */
+    float64_t Throughput;               /* Simulated nodes per s                            */
+} SIM_MONTE_CARLO_RESULT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SimMonteCarlo_DefaultCfg(SIM_MONTE_CARLO_CFG_T *p_cfg);
+bool_t SimMonteCarlo_Run(const SIM_MONTE_CARLO_CFG_T *p_cfg, SIM_MONTE_CARLO_SAMPLE_T *p_samples,
+                         SIM_MONTE_CARLO_RESULT_T *p_result);
+
+/** @} (end addtogroup SimMonteCarlo)   */
+/** @} (end addtogroup Simulation)      */
+
+#endif  /* __SIM_MONTE_CARLO_H__       */
@@ -0,0 +1,733 @@
+/**
+ * \file    sim_node.c
+ *
+ * \brief   Simulation of a node in virtual time, running the decision engine on the
+ *          discrete-event kernel.
+ *          Every activation is an event, and the next one is scheduled after the periodicity
+ *          selected by the trigger agent. The charge drawn by an activation is the datasheet
+ *          power of the configs in use, and the idle charge between two activations is
+ *          accounted in closed form for the whole gap, so the cost of the simulation only
+ *          depends on the number of activations. The coulomb counter seen by the power agent
+ *          accumulates the charge drawn between its readings, with a gain error and a noise.
+ *          A harvester can charge the battery in the daylight of each day, up to the capacity.
+ *          When the configs, the sensor data and the power predictions have not changed for a
+ *          steady window, the following activations until the next event are advanced in
+ *          closed form (a leap), and the simulation steps again from the activation after the
+ *          leap, or from the next input.
+ *          The information delivered by the node is measured by the error of the data seen by
+ *          the sink, the last transmitted sample, against the true sensor data, and by the
+ *          events of the true data that the sink missed.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimNode_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+
+#include "../configs/battery_cfg.h"
+#include "../configs/radio_cfg.h"
+#include "../configs/sensor_cfg.h"
+#include "../include/power_agent.h"
+#include "../include/radio_agent.h"
+#include "../include/sensor_agent.h"
+#include "../include/trigger_agent.h"
+#include "../include/app_agent.h"
+#include "../include/decision_engine.h"
+
+#include "sim_kernel.h"
+#include "sim_random.h"
+#include "sim_node.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimNode
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Steady window, the activations since the last change of the node.
+ *
+ */
+typedef struct {
+    SENSOR_CFG_LIST_T Sensor;
+    RADIO_CFG_LIST_T Radio;
+    uint32_t Period;                    /* Periodicity, 0 when the window must restart      */
+    float32_t Data;
+    float32_t Power;                    /* Predicted power at the start of the window       */
+    SIM_TIME_T Start;
+    uint32_t Activations;               /* Counters at the start of the window              */
+    uint32_t Transmissions;
+    float64_t ActiveCharge;
+} SIM_NODE_WINDOW_T;
+
+/**
+ * \brief  Error of the data at the sink, integrated over time.
+ *
+ */
+typedef struct {
+    SIM_TIME_T Time;                    /* Time of the last accounting                      */
+    float64_t Error;                    /* Absolute error                                   */
+    float64_t Squared;                  /* Squared error                                    */
+    float64_t Max;                      /* Maximum absolute error                           */
+    float64_t Data;                     /* True data and its square, for the deviation      */
+    float64_t Squares;
+    bool_t Event;                       /* The true data is in an event                     */
+    bool_t Detected;                    /* A sample of the event reached the sink           */
+} SIM_NODE_TRACKER_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static SIM_NODE_CFG_T SimNode_Cfg;
+static SIM_NODE_RESULT_T SimNode_Result;
+static SIM_TIME_T SimNode_LastTime;             /* Time of the last idle accounting         */
+static SIM_NODE_WINDOW_T SimNode_Window;
+static float32_t SimNode_Data;                  /* Sensor data of the inputs                */
+static float32_t SimNode_Sample;                /* Last sensor data observed                */
+static float64_t SimNode_Counter;               /* Reading of the coulomb counter           */
+static float64_t SimNode_Counted;               /* Charge drawn at the last reading         */
+static float64_t SimNode_CounterDelta;          /* Increment of the last reading            */
+static float32_t SimNode_Delivered;             /* Last sample transmitted to the sink      */
+static SIM_TIME_T SimNode_RelayTime;            /* Time of the last relayed frames          */
+static RADIO_AGENT_OBS_T SimNode_Outcome;       /* Outcome of the last transmission         */
+static SIM_NODE_TRACKER_T SimNode_Tracker;
+
+/************************************** Function implementation **********************************/
+
+/************* Energy ***********************/
+/**
+ * \brief  Total charge drawn by the node.
+ *
+ * \return Charge.
+ *
+ */
+static float64_t SimNode_Consumed(void)
+{
+    return SimNode_Result.ActiveCharge + SimNode_Result.IdleCharge;
+}
+
+/**
+ * \brief  Charge left in the battery.
+ *
+ * \return Charge.
+ *
+ */
+static float64_t SimNode_Left(void)
+{
+    return SimNode_Cfg.Capacity + SimNode_Result.Harvested - SimNode_Consumed();
+}
+
+/**
+ * \brief  Charge harvested from the start up to a time.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ * \return Charge.
+ *
+ * \note List of notes:
+ *       1. The harvester delivers a constant current in the daylight of each day, and nothing
+ *          for the rest of the day.
+ */
+static float64_t SimNode_Harvest(SIM_TIME_T time)
+{
+    SIM_TIME_T daylight = SA_UTILS_MIN(SimNode_Cfg.Daylight, (SIM_TIME_T) SA_UTILS_DAYS_TO_MILLI_S);
+
+    daylight = (time / SA_UTILS_DAYS_TO_MILLI_S) * daylight +
+               SA_UTILS_MIN(time % SA_UTILS_DAYS_TO_MILLI_S, daylight);
+    return SimNode_Cfg.Harvest * (float64_t) daylight / SA_UTILS_S_TO_MILLI_S;
+}
+
+/**
+ * \brief  Accounts the idle charge from the last accounting up to a time.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ * \return DEF_TRUE if the battery was depleted during the gap; otherwise DEF_FALSE.
+ *
+ * \note List of notes:
+ *       1. The depletion time is solved in closed form inside the gap.
+ *       2. The charge harvested in the gap is stored at its start, and what does not fit in
+ *          the battery is lost. The gap is a period, so the error in the depletion time is
+ *          within an activation.
+ */
+static bool_t SimNode_Idle(SIM_TIME_T time)
+{
+    float64_t idle, left, harvest;
+
+    harvest = SimNode_Harvest(time) - SimNode_Harvest(SimNode_LastTime);
+    SimNode_Result.Harvested += SA_UTILS_SATURATE(0.0, SimNode_Cfg.Capacity - SimNode_Left(), harvest);
+    idle = SimNode_Cfg.IdleCurrent * (float64_t)(time - SimNode_LastTime) / SA_UTILS_S_TO_MILLI_S;
+    left = SimNode_Left();
+    if ((idle >= left) && (0.0 < SimNode_Cfg.IdleCurrent)) {
+        SimNode_Result.IdleCharge += SA_UTILS_MAX(left, 0.0);
+        SimNode_Result.Lifetime = SimNode_LastTime +
+            (SIM_TIME_T)(SA_UTILS_MAX(left, 0.0) * SA_UTILS_S_TO_MILLI_S / SimNode_Cfg.IdleCurrent);
+        SimNode_Result.Depleted = DEF_TRUE;
+        return DEF_TRUE;
+    }
+    SimNode_Result.IdleCharge += idle;
+    SimNode_LastTime = time;
+
+    return DEF_FALSE;
+}
+
+/************* Information ******************/
+/**
+ * \brief  Accounts the error of the data at the sink from the last accounting up to a time.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ * \note List of notes:
+ *       1. The error is accounted every time the true data or the data at the sink change.
+ *          The inputs hold the true data between the steps, so a gap is a single term; a
+ *          trace is integrated with the midpoint rule, in steps of SIM_NODE_TRACK_STEP.
+ *       2. A depletion in an idle gap can be before the last input, which was accounted.
+ *       3. An event starts when the true data reaches the event level, and it is missed if it
+ *          ends before a sample at or above the level is transmitted, see SimNode_RadioActs.
+ */
+static void SimNode_Track(SIM_TIME_T time)
+{
+    SIM_NODE_TRACKER_T *p_tracker = &SimNode_Tracker;
+    SIM_TIME_T step;
+    float64_t error;
+    float32_t truth;
+
+    while (time > p_tracker->Time) {
+        step = time - p_tracker->Time;
+        if (NULL == SimNode_Cfg.Trace) {
+            truth = SimNode_Data;
+        } else {
+            step = SA_UTILS_MIN(step, SIM_NODE_TRACK_STEP);
+            truth = SimNode_Cfg.Trace(p_tracker->Time + step / 2u);
+        }
+        error = fabsf(truth - SimNode_Delivered);
+        p_tracker->Error += error * (float64_t) step;
+        p_tracker->Squared += error * error * (float64_t) step;
+        p_tracker->Max = SA_UTILS_MAX(p_tracker->Max, error);
+        p_tracker->Data += truth * (float64_t) step;
+        p_tracker->Squares += (float64_t) truth * truth * (float64_t) step;
+        p_tracker->Time += step;
+
+        if (SimNode_Cfg.EventLevel <= truth) {
+            if (DEF_FALSE == p_tracker->Event) {
+                SimNode_Result.DataEvents++;
+                p_tracker->Event = DEF_TRUE;
+                p_tracker->Detected = DEF_FALSE;
+            }
+        } else if (DEF_TRUE == p_tracker->Event) {
+            if (DEF_FALSE == p_tracker->Detected) SimNode_Result.MissedEvents++;
+            p_tracker->Event = DEF_FALSE;
+        }
+    }
+}
+
+/**
+ * \brief  Computes the information of the result from the error accounted up to the lifetime.
+ *
+ * \note List of notes:
+ *       1. An event that has not been detected at the end of the simulation is missed.
+ */
+static void SimNode_Information(void)
+{
+    SIM_NODE_TRACKER_T *p_tracker = &SimNode_Tracker;
+    float64_t lifetime = (float64_t) SimNode_Result.Lifetime, mean;
+
+    SimNode_Track(SimNode_Result.Lifetime);
+    if ((DEF_TRUE == p_tracker->Event) && (DEF_FALSE == p_tracker->Detected)) {
+        SimNode_Result.MissedEvents++;
+    }
+    if (0u == SimNode_Result.Lifetime) return;
+
+    mean = p_tracker->Data / lifetime;
+    SimNode_Result.Error = p_tracker->Error / lifetime;
+    SimNode_Result.Rmse = sqrt(p_tracker->Squared / lifetime);
+    SimNode_Result.MaxError = p_tracker->Max;
+    SimNode_Result.Deviation = sqrt(SA_UTILS_MAX(p_tracker->Squares / lifetime - mean * mean, 0.0));
+}
+
+/************* Power Agent ******************/
+/**
+ * \brief  Reads the coulomb counter.
+ *
+ * \param  p_obs:  Pointer to the observation data of the power agent.
+ *
+ * \note List of notes:
+ *       1. The counter measures the charge drawn since the last reading, with the gain error
+ *          of the counter and a gaussian noise, both relative to the charge.
+ *       2. The harvester reports all the charge it has delivered, also what did not fit in
+ *          the battery.
+ */
+static void SimNode_PowerObs(POWER_AGENT_OBS_T *p_obs)
+{
+    float64_t error = SimNode_Cfg.CounterGain;
+
+    if (0.0 != SimNode_Cfg.CounterNoise) error += SimNode_Cfg.CounterNoise * SimRandom_Gaussian();
+    SimNode_CounterDelta = (SimNode_Consumed() - SimNode_Counted) * (1.0 + error);
+    SimNode_Counted = SimNode_Consumed();
+    SimNode_Counter += SimNode_CounterDelta;
+
+    p_obs->Battery.Charge = (float32_t) SimNode_Counter;
+    p_obs->Battery.BatteryVoltage = 0;      /* No voltage measurement   */
+    p_obs->Battery.Temperature = POWER_AGENT_TEMP_REF;
+    p_obs->Battery.Harvested = (float32_t) SimNode_Harvest(SimNode_LastTime);
+}
+
+/**
+ * \brief  Actuation of the power agent, nothing to simulate.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void SimNode_PowerActs(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Radio Agent ******************/
+/**
+ * \brief  Frames relayed for other nodes in a time interval.
+ *
+ * \param  start:  Start of the interval in ms.
+ * \param  end:    End of the interval in ms.
+ *
+ * \return Frames, the relayed frames arrive at a constant rate.
+ *
+ */
+static uint32_t SimNode_Relays(SIM_TIME_T start, SIM_TIME_T end)
+{
+    float64_t rate = SimNode_Cfg.Forwarding / SA_UTILS_S_TO_MILLI_S;
+
+    return (uint32_t)(floor(rate * (float64_t) end) - floor(rate * (float64_t) start));
+}
+
+/**
+ * \brief  Radio observation, the radio config is not changed by the environment.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ * \note List of notes:
+ *       1. The frames relayed since the last observation draw the charge of a reception and
+ *          a transmission each, at the power of the radio config in use.
+ *       2. The outcome of the last transmission is reported once, if the radio reports it.
+ */
+static void SimNode_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    uint32_t frames = SimNode_Relays(SimNode_RelayTime, SimKernel_GetTime());
+
+    SimNode_RelayTime = SimKernel_GetTime();
+    SimNode_Result.ActiveCharge += frames * (1.0 + SIM_NODE_RX_SHARE) *
+                                   RadioCfg_Configs_Ptr[RadioAgent_GetConfig()].PowerCost.Power;
+    SimNode_Result.Relayed += frames;
+
+    p_obs->ConfigChange = DEF_FALSE;
+    p_obs->Forwarded = (uint16_t) SA_UTILS_MIN(frames, UINT16_MAX);
+    if ((DEF_TRUE == SimNode_Cfg.Acknowledged) && (0u != SimNode_Outcome.Attempts)) {
+        p_obs->Attempts = SimNode_Outcome.Attempts;
+        p_obs->Acked = SimNode_Outcome.Acked;
+        p_obs->Rssi = SimNode_Outcome.Rssi;
+        SimNode_Outcome.Attempts = 0;
+    }
+}
+
+/**
+ * \brief  Draws the attempts of a transmission over the link to the sink.
+ *
+ * \note List of notes:
+ *       1. Each attempt is delivered with a logistic probability of the margin of the RSSI
+ *          over SIM_NODE_SENSITIVITY, and each retry draws a backoff of SIM_NODE_BACKOFF_SHARE
+ *          of the charge of an attempt. The path loss steps by LossStep at LossTime. A
+ *          lossless link delivers the first attempt, without an RSSI.
+ */
+static void SimNode_Attempt(void)
+{
+    float64_t power = RadioCfg_Configs_Ptr[RadioAgent_GetConfig()].PowerCost.Power;
+    float64_t rssi = RadioCfg_TxPower_Ptr[RadioAgent_GetConfig()] - SimNode_Cfg.PathLoss;
+    bool_t lossy = (0.0 != SimNode_Cfg.PathLoss) ? DEF_TRUE : DEF_FALSE;
+    float64_t delivery;
+    uint8_t attempts = 1;
+
+    if (SimNode_Cfg.LossTime <= SimKernel_GetTime()) rssi -= SimNode_Cfg.LossStep;
+    delivery = 1.0 / (1.0 + exp(-(rssi - SIM_NODE_SENSITIVITY) / SIM_NODE_LINK_SLOPE));
+
+    while ((DEF_TRUE == lossy) && (SIM_NODE_ATTEMPTS > attempts) && (SimRandom_Uniform() >= delivery)) {
+        attempts++;
+    }
+    SimNode_Outcome.Attempts = attempts;
+    SimNode_Outcome.Acked = (DEF_FALSE == lossy) || (SIM_NODE_ATTEMPTS > attempts) || (SimRandom_Uniform() < delivery);
+    SimNode_Outcome.Rssi = ((DEF_TRUE == lossy) && (DEF_TRUE == SimNode_Outcome.Acked)) ?
+                           (int8_t) SA_UTILS_SATURATE(RADIO_CFG_RSSI_UNKNOWN + 1, 0, lround(rssi)) :
+                           RADIO_CFG_RSSI_UNKNOWN;
+    SimNode_Result.ActiveCharge += power * (attempts + SIM_NODE_BACKOFF_SHARE * (attempts - 1));
+    SimNode_Result.Attempts += attempts;
+    if (DEF_FALSE == SimNode_Outcome.Acked) SimNode_Result.Lost++;
+}
+
+/**
+ * \brief  Draws the charge of a transmission.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ * \note List of notes:
+ *       1. A transmission lost after all its attempts does not reach the sink.
+ */
+static void SimNode_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+    SimNode_Attempt();
+    SimNode_Result.Transmissions++;
+    if (DEF_FALSE == SimNode_Outcome.Acked) return;
+    SimNode_Track(SimKernel_GetTime());
+    SimNode_Delivered = SimNode_Sample;
+    if ((DEF_TRUE == SimNode_Tracker.Event) && (SimNode_Cfg.EventLevel <= SimNode_Sample)) {
+        SimNode_Tracker.Detected = DEF_TRUE;
+    }
+    if (NULL != SimNode_Cfg.Send) SimNode_Cfg.Send(SimKernel_GetTime(), SimNode_Sample);
+}
+
+/************* Application Agent ************/
+/**
+ * \brief  Samples the sensor, drawing the charge of the sensor config in use.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data.
+ *
+ */
+static void SimNode_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    SimNode_Result.ActiveCharge += SensorCfg_Configs_Ptr[SensorAgent_GetConfig()].PowerCost.Power;
+    SimNode_Sample = (NULL == SimNode_Cfg.Trace) ? SimNode_Data : SimNode_Cfg.Trace(SimKernel_GetTime());
+    p_obs->SensorData = SimNode_Sample;
+}
+
+/**
+ * \brief  Configuration of the sensor, read back through SensorAgent_GetConfig.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void SimNode_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Trigger observation, nothing to observe.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void SimNode_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Configuration of the trigger, read back through TriggerAgent_GetConfig.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void SimNode_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Fast-forward *****************/
+/**
+ * \brief  Updates the steady window with the last activation.
+ *
+ * \param  time:  Virtual time of the activation in ms.
+ *
+ * \return DEF_TRUE if the node is in steady state; otherwise DEF_FALSE.
+ *
+ * \note List of notes:
+ *       1. The window restarts when a config, the periodicity or the sensor data change, or
+ *          when the predicted power has moved from the start of the window, so the estimator
+ *          has not converged.
+ *       2. The window must last SIM_NODE_STEADY_ACTIVATIONS and SIM_NODE_STEADY_TIME, so it
+ *          covers a whole slot of the energy plan.
+ */
+static bool_t SimNode_Steady(SIM_TIME_T time)
+{
+    SIM_NODE_WINDOW_T *p_window = &SimNode_Window;
+    float32_t power = DecisionEng_GetPower();
+
+    if ((p_window->Sensor != SensorAgent_GetConfig()) || (p_window->Radio != RadioAgent_GetConfig()) ||
+        (p_window->Period != TriggerAgent_GetConfig()) || (p_window->Data != SimNode_Sample) ||
+        (SIM_NODE_STEADY_TOLERANCE * fabsf(p_window->Power) < fabsf(power - p_window->Power))) {
+        p_window->Sensor = SensorAgent_GetConfig();
+        p_window->Radio = RadioAgent_GetConfig();
+        p_window->Period = TriggerAgent_GetConfig();
+        p_window->Data = SimNode_Sample;
+        p_window->Power = power;
+        p_window->Start = time;
+        p_window->Activations = SimNode_Result.Activations;
+        p_window->Transmissions = SimNode_Result.Transmissions;
+        p_window->ActiveCharge = SimNode_Result.ActiveCharge;
+        return DEF_FALSE;
+    }
+
+    return ((SIM_NODE_STEADY_ACTIVATIONS <= SimNode_Result.Activations - p_window->Activations) &&
+            (SIM_NODE_STEADY_TIME <= time - p_window->Start)) ? DEF_TRUE : DEF_FALSE;
+}
+
+/**
+ * \brief  Advances the steady state in closed form, up to the next event.
+ *
+ * \param  time:  Virtual time of the last activation in ms.
+ *
+ * \return Virtual time of the next activation in ms.
+ *
+ * \note List of notes:
+ *       1. The skipped activations repeat the mean charge and transmissions of the window, and
+ *          they all end before the next event, with the charge left for the activation after
+ *          the leap, which is simulated and detects the depletion. The coulomb counter
+ *          repeats its last reading, as the power agent expects. The charge of the relayed
+ *          frames is part of the mean charge.
+ *       2. A leap draws at most SIM_NODE_LEAP_CHARGE of the capacity, so the slow drift of the
+ *          models with the remaining charge is checked by a new window.
+ */
+static SIM_TIME_T SimNode_Leap(SIM_TIME_T time)
+{
+    SIM_NODE_WINDOW_T *p_window = &SimNode_Window;
+    uint32_t activations = SimNode_Result.Activations - p_window->Activations;
+    SIM_TIME_T period = p_window->Period;
+    float64_t charge, idle, left;
+    uint64_t leap;
+
+    leap = (SimKernel_GetNextTime() - time - 1u) / period;
+
+    charge = (SimNode_Result.ActiveCharge - p_window->ActiveCharge) / activations;
+    idle = SimNode_Cfg.IdleCurrent * (float64_t) period / SA_UTILS_S_TO_MILLI_S;
+    left = SA_UTILS_MIN(SimNode_Left(), SIM_NODE_LEAP_CHARGE * SimNode_Cfg.Capacity);
+    leap = SA_UTILS_MIN(leap, (uint64_t)(left / (charge + idle)));
+    if (0u == leap) return time + period;
+
+    SimNode_Result.ActiveCharge += leap * charge;
+    SimNode_Result.IdleCharge += leap * idle;
+    SimNode_Counted += leap * (charge + idle);
+    SimNode_Counter += leap * SimNode_CounterDelta;
+    SimNode_Result.Transmissions += (uint32_t)((leap * (SimNode_Result.Transmissions - p_window->Transmissions) +
+                                                activations / 2u) / activations);
+    SimNode_Result.Activations += (uint32_t) leap;
+    SimNode_Result.Skipped += (uint32_t) leap;
+    SimNode_Result.Leaps++;
+    SimNode_LastTime = time + leap * period;
+    SimNode_Result.Relayed += SimNode_Relays(SimNode_RelayTime, SimNode_LastTime);
+    SimNode_RelayTime = SimNode_LastTime;
+    DecisionEng_Advance((uint32_t) leap);
+
+    p_window->Period = 0;           /* Restarts the window  */
+
+    return time + (leap + 1u) * period;
+}
+
+/************* Events ***********************/
+/**
+ * \brief  Runs an activation of the node and schedules the next one.
+ *
+ * \param  p_event:  Pointer to the event.
+ *
+ * \note List of notes:
+ *       1. The frames of the neighbors heard since the last activation draw the charge of a
+ *          reception each, at the power of the radio config in use. A node that listens is
+ *          not fast-forwarded, as the frames change its models.
+ *       2. A node that harvests is not fast-forwarded either, as the harvest changes along
+ *          the day.
+ */
+static void SimNode_Activation(const SIM_EVENT_T *p_event)
+{
+    SIM_TIME_T next;
+    uint32_t frames;
+
+    if (DEF_TRUE == SimNode_Idle(p_event->Time)) {
+        SimKernel_Stop();
+        return;
+    }
+
+    if (NULL != SimNode_Cfg.Listen) {
+        frames = SimNode_Cfg.Listen(p_event->Time);
+        SimNode_Result.ActiveCharge += frames * SIM_NODE_RX_SHARE *
+                                       RadioCfg_Configs_Ptr[RadioAgent_GetConfig()].PowerCost.Power;
+        SimNode_Result.Heard += frames;
+    }
+
+    SimNode_Result.ActiveCharge += SimNode_Cfg.BaseCharge;
+    DecisionEng_Loop();
+    SimNode_Result.Activations++;
+
+    if (0.0 >= SimNode_Left()) {
+        SimNode_Result.Lifetime = p_event->Time;
+        SimNode_Result.Depleted = DEF_TRUE;
+        SimKernel_Stop();
+        return;
+    }
+
+    next = p_event->Time + SA_UTILS_MAX(TriggerAgent_GetConfig(), 1u);
+    if ((DEF_TRUE == SimNode_Cfg.FastForward) && (NULL == SimNode_Cfg.Listen) &&
+        (0.0 == SimNode_Cfg.Harvest) && (DEF_TRUE == SimNode_Steady(p_event->Time))) {
+        next = SimNode_Leap(p_event->Time);
+    }
+    SimKernel_Schedule(next, SIM_EVENT_ACTIVATION, 0u);
+}
+
+/**
+ * \brief  Applies a step of the sensor data and schedules the next one.
+ *
+ * \param  p_event:  Pointer to the event, with the index of the input as data.
+ *
+ */
+static void SimNode_Input(const SIM_EVENT_T *p_event)
+{
+    SimNode_Track(p_event->Time);
+    SimNode_Data = SimNode_Cfg.Inputs[p_event->Data].Data;
+    if (p_event->Data + 1u < SimNode_Cfg.NumInputs) {
+        SimKernel_Schedule(SimNode_Cfg.Inputs[p_event->Data + 1u].Time, SIM_EVENT_INPUT,
+                           p_event->Data + 1u);
+    }
+}
+
+/**
+ * \brief  Ends the simulation at the horizon.
+ *
+ * \param  p_event:  Pointer to the event.
+ *
+ */
+static void SimNode_End(const SIM_EVENT_T *p_event)
+{
+    if (DEF_FALSE == SimNode_Idle(p_event->Time)) {
+        SimNode_Result.Lifetime = p_event->Time;
+    }
+    SimKernel_Stop();
+}
+
+/************* External *********************/
+/**
+ * \brief  Gets the configuration of the default node.
+ *
+ * \param  p_cfg:  Pointer to where the configuration will be saved.
+ *
+ */
+void SimNode_DefaultCfg(SIM_NODE_CFG_T *p_cfg)
+{
+    p_cfg->Capacity = SIM_NODE_CAPACITY;
+    p_cfg->RatedCapacity = 0.0;
+    p_cfg->CounterGain = 0.0;
+    p_cfg->CounterNoise = 0.0;
+    p_cfg->IdleCurrent = SIM_NODE_IDLE_CURRENT;
+    p_cfg->BaseCharge = SIM_NODE_BASE_CHARGE;
+    p_cfg->Horizon = SIM_NODE_HORIZON;
+    p_cfg->Trace = NULL;
+    p_cfg->Inputs = NULL;
+    p_cfg->NumInputs = 0;
+    p_cfg->FastForward = DEF_TRUE;
+    p_cfg->Policy = DECISION_ENGINE_POLICY_RELEVANCE;
+    p_cfg->EventLevel = SIM_NODE_EVENT_LEVEL;
+    p_cfg->Forwarding = 0.0;
+    p_cfg->AssignedPeriod = 0;
+    p_cfg->Node = 0;
+    p_cfg->Cooperative = DEF_FALSE;
+    p_cfg->Listen = NULL;
+    p_cfg->Send = NULL;
+    p_cfg->PathLoss = 0.0;
+    p_cfg->LossStep = 0.0;
+    p_cfg->LossTime = 0;
+    p_cfg->Acknowledged = DEF_FALSE;
+    p_cfg->Harvest = 0.0;
+    p_cfg->Daylight = 0;
+    p_cfg->EnergyNeutral = MOTE_CFG_ENERGY_NEUTRAL;
+    p_cfg->RadioBatch = 1u;
+}
+
+/**
+ * \brief  Simulates a node from a fresh battery until it is depleted or the horizon.
+ *
+ * \param  p_cfg:     Pointer to the configuration of the node.
+ * \param  p_result:  Pointer to where the result will be saved.
+ *
+ * \return DEF_OK if the simulation could run; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The decision engine is initialized from scratch, and the power agent starts with
+ *          the rated capacity of the battery, or the true capacity if it is not set.
+ *       2. Without a trace, the sensor data is SIM_NODE_SENSOR_DATA until the first input, and
+ *          an input at time 0 is seen by the first activation.
+ *       3. The decision engine runs the sampling policy of the configuration, towards the
+ *          period assigned by the sink if it is set, and in cooperative mode if it is set.
+ */
+bool_t SimNode_Run(const SIM_NODE_CFG_T *p_cfg, SIM_NODE_RESULT_T *p_result)
+{
+    DECISION_ENGINE_INIT_T init = {
+        .PowerInit.Obs = SimNode_PowerObs,
+        .PowerInit.Act = SimNode_PowerActs,
+        .PowerInit.Alarm = NULL,
+        .RadioInit.Obs = SimNode_RadioObs,
+        .RadioInit.Act = SimNode_RadioActs,
+        .RadioInit.Done = NULL,
+        .AppInit.Sensor.Obs = SimNode_SensorObs,
+        .AppInit.Sensor.Act = SimNode_SensorActs,
+        .AppInit.Sensor.Alarm = NULL,
+        .AppInit.Sensor.Start = NULL,
+        .AppInit.Sensor.Ready = NULL,
+        .AppInit.Trigger.Obs = SimNode_TriggerObs,
+        .AppInit.Trigger.Act = SimNode_TriggerActs,
+        .AppInit.Trigger.Alarm = NULL,
+        .AppInit.Alarm = NULL
+    };
+
+    SimNode_Cfg = *p_cfg;
+    memset(&SimNode_Result, 0x00, sizeof(SIM_NODE_RESULT_T));
+    memset(&SimNode_Window, 0x00, sizeof(SIM_NODE_WINDOW_T));
+    SimNode_LastTime = 0;
+    SimNode_Data = SIM_NODE_SENSOR_DATA;
+    SimNode_Counter = 0.0;
+    SimNode_Counted = 0.0;
+    SimNode_CounterDelta = 0.0;
+    SimNode_Sample = SIM_NODE_SENSOR_DATA;
+    SimNode_Delivered = SIM_NODE_SENSOR_DATA;
+    SimNode_RelayTime = 0;
+    memset(&SimNode_Outcome, 0x00, sizeof(RADIO_AGENT_OBS_T));
+    memset(&SimNode_Tracker, 0x00, sizeof(SIM_NODE_TRACKER_T));
+
+    if (DEF_FALSE == DecisionEng_Init(&init)) return DEF_FAIL;
+    DecisionEng_SetPolicy(p_cfg->Policy);
+    DecisionEng_SetAssignedPeriod(p_cfg->AssignedPeriod);
+    DecisionEng_SetEnergyNeutral(p_cfg->EnergyNeutral);
+    DecisionEng_SetRadioBatch(p_cfg->RadioBatch);
+    AppAgent_SetCooperative(p_cfg->Cooperative, p_cfg->Node);
+    PowerAgent_SetBatteryCharge((float32_t)((0.0 < p_cfg->RatedCapacity) ? p_cfg->RatedCapacity :
+                                                                            p_cfg->Capacity));
+
+    SimKernel_Init();
+    SimKernel_SetHandler(SIM_EVENT_ACTIVATION, SimNode_Activation);
+    SimKernel_SetHandler(SIM_EVENT_INPUT, SimNode_Input);
+    SimKernel_SetHandler(SIM_EVENT_END, SimNode_End);
+    if ((0u != p_cfg->NumInputs) &&
+        (DEF_FAIL == SimKernel_Schedule(p_cfg->Inputs[0].Time, SIM_EVENT_INPUT, 0u))) {
+        return DEF_FAIL;
+    }
+    if ((DEF_FAIL == SimKernel_Schedule(0u, SIM_EVENT_ACTIVATION, 0u)) ||
+        (DEF_FAIL == SimKernel_Schedule(p_cfg->Horizon, SIM_EVENT_END, 0u))) {
+        return DEF_FAIL;
+    }
+    SimKernel_Run(SIM_KERNEL_NEVER);
+
+    SimNode_Result.Events = SimKernel_GetEvents();
+    SimNode_Information();
+    *p_result = SimNode_Result;
+
+    return DEF_OK;
+}
+
+/** @} (end addtogroup SimNode)     */
+/** @} (end addtogroup Simulation)  */
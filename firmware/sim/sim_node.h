@@ -0,0 +1,135 @@
+/**
+ * \file    sim_node.h
+ *
+ * \brief   Header file for the simulation of a node in virtual time.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_NODE_H__
+#define __SIM_NODE_H__
+
+#include <float.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/mote_cfg.h"
+#include "../include/decision_engine.h"
+
+#include "sim_kernel.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimNode
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+/* Default node, the charge is in the units of the power of the configs  */
+#define SIM_NODE_CAPACITY           4.0e6       /* True charge of the battery                   */
+#define SIM_NODE_IDLE_CURRENT       0.05        /* Charge drawn per s between activations       */
+#define SIM_NODE_BASE_CHARGE        10.0        /* Charge of the MCU per activation             */
+#define SIM_NODE_SENSOR_DATA        10.0f       /* Sensor data before the first input           */
+#define SIM_NODE_EVENT_LEVEL        FLT_MAX     /* Level of the events of the data, no events   */
+#define SIM_NODE_RX_SHARE           0.5         /* Charge of a reception, of a transmission     */
+#define SIM_NODE_ATTEMPTS           4u          /* Attempts of a transmission, the retries + 1  */
+#define SIM_NODE_BACKOFF_SHARE      0.2         /* Charge of a backoff, of a transmission       */
+#define SIM_NODE_SENSITIVITY        (-90.0)     /* RSSI with half of the attempts lost          */
+#define SIM_NODE_LINK_SLOPE         2.0         /* dB of margin per logistic unit               */
+
+/* Fast-forward of the steady state */
+#define SIM_NODE_STEADY_ACTIVATIONS 8u          /* Minimum activations of a steady window       */
+#define SIM_NODE_STEADY_TIME        MOTE_CFG_PLANNER_SLOT_LENGTH    /* Minimum time of a window, ms */
+#define SIM_NODE_STEADY_TOLERANCE   1.0e-3      /* Relative change of the predicted power       */
+#define SIM_NODE_LEAP_CHARGE        0.05        /* Maximum charge of a leap, of the capacity    */
+#define SIM_NODE_TRACK_STEP         SA_UTILS_HOURS_TO_MILLI_S   /* Integration step of a trace, ms  */
+
+/* End of the simulation in ms, the expected battery life */
+#define SIM_NODE_HORIZON            ((SIM_TIME_T) MOTE_CFG_EXPECTED_BATTERY_LIFE * SA_UTILS_S_TO_MILLI_S)
+
+/************************************** Typedef **************************************************/
+typedef float32_t (*SIM_NODE_TRACE_T)(SIM_TIME_T);
+typedef uint32_t (*SIM_NODE_LISTEN_T)(SIM_TIME_T);
+typedef void (*SIM_NODE_SEND_T)(SIM_TIME_T, float32_t);
+
+/**
+ * \brief  Step of the sensor data, held until the next input.
+ *
+ */
+typedef struct {
+    SIM_TIME_T Time;                    /* Virtual time of the step in ms                   */
+    float32_t Data;                     /* Sensor data from this time on                    */
+} SIM_NODE_INPUT_T;
+
+/**
+ * \brief  Configuration of the simulated node, the true values behind the models.
+ *
+ */
+typedef struct {
+    float64_t Capacity;                 /* True charge of the battery                       */
+    float64_t RatedCapacity;            /* Charge given to the power agent, 0 for the true  */
+    float64_t CounterGain;              /* Relative gain error of the coulomb counter       */
+    float64_t CounterNoise;             /* Relative noise of each coulomb counter reading   */
+    float64_t IdleCurrent;              /* Charge drawn per s between activations           */
+    float64_t BaseCharge;               /* Charge of the MCU per activation                 */
+    SIM_TIME_T Horizon;                 /* End of the simulation in ms                      */
+    SIM_NODE_TRACE_T Trace;             /* Sensor data over time, NULL to use the inputs    */
+    const SIM_NODE_INPUT_T *Inputs;     /* Steps of the sensor data, sorted by time         */
+    uint16_t NumInputs;
+    bool_t FastForward;                 /* Advance the steady state in closed form          */
+    DECISION_ENGINE_POLICY_T Policy;    /* Sampling policy of the decision engine           */
+    float32_t EventLevel;               /* An event is the true data at or above the level  */
+    float64_t Forwarding;               /* Frames relayed for other nodes per s             */
+    uint32_t AssignedPeriod;            /* Period assigned by the sink in ms, 0 for none    */
+    uint16_t Node;                      /* Identifier of the node in its frames             */
+    bool_t Cooperative;                 /* See AppAgent_SetCooperative                      */
+    SIM_NODE_LISTEN_T Listen;           /* Frames heard up to an activation, NULL for none  */
+    SIM_NODE_SEND_T Send;               /* Sends a transmitted sample, NULL for none        */
+    float64_t PathLoss;                 /* dB of the link to the sink, 0 for a lossless one */
+    float64_t LossStep;                 /* dB added to the path loss from LossTime          */
+    SIM_TIME_T LossTime;                /* Time of the step of the path loss in ms          */
+    bool_t Acknowledged;                /* The outcome of the transmissions is reported     */
+    float64_t Harvest;                  /* Charge harvested per s in daylight, 0 for none   */
+    SIM_TIME_T Daylight;                /* Daylight at the start of each day in ms          */
+    bool_t EnergyNeutral;               /* See DecisionEng_SetEnergyNeutral                 */
+    uint8_t RadioBatch;                 /* See DecisionEng_SetRadioBatch                    */
+} SIM_NODE_CFG_T;
+
+/**
+ * \brief  Result of the simulation of a node.
+ *
+ */
+typedef struct {
+    SIM_TIME_T Lifetime;                /* Time of the depletion, or the horizon, in ms     */
+    bool_t Depleted;                    /* The battery was depleted before the horizon      */
+    uint32_t Activations;
+    uint32_t Transmissions;
+    uint32_t Attempts;                  /* Attempts of the transmissions, with the retries  */
+    uint32_t Lost;                      /* Transmissions not acknowledged                   */
+    uint32_t Relayed;                   /* Frames relayed for other nodes                   */
+    uint32_t Heard;                     /* Frames of the neighbors heard                    */
+    float64_t ActiveCharge;             /* Charge drawn by the activations                  */
+    float64_t IdleCharge;               /* Charge drawn between the activations             */
+    float64_t Harvested;                /* Harvested charge stored in the battery           */
+    uint64_t Events;                    /* Events dispatched by the kernel                  */
+    uint32_t Leaps;                     /* Fast-forwards of the steady state                */
+    uint32_t Skipped;                   /* Activations advanced in closed form              */
+    float64_t Error;                    /* Mean absolute error of the data at the sink      */
+    float64_t Rmse;                     /* Root mean square error of the data at the sink   */
+    float64_t MaxError;                 /* Maximum error of the data at the sink            */
+    float64_t Deviation;                /* Standard deviation of the true data over time    */
+    uint32_t DataEvents;                /* Events of the true data, see EventLevel          */
+    uint32_t MissedEvents;              /* Events without a sample of the event at the sink */
+} SIM_NODE_RESULT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SimNode_DefaultCfg(SIM_NODE_CFG_T *p_cfg);
+bool_t SimNode_Run(const SIM_NODE_CFG_T *p_cfg, SIM_NODE_RESULT_T *p_result);
+
+/** @} (end addtogroup SimNode)     */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_NODE_H__       */
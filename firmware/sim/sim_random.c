@@ -0,0 +1,97 @@
+/**
+ * \file    sim_random.c
+ *
+ * \brief   Random numbers of the simulation.
+ *          A xorshift64* generator, seeded with splitmix64 from a seed and a stream, so every
+ *          simulated node has its own sequence, whatever the process that simulates it.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimRandom_
+ *
+ */
+
+#include <math.h>
+#include "../platform/sa_types.h"
+
+#include "sim_random.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimRandom
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SIM_RANDOM_GOLDEN           0x9E3779B97F4A7C15ull   /* Increment of splitmix64  */
+#define SIM_RANDOM_MULTIPLIER       0x2545F4914F6CDD1Dull   /* Output of xorshift64*    */
+#define SIM_RANDOM_MANTISSA         (1.0 / 9007199254740992.0)      /* 2^-53            */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static uint64_t SimRandom_State = SIM_RANDOM_GOLDEN;
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Seeds the generator.
+ *
+ * \param  seed:    Seed of the simulation.
+ * \param  stream:  Sequence within the simulation, e.g. the index of the node.
+ *
+ */
+void SimRandom_Seed(uint64_t seed, uint64_t stream)
+{
+    uint64_t z = seed + (stream + 1u) * SIM_RANDOM_GOLDEN;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    SimRandom_State = (0u == z) ? SIM_RANDOM_GOLDEN : z;    /* The state must not be 0  */
+}
+
+/**
+ * \brief  Gets the next random number.
+ *
+ * \return Random number, uniform over 64 bits.
+ *
+ */
+uint64_t SimRandom_Next(void)
+{
+    SimRandom_State ^= SimRandom_State >> 12;
+    SimRandom_State ^= SimRandom_State << 25;
+    SimRandom_State ^= SimRandom_State >> 27;
+    return SimRandom_State * SIM_RANDOM_MULTIPLIER;
+}
+
+/**
+ * \brief  Gets a uniform random number.
+ *
+ * \return Random number in [0, 1).
+ *
+ */
+float64_t SimRandom_Uniform(void)
+{
+    return (float64_t)(SimRandom_Next() >> 11) * SIM_RANDOM_MANTISSA;
+}
+
+/**
+ * \brief  Gets a standard normal random number, with the Box-Muller transform.
+ *
+ * \return Random number with mean 0 and standard deviation 1.
+ *
+ */
+float64_t SimRandom_Gaussian(void)
+{
+    float64_t u = 1.0 - SimRandom_Uniform();       /* (0, 1], log(u) is finite */
+
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * SimRandom_Uniform());
+}
+
+/** @} (end addtogroup SimRandom)   */
+/** @} (end addtogroup Simulation)  */
@@ -0,0 +1,37 @@
+/**
+ * \file    sim_random.h
+ *
+ * \brief   Header file for the random numbers of the simulation.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_RANDOM_H__
+#define __SIM_RANDOM_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimRandom
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SimRandom_Seed(uint64_t seed, uint64_t stream);
+uint64_t SimRandom_Next(void);
+float64_t SimRandom_Uniform(void);
+float64_t SimRandom_Gaussian(void);
+
+/** @} (end addtogroup SimRandom)   */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_RANDOM_H__       */
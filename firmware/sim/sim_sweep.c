@@ -0,0 +1,268 @@
+/**
+ * \file    sim_sweep.c
+ *
+ * \brief   Parameter sweep of the policy.
+ *          Every point of the sweep sets the tuning parameters of TuningCfg and simulates the
+ *          configured nodes, e.g. nodes replaying recorded sensor traces. A point is scored
+ *          by the mean lifetime of the nodes and by the mean error of the data at the sink,
+ *          the information lost, and the points that are not dominated on both scores form
+ *          the Pareto set of the trade-off between lifetime and information.
+ *          The points are shared between worker processes, see SimWorkers. Each point is
+ *          generated from its index, so the result does not depend on the number of workers.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimSweep_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/tuning_cfg.h"
+
+#include "sim_kernel.h"
+#include "sim_random.h"
+#include "sim_workers.h"
+#include "sim_node.h"
+#include "sim_sweep.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimSweep
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function implementation **********************************/
+
+/************* Points ***********************/
+/**
+ * \brief  Sets a parameter of a point.
+ *
+ * \param  p_params:  Pointer to the parameters of the point.
+ * \param  param:     Parameter.
+ * \param  value:     Value of the parameter, rounded for the integer parameters.
+ *
+ */
+static void SimSweep_SetParam(TUNING_CFG_PARAMS_T *p_params, SIM_SWEEP_PARAM_T param, float64_t value)
+{
+    switch (param) {
+    case SIM_SWEEP_POWER_LOOP_GAIN:
+        p_params->PowerLoopGain = (float32_t) value;
+        break;
+    case SIM_SWEEP_UPDATE_STEP:
+        p_params->UpdateStep = (uint8_t) SA_UTILS_ROUND(value);
+        break;
+    case SIM_SWEEP_MAXIMUM_RATE:
+        p_params->MaximumRate = (float32_t) value;
+        break;
+    case SIM_SWEEP_DEVIATION:
+        p_params->Deviation = (float32_t) value;
+        break;
+    case SIM_SWEEP_AVERAGE_NUM:
+        p_params->AverageNum = (uint16_t) SA_UTILS_ROUND(value);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * \brief  Generates a point of the sweep from its index.
+ *
+ * \param  p_cfg:     Pointer to the configuration.
+ * \param  index:     Index of the point.
+ * \param  p_params:  Pointer to where the parameters of the point will be saved.
+ *
+ * \note List of notes:
+ *       1. The index of a grid point is a mixed radix number, with a digit per parameter.
+ */
+static void SimSweep_Point(const SIM_SWEEP_CFG_T *p_cfg, uint32_t index, TUNING_CFG_PARAMS_T *p_params)
+{
+    const SIM_SWEEP_RANGE_T *p_range;
+    float64_t fraction;
+    uint8_t param;
+
+    SimRandom_Seed(p_cfg->Seed, index);     /* Also the random numbers of the nodes    */
+    for (param = 0; param < SIM_SWEEP_PARAMS; param++) {
+        p_range = &p_cfg->Ranges[param];
+        if (SIM_SWEEP_RANDOM == p_cfg->Mode) {
+            fraction = SimRandom_Uniform();
+        } else {
+            fraction = (1u < p_range->Steps) ?
+                       (float64_t)(index % p_range->Steps) / (p_range->Steps - 1u) : 0.0;
+            index /= SA_UTILS_MAX(p_range->Steps, 1u);
+        }
+        SimSweep_SetParam(p_params, (SIM_SWEEP_PARAM_T) param,
+                          p_range->Min + fraction * (p_range->Max - p_range->Min));
+    }
+}
+
+/**
+ * \brief  Job of a worker, the evaluation of a point.
+ *
+ * \param  p_ctx:     Pointer to the configuration.
+ * \param  job:       Index of the point.
+ * \param  p_record:  Pointer to where the point will be saved.
+ *
+ * \return DEF_OK if the parameters are valid and the nodes could be simulated; otherwise
+ *         DEF_FAIL.
+ *
+ */
+static bool_t SimSweep_Job(const void *p_ctx, uint32_t job, void *p_record)
+{
+    const SIM_SWEEP_CFG_T *p_cfg = (const SIM_SWEEP_CFG_T *) p_ctx;
+    SIM_SWEEP_POINT_T *p_point = (SIM_SWEEP_POINT_T *) p_record;
+    SIM_NODE_RESULT_T result;
+    uint16_t node;
+
+    memset(p_point, 0x00, sizeof(SIM_SWEEP_POINT_T));
+    p_point->Params = TuningCfg_Params;
+    SimSweep_Point(p_cfg, job, &p_point->Params);
+    if (DEF_FAIL == TuningCfg_Set(&p_point->Params)) return DEF_FAIL;
+
+    for (node = 0; node < p_cfg->NumNodes; node++) {
+        if (DEF_FAIL == SimNode_Run(&p_cfg->Nodes[node], &result)) return DEF_FAIL;
+        p_point->Lifetime += (float64_t) result.Lifetime / p_cfg->NumNodes;
+        p_point->Error += result.Error / p_cfg->NumNodes;
+        p_point->Transmissions += result.Transmissions;
+    }
+
+    return DEF_OK;
+}
+
+/************* Pareto ***********************/
+/**
+ * \brief  Marks the points of the Pareto set, with the longest lifetime and the lowest error.
+ *
+ * \param  p_points:  Pointer to the points.
+ * \param  points:    Number of points.
+ *
+ * \return Points of the Pareto set.
+ *
+ * \note List of notes:
+ *       1. A point is dominated if another one is at least as good on both scores and better
+ *          on one of them, so equal points are all in the set.
+ */
+static uint32_t SimSweep_Pareto(SIM_SWEEP_POINT_T *p_points, uint32_t points)
+{
+    uint32_t point, other, pareto = 0;
+    SIM_SWEEP_POINT_T *p_a, *p_b;
+
+    for (point = 0; point < points; point++) {
+        p_a = &p_points[point];
+        p_a->Pareto = DEF_TRUE;
+        for (other = 0; (other < points) && (DEF_TRUE == p_a->Pareto); other++) {
+            p_b = &p_points[other];
+            if ((p_b->Lifetime >= p_a->Lifetime) && (p_b->Error <= p_a->Error) &&
+                ((p_b->Lifetime > p_a->Lifetime) || (p_b->Error < p_a->Error))) {
+                p_a->Pareto = DEF_FALSE;
+            }
+        }
+        if (DEF_TRUE == p_a->Pareto) pareto++;
+    }
+
+    return pareto;
+}
+
+/************* External *********************/
+/**
+ * \brief  Gets the default configuration: a grid of SIM_SWEEP_STEPS values of each parameter,
+ *         one worker per core and no nodes.
+ *
+ * \param  p_cfg:  Pointer to where the configuration will be saved.
+ *
+ */
+void SimSweep_DefaultCfg(SIM_SWEEP_CFG_T *p_cfg)
+{
+    static const SIM_SWEEP_RANGE_T ranges[SIM_SWEEP_PARAMS] = {
+        { SIM_SWEEP_POWER_LOOP_GAIN_MIN, SIM_SWEEP_POWER_LOOP_GAIN_MAX, SIM_SWEEP_STEPS },
+        { SIM_SWEEP_UPDATE_STEP_MIN,     SIM_SWEEP_UPDATE_STEP_MAX,     SIM_SWEEP_STEPS },
+        { SIM_SWEEP_MAXIMUM_RATE_MIN,    SIM_SWEEP_MAXIMUM_RATE_MAX,    SIM_SWEEP_STEPS },
+        { SIM_SWEEP_DEVIATION_MIN,       SIM_SWEEP_DEVIATION_MAX,       SIM_SWEEP_STEPS },
+        { SIM_SWEEP_AVERAGE_NUM_MIN,     SIM_SWEEP_AVERAGE_NUM_MAX,     SIM_SWEEP_STEPS },
+    };
+
+    p_cfg->Nodes = NULL;
+    p_cfg->NumNodes = 0;
+    memcpy(p_cfg->Ranges, ranges, sizeof(ranges));
+    p_cfg->Mode = SIM_SWEEP_GRID;
+    p_cfg->Samples = 0;
+    p_cfg->Seed = 1u;
+    p_cfg->Workers = 0;
+}
+
+/**
+ * \brief  Gets the number of points of the sweep.
+ *
+ * \param  p_cfg:  Pointer to the configuration.
+ *
+ * \return Points, the product of the steps of a grid or the samples of a random sweep.
+ *
+ */
+uint32_t SimSweep_GetPoints(const SIM_SWEEP_CFG_T *p_cfg)
+{
+    uint32_t points = 1u;
+    uint8_t param;
+
+    if (SIM_SWEEP_RANDOM == p_cfg->Mode) return p_cfg->Samples;
+
+    for (param = 0; param < SIM_SWEEP_PARAMS; param++) {
+        points *= SA_UTILS_MAX(p_cfg->Ranges[param].Steps, 1u);
+    }
+    return points;
+}
+
+/**
+ * \brief  Evaluates the points of the sweep and marks the Pareto set.
+ *
+ * \param  p_cfg:     Pointer to the configuration.
+ * \param  p_points:  Pointer to an array of SimSweep_GetPoints points, where the evaluated
+ *                    points are saved in the order of their index.
+ * \param  p_result:  Pointer to where the summary will be saved.
+ *
+ * \return DEF_OK if every point could be evaluated; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The tuning parameters in use are restored at the end, the workers run each point
+ *          with its own parameters.
+ */
+bool_t SimSweep_Run(const SIM_SWEEP_CFG_T *p_cfg, SIM_SWEEP_POINT_T *p_points,
+                    SIM_SWEEP_RESULT_T *p_result)
+{
+    TUNING_CFG_PARAMS_T params = TuningCfg_Params;
+    float64_t start = SimWorkers_Wall();
+    bool_t result;
+
+    memset(p_result, 0x00, sizeof(SIM_SWEEP_RESULT_T));
+    p_result->Points = SimSweep_GetPoints(p_cfg);
+    if ((0u == p_result->Points) || (0u == p_cfg->NumNodes)) return DEF_FAIL;
+
+    p_result->Workers = SimWorkers_Count(p_cfg->Workers);
+    result = SimWorkers_Run(SimSweep_Job, p_cfg, p_result->Points, p_result->Workers,
+                            p_points, sizeof(SIM_SWEEP_POINT_T));
+    TuningCfg_Params = params;
+    if (DEF_FAIL == result) return DEF_FAIL;
+
+    p_result->Wall = SimWorkers_Wall() - start;
+    p_result->Throughput = (0.0 < p_result->Wall) ?
+                           (float64_t) p_result->Points * p_cfg->NumNodes / p_result->Wall : 0.0;
+    p_result->Pareto = SimSweep_Pareto(p_points, p_result->Points);
+
+    return DEF_OK;
+}
+
+/** @} (end addtogroup SimSweep)    */
+/** @} (end addtogroup Simulation)  */
@@ -0,0 +1,122 @@
+/**
+ * \file    sim_sweep.h
+ *
+ * \brief   Header file for the parameter sweep of the policy.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_SWEEP_H__
+#define __SIM_SWEEP_H__
+
+#include "../platform/sa_types.h"
+#include "../configs/tuning_cfg.h"
+
+#include "sim_kernel.h"
+#include "sim_node.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimSweep
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+/* Default ranges of the parameters, around the defaults of TuningCfg   */
+#define SIM_SWEEP_POWER_LOOP_GAIN_MIN   0.1
+#define SIM_SWEEP_POWER_LOOP_GAIN_MAX   1.0
+#define SIM_SWEEP_UPDATE_STEP_MIN       5.0
+#define SIM_SWEEP_UPDATE_STEP_MAX       50.0
+#define SIM_SWEEP_MAXIMUM_RATE_MIN      0.25
+#define SIM_SWEEP_MAXIMUM_RATE_MAX      2.0
+#define SIM_SWEEP_DEVIATION_MIN         2.5
+#define SIM_SWEEP_DEVIATION_MAX         20.0
+#define SIM_SWEEP_AVERAGE_NUM_MIN       2.0
+#define SIM_SWEEP_AVERAGE_NUM_MAX       ((float64_t) TUNING_CFG_MAX_AVERAGE_NUM)
+#define SIM_SWEEP_STEPS                 3u          /* Values of each parameter in a grid       */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Swept parameters, the fields of TUNING_CFG_PARAMS_T.
+ *
+ */
+typedef enum {
+    SIM_SWEEP_POWER_LOOP_GAIN = 0,
+    SIM_SWEEP_UPDATE_STEP,
+    SIM_SWEEP_MAXIMUM_RATE,
+    SIM_SWEEP_DEVIATION,
+    SIM_SWEEP_AVERAGE_NUM,
+    SIM_SWEEP_PARAMS,
+} SIM_SWEEP_PARAM_T;
+
+/**
+ * \brief  Sampling of the parameter space.
+ *
+ */
+typedef enum {
+    SIM_SWEEP_GRID = 0,                 /* Every combination of the steps of the ranges     */
+    SIM_SWEEP_RANDOM,                   /* Uniform random points in the ranges              */
+} SIM_SWEEP_MODE_T;
+
+/**
+ * \brief  Range of a parameter.
+ *
+ */
+typedef struct {
+    float64_t Min;
+    float64_t Max;
+    uint16_t Steps;                     /* Values in a grid, 1 keeps the minimum            */
+} SIM_SWEEP_RANGE_T;
+
+/**
+ * \brief  Configuration of the sweep.
+ *
+ */
+typedef struct {
+    const SIM_NODE_CFG_T *Nodes;        /* Nodes of each point, e.g. with replayed traces   */
+    uint16_t NumNodes;
+    SIM_SWEEP_RANGE_T Ranges[SIM_SWEEP_PARAMS];
+    SIM_SWEEP_MODE_T Mode;
+    uint32_t Samples;                   /* Points of a random sweep                         */
+    uint64_t Seed;
+    uint16_t Workers;                   /* Parallel processes, 0 for one per core           */
+} SIM_SWEEP_CFG_T;
+
+/**
+ * \brief  Evaluated point of the parameter space.
+ *
+ */
+typedef struct {
+    TUNING_CFG_PARAMS_T Params;
+    float64_t Lifetime;                 /* Mean lifetime of the nodes in ms                 */
+    float64_t Error;                    /* Mean error of the data at the sink               */
+    uint32_t Transmissions;             /* Transmissions of all the nodes                   */
+    bool_t Pareto;                      /* Not dominated by another point                   */
+} SIM_SWEEP_POINT_T;
+
+/**
+ * \brief  Summary of the sweep.
+ *
+ */
+typedef struct {
+    uint32_t Points;
+    uint32_t Pareto;                    /* Points of the Pareto set                         */
+    uint16_t Workers;
+    float64_t Wall;                     /* Wall time in s                                   */
+    float64_t Throughput;               /* Simulated nodes per s                            */
+} SIM_SWEEP_RESULT_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void SimSweep_DefaultCfg(SIM_SWEEP_CFG_T *p_cfg);
+uint32_t SimSweep_GetPoints(const SIM_SWEEP_CFG_T *p_cfg);
+bool_t SimSweep_Run(const SIM_SWEEP_CFG_T *p_cfg, SIM_SWEEP_POINT_T *p_points,
+                    SIM_SWEEP_RESULT_T *p_result);
+
+/** @} (end addtogroup SimSweep)    */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_SWEEP_H__       */
@@ -0,0 +1,256 @@
+/**
+ * \file    sim_workers.c
+ *
+ * \brief   Worker processes of the simulation.
+ *          The decision engine keeps its state in static variables, so the independent jobs of
+ *          a simulation, e.g. the nodes of a Monte Carlo run or the points of a parameter
+ *          sweep, run in parallel as processes rather than threads. The jobs are shared
+ *          between the workers, and each worker sends the result of its jobs to the parent
+ *          through a pipe. The result of a job only depends on its index, so it does not
+ *          depend on the number of workers.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimWorkers_
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define SIM_WORKERS_FORK                        /* Workers as processes     */
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+#endif
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+
+#include "sim_workers.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimWorkers
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Result of a job, sent by a worker.
+ *
+ */
+typedef struct {
+    uint32_t Job;
+    uint8_t Record[SIM_WORKERS_MAX_RECORD];
+} SIM_WORKERS_MESSAGE_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function implementation **********************************/
+
+#ifdef SIM_WORKERS_FORK
+/**
+ * \brief  Runs the jobs of a worker process, sending the results through a pipe.
+ *
+ * \param  job:          Job function.
+ * \param  p_ctx:        Pointer to the context of the jobs.
+ * \param  jobs:         Number of jobs.
+ * \param  worker:       Index of the worker.
+ * \param  workers:      Number of workers.
+ * \param  record_size:  Size of the result of a job.
+ * \param  fd:           Write end of the pipe.
+ *
+ * \return Exit status of the process.
+ *
+ */
+static int SimWorkers_Worker(SIM_WORKERS_JOB_T job, const void *p_ctx, uint32_t jobs, uint16_t worker,
+                             uint16_t workers, uint16_t record_size, int fd)
+{
+    SIM_WORKERS_MESSAGE_T message;
+    ssize_t size = (ssize_t)(sizeof(message.Job) + record_size);
+
+    for (message.Job = worker; message.Job < jobs; message.Job += workers) {
+        memset(message.Record, 0x00, record_size);
+        if ((DEF_FAIL == job(p_ctx, message.Job, message.Record)) ||
+            (size != write(fd, &message, (size_t) size))) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * \brief  Runs the jobs in worker processes and collects their results.
+ *
+ * \param  job:          Job function.
+ * \param  p_ctx:        Pointer to the context of the jobs.
+ * \param  jobs:         Number of jobs.
+ * \param  workers:      Number of workers.
+ * \param  p_records:    Pointer to where the result of each job will be saved.
+ * \param  record_size:  Size of the result of a job.
+ *
+ * \return DEF_OK if every job could run; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The pipes are polled, so a worker never waits on a full pipe while another one is
+ *          read. A message is smaller than PIPE_BUF, so it is written and read at once.
+ */
+static bool_t SimWorkers_Fork(SIM_WORKERS_JOB_T job, const void *p_ctx, uint32_t jobs, uint16_t workers,
+                              uint8_t *p_records, uint16_t record_size)
+{
+    struct pollfd fds[SIM_WORKERS_MAX];
+    pid_t pids[SIM_WORKERS_MAX];
+    SIM_WORKERS_MESSAGE_T message;
+    ssize_t size = (ssize_t)(sizeof(message.Job) + record_size);
+    uint32_t received = 0;
+    uint16_t worker, open = 0;
+    int pipe_fds[2], status;
+    bool_t result = DEF_OK;
+
+    fflush(stdout);                     /* Not printed again by the workers */
+    for (worker = 0; worker < workers; worker++) {
+        pids[worker] = -1;
+        fds[worker].fd = -1;
+        fds[worker].events = POLLIN;
+        if (0 != pipe(pipe_fds)) {
+            result = DEF_FAIL;
+            continue;
+        }
+        pids[worker] = fork();
+        if (0 == pids[worker]) {
+            close(pipe_fds[0]);
+            _exit(SimWorkers_Worker(job, p_ctx, jobs, worker, workers, record_size, pipe_fds[1]));
+        }
+        close(pipe_fds[1]);
+        if (0 > pids[worker]) {
+            close(pipe_fds[0]);
+            result = DEF_FAIL;
+        } else {
+            fds[worker].fd = pipe_fds[0];
+            open++;
+        }
+    }
+
+    while (0u != open) {
+        if (0 > poll(fds, workers, -1)) break;
+        for (worker = 0; worker < workers; worker++) {
+            if ((0 > fds[worker].fd) || (0 == fds[worker].revents)) continue;
+            if ((size == read(fds[worker].fd, &message, (size_t) size)) && (jobs > message.Job)) {
+                memcpy(&p_records[(size_t) message.Job * record_size], message.Record, record_size);
+                received++;
+            } else {
+                close(fds[worker].fd);  /* End of the worker    */
+                fds[worker].fd = -1;
+                open--;
+            }
+        }
+    }
+
+    for (worker = 0; worker < workers; worker++) {
+        if (0 > pids[worker]) continue;
+        if (0 <= fds[worker].fd) close(fds[worker].fd);
+        if ((pids[worker] != waitpid(pids[worker], &status, 0)) ||
+            (0 == WIFEXITED(status)) || (EXIT_SUCCESS != WEXITSTATUS(status))) {
+            result = DEF_FAIL;
+        }
+    }
+
+    return ((DEF_OK == result) && (jobs == received)) ? DEF_OK : DEF_FAIL;
+}
+#endif
+
+/************* External *********************/
+/**
+ * \brief  Gets the number of workers.
+ *
+ * \param  requested:  Workers requested, 0 for one per core.
+ *
+ * \return Number of workers, 1 without worker processes.
+ *
+ */
+uint16_t SimWorkers_Count(uint16_t requested)
+{
+#ifdef SIM_WORKERS_FORK
+    long cores;
+
+    if (0u == requested) {
+        cores = sysconf(_SC_NPROCESSORS_ONLN);
+        requested = (uint16_t)((0 < cores) ? cores : 1);
+    }
+    return SA_UTILS_MIN(requested, SIM_WORKERS_MAX);
+#else
+    (void) requested;
+    return 1u;
+#endif
+}
+
+/**
+ * \brief  Gets the wall time.
+ *
+ * \return Time in s.
+ *
+ */
+float64_t SimWorkers_Wall(void)
+{
+#ifdef SIM_WORKERS_FORK
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (float64_t) now.tv_sec + (float64_t) now.tv_nsec * 1.0e-9;
+#else
+    return (float64_t) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * \brief  Runs the jobs, in parallel with more than one worker.
+ *
+ * \param  job:          Job function.
+ * \param  p_ctx:        Pointer to the context of the jobs.
+ * \param  jobs:         Number of jobs.
+ * \param  workers:      Number of workers, see SimWorkers_Count.
+ * \param  p_records:    Pointer to an array of jobs results, where the result of each job is
+ *                       saved at the index of the job.
+ * \param  record_size:  Size of the result of a job, at most SIM_WORKERS_MAX_RECORD.
+ *
+ * \return DEF_OK if every job could run; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. With one worker, or without fork, the jobs run in this process, one after the other.
+ *       2. Each record is cleared before its job, so the records, padding included, do not depend
+ *          on the number of workers.
+ */
+bool_t SimWorkers_Run(SIM_WORKERS_JOB_T job, const void *p_ctx, uint32_t jobs, uint16_t workers,
+                      void *p_records, uint16_t record_size)
+{
+    uint8_t *p_record = (uint8_t *) p_records;
+    bool_t result = DEF_OK;
+    uint32_t index;
+
+    if (SIM_WORKERS_MAX_RECORD < record_size) return DEF_FAIL;
+
+#ifdef SIM_WORKERS_FORK
+    if (1u < workers) {
+        return SimWorkers_Fork(job, p_ctx, jobs, SA_UTILS_MIN(workers, SIM_WORKERS_MAX), p_record,
+                               record_size);
+    }
+#endif
+    for (index = 0; (index < jobs) && (DEF_OK == result); index++) {
+        memset(&p_record[(size_t) index * record_size], 0x00, record_size);
+        result = job(p_ctx, index, &p_record[(size_t) index * record_size]);
+    }
+
+    return result;
+}
+
+/** @} (end addtogroup SimWorkers)  */
+/** @} (end addtogroup Simulation)  */
@@ -0,0 +1,50 @@
+/**
+ * \file    sim_workers.h
+ *
+ * \brief   Header file for the worker processes of the simulation.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_WORKERS_H__
+#define __SIM_WORKERS_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Simulation
+ *   @{
+ */
+/** \addtogroup SimWorkers
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SIM_WORKERS_MAX             64u         /* Maximum worker processes                     */
+#define SIM_WORKERS_MAX_RECORD      256u        /* Maximum size of the result of a job in bytes */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Job run by a worker.
+ *
+ * \param  p_ctx:     Pointer to the context shared by the jobs.
+ * \param  job:       Index of the job.
+ * \param  p_record:  Pointer to where the result of the job will be saved.
+ *
+ * \return DEF_OK if the job could run; otherwise DEF_FAIL.
+ *
+ */
+typedef bool_t (*SIM_WORKERS_JOB_T)(const void *p_ctx, uint32_t job, void *p_record);
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+uint16_t SimWorkers_Count(uint16_t requested);
+float64_t SimWorkers_Wall(void);
+bool_t SimWorkers_Run(SIM_WORKERS_JOB_T job, const void *p_ctx, uint32_t jobs, uint16_t workers,
+                      void *p_records, uint16_t record_size);
+
+/** @} (end addtogroup SimWorkers)  */
+/** @} (end addtogroup Simulation)  */
+
+#endif  /* __SIM_WORKERS_H__       */
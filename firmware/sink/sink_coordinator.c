@@ -0,0 +1,586 @@
+/**
+ * \file    sink_coordinator.c
+ *
+ * \brief   Coordinator of the sampling periods of the network, run by the sink.
+ *          Each node is assigned one of the periods of TriggerCfg_Periods, so that the
+ *          information the network delivers per day is the highest the batteries allow. A node
+ *          pays for its own frames and for the frames of the nodes routed through it, so a
+ *          faster period is paid by the node and by every relay on its route to the sink.
+ *          The assignment is a greedy one: starting from the slowest periods, the faster period
+ *          that gives the most information per charge of the route is assigned while no node
+ *          on the route goes over its budget. The candidates come out of a heap, and a
+ *          candidate that does not fit waits parked at the node that blocked it, so a change
+ *          in the battery of a node only re-evaluates the candidates it blocked, instead of
+ *          solving the whole network again.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SinkCoord_
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/trigger_cfg.h"
+
+#include "sink_coordinator.h"
+
+/** \addtogroup Sink
+ *   @{
+ */
+/** \addtogroup SinkCoord
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+static int SinkCoord_CompareWorth(const void *p_a, const void *p_b);
+
+/************************************** Local Var ************************************************/
+static uint32_t SinkCoord_Nodes;
+static uint32_t SinkCoord_Sink;
+static SINK_COORD_NODE_T SinkCoord_Node[SINK_COORD_MAX_NODES];
+static uint8_t SinkCoord_Level[SINK_COORD_MAX_NODES];       /* Index of the assigned period     */
+static float64_t SinkCoord_Slack[SINK_COORD_MAX_NODES];     /* Budget left per day              */
+static float64_t SinkCoord_Path[SINK_COORD_MAX_NODES];      /* Charge of a frame to the sink    */
+static SINK_COORD_STATUS_T SinkCoord_Status;
+
+/* Routing tree, in preorder from the sink */
+static uint32_t SinkCoord_ChildRows[SINK_COORD_MAX_NODES + 1u];
+static uint32_t SinkCoord_Children[SINK_COORD_MAX_NODES];
+static uint32_t SinkCoord_Preorder[SINK_COORD_MAX_NODES];
+static uint32_t SinkCoord_First[SINK_COORD_MAX_NODES];      /* Position in the preorder         */
+static uint32_t SinkCoord_Size[SINK_COORD_MAX_NODES];       /* Nodes of the subtree             */
+static uint32_t SinkCoord_Routed;                           /* Nodes in the preorder            */
+
+/* Candidates, in a heap by priority or parked at the node that blocked them */
+static uint32_t SinkCoord_Heap[SINK_COORD_MAX_NODES];
+static uint32_t SinkCoord_Position[SINK_COORD_MAX_NODES];   /* In the heap, NONE if not         */
+static float64_t SinkCoord_Keys[SINK_COORD_MAX_NODES];      /* Priority of the candidate        */
+static uint32_t SinkCoord_HeapSize;
+static uint32_t SinkCoord_Parked[SINK_COORD_MAX_NODES];     /* First candidate blocked by a node*/
+static uint32_t SinkCoord_Blocker[SINK_COORD_MAX_NODES];    /* NONE if not parked               */
+static uint32_t SinkCoord_Next[SINK_COORD_MAX_NODES];
+static uint32_t SinkCoord_Prev[SINK_COORD_MAX_NODES];
+
+/* Nodes of a subtree over budget, by the worth of their last faster period */
+static uint32_t SinkCoord_Shedding[SINK_COORD_MAX_NODES];
+static float64_t SinkCoord_Worth[SINK_COORD_MAX_NODES];
+
+/************************************** Function implementation **********************************/
+
+/************* Model ************************/
+/**
+ * \brief  Frames per day of a period.
+ *
+ * \param  level:  Index of the period in TriggerCfg_Periods.
+ *
+ * \return Frames per day.
+ *
+ */
+static float64_t SinkCoord_Frames(uint8_t level)
+{
+    return (float64_t) SA_UTILS_DAYS_TO_MILLI_S / TriggerCfg_Periods_Ptr[level];
+}
+
+/**
+ * \brief  Information per charge of a node going one period faster.
+ *
+ * \param  node:   Node.
+ * \param  level:  Current period of the node, slower than SINK_COORD_FASTEST.
+ *
+ * \return Priority of the faster period.
+ *
+ * \note List of notes:
+ *       1. The information of a node is its weight times the logarithm of its frames per day,
+ *          so doubling the rate of any node is worth its weight, and the worth of a faster
+ *          period falls as the period shortens.
+ */
+static float64_t SinkCoord_Priority(uint32_t node, uint8_t level)
+{
+    float64_t slow = SinkCoord_Frames(level), fast = SinkCoord_Frames(level - 1u);
+
+    return SinkCoord_Node[node].Weight * log(fast / slow) / ((fast - slow) * SinkCoord_Path[node]);
+}
+
+/**
+ * \brief  Charges a change of the frames of a node to it and to the relays to the sink.
+ *
+ * \param  node:    Node.
+ * \param  frames:  Change of the frames per day, negative for a slower period.
+ *
+ */
+static void SinkCoord_Charge(uint32_t node, float64_t frames)
+{
+    uint32_t relay;
+
+    SinkCoord_Slack[node] -= SinkCoord_Node[node].Frame * frames;
+    for (relay = SinkCoord_Node[node].Parent; SinkCoord_Sink != relay; relay = SinkCoord_Node[relay].Parent) {
+        SinkCoord_Slack[relay] -= SinkCoord_Node[relay].Relay * frames;
+    }
+}
+
+/**
+ * \brief  Finds the first node on the route of a node without the budget for more frames.
+ *
+ * \param  node:    Node.
+ * \param  frames:  Increment of the frames per day.
+ *
+ * \return Blocking node, or SINK_COORD_NONE if the route has the budget.
+ *
+ */
+static uint32_t SinkCoord_Blocking(uint32_t node, float64_t frames)
+{
+    uint32_t relay;
+
+    if (SinkCoord_Slack[node] < SinkCoord_Node[node].Frame * frames) return node;
+    for (relay = SinkCoord_Node[node].Parent; SinkCoord_Sink != relay; relay = SinkCoord_Node[relay].Parent) {
+        if (SinkCoord_Slack[relay] < SinkCoord_Node[relay].Relay * frames) return relay;
+    }
+    return SINK_COORD_NONE;
+}
+
+/************* Candidates *******************/
+/**
+ * \brief  Swaps two entries of the heap.
+ *
+ * \param  a:  First entry.
+ * \param  b:  Second entry.
+ *
+ */
+static void SinkCoord_Swap(uint32_t a, uint32_t b)
+{
+    uint32_t node = SinkCoord_Heap[a];
+
+    SinkCoord_Heap[a] = SinkCoord_Heap[b];
+    SinkCoord_Heap[b] = node;
+    SinkCoord_Position[SinkCoord_Heap[a]] = a;
+    SinkCoord_Position[SinkCoord_Heap[b]] = b;
+}
+
+/**
+ * \brief  Priority of the candidate of an entry of the heap.
+ *
+ * \param  entry:  Entry.
+ *
+ * \return Priority.
+ *
+ */
+static float64_t SinkCoord_Key(uint32_t entry)
+{
+    return SinkCoord_Keys[SinkCoord_Heap[entry]];
+}
+
+/**
+ * \brief  Moves an entry of the heap to its place.
+ *
+ * \param  entry:  Entry.
+ *
+ */
+static void SinkCoord_Sift(uint32_t entry)
+{
+    uint32_t child;
+
+    while ((0u < entry) && (SinkCoord_Key(entry) > SinkCoord_Key((entry - 1u) / 2u))) {
+        SinkCoord_Swap(entry, (entry - 1u) / 2u);
+        entry = (entry - 1u) / 2u;
+    }
+    for (child = 2u * entry + 1u; child < SinkCoord_HeapSize; child = 2u * entry + 1u) {
+        if ((child + 1u < SinkCoord_HeapSize) && (SinkCoord_Key(child + 1u) > SinkCoord_Key(child))) child++;
+        if (SinkCoord_Key(child) <= SinkCoord_Key(entry)) break;
+        SinkCoord_Swap(entry, child);
+        entry = child;
+    }
+}
+
+/**
+ * \brief  Adds a node to the candidates, if it can go faster.
+ *
+ * \param  node:  Node, neither in the heap nor parked.
+ *
+ */
+static void SinkCoord_Push(uint32_t node)
+{
+    if (SINK_COORD_FASTEST == SinkCoord_Level[node]) return;
+    SinkCoord_Keys[node] = SinkCoord_Priority(node, SinkCoord_Level[node]);
+    SinkCoord_Heap[SinkCoord_HeapSize] = node;
+    SinkCoord_Position[node] = SinkCoord_HeapSize++;
+    SinkCoord_Sift(SinkCoord_Position[node]);
+}
+
+/**
+ * \brief  Removes a node from the candidates, in the heap or parked.
+ *
+ * \param  node:  Node.
+ *
+ */
+static void SinkCoord_Withdraw(uint32_t node)
+{
+    uint32_t entry = SinkCoord_Position[node];
+
+    if (SINK_COORD_NONE != entry) {
+        SinkCoord_Position[node] = SINK_COORD_NONE;
+        if (entry != --SinkCoord_HeapSize) {
+            SinkCoord_Heap[entry] = SinkCoord_Heap[SinkCoord_HeapSize];
+            SinkCoord_Position[SinkCoord_Heap[entry]] = entry;
+            SinkCoord_Sift(entry);
+        }
+    } else if (SINK_COORD_NONE != SinkCoord_Blocker[node]) {
+        if (SINK_COORD_NONE != SinkCoord_Prev[node]) {
+            SinkCoord_Next[SinkCoord_Prev[node]] = SinkCoord_Next[node];
+        } else {
+            SinkCoord_Parked[SinkCoord_Blocker[node]] = SinkCoord_Next[node];
+        }
+        if (SINK_COORD_NONE != SinkCoord_Next[node]) SinkCoord_Prev[SinkCoord_Next[node]] = SinkCoord_Prev[node];
+        SinkCoord_Blocker[node] = SINK_COORD_NONE;
+    }
+}
+
+/**
+ * \brief  Parks a candidate at the node that blocked it.
+ *
+ * \param  node:     Candidate, out of the heap.
+ * \param  blocker:  Blocking node.
+ *
+ */
+static void SinkCoord_Park(uint32_t node, uint32_t blocker)
+{
+    SinkCoord_Blocker[node] = blocker;
+    SinkCoord_Prev[node] = SINK_COORD_NONE;
+    SinkCoord_Next[node] = SinkCoord_Parked[blocker];
+    if (SINK_COORD_NONE != SinkCoord_Next[node]) SinkCoord_Prev[SinkCoord_Next[node]] = node;
+    SinkCoord_Parked[blocker] = node;
+}
+
+/**
+ * \brief  Returns the candidates blocked by a node to the heap, after its budget grew.
+ *
+ * \param  blocker:  Node.
+ *
+ */
+static void SinkCoord_Release(uint32_t blocker)
+{
+    uint32_t node;
+
+    while (SINK_COORD_NONE != SinkCoord_Parked[blocker]) {
+        node = SinkCoord_Parked[blocker];
+        SinkCoord_Parked[blocker] = SinkCoord_Next[node];
+        SinkCoord_Blocker[node] = SINK_COORD_NONE;
+        SinkCoord_Push(node);
+    }
+}
+
+/**
+ * \brief  Assigns the faster periods of the candidates, in order of priority, while they fit.
+ *
+ */
+static void SinkCoord_Greedy(void)
+{
+    uint32_t node, blocker;
+    uint8_t level;
+    float64_t frames;
+
+    while (0u < SinkCoord_HeapSize) {
+        node = SinkCoord_Heap[0];
+        SinkCoord_Withdraw(node);
+        level = SinkCoord_Level[node];
+        frames = SinkCoord_Frames(level - 1u) - SinkCoord_Frames(level);
+        SinkCoord_Status.Evaluations++;
+
+        blocker = SinkCoord_Blocking(node, frames);
+        if (SINK_COORD_NONE != blocker) {
+            SinkCoord_Park(node, blocker);
+            continue;
+        }
+        SinkCoord_Charge(node, frames);
+        SinkCoord_Level[node] = level - 1u;
+        SinkCoord_Status.Upgrades++;
+        SinkCoord_Push(node);
+    }
+}
+
+/**
+ * \brief  Orders two nodes by the worth of their last faster period, for qsort.
+ *
+ * \param  p_a:  Pointer to the first node.
+ * \param  p_b:  Pointer to the second node.
+ *
+ * \return Negative, 0 or positive as the first worth is lower, equal or higher.
+ *
+ */
+static int SinkCoord_CompareWorth(const void *p_a, const void *p_b)
+{
+    float64_t a = SinkCoord_Worth[*(const uint32_t*) p_a], b = SinkCoord_Worth[*(const uint32_t*) p_b];
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * \brief  Assigns a node the next slower period.
+ *
+ * \param  node:  Node, faster than SINK_COORD_SLOWEST.
+ *
+ * \note List of notes:
+ *       1. The node and the relays on its route get budget back, so the candidates they
+ *          blocked are evaluated again.
+ */
+static void SinkCoord_Slower(uint32_t node)
+{
+    uint32_t relay;
+
+    SinkCoord_Withdraw(node);
+    SinkCoord_Charge(node, SinkCoord_Frames(SinkCoord_Level[node] + 1u) - SinkCoord_Frames(SinkCoord_Level[node]));
+    SinkCoord_Level[node]++;
+    SinkCoord_Status.Downgrades++;
+    SinkCoord_Push(node);
+    SinkCoord_Release(node);
+    for (relay = SinkCoord_Node[node].Parent; SinkCoord_Sink != relay; relay = SinkCoord_Node[relay].Parent) {
+        SinkCoord_Release(relay);
+    }
+}
+
+/**
+ * \brief  Assigns slower periods in the subtree of a node until it is within its budget.
+ *
+ * \param  node:  Node over its budget.
+ *
+ * \note List of notes:
+ *       1. The nodes of the subtree go one period slower in order of the worth of their last
+ *          faster period, the least information per charge first, which undoes the greedy
+ *          assignment. A pass over the subtree that is not enough is followed by another.
+ */
+static void SinkCoord_Shed(uint32_t node)
+{
+    uint32_t position, other, count, index;
+
+    while (0.0 > SinkCoord_Slack[node]) {
+        count = 0;
+        for (position = SinkCoord_First[node]; position < SinkCoord_First[node] + SinkCoord_Size[node]; position++) {
+            other = SinkCoord_Preorder[position];
+            if (SINK_COORD_SLOWEST == SinkCoord_Level[other]) continue;
+            SinkCoord_Worth[other] = SinkCoord_Priority(other, SinkCoord_Level[other] + 1u);
+            SinkCoord_Shedding[count++] = other;
+        }
+        if (0u == count) return;                        /* Overspent at the slowest periods */
+
+        qsort(SinkCoord_Shedding, count, sizeof(uint32_t), SinkCoord_CompareWorth);
+        for (index = 0; (index < count) && (0.0 > SinkCoord_Slack[node]); index++) {
+            SinkCoord_Slower(SinkCoord_Shedding[index]);
+        }
+    }
+}
+
+/************* Main *************************/
+/**
+ * \brief  Initializes the coordinator with the nodes of the network.
+ *
+ * \param  nodes:    Number of nodes.
+ * \param  sink:     Sink, which has no budget.
+ * \param  p_nodes:  Pointer to the nodes, copied.
+ *
+ * \return DEF_OK if the network is valid; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The nodes without a route to the sink keep the slowest period and deliver no
+ *          information.
+ *       2. Every node keeps the slowest period until SinkCoord_Solve.
+ */
+bool_t SinkCoord_Init(uint32_t nodes, uint32_t sink, const SINK_COORD_NODE_T *p_nodes)
+{
+    uint32_t node, parent, stack = 0, position;
+
+    if ((SINK_COORD_MAX_NODES < nodes) || (sink >= nodes)) return DEF_FAIL;
+    for (node = 0; node < nodes; node++) {
+        parent = p_nodes[node].Parent;
+        if ((node != sink) && (SINK_COORD_NONE != parent) &&
+            ((parent >= nodes) || (0.0 >= p_nodes[node].Frame) || (0.0 > p_nodes[node].Relay))) {
+            return DEF_FAIL;
+        }
+    }
+    SinkCoord_Nodes = nodes;
+    SinkCoord_Sink = sink;
+    memcpy(SinkCoord_Node, p_nodes, nodes * sizeof(SINK_COORD_NODE_T));
+    SinkCoord_Node[sink].Parent = SINK_COORD_NONE;
+
+    /* Children                 */
+    memset(SinkCoord_ChildRows, 0x00, (nodes + 1u) * sizeof(uint32_t));
+    for (node = 0; node < nodes; node++) {
+        if (SINK_COORD_NONE != SinkCoord_Node[node].Parent) SinkCoord_ChildRows[SinkCoord_Node[node].Parent + 1u]++;
+    }
+    for (node = 0; node < nodes; node++) {
+        SinkCoord_ChildRows[node + 1u] += SinkCoord_ChildRows[node];
+    }
+    for (node = 0; node < nodes; node++) {
+        parent = SinkCoord_Node[node].Parent;
+        if (SINK_COORD_NONE != parent) SinkCoord_Children[SinkCoord_ChildRows[parent]++] = node;
+    }
+    for (node = nodes; 0u < node; node--) {             /* Back to the start of each row    */
+        SinkCoord_ChildRows[node] = SinkCoord_ChildRows[node - 1u];
+    }
+    SinkCoord_ChildRows[0] = 0;
+
+    /* Preorder from the sink, the heap is the stack */
+    SinkCoord_Routed = 0;
+    for (node = 0; node < nodes; node++) {
+        SinkCoord_First[node] = SINK_COORD_NONE;
+        SinkCoord_Level[node] = SINK_COORD_SLOWEST;
+    }
+    SinkCoord_Heap[stack++] = sink;
+    while (0u < stack) {
+        node = SinkCoord_Heap[--stack];
+        SinkCoord_First[node] = SinkCoord_Routed;
+        SinkCoord_Preorder[SinkCoord_Routed++] = node;
+        for (position = SinkCoord_ChildRows[node]; position < SinkCoord_ChildRows[node + 1u]; position++) {
+            SinkCoord_Heap[stack++] = SinkCoord_Children[position];
+        }
+    }
+    for (position = SinkCoord_Routed; 0u < position; position--) {     /* Children first */
+        node = SinkCoord_Preorder[position - 1u];
+        SinkCoord_Size[node] = 1u;
+        for (parent = SinkCoord_ChildRows[node]; parent < SinkCoord_ChildRows[node + 1u]; parent++) {
+            SinkCoord_Size[node] += SinkCoord_Size[SinkCoord_Children[parent]];
+        }
+    }
+
+    /* Charge of a frame to the sink, the relays first */
+    SinkCoord_Path[sink] = 0.0;
+    for (position = 1u; position < SinkCoord_Routed; position++) {
+        node = SinkCoord_Preorder[position];
+        parent = SinkCoord_Node[node].Parent;
+        SinkCoord_Path[node] = SinkCoord_Node[node].Frame +
+                               ((sink == parent) ? 0.0 : SinkCoord_Path[parent] - SinkCoord_Node[parent].Frame +
+                                                         SinkCoord_Node[parent].Relay);
+    }
+    memset(&SinkCoord_Status, 0x00, sizeof(SINK_COORD_STATUS_T));
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Assigns the periods of the whole network from the slowest ones.
+ *
+ */
+void SinkCoord_Solve(void)
+{
+    uint32_t position, node;
+    float64_t frames = SinkCoord_Frames(SINK_COORD_SLOWEST);
+
+    memset(&SinkCoord_Status, 0x00, sizeof(SINK_COORD_STATUS_T));
+    SinkCoord_HeapSize = 0;
+    for (node = 0; node < SinkCoord_Nodes; node++) {
+        SinkCoord_Level[node] = SINK_COORD_SLOWEST;
+        SinkCoord_Slack[node] = SinkCoord_Node[node].Budget - SinkCoord_Node[node].Fixed;
+        SinkCoord_Position[node] = SINK_COORD_NONE;
+        SinkCoord_Blocker[node] = SINK_COORD_NONE;
+        SinkCoord_Parked[node] = SINK_COORD_NONE;
+    }
+    for (position = 1u; position < SinkCoord_Routed; position++) {
+        SinkCoord_Charge(SinkCoord_Preorder[position], frames);
+    }
+    for (position = 1u; position < SinkCoord_Routed; position++) {
+        SinkCoord_Push(SinkCoord_Preorder[position]);
+    }
+    SinkCoord_Greedy();
+}
+
+/**
+ * \brief  Changes the budget of a node and updates the assignment.
+ *
+ * \param  node:    Node, with a route to the sink.
+ * \param  budget:  Charge per day the battery allows.
+ *
+ * \return DEF_OK if the budget is changed; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. A lower budget sheds the faster periods of the subtree of the node, and a higher one
+ *          evaluates again the candidates it blocked, see SinkCoord_Shed.
+ */
+bool_t SinkCoord_SetBudget(uint32_t node, float64_t budget)
+{
+    if ((node >= SinkCoord_Nodes) || (node == SinkCoord_Sink) || (SINK_COORD_NONE == SinkCoord_First[node])) {
+        return DEF_FAIL;
+    }
+    memset(&SinkCoord_Status, 0x00, sizeof(SINK_COORD_STATUS_T));
+    SinkCoord_Slack[node] += budget - SinkCoord_Node[node].Budget;
+    SinkCoord_Node[node].Budget = budget;
+    SinkCoord_Shed(node);
+    SinkCoord_Release(node);
+    SinkCoord_Greedy();
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Gets the period assigned to a node, see DecisionEng_SetAssignedPeriod.
+ *
+ * \param  node:  Node.
+ *
+ * \return Period in ms, 0 for the sink or a node without a route.
+ *
+ */
+uint32_t SinkCoord_GetPeriod(uint32_t node)
+{
+    if ((node == SinkCoord_Sink) || (SINK_COORD_NONE == SinkCoord_First[node])) return 0u;
+    return TriggerCfg_Periods_Ptr[SinkCoord_Level[node]];
+}
+
+/**
+ * \brief  Gets the period assigned to a node as an index of TriggerCfg_Periods.
+ *
+ * \param  node:  Node.
+ *
+ * \return Index of the period.
+ *
+ */
+uint8_t SinkCoord_GetLevel(uint32_t node)
+{
+    return SinkCoord_Level[node];
+}
+
+/**
+ * \brief  Gets the charge per day of a node with the assigned periods.
+ *
+ * \param  node:  Node.
+ *
+ * \return Charge per day, 0 for the sink or a node without a route.
+ *
+ */
+float64_t SinkCoord_GetCharge(uint32_t node)
+{
+    if ((node == SinkCoord_Sink) || (SINK_COORD_NONE == SinkCoord_First[node])) return 0.0;
+    return SinkCoord_Node[node].Budget - SinkCoord_Slack[node];
+}
+
+/**
+ * \brief  Gets the status of the assignment.
+ *
+ * \param  p_status:  Pointer to where the status will be saved. The counters are the ones of the
+ *                    last SinkCoord_Solve or SinkCoord_SetBudget.
+ *
+ */
+void SinkCoord_GetStatus(SINK_COORD_STATUS_T *p_status)
+{
+    uint32_t position, node;
+    float64_t slowest = SinkCoord_Frames(SINK_COORD_SLOWEST);
+
+    SinkCoord_Status.Information = 0.0;
+    SinkCoord_Status.Overspent = 0;
+    for (position = 1u; position < SinkCoord_Routed; position++) {
+        node = SinkCoord_Preorder[position];
+        SinkCoord_Status.Information += SinkCoord_Node[node].Weight *
+                                        log(SinkCoord_Frames(SinkCoord_Level[node]) / slowest);
+        if (0.0 > SinkCoord_Slack[node]) SinkCoord_Status.Overspent++;
+    }
+    memcpy(p_status, &SinkCoord_Status, sizeof(SINK_COORD_STATUS_T));
+}
+
+/** @} (end addtogroup SinkCoord)   */
+/** @} (end addtogroup Sink)        */
@@ -0,0 +1,70 @@
+/**
+ * \file    sink_coordinator.h
+ *
+ * \brief   Header file for the coordinator of the sampling periods of the network.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SINK_COORDINATOR_H__
+#define __SINK_COORDINATOR_H__
+
+#include "../platform/sa_types.h"
+#include "../configs/trigger_cfg.h"
+
+/** \addtogroup Sink
+ *   @{
+ */
+/** \addtogroup SinkCoord
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SINK_COORD_MAX_NODES        16384u      /* Maximum nodes of the network                 */
+#define SINK_COORD_NONE             UINT32_MAX  /* No node                                      */
+#define SINK_COORD_SLOWEST          TRIGGER_CFG_MINIMUM_SAMPLING    /* Level of a new node      */
+#define SINK_COORD_FASTEST          TRIGGER_CFG_MAXIMUM_SAMPLING
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Node of the network, as reported to the sink. The charges are in the units of the
+ *         power models of the nodes.
+ *
+ */
+typedef struct {
+    uint32_t Parent;                    /* Next hop to the sink, SINK_COORD_NONE without route  */
+    float64_t Weight;                   /* Value of the data of the node                        */
+    float64_t Fixed;                    /* Charge per day apart from the frames                 */
+    float64_t Frame;                    /* Charge of sending an own frame                       */
+    float64_t Relay;                    /* Charge of receiving and forwarding a frame           */
+    float64_t Budget;                   /* Charge per day the battery allows                    */
+} SINK_COORD_NODE_T;
+
+/**
+ * \brief  Status of the assignment.
+ *
+ */
+typedef struct {
+    float64_t Information;              /* Information of the network per day                   */
+    uint32_t Upgrades;                  /* Faster periods assigned by the last solve            */
+    uint32_t Downgrades;                /* Slower periods assigned by the last solve            */
+    uint32_t Evaluations;               /* Candidate periods evaluated by the last solve        */
+    uint32_t Overspent;                 /* Nodes over budget even at the slowest period         */
+} SINK_COORD_STATUS_T;
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SinkCoord_Init(uint32_t nodes, uint32_t sink, const SINK_COORD_NODE_T *p_nodes);
+void SinkCoord_Solve(void);
+bool_t SinkCoord_SetBudget(uint32_t node, float64_t budget);
+uint32_t SinkCoord_GetPeriod(uint32_t node);
+uint8_t SinkCoord_GetLevel(uint32_t node);
+float64_t SinkCoord_GetCharge(uint32_t node);
+void SinkCoord_GetStatus(SINK_COORD_STATUS_T *p_status);
+
+/** @} (end addtogroup SinkCoord)   */
+/** @} (end addtogroup Sink)        */
+
+#endif  /* __SINK_COORDINATOR_H__       */
@@ -2,6 +2,8 @@
   * \file    error_handling.h
   *
   * \brief   Header file for the error handling functions.
+  *          This contains the health record kept by the supervisory agent and the degraded
+  *          modes it can switch the node into.
   *
   * \author  David Arnaiz
   *
@@ -10,9 +12,64 @@
 #ifndef __ERROR_HANDLING_H__
 #define __ERROR_HANDLING_H__
 
+#include "../platform/sa_types.h"
+
+/** \addtogroup SupervisoryAgent
+ *   @{
+ */
+
 /************************************** Defines **************************************************/
 
 /************************************** Typedef **************************************************/
+/**
+ * \brief  Agents supervised through their alarm callbacks.
+ *
+ */
+typedef enum {
+    ERROR_HANDLING_POWER_AGENT = 0,
+    ERROR_HANDLING_SENSOR_AGENT,
+    ERROR_HANDLING_TRIGGER_AGENT,
+    ERROR_HANDLING_APP_AGENT,
+    ERROR_HANDLING_AGENTS,
+} ERROR_HANDLING_AGENT_T;
+
+/**
+ * \brief  Operating modes, sorted from normal to the most degraded one.
+ *
+ */
+typedef enum {
+    ERROR_HANDLING_MODE_NORMAL = 0,
+    ERROR_HANDLING_MODE_REDUCED_SAMPLING,   /* Sampling rate limited                        */
+    ERROR_HANDLING_MODE_RADIO_BATCHING,     /* Sampling rate limited and radio batching     */
+    ERROR_HANDLING_MODES,
+} ERROR_HANDLING_MODE_T;
+
+/**
+ * \brief  Health of one agent.
+ *
+ */
+typedef struct {
+    uint8_t Alarms;                     /* Total alarms, saturated                      */
+    uint8_t Recent;                     /* Alarms since the last clean period           */
+    uint8_t LastError;                  /* Error code of the last alarm                 */
+} ERROR_HANDLING_AGENT_HEALTH_T;
+
+/**
+ * \brief  Health record of the node.
+ *
+ * \note List of notes:
+ *       1. All the counters are saturated instead of wrapping around.
+ */
+typedef struct {
+    uint32_t WorstLoop;                 /* Longest loop in cycles                       */
+    uint16_t Loops;                     /* Supervised loops                             */
+    uint16_t Overruns;                  /* Loops over the deadline                      */
+    uint8_t  ConsecutiveOverruns;
+    uint8_t  CleanLoops;                /* Consecutive loops without overrun or alarm   */
+    uint8_t  Escalations;               /* Changes to a more degraded mode              */
+    uint8_t  Mode;                      /* Current ERROR_HANDLING_MODE_T                */
+    ERROR_HANDLING_AGENT_HEALTH_T Agents[ERROR_HANDLING_AGENTS];
+} ERROR_HANDLING_HEALTH_T;
 
 /************************************** Function prototypes **************************************/
 
@@ -20,5 +77,6 @@
 
 /************************************** Function prototypes **************************************/
 
+/** @} (end addtogroup SupervisoryAgent)    */
 
 #endif
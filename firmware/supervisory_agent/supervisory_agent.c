@@ -0,0 +1,290 @@
+/**
+ * \file    supervisory_agent.c
+ *
+ * \brief   Main file for the supervisory agent.
+ *          The supervisory agent runs the self-aware loop of the decision engine and:
+ *            -) Checks every loop against a deadline, so a runaway wake time is detected.
+ *            -) Tracks the health of the agents from their alarm callbacks.
+ *            -) Switches the node into degraded modes when the deadline is overrun or the
+ *               alarms repeat, and back to normal after a clean period.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SupervisoryAgent_
+ *
+ */
+
+#include <string.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../platform/sa_timing.h"
+
+#include "../configs/supervisory_cfg.h"
+
+#include "../include/agents_main.h"
+#include "../include/decision_engine.h"
+#include "../include/supervisory_agent.h"
+#include "error_handling.h"
+
+/** \addtogroup SupervisoryAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SUPERVISORY_AGENT_MAX_COUNT_8       0xFFu
+#define SUPERVISORY_AGENT_MAX_COUNT_16      0xFFFFu
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Configuration applied in each mode.
+ *
+ */
+typedef struct {
+    int8_t  MaxRelevanceTarget;         /* Limit of the relevance target (sampling)     */
+    uint8_t RadioBatch;                 /* Activations per transmission                 */
+} SUPERVISORY_AGENT_MODE_CFG_T;
+
+/**
+ * \brief  Alarm callbacks of the application, called after the health is recorded.
+ *
+ */
+typedef struct {
+    POWER_AGENT_ALARM_T Power;
+    SENSOR_AGENT_ALARM_T Sensor;
+    TRIGGER_AGENT_ALARM_T Trigger;
+    APP_AGENT_ALARM_T App;
+} SUPERVISORY_AGENT_ALARMS_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static const SUPERVISORY_AGENT_MODE_CFG_T SupervisoryAgent_Modes[ERROR_HANDLING_MODES] = {
+    [ERROR_HANDLING_MODE_NORMAL]           = {AGENTS_INDEX_MAX_VALUE, 1u},
+    [ERROR_HANDLING_MODE_REDUCED_SAMPLING] = {SUPERVISORY_CFG_REDUCED_TARGET, 1u},
+    [ERROR_HANDLING_MODE_RADIO_BATCHING]   = {SUPERVISORY_CFG_REDUCED_TARGET, SUPERVISORY_CFG_RADIO_BATCH},
+};
+
+static SUPERVISORY_AGENT_ALARMS_T SupervisoryAgent_Alarms;
+static ERROR_HANDLING_HEALTH_T SupervisoryAgent_Health;
+static bool_t SupervisoryAgent_AlarmInLoop;
+
+/************************************** Function implementation **********************************/
+
+/************* Monitoring *******************/
+/**
+ * \brief  Gets the health record.
+ *
+ * \param  p_health:  Pointer to where the health record will be saved.
+ *
+ */
+void SupervisoryAgent_GetHealth(ERROR_HANDLING_HEALTH_T *p_health)
+{
+    *p_health = SupervisoryAgent_Health;
+}
+
+/**
+ * \brief  Gets the current operating mode.
+ *
+ * \return Current operating mode.
+ *
+ */
+ERROR_HANDLING_MODE_T SupervisoryAgent_GetMode(void)
+{
+    return (ERROR_HANDLING_MODE_T) SupervisoryAgent_Health.Mode;
+}
+
+/************* Modes ************************/
+/**
+ * \brief  Applies an operating mode.
+ *
+ * \param  mode:  New operating mode.
+ *
+ */
+static void SupervisoryAgent_SetMode(ERROR_HANDLING_MODE_T mode)
+{
+    SupervisoryAgent_Health.Mode = (uint8_t) mode;
+    DecisionEng_SetSamplingLimit(SupervisoryAgent_Modes[mode].MaxRelevanceTarget);
+    DecisionEng_SetRadioBatch(SupervisoryAgent_Modes[mode].RadioBatch);
+}
+
+/**
+ * \brief  Switches to the next degraded mode, if any.
+ *
+ */
+static void SupervisoryAgent_Degrade(void)
+{
+    ERROR_HANDLING_HEALTH_T *p_health = &SupervisoryAgent_Health;
+
+    if (ERROR_HANDLING_MODES - 1u > p_health->Mode) {
+        SupervisoryAgent_SetMode((ERROR_HANDLING_MODE_T)(p_health->Mode + 1u));
+        p_health->Escalations = SA_UTILS_MIN(p_health->Escalations + 1u, SUPERVISORY_AGENT_MAX_COUNT_8);
+    }
+}
+
+/**
+ * \brief  Records an alarm from an agent.
+ *
+ * \param  agent:  Agent that raised the alarm.
+ * \param  error:  Error code of the alarm.
+ *
+ * \note List of notes:
+ *       1. The mode is degraded when the same agent repeats the alarm without a clean period
+ *          in between. The count starts again after degrading, so a further degradation needs
+ *          new repetitions.
+ */
+static void SupervisoryAgent_RecordAlarm(ERROR_HANDLING_AGENT_T agent, uint8_t error)
+{
+    ERROR_HANDLING_AGENT_HEALTH_T *p_agent = &SupervisoryAgent_Health.Agents[agent];
+
+    p_agent->Alarms = SA_UTILS_MIN(p_agent->Alarms + 1u, SUPERVISORY_AGENT_MAX_COUNT_8);
+    p_agent->Recent++;
+    p_agent->LastError = error;
+    SupervisoryAgent_AlarmInLoop = DEF_TRUE;
+
+    if (SUPERVISORY_CFG_ALARM_REPEATS <= p_agent->Recent) {
+        p_agent->Recent = 0;
+        SupervisoryAgent_Degrade();
+    }
+}
+
+/************* Alarms ***********************/
+/**
+ * \brief  Alarm callback of the power agent.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void SupervisoryAgent_PowerAlarm(POWER_AGENT_ERROR_T error)
+{
+    SupervisoryAgent_RecordAlarm(ERROR_HANDLING_POWER_AGENT, (uint8_t) error);
+    if (NULL != SupervisoryAgent_Alarms.Power) SupervisoryAgent_Alarms.Power(error);
+}
+
+/**
+ * \brief  Alarm callback of the sensor agent.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void SupervisoryAgent_SensorAlarm(SENSOR_AGENT_ERROR_T error)
+{
+    SupervisoryAgent_RecordAlarm(ERROR_HANDLING_SENSOR_AGENT, (uint8_t) error);
+    if (NULL != SupervisoryAgent_Alarms.Sensor) SupervisoryAgent_Alarms.Sensor(error);
+}
+
+/**
+ * \brief  Alarm callback of the trigger agent.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void SupervisoryAgent_TriggerAlarm(uint8_t error)
+{
+    SupervisoryAgent_RecordAlarm(ERROR_HANDLING_TRIGGER_AGENT, error);
+    if (NULL != SupervisoryAgent_Alarms.Trigger) SupervisoryAgent_Alarms.Trigger(error);
+}
+
+/**
+ * \brief  Alarm callback of the application agent.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void SupervisoryAgent_AppAlarm(uint8_t error)
+{
+    SupervisoryAgent_RecordAlarm(ERROR_HANDLING_APP_AGENT, error);
+    if (NULL != SupervisoryAgent_Alarms.App) SupervisoryAgent_Alarms.App(error);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Initializes the supervisory agent and the decision engine.
+ *
+ * \param  p_init: Pointer to the initialization struct of the decision engine.
+ *
+ * \return DEF_TRUE if the initialization is successfull; otherwise DEF_FALSE.
+ *
+ * \note List of notes:
+ *       1. The alarm callbacks of the initialization struct are replaced by the ones of the
+ *          supervisory agent, which record the health and then call the original callbacks.
+ *          The struct passed is not modified.
+ */
+bool_t SupervisoryAgent_Init(DECISION_ENGINE_INIT_T *p_init)
+{
+    DECISION_ENGINE_INIT_T init = *p_init;
+    bool_t initialization;
+
+    SupervisoryAgent_Alarms.Power = p_init->PowerInit.Alarm;
+    SupervisoryAgent_Alarms.Sensor = p_init->AppInit.Sensor.Alarm;
+    SupervisoryAgent_Alarms.Trigger = p_init->AppInit.Trigger.Alarm;
+    SupervisoryAgent_Alarms.App = p_init->AppInit.Alarm;
+
+    init.PowerInit.Alarm = SupervisoryAgent_PowerAlarm;
+    init.AppInit.Sensor.Alarm = SupervisoryAgent_SensorAlarm;
+    init.AppInit.Trigger.Alarm = SupervisoryAgent_TriggerAlarm;
+    init.AppInit.Alarm = SupervisoryAgent_AppAlarm;
+
+    memset(&SupervisoryAgent_Health, 0x00, sizeof(ERROR_HANDLING_HEALTH_T));
+    SupervisoryAgent_AlarmInLoop = DEF_FALSE;
+    SaTiming_Init();
+
+    initialization = DecisionEng_Init(&init);
+    SupervisoryAgent_SetMode(ERROR_HANDLING_MODE_NORMAL);
+
+    return initialization;
+}
+
+/**
+ * \brief  Runs a supervised self-aware loop.
+ *
+ * \note List of notes:
+ *       1. The loop time includes the observation and actuation callbacks, since that is the
+ *          wake time that drains the battery.
+ *       2. The mode is degraded after SUPERVISORY_CFG_OVERRUN_LIMIT consecutive overruns, and
+ *          goes back one mode after SUPERVISORY_CFG_RECOVERY_LOOPS clean loops.
+ */
+void SupervisoryAgent_Loop(void)
+{
+    ERROR_HANDLING_HEALTH_T *p_health = &SupervisoryAgent_Health;
+    ERROR_HANDLING_AGENT_T agent;
+    uint32_t start, cycles;
+
+    SupervisoryAgent_AlarmInLoop = DEF_FALSE;
+
+    start = SaTiming_GetCycles();
+    DecisionEng_Loop();
+    cycles = SA_TIMING_ELAPSED(start);
+
+    p_health->Loops = SA_UTILS_MIN(p_health->Loops + 1u, SUPERVISORY_AGENT_MAX_COUNT_16);
+    p_health->WorstLoop = SA_UTILS_MAX(p_health->WorstLoop, cycles);
+
+    /* Deadline         */
+    if (SUPERVISORY_CFG_LOOP_DEADLINE < cycles) {
+        p_health->Overruns = SA_UTILS_MIN(p_health->Overruns + 1u, SUPERVISORY_AGENT_MAX_COUNT_16);
+        p_health->ConsecutiveOverruns++;
+        p_health->CleanLoops = 0;
+        if (SUPERVISORY_CFG_OVERRUN_LIMIT <= p_health->ConsecutiveOverruns) {
+            p_health->ConsecutiveOverruns = 0;
+            SupervisoryAgent_Degrade();
+        }
+        return;
+    }
+    p_health->ConsecutiveOverruns = 0;
+
+    /* Recovery         */
+    if (DEF_TRUE == SupervisoryAgent_AlarmInLoop) {
+        p_health->CleanLoops = 0;
+    } else if (SUPERVISORY_CFG_RECOVERY_LOOPS <= ++p_health->CleanLoops) {
+        p_health->CleanLoops = 0;
+        for (agent = ERROR_HANDLING_POWER_AGENT; agent < ERROR_HANDLING_AGENTS; agent++) {
+            p_health->Agents[agent].Recent = 0;
+        }
+        if (ERROR_HANDLING_MODE_NORMAL != p_health->Mode) {
+            SupervisoryAgent_SetMode((ERROR_HANDLING_MODE_T)(p_health->Mode - 1u));
+        }
+    }
+}
+
+/** @} (end addtogroup SupervisoryAgent)    */
@@ -14,6 +14,7 @@
 #include "../platform/sa_types.h"
 
 #include "app_agent_test.h"
+#include "test_utils.h"
 #include "../configs/sensor_cfg.h"
 #include "../configs/trigger_cfg.h"
 #include "../configs/app_cfg.h"
@@ -40,32 +41,59 @@
 
 /************************************** Local Var ************************************************/
 static uint32_t AppAgentTest_Iterations;
+static bool_t AppAgentTest_Pipelined = DEF_FALSE;   /* Start the acquisitions at the act stage  */
+static float32_t AppAgentTest_Conversion = 0;       /* Sample of the acquisition in progress     */
+static float32_t AppAgentTest_Data[2][APP_AGENT_TEST_ITERATIONS];  /* Serial and pipelined data */
 
 /************************************** Function implementation **********************************/
 
 /************* Sensor ***********************/
 /**
- * \brief  Fakes a measurement from the sensor.
+ * \brief  Fakes the value measured by the sensor.
  *
- * \param  p_obs:  Pointer to the sensor observation data of the sensor agent.
+ * \return Measured value in the current iteration.
  *
  */
-static void AppAgentTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+static float32_t AppAgentTest_SensorSample(void)
 {
     switch (AppAgentTest_Iterations) {
         case 3:
-            p_obs->SensorData = 50.0;
-            break;
+            return 50.0;
         case 9:
-            p_obs->SensorData = 110.0;
-            break;
+            return 110.0;
         default:
-            p_obs->SensorData = 10.0;
-            break;
+            return 10.0;
+    }
+}
+
+/**
+ * \brief  Fakes a measurement from the sensor.
+ *         When pipelined, the measurement is the one of the acquisition started in the
+ *         previous activation.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data of the sensor agent.
+ *
+ */
+static void AppAgentTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    if (DEF_TRUE == AppAgentTest_Pipelined) {
+        p_obs->SensorData = AppAgentTest_Conversion;
+    } else {
+        p_obs->SensorData = AppAgentTest_SensorSample();
     }
     printf("-- ::Sensor :: Observation->Data = %f\n", p_obs->SensorData);
 }
 
+/**
+ * \brief  Fakes the start of an acquisition, which completes while the MCU sleeps.
+ *
+ */
+static void AppAgentTest_SensorStart(void)
+{
+    AppAgentTest_Conversion = AppAgentTest_SensorSample();
+    printf("-- ::Sensor :: Acquisition started\n");
+}
+
 /**
  * \brief  Fakes the configuration change for the sensor.
  *
@@ -154,31 +182,71 @@ static void AppAgentTest_EvaluateOutputs(APP_AGENT_INTERFACE_T *p_data)
 }
 
 /**
- * \brief  Runs the test for the power agent.
+ * \brief  Runs the iterations of the test with a serial or a pipelined loop.
+ *
+ * \param  pipelined:  DEF_TRUE to start the acquisitions at the act stage.
  *
  */
-void AppAgentTest_RunTest() {
-    printf("//////////////////////////////////\n");
-    printf("////    App Agent Test    ////////\n");
-    printf("//////////////////////////////////\n\n");
+static void AppAgentTest_Run(bool_t pipelined)
+{
+    APP_AGENT_INTERFACE_T data;
+
+    printf("\n////    %s loop\n", (DEF_TRUE == pipelined) ? "Pipelined" : "Serial");
+    AppAgentTest_Pipelined = pipelined;
+    AppAgentTest_Conversion = 0;
+    AppAgentTest_Iterations = 0;
 
     AppAgent_Init(AppAgentTest_SensorObs,
                   AppAgentTest_SensorActs,
                   AppAgentTest_SensorAlarm,
+                  (DEF_TRUE == pipelined) ? AppAgentTest_SensorStart : NULL,
+                  NULL,
                   AppAgentTest_TriggerObs,
                   AppAgentTest_TriggerActs,
                   NULL, NULL);
 
-    AppAgentTest_Iterations = 0;
-    APP_AGENT_INTERFACE_T data;
-
     for (AppAgentTest_Iterations = 0; AppAgentTest_Iterations < APP_AGENT_TEST_ITERATIONS; \
          AppAgentTest_Iterations++) {
         printf("----------------------------------\nIteration: %u\n", AppAgentTest_Iterations);
         AppAgentTest_GenerateInputs(&data);
         AppAgent_Oda(&data);
         AppAgentTest_EvaluateOutputs(&data);
+        AppAgentTest_Data[pipelined][AppAgentTest_Iterations] = data.Outputs.Data;
+    }
+}
+
+/**
+ * \brief  Runs the test for the application agent.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The serial loop observes the sample of its own activation. The pipelined loop
+ *          observes the sample started in the previous activation, so its data lags one
+ *          activation behind.
+ */
+bool_t AppAgentTest_RunTest(void)
+{
+    bool_t result = DEF_OK;
+    bool_t lagged = DEF_TRUE;
+    uint32_t i;
+
+    printf("//////////////////////////////////\n");
+    printf("////    App Agent Test    ////////\n");
+    printf("//////////////////////////////////\n\n");
+
+    AppAgentTest_Run(DEF_FALSE);
+    AppAgentTest_Run(DEF_TRUE);
+
+    printf("\n");
+    for (i = 1u; i < APP_AGENT_TEST_ITERATIONS; i++) {
+        if (AppAgentTest_Data[DEF_TRUE][i] != AppAgentTest_Data[DEF_FALSE][i - 1u]) lagged = DEF_FALSE;
     }
+    TestUtils_Check(50.0f == AppAgentTest_Data[DEF_FALSE][3], "Serial data of its own activation",
+                    &result);
+    TestUtils_Check(lagged, "Pipelined data one activation later", &result);
+
+    return result;
 }
 
 /** @} (end addtogroup AppAgent)   */
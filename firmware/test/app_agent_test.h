@@ -33,7 +33,7 @@
 /************************************** Local Var ************************************************/
 
 /************************************** Function prototypes **************************************/
-void AppAgentTest_RunTest();
+bool_t AppAgentTest_RunTest(void);
 
 
 /** @} (end addtogroup AppAgent)   */
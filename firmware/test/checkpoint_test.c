@@ -0,0 +1,367 @@
+/**
+ * \file    checkpoint_test.c
+ *
+ * \brief   Main file for the warm restart test.
+ *          This is not a Unit test, but a functional test where the self-awareness module runs
+ *          with checkpoints, is reset, and must resume with the learned models instead of the
+ *          initial ones. It also checks the fall back to the previous checkpoint when the
+ *          latest is corrupted, and the wear leveling of the NVM sectors.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: CheckpointTest_
+ *
+ */
+
+#include <string.h>
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../platform/sa_nvm.h"
+
+#include "../configs/battery_cfg.h"
+#include "../configs/mote_cfg.h"
+#include "../configs/radio_cfg.h"
+#include "../configs/sensor_cfg.h"
+#include "../include/power_agent.h"
+#include "../include/radio_agent.h"
+#include "../include/trigger_agent.h"
+#include "../include/checkpoint.h"
+#include "../include/decision_engine.h"
+
+#include "checkpoint_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define CHECKPOINT_TEST_LOOPS               300u    /* Loops before the first forced checkpoint */
+#define CHECKPOINT_TEST_MORE_LOOPS           50u    /* Loops between the forced checkpoints     */
+#define CHECKPOINT_TEST_WEAR_SAVES          200u    /* Checkpoints of the wear leveling check   */
+#define CHECKPOINT_TEST_CORRUPT_OFFSET       16u    /* Offset of the corruption, in the data    */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Learned values compared before and after the reset.
+ *
+ */
+typedef struct {
+    float32_t RemainingCharge;
+    float32_t Soc;
+    float32_t DailyHarvest;
+    uint32_t  Periodicity;
+    CONFIG_POWER_T Radio[RADIO_CFG_CONFIGS_SIZE];
+    CONFIG_POWER_T RadioExpected;       /* Expected power of a transmission with its retries */
+    float32_t Delivery[RADIO_CFG_CONFIGS_SIZE];
+    RADIO_CFG_LIST_T RadioConfig;
+    CONFIG_POWER_T Sensor[SENSOR_CFG_CONFIGS_SIZE];
+    CONFIG_POWER_T Base;
+    CONFIG_POWER_T Idle;
+} CHECKPOINT_TEST_SNAPSHOT_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static uint32_t CheckpointTest_Loops = 0;
+static float32_t CheckpointTest_ChargeAccum = 0;
+static float32_t CheckpointTest_HarvestAccum = 0;
+
+/************************************** Function implementation **********************************/
+/************* Power Agent ******************/
+/**
+ * \brief  Fakes the coulomb counter, which keeps counting through the resets of the mote.
+ *
+ * \param  p_obs:  Pointer to the observation data of the power agent.
+ *
+ */
+static void CheckpointTest_PowerObs(POWER_AGENT_OBS_T *p_obs)
+{
+    CheckpointTest_ChargeAccum += 5.0f + (float32_t)(CheckpointTest_Loops % 7u);
+    CheckpointTest_HarvestAccum += (float32_t)(CheckpointTest_Loops % 5u);
+    p_obs->Battery.Charge = CheckpointTest_ChargeAccum;
+    p_obs->Battery.BatteryVoltage = 0;      /* No voltage measurement   */
+    p_obs->Battery.Temperature = POWER_AGENT_TEMP_REF;
+    p_obs->Battery.Harvested = CheckpointTest_HarvestAccum;
+}
+
+/**
+ * \brief  Fakes the actuation of the power agent.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void CheckpointTest_PowerActs(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Radio Agent ******************/
+/**
+ * \brief  Fakes the radio observation.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void CheckpointTest_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = DEF_FALSE;
+    p_obs->Attempts = 1u + (CheckpointTest_Loops % 2u);
+    p_obs->Acked = DEF_TRUE;
+}
+
+/**
+ * \brief  Fakes the radio transmission.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void CheckpointTest_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Application Agent ************/
+/**
+ * \brief  Fakes a measurement from the sensor, a slow ramp with steps.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data.
+ *
+ */
+static void CheckpointTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    p_obs->SensorData = 10.0f + (float32_t)(CheckpointTest_Loops % 40u) * 0.5f;
+}
+
+/**
+ * \brief  Fakes the configuration of the sensor.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void CheckpointTest_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Fakes the trigger observation.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void CheckpointTest_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Fakes the trigger actuation.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void CheckpointTest_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Tools ************************/
+/**
+ * \brief  Initializes the module, as after a reset of the mote.
+ *
+ * \param  checkpoint:  DEF_TRUE for a warm restart from the checkpoints.
+ *
+ */
+static void CheckpointTest_Reset(bool_t checkpoint)
+{
+    DECISION_ENGINE_INIT_T init = {
+        .PowerInit.Obs = CheckpointTest_PowerObs,
+        .PowerInit.Act = CheckpointTest_PowerActs,
+        .PowerInit.Alarm = NULL,
+        .RadioInit.Obs = CheckpointTest_RadioObs,
+        .RadioInit.Act = CheckpointTest_RadioActs,
+        .RadioInit.Done = NULL,
+        .AppInit.Sensor.Obs = CheckpointTest_SensorObs,
+        .AppInit.Sensor.Act = CheckpointTest_SensorActs,
+        .AppInit.Sensor.Alarm = NULL,
+        .AppInit.Sensor.Start = NULL,
+        .AppInit.Sensor.Ready = NULL,
+        .AppInit.Trigger.Obs = CheckpointTest_TriggerObs,
+        .AppInit.Trigger.Act = CheckpointTest_TriggerActs,
+        .AppInit.Trigger.Alarm = NULL,
+        .AppInit.Alarm = NULL,
+        .Checkpoint = checkpoint
+    };
+
+    DecisionEng_Init(&init);
+}
+
+/**
+ * \brief  Runs the loop.
+ *
+ * \param  loops:  Number of loops.
+ *
+ */
+static void CheckpointTest_Run(uint32_t loops)
+{
+    while (0u < loops--) {
+        DecisionEng_Loop();
+        CheckpointTest_Loops++;
+    }
+}
+
+/**
+ * \brief  Takes a snapshot of the learned values.
+ *
+ * \param  p_snapshot:  Pointer to where the snapshot will be saved.
+ *
+ */
+static void CheckpointTest_Snapshot(CHECKPOINT_TEST_SNAPSHOT_T *p_snapshot)
+{
+    uint8_t config;
+
+    memset(p_snapshot, 0x00, sizeof(CHECKPOINT_TEST_SNAPSHOT_T));
+    p_snapshot->RemainingCharge = PowerAgent_GetRemainingBatteryLife();
+    p_snapshot->Soc = PowerAgent_GetSoc(NULL);
+    p_snapshot->DailyHarvest = PowerAgent_GetDailyHarvest();
+    p_snapshot->Periodicity = TriggerAgent_GetConfig();
+    memcpy(p_snapshot->Radio, RadioCfg_Learned_Ptr, sizeof(p_snapshot->Radio));
+    p_snapshot->RadioExpected = *RadioAgent_GetPowerPtr();
+    for (config = 0; config < RADIO_CFG_CONFIGS_SIZE; config++) {
+        p_snapshot->Delivery[config] = RadioAgent_GetDelivery((RADIO_CFG_LIST_T) config);
+    }
+    p_snapshot->RadioConfig = RadioAgent_GetConfig();
+    memcpy(p_snapshot->Sensor, SensorCfg_Learned_Ptr, sizeof(p_snapshot->Sensor));
+    p_snapshot->Base = MoteCfg_BasePower;
+    p_snapshot->Idle = MoteCfg_IdlePower;
+}
+
+/**
+ * \brief  Prints a snapshot.
+ *
+ * \param  p_name:      Name of the snapshot.
+ * \param  p_snapshot:  Pointer to the snapshot.
+ *
+ */
+static void CheckpointTest_Print(const char *p_name, const CHECKPOINT_TEST_SNAPSHOT_T *p_snapshot)
+{
+    printf("-- %-10s charge %.2f, SOC %.4f, harvest %.2f, period %u, radio %.3f, base %.3f\n",
+           p_name, p_snapshot->RemainingCharge, p_snapshot->Soc, p_snapshot->DailyHarvest,
+           p_snapshot->Periodicity, p_snapshot->Radio[RADIO_CFG_STANDARD_MODE].Power,
+           p_snapshot->Base.Power);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the warm restart.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ */
+bool_t CheckpointTest_RunTest(void)
+{
+    CHECKPOINT_TEST_SNAPSHOT_T previous, saved, restored;
+    CHECKPOINT_STATUS_T status;
+    uint32_t erases[MOTE_CFG_CHECKPOINT_SECTORS];
+    uint32_t min_erases = SA_UTILS_MAX_UINT32_T;
+    uint32_t max_erases = 0;
+    uint32_t sequence, save;
+    uint16_t sector;
+    uint8_t zeros[4] = {0};
+    bool_t result = DEF_OK;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Warm Restart Test     //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    /* Blank NVM, as a new mote     */
+    SaNvm_Init();
+    for (sector = 0; sector < MOTE_CFG_CHECKPOINT_SECTORS; sector++) {
+        SaNvm_EraseSector(MOTE_CFG_CHECKPOINT_FIRST_SECTOR + sector);
+    }
+
+    CheckpointTest_Reset(DEF_TRUE);
+    Checkpoint_GetStatus(&status);
+    TestUtils_Check(DEF_FALSE == status.Restored, "Nothing to restore on a new mote", &result);
+
+    /* Learn and checkpoint         */
+    CheckpointTest_Run(CHECKPOINT_TEST_LOOPS);
+    Checkpoint_GetStatus(&status);
+    printf("-- Periodic checkpoints: %u\n", status.Saved);
+    TestUtils_Check(CHECKPOINT_TEST_LOOPS / MOTE_CFG_CHECKPOINT_PERIOD == status.Saved,
+                    "Periodic checkpoints", &result);
+    DecisionEng_SaveCheckpoint();
+    CheckpointTest_Snapshot(&previous);
+    CheckpointTest_Run(CHECKPOINT_TEST_MORE_LOOPS);
+    DecisionEng_SaveCheckpoint();
+    CheckpointTest_Snapshot(&saved);
+    Checkpoint_GetStatus(&status);
+    sequence = status.Sequence;
+    CheckpointTest_Print("Saved", &saved);
+
+    /* Cold restart                 */
+    CheckpointTest_Reset(DEF_FALSE);
+    CheckpointTest_Snapshot(&restored);
+    CheckpointTest_Print("Cold", &restored);
+    TestUtils_Check(0 != memcmp(&saved, &restored, sizeof(saved)),
+                    "Cold restart loses the learned models", &result);
+
+    /* Warm restart                 */
+    CheckpointTest_Reset(DEF_TRUE);
+    CheckpointTest_Snapshot(&restored);
+    Checkpoint_GetStatus(&status);
+    CheckpointTest_Print("Warm", &restored);
+    TestUtils_Check((DEF_TRUE == status.Restored) && (sequence == status.Sequence),
+                    "Warm restart from the latest checkpoint", &result);
+    TestUtils_Check(0 == memcmp(&saved, &restored, sizeof(saved)),
+                    "Warm restart keeps the learned models", &result);
+
+    /* Corrupted latest checkpoint  */
+    SaNvm_Write(status.Address + CHECKPOINT_TEST_CORRUPT_OFFSET, zeros, sizeof(zeros));
+    CheckpointTest_Reset(DEF_TRUE);
+    CheckpointTest_Snapshot(&restored);
+    Checkpoint_GetStatus(&status);
+    CheckpointTest_Print("Fallback", &restored);
+    TestUtils_Check((sequence - 1u == status.Sequence) && (1u == status.Discarded),
+                    "Corrupted checkpoint is discarded", &result);
+    TestUtils_Check(0 == memcmp(&previous, &restored, sizeof(previous)),
+                    "Fall back to the previous checkpoint", &result);
+
+    /* Wear leveling                */
+    for (sector = 0; sector < MOTE_CFG_CHECKPOINT_SECTORS; sector++) {
+        erases[sector] = SaNvm_GetEraseCount(MOTE_CFG_CHECKPOINT_FIRST_SECTOR + sector);
+    }
+    for (save = 0; save < CHECKPOINT_TEST_WEAR_SAVES; save++) {
+        CheckpointTest_Run(1u);
+        if (DEF_FAIL == DecisionEng_SaveCheckpoint()) result = DEF_FAIL;
+    }
+    printf("-- Erases per sector after %u checkpoints:", CHECKPOINT_TEST_WEAR_SAVES);
+    for (sector = 0; sector < MOTE_CFG_CHECKPOINT_SECTORS; sector++) {
+        erases[sector] = SaNvm_GetEraseCount(MOTE_CFG_CHECKPOINT_FIRST_SECTOR + sector) -
+                         erases[sector];
+        min_erases = SA_UTILS_MIN(min_erases, erases[sector]);
+        max_erases = SA_UTILS_MAX(max_erases, erases[sector]);
+        printf(" %u", erases[sector]);
+    }
+    printf("\n");
+    TestUtils_Check(1u >= max_erases - min_erases, "Erases spread evenly over the sectors",
+                    &result);
+    CheckpointTest_Reset(DEF_TRUE);
+    Checkpoint_GetStatus(&status);
+    TestUtils_Check((DEF_TRUE == status.Restored) && (0u == status.Discarded),
+                    "Warm restart after the ring wraps around", &result);
+
+    printf("-- Result: %s\n", (DEF_OK == result) ? "PASS" : "FAIL");
+
+    return result;
+}
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
@@ -0,0 +1,35 @@
+/**
+ * \file    checkpoint_test.h
+ *
+ * \brief   Header file for the warm restart checkpoints.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __CHECKPOINT_TEST_H__
+#define __CHECKPOINT_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t CheckpointTest_RunTest(void);
+
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
+
+#endif  /* __CHECKPOINT_TEST_H__       */
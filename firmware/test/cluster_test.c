@@ -0,0 +1,343 @@
+/**
+ * \file    cluster_test.c
+ *
+ * \brief   Main file for the cooperative cluster test.
+ *          First the application agent learns the correlation of two overheard neighbors,
+ *          one that measures the same phenomenon and one that does not, and lowers its
+ *          relevance when the correlated one covers its data. Then a dense cluster of nodes
+ *          measuring a spatially correlated field is simulated with and without the
+ *          cooperative mode, and the charge spent is compared with the error of the field
+ *          rebuilt by the sink.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: ClusterTest_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/app_cfg.h"
+#include "../configs/trigger_cfg.h"
+#include "../include/sensor_agent.h"
+#include "../include/trigger_agent.h"
+#include "../include/app_agent.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_random.h"
+#include "../sim/sim_node.h"
+#include "../sim/sim_cluster.h"
+
+#include "cluster_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Cluster
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define CLUSTER_TEST_SEED                   1u
+#define CLUSTER_TEST_LEARNING               64u     /* Own samples of the learning check        */
+#define CLUSTER_TEST_CORRELATED             0.9     /* Correlation learnt of the same phenomenon*/
+#define CLUSTER_TEST_UNCORRELATED           0.5     /* Correlation learnt of another one        */
+
+/* Field, recorded every hour */
+#define CLUSTER_TEST_NODES                  6u
+#define CLUSTER_TEST_DAYS                   60u
+#define CLUSTER_TEST_CAPACITY               8.0e6   /* Battery to sample the hourly field       */
+#define CLUSTER_TEST_INPUTS                 (CLUSTER_TEST_DAYS * SA_UTILS_DAYS_TO_HOURS)
+#define CLUSTER_TEST_MEAN                   20.0
+#define CLUSTER_TEST_SPREAD                 1.0     /* Deviation of the offsets of the nodes    */
+#define CLUSTER_TEST_AMPLITUDE              3.0     /* Daily cycle                              */
+#define CLUSTER_TEST_WEATHER                2.0     /* Deviation of the common weather          */
+#define CLUSTER_TEST_WEATHER_MEMORY         0.98    /* Correlation of the weather in an hour    */
+#define CLUSTER_TEST_LOCAL                  0.2     /* Deviation of the local variations        */
+#define CLUSTER_TEST_LOCAL_MEMORY           0.9     /* Correlation of a local variation         */
+
+#define CLUSTER_TEST_SAVING                 0.3     /* Minimum charge saved by the cooperation  */
+#define CLUSTER_TEST_ERROR                  0.3     /* Maximum RMSE of the field, of deviation  */
+#define CLUSTER_TEST_SHARE                  0.25    /* Minimum samples of a node, of the mean   */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static float32_t ClusterTest_Sample;
+static SIM_NODE_INPUT_T ClusterTest_Inputs[CLUSTER_TEST_NODES][CLUSTER_TEST_INPUTS];
+static SIM_CLUSTER_CFG_T ClusterTest_Cfg;
+static SIM_CLUSTER_RESULT_T ClusterTest_Results[2];
+
+/************************************** Function implementation **********************************/
+/************* Learning *********************/
+/**
+ * \brief  Fakes a measurement from the sensor.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data of the sensor agent.
+ *
+ */
+static void ClusterTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    p_obs->SensorData = ClusterTest_Sample;
+}
+
+/**
+ * \brief  Fakes the actuation of the sensor.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void ClusterTest_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Fakes the trigger observation.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void ClusterTest_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Fakes the trigger actuation.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void ClusterTest_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Runs an activation of the application agent after a neighbor covered its data.
+ *
+ * \param  cooperative:  DEF_TRUE to run in cooperative mode.
+ *
+ * \return Relevance index of the activation.
+ *
+ */
+static int8_t ClusterTest_Covered(bool_t cooperative)
+{
+    APP_AGENT_INTERFACE_T data;
+
+    memset(&data, 0x00, sizeof(APP_AGENT_INTERFACE_T));
+    AppAgent_SetCooperative(cooperative, 0u);
+    AppAgent_Overhear(1u, ClusterTest_Sample, 1u, 100.0f);
+    AppAgent_Oda(&data);
+
+    return data.Outputs.RelevanceIndex;
+}
+
+/**
+ * \brief  Checks the correlation learnt by the application agent and its relevance.
+ *
+ * \param  p_result:  Pointer to the result of the test.
+ *
+ * \note List of notes:
+ *       1. Neighbor 1 measures the own data with an offset and a small noise, neighbor 2 an
+ *          independent random data. Neighbor 1 samples faster, so it covers the node.
+ */
+static void ClusterTest_Learning(bool_t *p_result)
+{
+    APP_AGENT_INTERFACE_T data;
+    float32_t correlated, uncorrelated;
+    uint32_t sample;
+    int8_t relevance, cooperative;
+
+    TestUtils_Check(DEF_TRUE == AppAgent_Init(ClusterTest_SensorObs, ClusterTest_SensorActs, NULL, NULL, NULL,
+                                              ClusterTest_TriggerObs, ClusterTest_TriggerActs, NULL, NULL),
+                    "Application agent initialized", p_result);
+    memset(&data, 0x00, sizeof(APP_AGENT_INTERFACE_T));
+    SimRandom_Seed(CLUSTER_TEST_SEED, 0u);
+    for (sample = 0; sample < CLUSTER_TEST_LEARNING; sample++) {
+        ClusterTest_Sample = (float32_t)(CLUSTER_TEST_MEAN + CLUSTER_TEST_AMPLITUDE * sin(sample / 4.0));
+        AppAgent_Overhear(1u, ClusterTest_Sample + 2.0f + 0.1f * (float32_t) SimRandom_Gaussian(),
+                          TriggerAgent_GetConfig(), 100.0f);
+        AppAgent_Overhear(2u, (float32_t)(CLUSTER_TEST_MEAN + CLUSTER_TEST_AMPLITUDE * SimRandom_Gaussian()),
+                          TriggerAgent_GetConfig(), 100.0f);
+        AppAgent_Oda(&data);
+    }
+    correlated = AppAgent_GetCorrelation(1u);
+    uncorrelated = AppAgent_GetCorrelation(2u);
+    relevance = ClusterTest_Covered(DEF_FALSE);
+    cooperative = ClusterTest_Covered(DEF_TRUE);
+    printf("-- Correlation learnt: same phenomenon %.3f, another one %.3f, unknown %.3f\n",
+           correlated, uncorrelated, AppAgent_GetCorrelation(3u));
+    printf("-- Relevance index when covered: %d, in cooperative mode %d\n", relevance, cooperative);
+
+    TestUtils_Check(CLUSTER_TEST_CORRELATED <= correlated, "Correlation of the same phenomenon", p_result);
+    TestUtils_Check(CLUSTER_TEST_UNCORRELATED > fabsf(uncorrelated), "Correlation of another phenomenon", p_result);
+    TestUtils_Check(0.0f == AppAgent_GetCorrelation(3u), "Unknown neighbor not correlated", p_result);
+    TestUtils_Check((0 == relevance) && (APP_CFG_COVER_RELEVANCE == cooperative),
+                    "Relevance lowered only when cooperative", p_result);
+}
+
+/************* Cluster **********************/
+/**
+ * \brief  Records the field measured by the nodes.
+ *
+ * \note List of notes:
+ *       1. The field is a daily cycle and a weather common to the cluster, plus an offset and
+ *          a small local variation of each node, both autoregressive.
+ */
+static void ClusterTest_Field(void)
+{
+    float64_t weather = 0.0, offset[CLUSTER_TEST_NODES], local[CLUSTER_TEST_NODES], cycle;
+    uint32_t hour, node;
+
+    SimRandom_Seed(CLUSTER_TEST_SEED, 1u);
+    for (node = 0; node < CLUSTER_TEST_NODES; node++) {
+        offset[node] = CLUSTER_TEST_SPREAD * SimRandom_Gaussian();
+        local[node] = 0.0;
+    }
+    for (hour = 0; hour < CLUSTER_TEST_INPUTS; hour++) {
+        weather = CLUSTER_TEST_WEATHER_MEMORY * weather + CLUSTER_TEST_WEATHER *
+                  sqrt(1.0 - CLUSTER_TEST_WEATHER_MEMORY * CLUSTER_TEST_WEATHER_MEMORY) * SimRandom_Gaussian();
+        cycle = CLUSTER_TEST_MEAN + weather +
+                CLUSTER_TEST_AMPLITUDE * sin(2.0 * M_PI * (hour % SA_UTILS_DAYS_TO_HOURS) / SA_UTILS_DAYS_TO_HOURS);
+        for (node = 0; node < CLUSTER_TEST_NODES; node++) {
+            local[node] = CLUSTER_TEST_LOCAL_MEMORY * local[node] + CLUSTER_TEST_LOCAL *
+                          sqrt(1.0 - CLUSTER_TEST_LOCAL_MEMORY * CLUSTER_TEST_LOCAL_MEMORY) * SimRandom_Gaussian();
+            ClusterTest_Inputs[node][hour].Time = (SIM_TIME_T) hour * SA_UTILS_HOURS_TO_MILLI_S;
+            ClusterTest_Inputs[node][hour].Data = (float32_t)(cycle + offset[node] + local[node]);
+        }
+    }
+}
+
+/**
+ * \brief  Simulates the cluster in a mode.
+ *
+ * \param  cooperative:  DEF_TRUE for the cooperative mode.
+ * \param  p_result:     Pointer to where the result will be saved.
+ *
+ * \return DEF_OK if the cluster could be simulated; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. Every node hears every other node, a dense cluster.
+ */
+static bool_t ClusterTest_Run(bool_t cooperative, SIM_CLUSTER_RESULT_T *p_result)
+{
+    SIM_CLUSTER_CFG_T *p_cfg = &ClusterTest_Cfg;
+    uint32_t node;
+
+    memset(p_cfg, 0x00, sizeof(SIM_CLUSTER_CFG_T));
+    p_cfg->Nodes = CLUSTER_TEST_NODES;
+    p_cfg->Cooperative = cooperative;
+    p_cfg->Horizon = (SIM_TIME_T) CLUSTER_TEST_DAYS * SA_UTILS_DAYS_TO_MILLI_S;
+    for (node = 0; node < CLUSTER_TEST_NODES; node++) {
+        SimNode_DefaultCfg(&p_cfg->Node[node]);
+        p_cfg->Node[node].Inputs = ClusterTest_Inputs[node];
+        p_cfg->Node[node].NumInputs = CLUSTER_TEST_INPUTS;
+        p_cfg->Node[node].Capacity = CLUSTER_TEST_CAPACITY;
+        p_cfg->Neighbors[node] = ((1uL << CLUSTER_TEST_NODES) - 1u) & ~(1uL << node);
+    }
+
+    return SimCluster_Run(p_cfg, p_result);
+}
+
+/**
+ * \brief  Prints the result of a mode.
+ *
+ * \param  p_name:    Name of the mode.
+ * \param  p_result:  Pointer to the result.
+ *
+ */
+static void ClusterTest_Print(const char *p_name, const SIM_CLUSTER_RESULT_T *p_result)
+{
+    uint32_t node, heard = 0;
+
+    for (node = 0; node < CLUSTER_TEST_NODES; node++) {
+        heard += p_result->Node[node].Heard;
+    }
+    printf("--   %-12s %7u %7u %11.1f %7.4f %7.4f %9.3f\n", p_name, p_result->Frames, heard,
+           p_result->Charge, p_result->Error, p_result->Rmse, p_result->Wall);
+}
+
+/**
+ * \brief  Tells if every node took its share of the samples.
+ *
+ * \param  p_result:  Pointer to the result.
+ *
+ * \return DEF_TRUE if no node sent less than CLUSTER_TEST_SHARE of the mean; otherwise
+ *         DEF_FALSE.
+ *
+ */
+static bool_t ClusterTest_Shared(const SIM_CLUSTER_RESULT_T *p_result)
+{
+    uint32_t node;
+    bool_t shared = DEF_TRUE;
+
+    printf("-- Samples of each node:");
+    for (node = 0; node < CLUSTER_TEST_NODES; node++) {
+        printf(" %u", p_result->Node[node].Transmissions);
+        if (p_result->Node[node].Transmissions < CLUSTER_TEST_SHARE * p_result->Frames / CLUSTER_TEST_NODES) {
+            shared = DEF_FALSE;
+        }
+    }
+    printf("\n");
+
+    return shared;
+}
+
+/**
+ * \brief  Runs the test of the cooperative cluster.
+ *
+ * \return DEF_OK if all the checks pass; otherwise DEF_FAIL.
+ *
+ */
+bool_t ClusterTest_RunTest(void)
+{
+    SIM_CLUSTER_RESULT_T *p_independent = &ClusterTest_Results[0], *p_cooperative = &ClusterTest_Results[1];
+    bool_t test = DEF_OK, simulated;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Cooperative Cluster Test ///\n");
+    printf("//////////////////////////////////\n\n");
+
+    ClusterTest_Learning(&test);
+
+    ClusterTest_Field();
+    simulated = ((DEF_OK == ClusterTest_Run(DEF_FALSE, p_independent)) &&
+                 (DEF_OK == ClusterTest_Run(DEF_TRUE, p_cooperative))) ? DEF_TRUE : DEF_FALSE;
+    TestUtils_Check(simulated, "Cluster simulated in both modes", &test);
+    if (DEF_FALSE == simulated) {
+        printf("-- Result: FAIL\n");
+        return DEF_FAIL;
+    }
+
+    printf("-- Cluster of %u nodes for %u days, field deviation %.4f\n", CLUSTER_TEST_NODES, CLUSTER_TEST_DAYS,
+           p_independent->Deviation);
+    printf("--   Mode          Frames   Heard  Charge/day     MAE    RMSE  Wall [s]\n");
+    ClusterTest_Print("Independent", p_independent);
+    ClusterTest_Print("Cooperative", p_cooperative);
+    printf("-- Charge saved %.1f %%, RMSE of the field %.1f %% of its deviation, %.1f %% independent\n",
+           100.0 * (1.0 - p_cooperative->Charge / p_independent->Charge),
+           100.0 * p_cooperative->Rmse / p_cooperative->Deviation,
+           100.0 * p_independent->Rmse / p_independent->Deviation);
+
+    TestUtils_Check(0u < p_cooperative->Node[0].Heard, "Neighbors overheard", &test);
+    TestUtils_Check(p_cooperative->Charge <= (1.0 - CLUSTER_TEST_SAVING) * p_independent->Charge,
+                    "Charge saved by the cooperation", &test);
+    TestUtils_Check(p_cooperative->Rmse <= CLUSTER_TEST_ERROR * p_cooperative->Deviation,
+                    "Field rebuilt by the sink", &test);
+    TestUtils_Check(ClusterTest_Shared(p_cooperative), "Turns shared by the nodes", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+    return test;
+}
+
+/** @} (end addtogroup Cluster) */
+/** @} (end addtogroup Tests)   */
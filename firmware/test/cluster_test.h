@@ -0,0 +1,35 @@
+/**
+ * \file    cluster_test.h
+ *
+ * \brief   Header file for the cooperative cluster test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __CLUSTER_TEST_H__
+#define __CLUSTER_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Cluster
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t ClusterTest_RunTest(void);
+
+
+/** @} (end addtogroup Cluster) */
+/** @} (end addtogroup Tests)   */
+
+#endif  /* __CLUSTER_TEST_H__       */
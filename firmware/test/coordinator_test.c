@@ -0,0 +1,367 @@
+/**
+ * \file    coordinator_test.c
+ *
+ * \brief   Main file for the sink coordinator test.
+ *          This is not a Unit test, but a functional test where the sink assigns the sampling
+ *          periods of a random mesh, routed by the mesh simulator, with random batteries and
+ *          random worth of the data of each node. The assignment is checked against the
+ *          budgets and against the best common period, then the batteries drain or recharge
+ *          and the assignment is updated node by node and compared with a new solve. Last, a
+ *          simulated node follows the period it was assigned.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: CoordTest_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/trigger_cfg.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_random.h"
+#include "../sim/sim_workers.h"
+#include "../sim/sim_node.h"
+#include "../sim/sim_mesh.h"
+#include "../sink/sink_coordinator.h"
+
+#include "coordinator_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Coordinator
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#ifndef COORD_TEST_NODES
+#define COORD_TEST_NODES                    10000u  /* Set by make NODES=, nodes of the mesh    */
+#endif
+#define COORD_TEST_SEED                     1u
+#define COORD_TEST_FIXED                    100.0   /* Charge per day of the MCU and the idle   */
+#define COORD_TEST_FRAME                    1.0     /* Charge of an own frame                   */
+#define COORD_TEST_RELAY                    1.5     /* Charge of a relayed frame, rx and tx     */
+#define COORD_TEST_BUDGET                   20000.0 /* Charge per day of a full battery         */
+#define COORD_TEST_MIN_BATTERY              0.5     /* Charge left in the emptiest battery      */
+#define COORD_TEST_MIN_WEIGHT               0.1
+#define COORD_TEST_UPDATES                  200u    /* Battery updates, drains and recharges    */
+#define COORD_TEST_CHANGE                   0.5     /* Maximum relative change of an update     */
+#define COORD_TEST_LOSS                     0.02    /* Information lost by the updates          */
+#define COORD_TEST_PERIOD_ERROR             0.1     /* Relative error of the followed period    */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static SINK_COORD_NODE_T CoordTest_Nodes[SINK_COORD_MAX_NODES];
+static uint8_t CoordTest_Levels[SINK_COORD_MAX_NODES];
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Builds the network: the routes of the mesh simulator, random batteries and weights.
+ *
+ * \param  p_nodes:  Pointer to where the number of nodes will be saved.
+ *
+ * \return DEF_OK if the mesh could be built; otherwise DEF_FAIL.
+ *
+ */
+static bool_t CoordTest_Network(uint32_t *p_nodes)
+{
+    SIM_MESH_CFG_T cfg;
+    SIM_MESH_RESULT_T result;
+    const SIM_MESH_NODE_T *p_mesh;
+    uint32_t node;
+
+    SimMesh_DefaultCfg(&cfg);
+    cfg.Slots = 0;                                      /* Only the routes  */
+    if ((DEF_FAIL == SimMesh_RandomTopology(COORD_TEST_NODES, SIM_MESH_DEGREE, SIM_MESH_MAX_LOSS,
+                                            COORD_TEST_SEED, &cfg.Topology)) ||
+        (DEF_FAIL == SimMesh_Run(&cfg, &result))) {
+        return DEF_FAIL;
+    }
+    printf("-- Mesh of %u nodes, %u routed, max hops %u\n", cfg.Topology.Nodes, result.Reachable, result.MaxHops);
+
+    p_mesh = SimMesh_GetNodes();
+    SimRandom_Seed(COORD_TEST_SEED, 0u);
+    for (node = 0; node < cfg.Topology.Nodes; node++) {
+        CoordTest_Nodes[node].Parent = p_mesh[node].Parent;
+        CoordTest_Nodes[node].Weight = COORD_TEST_MIN_WEIGHT + (1.0 - COORD_TEST_MIN_WEIGHT) * SimRandom_Uniform();
+        CoordTest_Nodes[node].Fixed = COORD_TEST_FIXED;
+        CoordTest_Nodes[node].Frame = COORD_TEST_FRAME;
+        CoordTest_Nodes[node].Relay = COORD_TEST_RELAY;
+        CoordTest_Nodes[node].Budget = COORD_TEST_FIXED + COORD_TEST_BUDGET *
+                                       (COORD_TEST_MIN_BATTERY + (1.0 - COORD_TEST_MIN_BATTERY) * SimRandom_Uniform());
+    }
+    *p_nodes = cfg.Topology.Nodes;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Frames per day of a node.
+ *
+ * \param  node:  Node.
+ *
+ * \return Frames per day, 0 for the sink and the nodes without a route.
+ *
+ */
+static float64_t CoordTest_Frames(uint32_t node)
+{
+    uint32_t period = SinkCoord_GetPeriod(node);
+
+    return (0u == period) ? 0.0 : (float64_t) SA_UTILS_DAYS_TO_MILLI_S / period;
+}
+
+/**
+ * \brief  Tells if every node is within its budget with the assigned periods, computing the
+ *         charges again from the routes.
+ *
+ * \param  nodes:  Number of nodes.
+ *
+ * \return DEF_TRUE if the assignment is within the budgets and matches the coordinator;
+ *         otherwise DEF_FALSE.
+ *
+ * \note List of notes:
+ *       1. A node over its budget at the slowest periods is within the assignment if every
+ *          node routed through it is at the slowest period.
+ */
+static bool_t CoordTest_Feasible(uint32_t nodes)
+{
+    static float64_t charges[SINK_COORD_MAX_NODES];
+    static bool_t loaded[SINK_COORD_MAX_NODES];
+    uint32_t node, relay;
+    float64_t frames;
+    bool_t feasible = DEF_TRUE;
+
+    for (node = 0; node < nodes; node++) {
+        charges[node] = (0.0 < CoordTest_Frames(node)) ? CoordTest_Nodes[node].Fixed : 0.0;
+        loaded[node] = DEF_FALSE;
+    }
+    for (node = 0; node < nodes; node++) {
+        frames = CoordTest_Frames(node);
+        if (0.0 == frames) continue;
+        charges[node] += CoordTest_Nodes[node].Frame * frames;
+        loaded[node] |= (SINK_COORD_SLOWEST != SinkCoord_GetLevel(node)) ? DEF_TRUE : DEF_FALSE;
+        for (relay = CoordTest_Nodes[node].Parent; 0.0 < CoordTest_Frames(relay); relay = CoordTest_Nodes[relay].Parent) {
+            charges[relay] += CoordTest_Nodes[relay].Relay * frames;
+            loaded[relay] |= (SINK_COORD_SLOWEST != SinkCoord_GetLevel(node)) ? DEF_TRUE : DEF_FALSE;
+        }
+    }
+    for (node = 0; node < nodes; node++) {
+        if (((DEF_TRUE == loaded[node]) && (charges[node] > CoordTest_Nodes[node].Budget)) ||
+            (1e-6 * charges[node] < fabs(charges[node] - SinkCoord_GetCharge(node)))) {
+            feasible = DEF_FALSE;
+        }
+    }
+    return feasible;
+}
+
+/**
+ * \brief  Information of the network with every node at the same period.
+ *
+ * \param  nodes:  Number of nodes.
+ * \param  p_level:  Pointer to where the fastest period within the budgets will be saved.
+ *
+ * \return Information of the fastest common period within the budgets.
+ *
+ */
+static float64_t CoordTest_Common(uint32_t nodes, uint8_t *p_level)
+{
+    static float64_t load[SINK_COORD_MAX_NODES];
+    uint32_t node, relay;
+    uint8_t level;
+    float64_t frames, weights = 0.0;
+    bool_t feasible = DEF_TRUE;
+
+    /* Frames through each node at 1 frame per day each */
+    memset(load, 0x00, nodes * sizeof(float64_t));
+    for (node = 0; node < nodes; node++) {
+        if (0u == SinkCoord_GetPeriod(node)) continue;
+        weights += CoordTest_Nodes[node].Weight;
+        for (relay = CoordTest_Nodes[node].Parent; 0u != SinkCoord_GetPeriod(relay); relay = CoordTest_Nodes[relay].Parent) {
+            load[relay] += 1.0;
+        }
+    }
+    *p_level = SINK_COORD_SLOWEST;
+    for (level = SINK_COORD_SLOWEST; (DEF_TRUE == feasible) && (SINK_COORD_FASTEST < level); level--) {
+        frames = (float64_t) SA_UTILS_DAYS_TO_MILLI_S / TriggerCfg_Periods_Ptr[level - 1u];
+        for (node = 0; node < nodes; node++) {
+            if ((0u != SinkCoord_GetPeriod(node)) &&
+                (CoordTest_Nodes[node].Fixed + frames * (CoordTest_Nodes[node].Frame + CoordTest_Nodes[node].Relay * load[node]) >
+                 CoordTest_Nodes[node].Budget)) {
+                feasible = DEF_FALSE;
+            }
+        }
+        if (DEF_TRUE == feasible) *p_level = level - 1u;
+    }
+    return weights * log((float64_t) TriggerCfg_Periods_Ptr[SINK_COORD_SLOWEST] / TriggerCfg_Periods_Ptr[*p_level]);
+}
+
+/**
+ * \brief  Prints the mean period of the nodes by hops to the sink.
+ *
+ * \param  nodes:  Number of nodes.
+ *
+ */
+static void CoordTest_Hops(uint32_t nodes)
+{
+    static float64_t sums[SIM_MESH_NO_ROUTE];
+    static uint32_t counts[SIM_MESH_NO_ROUTE];
+    const SIM_MESH_NODE_T *p_mesh = SimMesh_GetNodes();
+    uint32_t node;
+    uint16_t hops, max_hops = 0;
+
+    memset(sums, 0x00, sizeof(sums));
+    memset(counts, 0x00, sizeof(counts));
+    for (node = 0; node < nodes; node++) {
+        if (0u == SinkCoord_GetPeriod(node)) continue;
+        hops = p_mesh[node].Hops;
+        sums[hops] += (float64_t) SinkCoord_GetPeriod(node) / SA_UTILS_MINS_TO_MILLI_S;
+        counts[hops]++;
+        max_hops = SA_UTILS_MAX(max_hops, hops);
+    }
+    printf("-- Mean period by hops [min]:");
+    for (hops = 1u; hops <= max_hops; hops += 1u + max_hops / 10u) {
+        printf(" %u: %.0f", hops, sums[hops] / counts[hops]);
+    }
+    printf("\n");
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the sink coordinator test.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The updates are compared with a new solve in information, and in the candidates
+ *          evaluated as a measure of the work, the wall times are only reported.
+ */
+bool_t CoordTest_RunTest(void)
+{
+    SINK_COORD_STATUS_T status;
+    SIM_NODE_CFG_T node_cfg;
+    SIM_NODE_RESULT_T node_result;
+    uint32_t nodes, node, busiest = SINK_COORD_NONE, update, evaluations = 0, full_evaluations;
+    uint8_t level;
+    float64_t start, wall, full_wall, information, common, heavy = 0.0, light = 0.0, interval;
+    uint32_t heavy_count = 0, light_count = 0;
+    bool_t test = DEF_OK, weighted;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Sink Coordinator Test //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    TestUtils_Check(CoordTest_Network(&nodes), "Network routed", &test);
+    TestUtils_Check(SinkCoord_Init(nodes, 0u, CoordTest_Nodes), "Coordinator initialized", &test);
+
+    /* Full solve                   */
+    start = SimWorkers_Wall();
+    SinkCoord_Solve();
+    full_wall = SimWorkers_Wall() - start;
+    SinkCoord_GetStatus(&status);
+    full_evaluations = status.Evaluations;
+    printf("-- Solve: information %.1f, upgrades %u, evaluations %u, overspent %u, wall time %.2f ms\n",
+           status.Information, status.Upgrades, status.Evaluations, status.Overspent,
+           full_wall * SA_UTILS_S_TO_MILLI_S);
+    CoordTest_Hops(nodes);
+    TestUtils_Check(CoordTest_Feasible(nodes), "Every node within its budget", &test);
+    common = CoordTest_Common(nodes, &level);
+    printf("-- Common period of %.0f min: information %.1f\n",
+           (float64_t) TriggerCfg_Periods_Ptr[level] / SA_UTILS_MINS_TO_MILLI_S, common);
+    TestUtils_Check(status.Information > common, "More information than a common period", &test);
+
+    for (node = 0; node < nodes; node++) {
+        if (0u == SinkCoord_GetPeriod(node)) continue;
+        if (CoordTest_Nodes[node].Weight > (1.0 + COORD_TEST_MIN_WEIGHT) / 2.0) {
+            heavy += SinkCoord_GetLevel(node);
+            heavy_count++;
+        } else {
+            light += SinkCoord_GetLevel(node);
+            light_count++;
+        }
+        if ((CoordTest_Nodes[node].Parent == 0u) &&
+            ((SINK_COORD_NONE == busiest) || (SinkCoord_GetCharge(node) > SinkCoord_GetCharge(busiest)))) {
+            busiest = node;
+        }
+    }
+    weighted = ((0u < heavy_count) && (0u < light_count) &&
+                (heavy / heavy_count < light / light_count)) ? DEF_TRUE : DEF_FALSE;
+    TestUtils_Check(weighted, "Faster periods for the worthier data", &test);
+
+    /* A relay loses half its budget */
+    TestUtils_Check(SINK_COORD_NONE != busiest, "Busiest relay found", &test);
+    if (SINK_COORD_NONE == busiest) busiest = 1u;
+    CoordTest_Nodes[busiest].Budget /= 2.0;
+    start = SimWorkers_Wall();
+    SinkCoord_SetBudget(busiest, CoordTest_Nodes[busiest].Budget);
+    wall = SimWorkers_Wall() - start;
+    SinkCoord_GetStatus(&status);
+    information = status.Information;
+    printf("-- Relay %u at half budget: information %.1f, upgrades %u, downgrades %u, evaluations %u, "
+           "wall time %.3f ms\n", busiest, status.Information, status.Upgrades, status.Downgrades,
+           status.Evaluations, wall * SA_UTILS_S_TO_MILLI_S);
+    TestUtils_Check((0u < status.Downgrades) && CoordTest_Feasible(nodes), "Update within the budgets", &test);
+    TestUtils_Check(status.Evaluations < full_evaluations, "Update cheaper than a solve", &test);
+    SinkCoord_Solve();
+    SinkCoord_GetStatus(&status);
+    printf("-- Solve: information %.1f\n", status.Information);
+    TestUtils_Check(information >= (1.0 - COORD_TEST_LOSS) * status.Information, "Update close to a solve", &test);
+
+    /* Batteries drain and recharge */
+    SimRandom_Seed(COORD_TEST_SEED, 1u);
+    start = SimWorkers_Wall();
+    for (update = 0; update < COORD_TEST_UPDATES; update++) {
+        do {
+            node = (uint32_t)(SimRandom_Next() % nodes);
+        } while (0u == SinkCoord_GetPeriod(node));
+        CoordTest_Nodes[node].Budget *= 1.0 + COORD_TEST_CHANGE * (2.0 * SimRandom_Uniform() - 1.0);
+        SinkCoord_SetBudget(node, CoordTest_Nodes[node].Budget);
+        SinkCoord_GetStatus(&status);
+        evaluations += status.Evaluations;
+    }
+    wall = SimWorkers_Wall() - start;
+    SinkCoord_GetStatus(&status);
+    information = status.Information;
+    printf("-- %u battery updates: information %.1f, %.1f evaluations and %.3f ms per update\n",
+           COORD_TEST_UPDATES, information, (float64_t) evaluations / COORD_TEST_UPDATES,
+           wall * SA_UTILS_S_TO_MILLI_S / COORD_TEST_UPDATES);
+    TestUtils_Check(CoordTest_Feasible(nodes), "Updates within the budgets", &test);
+    for (node = 0; node < nodes; node++) {
+        CoordTest_Levels[node] = SinkCoord_GetLevel(node);
+    }
+    SinkCoord_Solve();
+    SinkCoord_GetStatus(&status);
+    printf("-- Solve: information %.1f\n", status.Information);
+    TestUtils_Check(information >= (1.0 - COORD_TEST_LOSS) * status.Information, "Updates close to a solve", &test);
+
+    /* A node follows its period    */
+    for (node = 0; (node < nodes) && ((TRIGGER_CFG_DEFAULT_SAMPLING >= CoordTest_Levels[node]) ||
+                                      (SINK_COORD_SLOWEST <= CoordTest_Levels[node])); node++);
+    TestUtils_Check(node < nodes, "Node assigned a slower period", &test);
+    if (node == nodes) node = 1u;
+    SimNode_DefaultCfg(&node_cfg);
+    node_cfg.AssignedPeriod = TriggerCfg_Periods_Ptr[CoordTest_Levels[node]];
+    TestUtils_Check(SimNode_Run(&node_cfg, &node_result), "Node simulated", &test);
+    interval = (float64_t) node_result.Lifetime / node_result.Activations;
+    printf("-- Node %u assigned %.0f min: %u activations in %.1f days, mean period %.1f min\n", node,
+           (float64_t) node_cfg.AssignedPeriod / SA_UTILS_MINS_TO_MILLI_S, node_result.Activations,
+           (float64_t) node_result.Lifetime / SA_UTILS_DAYS_TO_MILLI_S, interval / SA_UTILS_MINS_TO_MILLI_S);
+    TestUtils_Check(fabs(interval - node_cfg.AssignedPeriod) < COORD_TEST_PERIOD_ERROR * node_cfg.AssignedPeriod,
+                    "Node at the assigned period", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+
+    return test;
+}
+
+/** @} (end addtogroup Coordinator) */
+/** @} (end addtogroup Tests)       */
@@ -0,0 +1,35 @@
+/**
+ * \file    coordinator_test.h
+ *
+ * \brief   Header file for the sink coordinator test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __COORDINATOR_TEST_H__
+#define __COORDINATOR_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Coordinator
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t CoordTest_RunTest(void);
+
+
+/** @} (end addtogroup Coordinator) */
+/** @} (end addtogroup Tests)   */
+
+#endif  /* __COORDINATOR_TEST_H__       */
@@ -25,9 +25,12 @@
 #include "../configs/radio_cfg.h"
 #include "../include/radio_agent.h"
 #include "../include/power_agent.h"
+#include "../configs/mote_cfg.h"
+#include "../include/energy_planner.h"
 #include "../include/decision_engine.h"
 
 #include "decision_engine_test.h"
+#include "test_utils.h"
 
 /** \addtogroup Agents
  *   @{
@@ -49,6 +52,10 @@
 
 #define DECISION_ENGINE_TEST_SHOW_POWER_LOOP    DEF_TRUE
 
+#define DECISION_ENGINE_TEST_CHARGE_TOLERANCE   1.0e-5f /* Relative error of a cached charge    */
+#define DECISION_ENGINE_TEST_PLANNER_CHARGE     1.0e5f  /* Charge of the energy plan check      */
+#define DECISION_ENGINE_TEST_PLANNER_DAYS       7u      /* Daily activations of the plan check  */
+
 /************************************** Typedef **************************************************/
 
 /************************************** Function prototypes **************************************/
@@ -66,8 +73,37 @@ static CONFIG_POWER_T DecisionEngTest_FeedbackPower = {0,0};
 static CONFIG_POWER_T DecisionEngTest_BasePower     = {0,0};
 static CONFIG_POWER_T DecisionEngTest_IdlePower     = {0,0};
 
+/* Cached charge    */
+static uint32_t DecisionEngTest_ChargeErrors = 0;
+
 /************************************** Function implementation **********************************/
 /************* Power Agent ******************/
+/**
+ * \brief  Checks the predicted charge of the mote against a full recompute of the power models.
+ *
+ * \note List of notes:
+ *       1. It is called from the power observation, which runs right after the decision engine
+ *          has set the power inputs and before the power predictions are updated, so the
+ *          charge of the engine, cached or not, must match the models at that point.
+ */
+static void DecisionEngTest_CheckCharge(void)
+{
+    float32_t charge;
+    float32_t error;
+
+    charge  = DecisionEng_GetIdlePowerPtr()->Power;
+    charge += DecisionEng_GetBasePowerPtr()->Power;
+    charge += SensorAgent_GetPower();
+    charge += RadioAgent_GetPower() * (RadioAgent_GetFrames() + RadioAgent_GetForwarding());
+
+    error = DecisionEng_GetPower() - charge;
+    if (0.0f > error) error = -error;
+    if (error > (DECISION_ENGINE_TEST_CHARGE_TOLERANCE * charge)) {
+        printf("-- ::Power  :: Cached charge %f, recomputed %f\n", DecisionEng_GetPower(), charge);
+        DecisionEngTest_ChargeErrors++;
+    }
+}
+
 /**
  * \brief  Fakes a measurement from the coulomb counter.
  *
@@ -82,6 +118,10 @@ static void DecisionEngTest_PowerObs(POWER_AGENT_OBS_T *p_obs)
             break;
     }
     p_obs->Battery.Charge = DecisionEngTest_ChargeAccum;
+    p_obs->Battery.BatteryVoltage = 0;      /* No voltage measurement   */
+    p_obs->Battery.Harvested = 0;           /* No harvester             */
+    p_obs->Battery.Temperature = 25.0;
+    DecisionEngTest_CheckCharge();
     if (DEF_TRUE == DECISION_ENGINE_TEST_SHOW_POWER)
         printf("-- ::Power  :: Observation->Data = %f\n", p_obs->Battery.Charge);
 }
@@ -104,10 +144,10 @@ static void DecisionEngTest_PowerActs(POWER_AGENT_ACTS_T *p_obs)
  * \param  error:  Error code.
  *
  */
-static void DecisionEngTest_PowerAlarm(void)
+static void DecisionEngTest_PowerAlarm(POWER_AGENT_ERROR_T error)
 {
     if (DEF_TRUE == DECISION_ENGINE_TEST_SHOW_POWER)
-        printf("-- ::Power  :: Alarm ----------------------------\n");
+        printf("-- ::Power  :: Alarm = %u----------------------------\n", error);
 }
 
 /************* Radio Agent ******************/
@@ -231,6 +271,7 @@ void DecisionEngTest_ShowPowerLoopPost(void)
 {
     if (DEF_TRUE == DECISION_ENGINE_TEST_SHOW_POWER_LOOP) {
         CONFIG_POWER_T *temp;
+        ENERGY_PLANNER_STATUS_T plan;
 
         printf(".........\nPowerLoop:\n");
         printf("--- Power prediction: %f, measured %f\n", DecisionEng_GetPower(), PowerAgent_GetPowerMeasurement());
@@ -254,16 +295,56 @@ void DecisionEngTest_ShowPowerLoopPost(void)
         printf("--- Idle     pre: %f, %f - Post %f, %f\n",
                DecisionEngTest_IdlePower.Power,DecisionEngTest_IdlePower.Covariance,
                temp->Power, temp->Covariance);
+        EnergyPlanner_GetStatus(&plan);
+        printf("--- Plan slot %u: budget %f, spent %f, weight %f -> index %d\n",
+               plan.Slot, plan.Budget, plan.Spent, plan.Weight, EnergyPlanner_GetBudgetIndex());
         printf(".........\n");
     }
 }
 
+/**
+ * \brief  Checks the budget index of the energy planner with a period longer than a slot.
+ *
+ * \param  p_result:  Pointer to the result of the test, set to DEF_FAIL if a check fails.
+ *
+ * \note List of notes:
+ *       1. The planner starts from scratch, so this runs after the loop of the engine.
+ *       2. A daily activation that spends half of the daily budget is within the budget, and
+ *          one that spends twice the daily budget is over it.
+ */
+static void DecisionEngTest_Planner(bool_t *p_result)
+{
+    float32_t charge = DECISION_ENGINE_TEST_PLANNER_CHARGE, daily = 0.0f;
+    bool_t within = DEF_TRUE;
+    uint32_t day;
+    int8_t index;
+
+    EnergyPlanner_Init(MOTE_CFG_EXPECTED_BATTERY_LIFE);
+    for (day = 0; day < DECISION_ENGINE_TEST_PLANNER_DAYS; day++) {
+        daily  = charge * (SA_UTILS_DAYS_TO_MILLI_S / SA_UTILS_S_TO_MILLI_S);
+        daily /= MOTE_CFG_EXPECTED_BATTERY_LIFE - day * (SA_UTILS_DAYS_TO_MILLI_S / SA_UTILS_S_TO_MILLI_S);
+        EnergyPlanner_Update(0.5f * daily, 1.0f, SA_UTILS_DAYS_TO_MILLI_S, charge, 0.0f);
+        charge -= 0.5f * daily;
+        if (0 >= EnergyPlanner_GetBudgetIndex()) {
+            within = DEF_FALSE;
+        }
+    }
+    index = EnergyPlanner_GetBudgetIndex();
+    EnergyPlanner_Update(2.0f * daily, 1.0f, SA_UTILS_DAYS_TO_MILLI_S, charge, 0.0f);
+    printf("-- Budget index of a daily activation: %d at half of the daily budget, %d at twice\n",
+           index, EnergyPlanner_GetBudgetIndex());
+    TestUtils_Check(within, "Daily period within the budget", p_result);
+    TestUtils_Check(0 > EnergyPlanner_GetBudgetIndex(), "Daily period over the budget", p_result);
+}
+
 /************* Main *************************/
 /**
  * \brief  Runs the simulation for the decision engine module.
  *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
  */
-void DecisionEngTest_RunTest()
+bool_t DecisionEngTest_RunTest(void)
 {
     DECISION_ENGINE_INIT_T init = {
         .PowerInit.Obs = DecisionEngTest_PowerObs,
@@ -279,6 +360,10 @@ void DecisionEngTest_RunTest()
         .AppInit.Trigger.Alarm = NULL,
         .AppInit.Alarm = NULL
     };
+    DECISION_ENGINE_SKIPS_T skips;
+    bool_t result = DEF_OK;
+
+    DecisionEngTest_ChargeErrors = 0;
     DecisionEng_Init(&init);
 
     for (DecisionEngTest_Iterations = 0; DecisionEngTest_Iterations < DECISION_ENGINE_TEST_ITERATIONS;
@@ -297,6 +382,26 @@ void DecisionEngTest_RunTest()
         DecisionEngTest_ShowPowerLoopPost();
 
     }
+
+    DecisionEng_GetSkips(&skips);
+    printf("\n-- Skipped work in %u loops: activations %u, power inputs %u, unchanged predictions %u\n",
+           skips.Loops, skips.ActivationsSkipped, skips.PowerInputsSkipped, skips.PredictionsUnchanged);
+    TestUtils_Check(0u == DecisionEngTest_ChargeErrors,
+                    "Cached charge matches a full recompute", &result);
+    TestUtils_Check(0u < skips.PowerInputsSkipped, "Cached charge reused", &result);
+    TestUtils_Check(0u < skips.ActivationsSkipped, "Cached activations reused", &result);
+
+    printf("-- Learned power: radio %f, sensor %f, base %f\n", RadioAgent_GetPower(),
+           SensorAgent_GetPower(), DecisionEng_GetBasePowerPtr()->Power);
+    DecisionEng_ResetToDatasheet();
+    printf("-- Datasheet power: radio %f, sensor %f, base %f\n", RadioAgent_GetPower(),
+           SensorAgent_GetPower(), DecisionEng_GetBasePowerPtr()->Power);
+    TestUtils_Check(RadioCfg_Configs_Ptr[RadioAgent_GetConfig()].PowerCost.Power == RadioAgent_GetPower(),
+                    "Radio power back to the datasheet", &result);
+
+    DecisionEngTest_Planner(&result);
+
+    return result;
 }
 
 
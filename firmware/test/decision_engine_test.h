@@ -23,6 +23,6 @@
 /************************************** Local Var ************************************************/
 
 /************************************** Function prototypes **************************************/
-void DecisionEngTest_RunTest(void);
+bool_t DecisionEngTest_RunTest(void);
 
 #endif /* __DECISION_ENGINE_TEST_H__       */
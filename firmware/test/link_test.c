@@ -0,0 +1,363 @@
+/**
+ * \file    link_test.c
+ *
+ * \brief   Main file for the link quality test.
+ *          The radio agent transmits over a simulated link whose path loss steps from a good
+ *          link to a marginal and a bad one. Each attempt is delivered with a probability
+ *          given by the margin of the received power over the sensitivity of the sink, and
+ *          the radio retries up to LINK_TEST_ATTEMPTS attempts, reporting the attempts, the
+ *          acknowledgement and its RSSI. The agent must select the mode with the least energy
+ *          per delivered byte in each phase, and spend less per delivered byte than a fixed
+ *          mode or the cheapest mode per attempt.
+ *          A simulated node then transmits over a link that degrades, with and without
+ *          reporting the outcome of its transmissions. With the outcome, the energy of the
+ *          retries must be predicted by the radio, so the power of an attempt and the base and
+ *          idle power learned by the decision engine stay as over a steady link.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: LinkTest_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/radio_cfg.h"
+#include "../include/radio_agent.h"
+
+#include "../sim/sim_random.h"
+#include "../sim/sim_node.h"
+
+#include "link_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Link
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define LINK_TEST_SEED                      1u
+#define LINK_TEST_PHASES                    3u
+#define LINK_TEST_TRANSMISSIONS             300u    /* Transmissions of each phase              */
+#define LINK_TEST_ATTEMPTS                  4u      /* Attempts of the radio, the retries plus 1*/
+#define LINK_TEST_SENSITIVITY               (-88.0) /* True RSSI with half of the attempts lost */
+#define LINK_TEST_SLOPE                     2.0     /* True dB of margin per logistic unit      */
+#define LINK_TEST_FADING                    2.0     /* Deviation of the RSSI in dB              */
+#define LINK_TEST_BACKOFF                   0.2     /* Charge of a backoff, of an attempt       */
+#define LINK_TEST_PATH_LOSS                 82.0    /* dB of the link of the node               */
+#define LINK_TEST_LOSS_STEP                 4.0     /* dB of the degradation of the link        */
+#define LINK_TEST_LOSS_TIME                 ((SIM_TIME_T) 1u * SA_UTILS_DAYS_TO_MILLI_S)
+#define LINK_TEST_HORIZON                   ((SIM_TIME_T) 5u * SA_UTILS_DAYS_TO_MILLI_S)
+#define LINK_TEST_ATTRIBUTION               0.5     /* Maximum drift with the retries, of the
+                                                       drift without them                       */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Result of a run over all the phases.
+ *
+ */
+typedef struct {
+    float64_t Charge;                   /* Charge of all the attempts                       */
+    uint32_t Bytes;                     /* Bytes delivered                                  */
+    uint32_t Attempts;
+    uint32_t Delivered;                 /* Transmissions acknowledged                       */
+    RADIO_CFG_LIST_T Mode[LINK_TEST_PHASES];    /* Mode at the end of each phase            */
+} LINK_TEST_RESULT_T;
+
+/**
+ * \brief  Power models learned by a simulated node.
+ *
+ */
+typedef struct {
+    float64_t Attempt;                  /* Power of an attempt of the radio config in use   */
+    float64_t Base;
+    float64_t Idle;
+    uint32_t Attempts;
+    uint32_t Transmissions;
+} LINK_TEST_LEARNED_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static const float64_t LinkTest_PathLoss[LINK_TEST_PHASES] = {70.0, 80.0, 92.0};   /* dB  */
+static const char *LinkTest_Names[RADIO_CFG_CONFIGS_SIZE] = {"low", "standard", "high"};
+
+static uint8_t LinkTest_Phase;
+static bool_t LinkTest_Feedback;        /* Outcome of the transmissions observed            */
+static RADIO_CFG_LIST_T LinkTest_Fixed; /* Mode forced without feedback                     */
+static RADIO_AGENT_OBS_T LinkTest_Last; /* Outcome of the last transmission                 */
+static LINK_TEST_RESULT_T LinkTest_Result;
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Gets the true delivery probability of an attempt.
+ *
+ * \param  mode:   Mode of the radio.
+ * \param  phase:  Phase of the link.
+ *
+ * \return Delivery probability.
+ *
+ */
+static float64_t LinkTest_Delivery(RADIO_CFG_LIST_T mode, uint8_t phase)
+{
+    float64_t margin = RadioCfg_TxPower_Ptr[mode] - LinkTest_PathLoss[phase] - LINK_TEST_SENSITIVITY;
+
+    return 1.0 / (1.0 + exp(-margin / LINK_TEST_SLOPE));
+}
+
+/**
+ * \brief  Gets the true energy per delivered frame of a mode.
+ *
+ * \param  mode:   Mode of the radio.
+ * \param  phase:  Phase of the link.
+ *
+ * \return Expected charge of the attempts and backoffs of a transmission over its delivery.
+ *
+ */
+static float64_t LinkTest_Cost(RADIO_CFG_LIST_T mode, uint8_t phase)
+{
+    float64_t delivery = LinkTest_Delivery(mode, phase);
+    float64_t lost = 1.0, charge = 0.0;
+    uint8_t attempt;
+
+    for (attempt = 1; attempt <= LINK_TEST_ATTEMPTS; attempt++) {
+        charge += lost * (1.0 + ((1u < attempt) ? LINK_TEST_BACKOFF : 0.0));
+        lost *= 1.0 - delivery;
+    }
+
+    return RadioCfg_Configs_Ptr[mode].PowerCost.Power * charge / (1.0 - lost);
+}
+
+/**
+ * \brief  Gets the mode with the least true energy per delivered byte.
+ *
+ * \param  phase:  Phase of the link.
+ *
+ * \return Best mode.
+ *
+ */
+static RADIO_CFG_LIST_T LinkTest_BestMode(uint8_t phase)
+{
+    RADIO_CFG_LIST_T best = RADIO_CFG_LOW_POWER_MODE;
+    uint8_t mode;
+
+    for (mode = 0; mode < RADIO_CFG_CONFIGS_SIZE; mode++) {
+        if (LinkTest_Cost((RADIO_CFG_LIST_T) mode, phase) < LinkTest_Cost(best, phase)) {
+            best = (RADIO_CFG_LIST_T) mode;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * \brief  Fakes the radio observation, the outcome of the last transmission.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void LinkTest_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = DEF_FALSE;
+    if (DEF_TRUE == LinkTest_Feedback) {
+        p_obs->Attempts = LinkTest_Last.Attempts;
+        p_obs->Acked = LinkTest_Last.Acked;
+        p_obs->Rssi = LinkTest_Last.Rssi;
+    } else if (LinkTest_Fixed != RadioAgent_GetConfig()) {
+        p_obs->ConfigChange = DEF_TRUE;
+        p_obs->Config = LinkTest_Fixed;
+    }
+}
+
+/**
+ * \brief  Transmits over the simulated link, retrying after a backoff until acknowledged.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void LinkTest_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    float64_t rssi;
+
+    LinkTest_Last.Acked = DEF_FALSE;
+    LinkTest_Last.Rssi = RADIO_CFG_RSSI_UNKNOWN;
+    for (LinkTest_Last.Attempts = 1; LinkTest_Last.Attempts <= LINK_TEST_ATTEMPTS; LinkTest_Last.Attempts++) {
+        LinkTest_Result.Charge += RadioCfg_Configs_Ptr[p_acts->Config].PowerCost.Power *
+                                  ((1u < LinkTest_Last.Attempts) ? 1.0 + LINK_TEST_BACKOFF : 1.0);
+        LinkTest_Result.Attempts++;
+        if (SimRandom_Uniform() < LinkTest_Delivery(p_acts->Config, LinkTest_Phase)) {
+            rssi = RadioCfg_TxPower_Ptr[p_acts->Config] - LinkTest_PathLoss[LinkTest_Phase] +
+                   LINK_TEST_FADING * SimRandom_Gaussian();
+            LinkTest_Last.Acked = DEF_TRUE;
+            LinkTest_Last.Rssi = (int8_t) SA_UTILS_SATURATE(RADIO_CFG_RSSI_UNKNOWN + 1, 0, lround(rssi));
+            LinkTest_Result.Bytes += RADIO_CFG_FRAME_HEADER + p_acts->BatchSize * sizeof(float32_t);
+            LinkTest_Result.Delivered++;
+            break;
+        }
+    }
+    LinkTest_Last.Attempts = (uint8_t) SA_UTILS_MIN(LinkTest_Last.Attempts, LINK_TEST_ATTEMPTS);
+}
+
+/**
+ * \brief  Runs the radio agent over all the phases of the link.
+ *
+ * \param  feedback:  DEF_TRUE to observe the outcome of the transmissions.
+ * \param  fixed:     Mode forced without feedback.
+ * \param  p_result:  Pointer to the result of the run.
+ *
+ */
+static void LinkTest_Run(bool_t feedback, RADIO_CFG_LIST_T fixed, LINK_TEST_RESULT_T *p_result)
+{
+    RADIO_AGENT_INTERFACE_T data;
+    uint32_t transmission;
+
+    memset(&LinkTest_Result, 0x00, sizeof(LINK_TEST_RESULT_T));
+    memset(&LinkTest_Last, 0x00, sizeof(RADIO_AGENT_OBS_T));
+    memset(&data, 0x00, sizeof(RADIO_AGENT_INTERFACE_T));
+    LinkTest_Feedback = feedback;
+    LinkTest_Fixed = fixed;
+    SimRandom_Seed(LINK_TEST_SEED, 0u);
+    RadioAgent_Init(LinkTest_RadioObs, LinkTest_RadioActs, NULL, DEF_FALSE);
+
+    data.Inputs.Batch = 1u;
+    for (LinkTest_Phase = 0; LinkTest_Phase < LINK_TEST_PHASES; LinkTest_Phase++) {
+        for (transmission = 0; transmission < LINK_TEST_TRANSMISSIONS; transmission++) {
+            data.Inputs.Data = (float32_t) transmission;
+            RadioAgent_Oda(&data);
+        }
+        LinkTest_Result.Mode[LinkTest_Phase] = RadioAgent_GetConfig();
+    }
+    *p_result = LinkTest_Result;
+}
+
+/**
+ * \brief  Prints the result of a run.
+ *
+ * \param  p_name:    Name of the run.
+ * \param  p_result:  Pointer to the result of the run.
+ *
+ */
+static void LinkTest_Print(const char *p_name, const LINK_TEST_RESULT_T *p_result)
+{
+    printf("--   %-12s %8u  %9u  %8.1f %%  %12.3f\n", p_name, p_result->Attempts, p_result->Delivered,
+           100.0 * p_result->Delivered / (LINK_TEST_PHASES * LINK_TEST_TRANSMISSIONS),
+           p_result->Charge / SA_UTILS_MAX(p_result->Bytes, 1u));
+}
+
+/**
+ * \brief  Simulates a node and gets the power models it has learned.
+ *
+ * \param  step:          dB of the degradation of the link at LINK_TEST_LOSS_TIME.
+ * \param  acknowledged:  DEF_TRUE to report the outcome of the transmissions.
+ * \param  p_learned:     Pointer to where the learned power models are saved.
+ *
+ */
+static void LinkTest_Simulate(float64_t step, bool_t acknowledged, LINK_TEST_LEARNED_T *p_learned)
+{
+    SIM_NODE_CFG_T cfg;
+    SIM_NODE_RESULT_T result;
+
+    SimNode_DefaultCfg(&cfg);
+    cfg.Horizon = LINK_TEST_HORIZON;
+    cfg.FastForward = DEF_FALSE;
+    cfg.Policy = DECISION_ENGINE_POLICY_FIXED;
+    cfg.PathLoss = LINK_TEST_PATH_LOSS;
+    cfg.LossStep = step;
+    cfg.LossTime = LINK_TEST_LOSS_TIME;
+    cfg.Acknowledged = acknowledged;
+    SimRandom_Seed(LINK_TEST_SEED, 0u);
+    (void) SimNode_Run(&cfg, &result);
+
+    p_learned->Attempt = RadioCfg_Learned_Ptr[RadioAgent_GetConfig()].Power;
+    p_learned->Base = DecisionEng_GetBasePowerPtr()->Power;
+    p_learned->Idle = DecisionEng_GetIdlePowerPtr()->Power;
+    p_learned->Attempts = result.Attempts;
+    p_learned->Transmissions = result.Transmissions;
+    printf("--   %-10s %-8s %9u  %8u  %10.2f  %8.2f  %8.2f\n", (DEF_TRUE == acknowledged) ? "Outcome" : "No outcome",
+           (0.0 == step) ? "Steady" : "Degraded", result.Transmissions, result.Attempts,
+           p_learned->Attempt, p_learned->Base, p_learned->Idle);
+}
+
+/**
+ * \brief  Gets the drift of the base and idle power learned over a degraded link.
+ *
+ * \param  p_steady:    Pointer to the power models learned over a steady link.
+ * \param  p_degraded:  Pointer to the power models learned over a degraded link.
+ *
+ * \return Absolute drift.
+ *
+ */
+static float64_t LinkTest_Drift(const LINK_TEST_LEARNED_T *p_steady, const LINK_TEST_LEARNED_T *p_degraded)
+{
+    return fabs(p_degraded->Base + p_degraded->Idle - p_steady->Base - p_steady->Idle);
+}
+
+/**
+ * \brief  Runs the test of the link quality aware mode selection.
+ *
+ * \return DEF_OK if all the checks pass; otherwise DEF_FAIL.
+ *
+ */
+bool_t LinkTest_RunTest(void)
+{
+    LINK_TEST_RESULT_T adaptive, standard, cheapest;
+    LINK_TEST_LEARNED_T steady, degraded, blind_steady, blind_degraded;
+    bool_t test = DEF_OK, selected = DEF_TRUE;
+    float64_t cost;
+    uint8_t phase, mode;
+
+    printf("//////////////////////////////////\n");
+    printf("////    Link Quality Test   //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    LinkTest_Run(DEF_TRUE, RADIO_CFG_DEFAULT_CONFIG, &adaptive);
+    LinkTest_Run(DEF_FALSE, RADIO_CFG_STANDARD_MODE, &standard);
+    LinkTest_Run(DEF_FALSE, RADIO_CFG_LOW_POWER_MODE, &cheapest);
+
+    for (phase = 0; phase < LINK_TEST_PHASES; phase++) {
+        printf("-- Path loss %.0f dB, energy per delivered frame:", LinkTest_PathLoss[phase]);
+        for (mode = 0; mode < RADIO_CFG_CONFIGS_SIZE; mode++) {
+            cost = LinkTest_Cost((RADIO_CFG_LIST_T) mode, phase);
+            printf(" %s %.1f", LinkTest_Names[mode], cost);
+        }
+        printf(", selected %s\n", LinkTest_Names[adaptive.Mode[phase]]);
+        if (LinkTest_BestMode(phase) != adaptive.Mode[phase]) selected = DEF_FALSE;
+    }
+    printf("--   Mode         Attempts  Delivered   Delivery  Energy/byte\n");
+    LinkTest_Print("Adaptive", &adaptive);
+    LinkTest_Print("Standard", &standard);
+    LinkTest_Print("Low power", &cheapest);
+
+    TestUtils_Check(selected, "Best mode selected for each link", &test);
+    TestUtils_Check((adaptive.Charge / adaptive.Bytes < standard.Charge / standard.Bytes) &&
+                    (adaptive.Charge / adaptive.Bytes < cheapest.Charge / cheapest.Bytes),
+                    "Least energy per delivered byte", &test);
+    TestUtils_Check(adaptive.Delivered >= standard.Delivered, "Delivery kept as the link degrades", &test);
+
+    printf("-- Node over a link of %.0f dB degraded by %.0f dB, learned power models:\n",
+           LINK_TEST_PATH_LOSS, LINK_TEST_LOSS_STEP);
+    printf("--   Run        Link     Transmits  Attempts     Attempt      Base      Idle\n");
+    LinkTest_Simulate(0.0, DEF_TRUE, &steady);
+    LinkTest_Simulate(LINK_TEST_LOSS_STEP, DEF_TRUE, &degraded);
+    LinkTest_Simulate(0.0, DEF_FALSE, &blind_steady);
+    LinkTest_Simulate(LINK_TEST_LOSS_STEP, DEF_FALSE, &blind_degraded);
+
+    TestUtils_Check(degraded.Attempts > steady.Attempts, "Transmissions retried as the link degrades", &test);
+    TestUtils_Check(LINK_TEST_ATTRIBUTION * fabs(blind_degraded.Attempt - blind_steady.Attempt) >=
+                    fabs(degraded.Attempt - steady.Attempt), "Retries not learned as radio power", &test);
+    TestUtils_Check(LINK_TEST_ATTRIBUTION * LinkTest_Drift(&blind_steady, &blind_degraded) >=
+                    LinkTest_Drift(&steady, &degraded), "Retries not learned as base or idle power", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+    return test;
+}
+
+/** @} (end addtogroup Link)    */
+/** @} (end addtogroup Tests)   */
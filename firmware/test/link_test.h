@@ -0,0 +1,35 @@
+/**
+ * \file    link_test.h
+ *
+ * \brief   Header file for the link quality test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __LINK_TEST_H__
+#define __LINK_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Link
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t LinkTest_RunTest(void);
+
+
+/** @} (end addtogroup Link)    */
+/** @} (end addtogroup Tests)   */
+
+#endif  /* __LINK_TEST_H__       */
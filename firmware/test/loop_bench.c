@@ -0,0 +1,209 @@
+/**
+ * \file    loop_bench.c
+ *
+ * \brief   Benchmark of the loop of the decision engine, for the host and the Cortex-M targets.
+ *          The loop runs LOOP_BENCH_LOOPS times with fixed inputs, so every build runs the same
+ *          code path. On the host and on Cortex-M3/M4 the cycles per loop are reported; on the
+ *          targets without hardware, make/qemu_bench.sh runs two builds with a different number
+ *          of loops under QEMU and reports the instructions per loop from the difference.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: LoopBench_
+ *
+ */
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_timing.h"
+
+#include "../configs/battery_cfg.h"
+#include "../include/power_agent.h"
+#include "../include/radio_agent.h"
+#include "../include/decision_engine.h"
+
+#include "loop_bench.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#ifndef LOOP_BENCH_LOOPS
+#define LOOP_BENCH_LOOPS                    1000u   /* Set by make LOOPS=, 0 for the baseline   */
+#endif
+#define LOOP_BENCH_CHARGE_DELTA             1.0f    /* Charge consumed per loop                 */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static float32_t LoopBench_ChargeAccum = 0;
+static float32_t LoopBench_SensorData = 0;
+
+/************************************** Function implementation **********************************/
+/************* Power Agent ******************/
+/**
+ * \brief  Fakes a measurement from the coulomb counter.
+ *
+ * \param  p_obs:  Pointer to the observation data of the power agent.
+ *
+ */
+static void LoopBench_PowerObs(POWER_AGENT_OBS_T *p_obs)
+{
+    LoopBench_ChargeAccum += LOOP_BENCH_CHARGE_DELTA;
+    p_obs->Battery.Charge = LoopBench_ChargeAccum;
+    p_obs->Battery.BatteryVoltage = 0;      /* No voltage measurement   */
+    p_obs->Battery.Temperature = POWER_AGENT_TEMP_REF;
+    p_obs->Battery.Harvested = 0;           /* No harvester             */
+}
+
+/**
+ * \brief  Fakes the actuation of the power agent.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void LoopBench_PowerActs(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Replaces the battery when it is depleted, so the benchmark keeps running.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void LoopBench_PowerAlarm(POWER_AGENT_ERROR_T error)
+{
+    if (POWER_AGENT_BATTERY_DEPLETED == error) {
+        PowerAgent_SetBatteryCharge(POWER_AGENT_MAX_BATTERY_MA * POWER_AGENT_EFFECTIVE_CHARGE);
+    }
+}
+
+/************* Radio Agent ******************/
+/**
+ * \brief  Fakes the radio observation.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void LoopBench_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = DEF_FALSE;
+}
+
+/**
+ * \brief  Fakes the radio transmission.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void LoopBench_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Application Agent ************/
+/**
+ * \brief  Fakes a measurement from the sensor.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data.
+ *
+ */
+static void LoopBench_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    LoopBench_SensorData += 1.0f;
+    p_obs->SensorData = LoopBench_SensorData;
+}
+
+/**
+ * \brief  Fakes the configuration of the sensor.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void LoopBench_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Fakes the trigger observation.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void LoopBench_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Fakes the trigger actuation.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void LoopBench_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the benchmark of the loop of the decision engine.
+ *
+ * \note List of notes:
+ *       1. Nothing is printed inside the measured loop, so the difference of the instruction
+ *          counts of two builds is only the cost of the loops.
+ */
+void LoopBench_RunTest(void)
+{
+    DECISION_ENGINE_INIT_T init = {
+        .PowerInit.Obs = LoopBench_PowerObs,
+        .PowerInit.Act = LoopBench_PowerActs,
+        .PowerInit.Alarm = LoopBench_PowerAlarm,
+        .RadioInit.Obs = LoopBench_RadioObs,
+        .RadioInit.Act = LoopBench_RadioActs,
+        .RadioInit.Done = NULL,
+        .AppInit.Sensor.Obs = LoopBench_SensorObs,
+        .AppInit.Sensor.Act = LoopBench_SensorActs,
+        .AppInit.Sensor.Alarm = NULL,
+        .AppInit.Sensor.Start = NULL,
+        .AppInit.Sensor.Ready = NULL,
+        .AppInit.Trigger.Obs = LoopBench_TriggerObs,
+        .AppInit.Trigger.Act = LoopBench_TriggerActs,
+        .AppInit.Trigger.Alarm = NULL,
+        .AppInit.Alarm = NULL
+    };
+    uint32_t loops = LOOP_BENCH_LOOPS;
+    uint32_t loop, start, cycles;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Decision Loop Bench  ///////\n");
+    printf("//////////////////////////////////\n\n");
+
+    SaTiming_Init();
+    DecisionEng_Init(&init);
+
+    start = SaTiming_GetCycles();
+    for (loop = 0; loop < loops; loop++) {
+        DecisionEng_Loop();
+    }
+    cycles = SA_TIMING_ELAPSED(start);
+
+    printf("-- Loops: %u\n", loops);
+    if (0u < loops) {
+        printf("-- Cycles per loop: %.1f\n", (float64_t) cycles / loops);
+    }
+}
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
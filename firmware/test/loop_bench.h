@@ -0,0 +1,35 @@
+/**
+ * \file    loop_bench.h
+ *
+ * \brief   Header file for the benchmark of the loop of the decision engine.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __LOOP_BENCH_H__
+#define __LOOP_BENCH_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void LoopBench_RunTest(void);
+
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
+
+#endif  /* __LOOP_BENCH_H__       */
@@ -16,9 +16,24 @@
 #include "../platform/sa_types.h"
 
 #include "power_agent_test.h"
+#include "power_agent_bench.h"
 #include "radio_agent_test.h"
 #include "app_agent_test.h"
 #include "decision_engine_test.h"
+#include "supervisory_agent_test.h"
+#include "wcet_test.h"
+#include "resumable_test.h"
+#include "loop_bench.h"
+#include "checkpoint_test.h"
+#include "sample_store_test.h"
+#include "sim_test.h"
+#include "monte_carlo_test.h"
+#include "sweep_test.h"
+#include "quality_bench.h"
+#include "mesh_test.h"
+#include "coordinator_test.h"
+#include "cluster_test.h"
+#include "link_test.h"
 
 
 /** \addtogroup Testing
@@ -46,6 +61,11 @@ void Main_Tests(void) {
     exit(0);
 }
 
+#elif defined TEST_POWER_BENCH
+void Main_Tests(void) {
+    exit(DEF_OK == PowerAgentBench_RunTest() ? 0 : 1);
+}
+
 #elif defined TEST_RADIO
 void Main_Tests(void) {
     RadioAgentTest_RunTest();
@@ -54,16 +74,81 @@ void Main_Tests(void) {
 
 #elif defined TEST_APP
 void Main_Tests(void) {
-    AppAgentTest_RunTest();
-    exit(0);
+    exit(DEF_OK == AppAgentTest_RunTest() ? 0 : 1);
 }
 
 #elif defined TEST_DECISION
 void Main_Tests(void) {
-    DecisionEngTest_RunTest();
+    exit(DEF_OK == DecisionEngTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_SUPERVISORY
+void Main_Tests(void) {
+    exit(DEF_OK == SupervisoryTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_WCET
+void Main_Tests(void) {
+    exit(DEF_OK == WcetTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_RESUMABLE
+void Main_Tests(void) {
+    exit(DEF_OK == ResumableTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_LOOP_BENCH
+void Main_Tests(void) {
+    LoopBench_RunTest();
     exit(0);
 }
 
+#elif defined TEST_CHECKPOINT
+void Main_Tests(void) {
+    exit(DEF_OK == CheckpointTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_STORE
+void Main_Tests(void) {
+    exit(DEF_OK == SampleStoreTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_SIM
+void Main_Tests(void) {
+    exit(DEF_OK == SimTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_MONTE_CARLO
+void Main_Tests(void) {
+    exit(DEF_OK == MonteCarloTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_SWEEP
+void Main_Tests(void) {
+    exit(DEF_OK == SweepTest_RunTest() ? 0 : 1);
+}
+
+#elif defined TEST_QUALITY_BENCH
+void Main_Tests(void) {
+    exit(DEF_OK == QualityBench_RunTest() ? 0 : 1);
+}
+#elif defined TEST_MESH
+void Main_Tests(void) {
+    exit(DEF_OK == MeshTest_RunTest() ? 0 : 1);
+}
+#elif defined TEST_COORDINATOR
+void Main_Tests(void) {
+    exit(DEF_OK == CoordTest_RunTest() ? 0 : 1);
+}
+#elif defined TEST_CLUSTER
+void Main_Tests(void) {
+    exit(DEF_OK == ClusterTest_RunTest() ? 0 : 1);
+}
+#elif defined TEST_LINK
+void Main_Tests(void) {
+    exit(DEF_OK == LinkTest_RunTest() ? 0 : 1);
+}
+
 #else
 void Main_Tests(void) {
     printf("Nothing to test\n");
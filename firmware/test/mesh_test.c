@@ -0,0 +1,252 @@
+/**
+ * \file    mesh_test.c
+ *
+ * \brief   Main file for the mesh network test.
+ *          This is not a Unit test, but a functional test where a random mesh of battery
+ *          powered nodes reports to a sink in the center, first for an hour with full
+ *          batteries and then with small batteries until the busiest relays are depleted.
+ *          The busiest relay is then simulated as a full node, with its forwarding load fed
+ *          to the radio agent, and compared with a node that only sends its own frames.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: MeshTest_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../include/radio_agent.h"
+#include "../include/trigger_agent.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_node.h"
+#include "../sim/sim_mesh.h"
+
+#include "mesh_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Mesh
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#ifndef MESH_TEST_NODES
+#define MESH_TEST_NODES                     10000u  /* Set by make NODES=, nodes of the mesh    */
+#endif
+#define MESH_TEST_SEED                      1u
+#define MESH_TEST_DEPLETION                 0.5     /* Part of the busiest charge in a battery  */
+#define MESH_TEST_RELAY_RATE                0.05    /* Frames per s relayed by the full node    */
+#define MESH_TEST_FORWARDING_ERROR          0.25    /* Relative error of the learnt forwarding  */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Tells if every link of a topology has its way back, with the same loss.
+ *
+ * \param  p_topology:  Pointer to the topology.
+ *
+ * \return DEF_TRUE if the links are symmetric; otherwise DEF_FALSE.
+ *
+ */
+static bool_t MeshTest_Symmetric(const SIM_MESH_TOPOLOGY_T *p_topology)
+{
+    uint32_t node, link, back, other;
+    bool_t found;
+
+    for (node = 0; node < p_topology->Nodes; node++) {
+        for (link = p_topology->Rows[node]; link < p_topology->Rows[node + 1u]; link++) {
+            other = p_topology->Links[link];
+            found = DEF_FALSE;
+            for (back = p_topology->Rows[other]; back < p_topology->Rows[other + 1u]; back++) {
+                if ((node == p_topology->Links[back]) && (p_topology->Loss[link] == p_topology->Loss[back])) {
+                    found = DEF_TRUE;
+                }
+            }
+            if (DEF_FALSE == found) return DEF_FALSE;
+        }
+    }
+    return DEF_TRUE;
+}
+
+/**
+ * \brief  Tells if every generated frame of a result is accounted for.
+ *
+ * \param  p_result:  Pointer to the result.
+ *
+ * \return DEF_TRUE if the frames are conserved; otherwise DEF_FALSE.
+ *
+ */
+static bool_t MeshTest_Conserved(const SIM_MESH_RESULT_T *p_result)
+{
+    return (p_result->Generated == p_result->Delivered + p_result->Dropped + p_result->Overflows +
+                                   p_result->Orphaned + p_result->Lost + p_result->Waiting) ? DEF_TRUE : DEF_FALSE;
+}
+
+/**
+ * \brief  Prints the result of a mesh simulation.
+ *
+ * \param  p_result:  Pointer to the result.
+ *
+ */
+static void MeshTest_Print(const SIM_MESH_RESULT_T *p_result)
+{
+    printf("-- Reachable %u, max hops %u, generated %llu, delivered %llu, dropped %llu, overflows %llu\n",
+           p_result->Reachable, p_result->MaxHops, (unsigned long long) p_result->Generated,
+           (unsigned long long) p_result->Delivered, (unsigned long long) p_result->Dropped,
+           (unsigned long long) p_result->Overflows);
+    printf("-- Orphaned %llu, lost %llu, waiting %llu, transmissions %llu, collisions %llu, losses %llu\n",
+           (unsigned long long) p_result->Orphaned, (unsigned long long) p_result->Lost,
+           (unsigned long long) p_result->Waiting, (unsigned long long) p_result->Transmissions,
+           (unsigned long long) p_result->Collisions, (unsigned long long) p_result->Losses);
+    printf("-- Depleted %u, wall time %.3f s, throughput %.3e node slots/s\n",
+           p_result->Deaths, p_result->Wall, p_result->Throughput);
+}
+
+/**
+ * \brief  Finds the node with the most charge drawn by the radio, other than the sink.
+ *
+ * \param  p_cfg:  Pointer to the configuration of the last simulation.
+ *
+ * \return Busiest node.
+ *
+ */
+static uint32_t MeshTest_Busiest(const SIM_MESH_CFG_T *p_cfg)
+{
+    const SIM_MESH_NODE_T *p_nodes = SimMesh_GetNodes();
+    uint32_t node, busiest = (0u == p_cfg->Sink) ? 1u : 0u;
+
+    for (node = 0; node < p_cfg->Topology.Nodes; node++) {
+        if ((node != p_cfg->Sink) && (p_nodes[node].Charge > p_nodes[busiest].Charge)) busiest = node;
+    }
+    return busiest;
+}
+
+/**
+ * \brief  Finds the node relaying the most frames up to a limit.
+ *
+ * \param  p_cfg:    Pointer to the configuration of the last simulation.
+ * \param  relayed:  Maximum relayed frames.
+ *
+ * \return Relay, or SIM_MESH_NONE if no node relays frames up to the limit.
+ *
+ */
+static uint32_t MeshTest_Relay(const SIM_MESH_CFG_T *p_cfg, uint32_t relayed)
+{
+    const SIM_MESH_NODE_T *p_nodes = SimMesh_GetNodes();
+    uint32_t node, relay = SIM_MESH_NONE;
+
+    for (node = 0; node < p_cfg->Topology.Nodes; node++) {
+        if ((relayed >= p_nodes[node].Relayed) && (0u < p_nodes[node].Relayed) &&
+            ((SIM_MESH_NONE == relay) || (p_nodes[node].Relayed > p_nodes[relay].Relayed))) {
+            relay = node;
+        }
+    }
+    return relay;
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the mesh network test.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The busiest relays, next to the sink, last a few activations as full nodes, so the
+ *          full node is the busiest relay up to MESH_TEST_RELAY_RATE, whose forwarding rate
+ *          over the hour the radio agent learns in frames per activation.
+ */
+bool_t MeshTest_RunTest(void)
+{
+    SIM_MESH_CFG_T cfg;
+    SIM_MESH_RESULT_T result, depleted;
+    SIM_NODE_CFG_T node_cfg;
+    SIM_NODE_RESULT_T leaf, relay;
+    const SIM_MESH_NODE_T *p_nodes;
+    SIM_MESH_NODE_T busiest, forwarder;
+    uint32_t node;
+    float64_t seconds, rate, interval, forwarding;
+    bool_t test = DEF_OK;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Mesh Network Test     //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    SimMesh_DefaultCfg(&cfg);
+    TestUtils_Check(SimMesh_RandomTopology(MESH_TEST_NODES, SIM_MESH_DEGREE, SIM_MESH_MAX_LOSS,
+                                           MESH_TEST_SEED, &cfg.Topology),
+                    "Random topology built", &test);
+    printf("-- Nodes %u, links %u\n", cfg.Topology.Nodes, cfg.Topology.Rows[cfg.Topology.Nodes]);
+    TestUtils_Check(MeshTest_Symmetric(&cfg.Topology), "Links symmetric", &test);
+
+    /* An hour of full batteries    */
+    TestUtils_Check(SimMesh_Run(&cfg, &result), "Mesh simulated", &test);
+    MeshTest_Print(&result);
+    TestUtils_Check(MeshTest_Conserved(&result), "Frames conserved", &test);
+    TestUtils_Check((0u < result.Delivered) && (0u < result.Collisions) && (0u < result.Losses),
+                    "Frames delivered, collided and lost", &test);
+    TestUtils_Check((result.Reachable > cfg.Topology.Nodes / 2u) && (1u < result.MaxHops),
+                    "Multi-hop routes to the sink", &test);
+    TestUtils_Check(0u == result.Deaths, "No node depleted with full batteries", &test);
+
+    p_nodes = SimMesh_GetNodes();
+    node = MeshTest_Busiest(&cfg);
+    busiest = p_nodes[node];
+    printf("-- Busiest node %u: hops %u, generated %u, relayed %u, transmissions %u, charge %.0f\n",
+           node, busiest.Hops, busiest.Generated, busiest.Relayed, busiest.Transmissions, busiest.Charge);
+    TestUtils_Check((1u == busiest.Hops) && (busiest.Relayed > busiest.Generated),
+                    "Busiest node a relay next to the sink", &test);
+    seconds = (float64_t) cfg.Slots * SIM_MESH_SLOT / SA_UTILS_S_TO_MILLI_S;
+    node = MeshTest_Relay(&cfg, (uint32_t)(MESH_TEST_RELAY_RATE * seconds));
+    TestUtils_Check(SIM_MESH_NONE != node, "Relay found away from the sink", &test);
+    if (SIM_MESH_NONE != node) forwarder = p_nodes[node];
+    else memset(&forwarder, 0x00, sizeof(SIM_MESH_NODE_T));
+
+    /* Small batteries              */
+    cfg.Capacity = MESH_TEST_DEPLETION * busiest.Charge +
+                   cfg.IdleCurrent * cfg.Slots * SIM_MESH_SLOT / SA_UTILS_S_TO_MILLI_S;
+    TestUtils_Check(SimMesh_Run(&cfg, &depleted), "Mesh simulated with small batteries", &test);
+    MeshTest_Print(&depleted);
+    TestUtils_Check(MeshTest_Conserved(&depleted), "Frames conserved with depletions", &test);
+    TestUtils_Check((0u < depleted.Deaths) && (0u < p_nodes[depleted.FirstDead].Relayed),
+                    "First depleted node a relay", &test);
+    printf("-- First depletion of node %u after %.1f s, delivered %llu before and %llu after\n",
+           depleted.FirstDead, (float64_t) depleted.FirstDeath * SIM_MESH_SLOT / SA_UTILS_S_TO_MILLI_S,
+           (unsigned long long) depleted.DeliveredAtDeath,
+           (unsigned long long)(depleted.Delivered - depleted.DeliveredAtDeath));
+    TestUtils_Check(depleted.Delivered > depleted.DeliveredAtDeath, "Frames rerouted after the depletion", &test);
+
+    /* Relay as a full node         */
+    rate = forwarder.Relayed / seconds;
+    SimNode_DefaultCfg(&node_cfg);
+    TestUtils_Check(SimNode_Run(&node_cfg, &leaf), "Leaf node simulated", &test);
+    node_cfg.Forwarding = rate;
+    TestUtils_Check(SimNode_Run(&node_cfg, &relay), "Relay node simulated", &test);
+    interval = (float64_t) TriggerAgent_GetConfig() / SA_UTILS_S_TO_MILLI_S;
+    forwarding = RadioAgent_GetForwarding();
+    printf("-- Leaf: %.2f days; relay of %.3f frames/s: %.2f days, %u relayed, %.1f per activation, %.1f learnt\n",
+           (float64_t) leaf.Lifetime / SA_UTILS_DAYS_TO_MILLI_S, rate,
+           (float64_t) relay.Lifetime / SA_UTILS_DAYS_TO_MILLI_S, relay.Relayed, rate * interval, forwarding);
+    TestUtils_Check(relay.Lifetime < leaf.Lifetime, "Relay depleted before the leaf", &test);
+    TestUtils_Check(fabs(forwarding - rate * interval) < MESH_TEST_FORWARDING_ERROR * rate * interval,
+                    "Forwarding load learnt by the radio agent", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+
+    return test;
+}
+
+/** @} (end addtogroup Mesh)    */
+/** @} (end addtogroup Tests)   */
@@ -0,0 +1,35 @@
+/**
+ * \file    mesh_test.h
+ *
+ * \brief   Header file for the mesh network test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __MESH_TEST_H__
+#define __MESH_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Mesh
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t MeshTest_RunTest(void);
+
+
+/** @} (end addtogroup Mesh)    */
+/** @} (end addtogroup Tests)   */
+
+#endif  /* __MESH_TEST_H__       */
@@ -0,0 +1,139 @@
+/**
+ * \file    monte_carlo_test.c
+ *
+ * \brief   Main file for the Monte Carlo test.
+ *          This is not a Unit test, but a functional test where the lifetime distribution of a
+ *          population of nodes is simulated, once in this process and once shared between worker
+ *          processes. Both runs must give the same nodes, and the report gives the percentiles
+ *          of the lifetime, the probability of an early depletion and the throughput.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: MonteCarloTest_
+ *
+ */
+
+#include <string.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_monte_carlo.h"
+
+#include "monte_carlo_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup MonteCarlo
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#ifndef MONTE_CARLO_TEST_TRIALS
+#define MONTE_CARLO_TEST_TRIALS             256u     /* Set by make TRIALS=                      */
+#endif
+#ifndef MONTE_CARLO_TEST_WORKERS
+#define MONTE_CARLO_TEST_WORKERS            0u      /* Set by make WORKERS=, 0 for the default  */
+#endif
+#define MONTE_CARLO_TEST_PARALLEL_WORKERS   4u      /* Workers of the parallel run by default   */
+#define MONTE_CARLO_TEST_CAPACITY           5.0e5   /* Rated battery, depleted near the target  */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static SIM_MONTE_CARLO_SAMPLE_T MonteCarloTest_Serial[MONTE_CARLO_TEST_TRIALS];
+static SIM_MONTE_CARLO_SAMPLE_T MonteCarloTest_Parallel[MONTE_CARLO_TEST_TRIALS];
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Prints the distribution of the lifetime.
+ *
+ * \param  p_cfg:     Pointer to the configuration.
+ * \param  p_result:  Pointer to the distribution.
+ *
+ */
+static void MonteCarloTest_Print(const SIM_MONTE_CARLO_CFG_T *p_cfg,
+                                 const SIM_MONTE_CARLO_RESULT_T *p_result)
+{
+    uint8_t level;
+
+    printf("-- Trials %u, workers %u, wall time %.3f s, throughput %.1f nodes/s\n",
+           p_result->Trials, p_result->Workers, p_result->Wall, p_result->Throughput);
+    printf("-- Lifetime: mean %.2f days, depleted %u\n",
+           p_result->Mean / SA_UTILS_DAYS_TO_MILLI_S, p_result->Depleted);
+    for (level = 0; level < SIM_MONTE_CARLO_PERCENTILES; level++) {
+        printf("--   P%-2u %8.2f days\n", p_result->Levels[level],
+               (float64_t) p_result->Percentiles[level] / SA_UTILS_DAYS_TO_MILLI_S);
+    }
+    printf("-- Depleted before %.2f days: %u, probability %.4f [%.4f, %.4f]\n",
+           (float64_t) p_cfg->Target / SA_UTILS_DAYS_TO_MILLI_S, p_result->Early,
+           p_result->EarlyProbability, p_result->EarlyLower, p_result->EarlyUpper);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the Monte Carlo simulation.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The parallel run uses the workers set by make WORKERS=, or by default
+ *          MONTE_CARLO_TEST_PARALLEL_WORKERS, so the workers are exercised on a single core.
+ */
+bool_t MonteCarloTest_RunTest(void)
+{
+    SIM_MONTE_CARLO_CFG_T cfg;
+    SIM_MONTE_CARLO_RESULT_T serial, parallel;
+    bool_t ordered = DEF_TRUE, run, test = DEF_OK;
+    uint8_t level;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Monte Carlo Test      //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    SimMonteCarlo_DefaultCfg(&cfg);
+    cfg.Trials = MONTE_CARLO_TEST_TRIALS;
+    cfg.Node.Capacity = MONTE_CARLO_TEST_CAPACITY;
+
+    /* One process                  */
+    cfg.Workers = 1u;
+    run = SimMonteCarlo_Run(&cfg, MonteCarloTest_Serial, &serial);
+    MonteCarloTest_Print(&cfg, &serial);
+    TestUtils_Check(run, "Serial run", &test);
+
+    /* Worker processes             */
+    cfg.Workers = (0u != MONTE_CARLO_TEST_WORKERS) ? MONTE_CARLO_TEST_WORKERS :
+                  MONTE_CARLO_TEST_PARALLEL_WORKERS;
+    run = SimMonteCarlo_Run(&cfg, MonteCarloTest_Parallel, &parallel);
+    MonteCarloTest_Print(&cfg, &parallel);
+    TestUtils_Check(run, "Parallel run", &test);
+
+    TestUtils_Check(0 == memcmp(MonteCarloTest_Serial, MonteCarloTest_Parallel,
+                                sizeof(MonteCarloTest_Serial)),
+                    "Same nodes whatever the workers", &test);
+    for (level = 1; level < SIM_MONTE_CARLO_PERCENTILES; level++) {
+        if (parallel.Percentiles[level - 1u] > parallel.Percentiles[level]) ordered = DEF_FALSE;
+    }
+    TestUtils_Check(ordered && (parallel.Percentiles[0] <= cfg.Node.Horizon),
+                    "Percentiles in order", &test);
+    TestUtils_Check((parallel.EarlyLower <= parallel.EarlyProbability) &&
+                    (parallel.EarlyProbability <= parallel.EarlyUpper) &&
+                    (0.0 <= parallel.EarlyLower) && (1.0 >= parallel.EarlyUpper) &&
+                    (parallel.Early <= parallel.Depleted),
+                    "Early depletion probability bounded", &test);
+    TestUtils_Check(parallel.Percentiles[0] < parallel.Percentiles[SIM_MONTE_CARLO_PERCENTILES - 1u],
+                    "Lifetime spread between the nodes", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+
+    return test;
+}
+
+/** @} (end addtogroup MonteCarlo)   */
+/** @} (end addtogroup Tests)        */
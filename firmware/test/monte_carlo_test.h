@@ -0,0 +1,35 @@
+/**
+ * \file    monte_carlo_test.h
+ *
+ * \brief   Header file for the Monte Carlo distribution of the battery lifetime.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __MONTE_CARLO_TEST_H__
+#define __MONTE_CARLO_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup MonteCarlo
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t MonteCarloTest_RunTest(void);
+
+
+/** @} (end addtogroup MonteCarlo)   */
+/** @} (end addtogroup Tests)        */
+
+#endif  /* __MONTE_CARLO_TEST_H__       */
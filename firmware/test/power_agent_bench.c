@@ -0,0 +1,226 @@
+/**
+ * \file    power_agent_bench.c
+ *
+ * \brief   This file contains the cycle benchmark for the power agent.
+ *          The power agent observation task (learn, reflect and reason, which includes the
+ *          SOC estimator) is run for a large number of activations with varying charge,
+ *          voltage, temperature and period, and the cycles of every activation are
+ *          compared with POWER_AGENT_SOC_CYCLE_BUDGET. The activations are repeated in a few
+ *          runs from the same seed, and the fastest run is the one checked.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: PowerAgentBench_
+ *
+ */
+
+#include <string.h>
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../platform/sa_timing.h"
+
+#include "power_agent_bench.h"
+#include "../configs/battery_cfg.h"
+#include "../include/power_agent.h"
+
+/** \addtogroup Agents
+ *   @{
+ */
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup PowerAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define POWER_AGENT_BENCH_ITERATIONS        200000u
+#define POWER_AGENT_BENCH_RUNS                   3u     /* Runs of the same activations             */
+#define POWER_AGENT_BENCH_SEED                   1u
+#define POWER_AGENT_BENCH_WARMUP              1000u
+#define POWER_AGENT_BENCH_HIST_BINS            256u     /* Histogram of the cycles per activation   */
+#define POWER_AGENT_BENCH_HIST_STEP             16u     /* Cycles per histogram bin                 */
+#define POWER_AGENT_BENCH_PERCENTILE          0.999f    /* Percentile checked against the budget    */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Cycles per activation of a run.
+ *
+ */
+typedef struct {
+    uint32_t Percentile;                /* POWER_AGENT_BENCH_PERCENTILE, end of its bin     */
+    uint32_t Max;
+    float64_t Average;
+} POWER_AGENT_BENCH_RUN_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static uint32_t PowerAgentBench_Seed = POWER_AGENT_BENCH_SEED;
+static POWER_AGENT_OBS_T PowerAgentBench_Observation;
+static uint32_t PowerAgentBench_Histogram[POWER_AGENT_BENCH_HIST_BINS];
+
+/************************************** Function implementation **********************************/
+
+/**
+ * \brief  Pseudo random number generator, so the benchmark is repeatable.
+ *
+ * \return Random number in [0, 1).
+ *
+ */
+static float32_t PowerAgentBench_Random(void)
+{
+    PowerAgentBench_Seed = PowerAgentBench_Seed * 1664525u + 1013904223u;
+    return (PowerAgentBench_Seed >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * \brief  Generates the next observation, outside of the measured code.
+ *
+ */
+static void PowerAgentBench_GenerateObservation(void)
+{
+    POWER_AGENT_BATTERY_OBS_T *p_battery = &PowerAgentBench_Observation.Battery;
+
+    p_battery->Charge += 1.0f + 200.0f * PowerAgentBench_Random();
+    p_battery->Harvested += 50.0f * PowerAgentBench_Random();
+    p_battery->Temperature = -30.0f + 90.0f * PowerAgentBench_Random();
+    p_battery->BatteryVoltage = PowerAgent_GetOcv(PowerAgentBench_Random(), p_battery->Temperature);
+}
+
+/**
+ * \brief  Fakes the sensors used by the power agent.
+ *
+ * \param  p_obs:  Pointer to the observations data.
+ *
+ */
+static void PowerAgentBench_FakeObservations(POWER_AGENT_OBS_T *p_obs)
+{
+    *p_obs = PowerAgentBench_Observation;
+}
+
+/**
+ * \brief  Fakes the actuators used by the power agent.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void PowerAgentBench_FakeActuations(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Restarts the battery when it is depleted, so the benchmark keeps running.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void PowerAgentBench_FakeAlarm(POWER_AGENT_ERROR_T error)
+{
+    if (POWER_AGENT_BATTERY_DEPLETED == error) {
+        PowerAgent_SetBatteryCharge(POWER_AGENT_MAX_BATTERY_MA * POWER_AGENT_EFFECTIVE_CHARGE);
+    }
+}
+
+/**
+ * \brief  Runs the activations of the benchmark from the seed.
+ *
+ * \param  p_run:  Pointer to where the cycles of the run will be saved.
+ *
+ */
+static void PowerAgentBench_Run(POWER_AGENT_BENCH_RUN_T *p_run)
+{
+    POWER_AGENT_INTERFACE_T data;
+    uint32_t iteration, start, cycles, bin;
+    uint64_t total_cycles = 0;
+    uint32_t count = 0;
+
+    PowerAgentBench_Seed = POWER_AGENT_BENCH_SEED;
+    memset(&PowerAgentBench_Observation, 0x00, sizeof(PowerAgentBench_Observation));
+    memset(PowerAgentBench_Histogram, 0x00, sizeof(PowerAgentBench_Histogram));
+    PowerAgent_Init(PowerAgentBench_FakeObservations, PowerAgentBench_FakeActuations,
+                    PowerAgentBench_FakeAlarm);
+
+    data.Inputs.PredictedChargeDelta = 100.0f;
+    data.Inputs.PredictedIncrement = 0.0f;
+    data.Inputs.ExpectedLifetime = 100u;
+    data.Inputs.EnergyNeutral = DEF_FALSE;
+    p_run->Max = 0;
+
+    for (iteration = 0; iteration < POWER_AGENT_BENCH_ITERATIONS + POWER_AGENT_BENCH_WARMUP; iteration++) {
+        data.Inputs.Period = SA_UTILS_S_TO_MILLI_S + (uint32_t)(SA_UTILS_HOURS_TO_MILLI_S * PowerAgentBench_Random());
+        PowerAgentBench_GenerateObservation();
+
+        start = SaTiming_GetCycles();
+        PowerAgent_Observe(&data);
+        cycles = SA_TIMING_ELAPSED(start);
+        PowerAgent_Act(&data);
+
+        if (POWER_AGENT_BENCH_WARMUP <= iteration) {
+            bin = SA_UTILS_MIN(cycles / POWER_AGENT_BENCH_HIST_STEP, POWER_AGENT_BENCH_HIST_BINS - 1);
+            PowerAgentBench_Histogram[bin]++;
+            p_run->Max = SA_UTILS_MAX(p_run->Max, cycles);
+            total_cycles += cycles;
+        }
+    }
+
+    /* Percentile from the histogram, rounded up to the end of the bin  */
+    for (bin = 0; bin < POWER_AGENT_BENCH_HIST_BINS; bin++) {
+        count += PowerAgentBench_Histogram[bin];
+        if (count >= POWER_AGENT_BENCH_PERCENTILE * POWER_AGENT_BENCH_ITERATIONS) break;
+    }
+    p_run->Percentile = (bin + 1) * POWER_AGENT_BENCH_HIST_STEP;
+    if (POWER_AGENT_BENCH_HIST_BINS - 1 <= bin) p_run->Percentile = p_run->Max;
+    p_run->Average = (float64_t) total_cycles / POWER_AGENT_BENCH_ITERATIONS;
+}
+
+/**
+ * \brief  Runs the cycle benchmark for the power agent.
+ *
+ * \return DEF_OK if the budget is met; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The budget is checked against a high percentile and not the maximum, since on a
+ *          host the maximum is dominated by interrupts and preemption of the OS. The maximum
+ *          is still reported.
+ *       2. The preemption of the OS only adds cycles, so the run with the lowest percentile
+ *          is checked.
+ */
+bool_t PowerAgentBench_RunTest(void)
+{
+    POWER_AGENT_BENCH_RUN_T run, best;
+    uint32_t index;
+    bool_t result;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Power Agent Benchmark  /////\n");
+    printf("//////////////////////////////////\n\n");
+
+    SaTiming_Init();
+    for (index = 0; index < POWER_AGENT_BENCH_RUNS; index++) {
+        PowerAgentBench_Run(&run);
+        printf("-- Run %u: p%.1f <= %u cycles\n", index, 100.0f * POWER_AGENT_BENCH_PERCENTILE,
+               run.Percentile);
+        if ((0u == index) || (best.Percentile > run.Percentile)) best = run;
+    }
+
+    result = (best.Percentile <= POWER_AGENT_SOC_CYCLE_BUDGET) ? DEF_OK : DEF_FAIL;
+
+    printf("-- Activations: %u, fastest of %u runs\n", POWER_AGENT_BENCH_ITERATIONS,
+           POWER_AGENT_BENCH_RUNS);
+    printf("-- Cycles per activation: avg %.1f, p%.1f <= %u, max %u\n", best.Average,
+           100.0f * POWER_AGENT_BENCH_PERCENTILE, best.Percentile, best.Max);
+    printf("-- Budget: %u cycles -> %s\n", POWER_AGENT_SOC_CYCLE_BUDGET,
+           (DEF_OK == result) ? "MET" : "EXCEEDED");
+
+    return result;
+}
+
+
+/** @} (end addtogroup PowerAgent)  */
+/** @} (end addtogroup Tests)       */
+/** @} (end addtogroup Agents)      */
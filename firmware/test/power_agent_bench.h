@@ -0,0 +1,40 @@
+/**
+ * \file    power_agent_bench.h
+ *
+ * \brief   Header file for the power agent benchmark.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __POWER_AGENT_BENCH_H__
+#define __POWER_AGENT_BENCH_H__
+
+#include "../platform/sa_types.h"
+#include "../include/power_agent.h"
+
+/** \addtogroup Agents
+ *   @{
+ */
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup PowerAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t PowerAgentBench_RunTest(void);
+
+
+/** @} (end addtogroup PowerAgent)  */
+/** @} (end addtogroup Tests)       */
+/** @} (end addtogroup Agents)      */
+
+#endif  /* __POWER_AGENT_BENCH_H__       */
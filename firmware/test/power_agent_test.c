@@ -17,9 +17,10 @@
  */
 
 #include "../platform/sa_types.h"
-#include "../Platform/sa_utils.h"
+#include "../platform/sa_utils.h"
 
 #include "power_agent_test.h"
+#include "../configs/battery_cfg.h"
 #include "../include/power_agent.h"
 
 /** \addtogroup Agents
@@ -38,6 +39,15 @@
 #define POWER_AGENT_TEST_NOISE_NUM                3
 
 #define POWER_AGENT_TEST_EXPECTED_LIFE          100
+#define POWER_AGENT_TEST_PERIOD                 (30 * SA_UTILS_MINS_TO_MILLI_S)
+#define POWER_AGENT_TEST_TEMPERATURE            10.0f
+#define POWER_AGENT_TEST_VOLTAGE_NOISE          0.1f    /* Voltage noise per unit of charge noise   */
+#define POWER_AGENT_TEST_HARVEST                30.0f   /* Harvested charge per activation with sun */
+#define POWER_AGENT_TEST_SUNRISE                (6  * SA_UTILS_HOURS_TO_MILLI_S)
+#define POWER_AGENT_TEST_SUNSET                 (18 * SA_UTILS_HOURS_TO_MILLI_S)
+#define POWER_AGENT_TEST_CAPACITY               (POWER_AGENT_MAX_BATTERY_MA * POWER_AGENT_EFFECTIVE_CHARGE * \
+                                                 (1.0f + POWER_AGENT_TEMP_CAPACITY_COEF * \
+                                                  (POWER_AGENT_TEST_TEMPERATURE - POWER_AGENT_TEMP_REF)))
 
 /************************************** Typedef **************************************************/
 
@@ -58,6 +68,10 @@ float32_t PowerAgentTest_ChargeNoise[POWER_AGENT_TEST_NOISE_NUM] = {0.05, -0.02,
 static uint8_t PowerAgentTest_IncrementCounter = 0;
 static uint8_t PowerAgentTest_NoiseCounter = 0;
 static bool_t PowerAgentTest_First = DEF_FALSE;
+static float32_t PowerAgentTest_BatteryVoltage = 0;
+static float32_t PowerAgentTest_TrueCharge = POWER_AGENT_TEST_CAPACITY;
+static float32_t PowerAgentTest_Harvested = 0;
+static uint32_t PowerAgentTest_TimeOfDay = 0;
 
 /* Battery life */
 static uint32_t PowerAgentTest_Remaininglife = POWER_AGENT_TEST_EXPECTED_LIFE;
@@ -83,8 +97,24 @@ static void PowerAgentTest_SimulateBattery(void) {
     PowerAgentTest_MeasuredCharge += temp;
     PowerAgentTest_MeasuredIncrement = temp - PowerAgentTest_MeasuredChargeDelta;
     PowerAgentTest_MeasuredChargeDelta = temp;
+
     PowerAgentTest_IncrementCounter %= POWER_AGENT_TEST_INCREMENTS;
     PowerAgentTest_NoiseCounter %= POWER_AGENT_TEST_NOISE_NUM;
+
+    /* Solar harvest during the day                */
+    PowerAgentTest_TimeOfDay = (PowerAgentTest_TimeOfDay + POWER_AGENT_TEST_PERIOD) % SA_UTILS_DAYS_TO_MILLI_S;
+    if ((POWER_AGENT_TEST_SUNRISE <= PowerAgentTest_TimeOfDay) &&
+        (POWER_AGENT_TEST_SUNSET > PowerAgentTest_TimeOfDay)) {
+        PowerAgentTest_Harvested += POWER_AGENT_TEST_HARVEST;
+        PowerAgentTest_TrueCharge += POWER_AGENT_CHARGE_EFFICIENCY * POWER_AGENT_TEST_HARVEST;
+    }
+
+    /* Cell voltage at rest, from the true charge  */
+    PowerAgentTest_TrueCharge -= PowerAgentTest_PredictedCharge;
+    PowerAgentTest_BatteryVoltage = PowerAgent_GetOcv(PowerAgentTest_TrueCharge / POWER_AGENT_TEST_CAPACITY,
+                                                      POWER_AGENT_TEST_TEMPERATURE);
+    PowerAgentTest_BatteryVoltage += POWER_AGENT_TEST_VOLTAGE_NOISE * \
+        PowerAgentTest_ChargeNoise[PowerAgentTest_NoiseCounter];
 }
 
 /**
@@ -98,6 +128,8 @@ static void PowerAgentTest_Predict(POWER_AGENT_INTERFACE_T *p_data) {
     PowerAgentTest_Remaininglife = SA_UTILS_MAX(0, PowerAgentTest_Remaininglife);
     p_data->Inputs.PredictedChargeDelta = PowerAgentTest_PredictedCharge;
     p_data->Inputs.PredictedIncrement = PowerAgentTest_PredictedIncrement;
+    p_data->Inputs.Period = POWER_AGENT_TEST_PERIOD;
+    p_data->Inputs.EnergyNeutral = DEF_FALSE;
 }
 
 /**
@@ -107,7 +139,11 @@ static void PowerAgentTest_Predict(POWER_AGENT_INTERFACE_T *p_data) {
 static void PowerAgentTest_PrintBattery(void) {
     float32_t remaining_charge = PowerAgent_GetRemainingBatteryLife();
     float32_t perc = PowerAgent_GetRemainingChargePerc();
+    float32_t covariance;
+    float32_t soc = PowerAgent_GetSoc(&covariance);
     printf("-- Battery charge: %f, %f%%\n", remaining_charge, perc);
+    printf("-- SOC, covariance: %f, %f\n", soc, covariance);
+    printf("-- Expected daily harvest: %f\n", PowerAgent_GetDailyHarvest());
 }
 
 /**
@@ -126,7 +162,11 @@ static void PowerAgentTest_Results(POWER_AGENT_INTERFACE_T *p_data) {
     printf("-- Increment, prediction: %f, %f\n",
            PowerAgentTest_MeasuredIncrement,
            p_data->Inputs.PredictedIncrement);
+    POWER_AGENT_FORECAST_T forecast;
+    PowerAgent_GetLifeForecast(&forecast);
     printf("-- Power Index: %d\n", p_data->Outputs.PowerIndex);
+    printf("-- Life forecast [lower, mean, upper]: %u, %u, %u\n",
+           forecast.Lower, forecast.Mean, forecast.Upper);
     PowerAgentTest_PrintBattery();
 }
 
@@ -138,7 +178,13 @@ static void PowerAgentTest_Results(POWER_AGENT_INTERFACE_T *p_data) {
  */
 static void PowerAgentTest_FakeObservations(POWER_AGENT_OBS_T *p_obs) {
     p_obs->Battery.Charge = PowerAgentTest_MeasuredCharge;
-    printf("-- Coulomb counter charge: %f\n", PowerAgentTest_MeasuredCharge);
+    p_obs->Battery.BatteryVoltage = PowerAgentTest_BatteryVoltage;
+    p_obs->Battery.Temperature = POWER_AGENT_TEST_TEMPERATURE;
+    p_obs->Battery.Harvested = PowerAgentTest_Harvested;
+    printf("-- Coulomb counter charge, harvested: %f, %f\n", PowerAgentTest_MeasuredCharge,
+           PowerAgentTest_Harvested);
+    printf("-- Battery voltage, temperature: %f, %f\n", PowerAgentTest_BatteryVoltage,
+           POWER_AGENT_TEST_TEMPERATURE);
 }
 
 /**
@@ -153,12 +199,18 @@ static void PowerAgentTest_FakeActuations(POWER_AGENT_ACTS_T *p_acts) {
 }
 
 /**
- * \brief  Fakes the battery depletion function. Stops the simulation.
+ * \brief  Fakes the power alarm function. Stops the simulation when the battery is depleted.
+ *
+ * \param  error:  Error code.
  *
  */
-static void PowerAgentTest_FakeBatteryDepletion(void) {
-    PowerAgentTest_SimulationRunning = DEF_FALSE;
-    printf("--- Battery depleated! ---\n");
+static void PowerAgentTest_FakeAlarm(POWER_AGENT_ERROR_T error) {
+    if (POWER_AGENT_BATTERY_DEPLETED == error) {
+        PowerAgentTest_SimulationRunning = DEF_FALSE;
+        printf("--- Battery depleated! ---\n");
+    } else {
+        printf("--- Battery low! ---\n");
+    }
 }
 
 /**
@@ -171,7 +223,7 @@ void PowerAgentTest_RunTest()  {
     printf("//////////////////////////////////\n\n");
 
     PowerAgent_Init(PowerAgentTest_FakeObservations, PowerAgentTest_FakeActuations, \
-                    PowerAgentTest_FakeBatteryDepletion);
+                    PowerAgentTest_FakeAlarm);
 
     PowerAgentTest_SimulationRunning = DEF_TRUE;
     uint32_t iterations = 0;
@@ -0,0 +1,251 @@
+/**
+ * \file    quality_bench.c
+ *
+ * \brief   Benchmark of the information delivered by the node against the energy it consumes.
+ *          A reference signal, a daily cycle with weekly events, is traced through the
+ *          simulated node once per sampling policy of the decision engine. The sink rebuilds
+ *          the signal from the transmitted samples, and the report gives the error of the
+ *          rebuilt signal (mean, RMS and maximum), the missed events and the consumed charge.
+ *          The information of a policy, in bits, is 1/2 log2(1 + (RMSE0 / RMSE)^2), where
+ *          RMSE0 is the error of a baseline sink that holds one sample per day. Its KPI is
+ *          the charge per day spent for each bit, so the policy with the lowest KPI pays best.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: QualityBench_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/trigger_cfg.h"
+#include "../include/decision_engine.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_node.h"
+
+#include "quality_bench.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Quality
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+/* Reference signal */
+#define QUALITY_BENCH_DAYS                  100u    /* The expected battery life                */
+#define QUALITY_BENCH_MEAN                  20.0
+#define QUALITY_BENCH_AMPLITUDE             2.0     /* Daily cycle                              */
+#define QUALITY_BENCH_EVENT                 30.0    /* Step of an event, over the maximum rate  */
+#define QUALITY_BENCH_EVENT_DAYS            7u      /* Days between the events                  */
+#define QUALITY_BENCH_EVENT_START           36u     /* Hour of the week of the events           */
+#define QUALITY_BENCH_EVENT_OFFSET          150u    /* s, off the grid of the activations       */
+#define QUALITY_BENCH_EVENT_HOURS           6u      /* Length of an event                       */
+#define QUALITY_BENCH_EVENTS                15u     /* Weeks started before the last event      */
+#define QUALITY_BENCH_EVENT_LEVEL           (QUALITY_BENCH_MEAN + QUALITY_BENCH_AMPLITUDE + \
+                                             QUALITY_BENCH_EVENT / 2.0)
+
+/* Baseline, a sink holding one sample per day */
+#define QUALITY_BENCH_BASELINE_PERIOD       SA_UTILS_DAYS_TO_MILLI_S
+#define QUALITY_BENCH_BASELINE_STEP         SA_UTILS_MINS_TO_MILLI_S    /* Integration step     */
+
+#define QUALITY_BENCH_POLICIES              3u
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Result of a policy.
+ *
+ */
+typedef struct {
+    DECISION_ENGINE_POLICY_T Policy;
+    const char *Name;
+    SIM_NODE_RESULT_T Node;
+    float64_t Charge;                   /* Consumed charge per day                          */
+    float64_t Baseline;                 /* RMSE of the baseline over the same life          */
+    float64_t Information;              /* Bits over the baseline                           */
+    float64_t Kpi;                      /* Charge per day per bit                           */
+} QUALITY_BENCH_RESULT_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static QUALITY_BENCH_RESULT_T QualityBench_Results[QUALITY_BENCH_POLICIES] = {
+    { .Policy = DECISION_ENGINE_POLICY_RELEVANCE, .Name = "Relevance" },
+    { .Policy = DECISION_ENGINE_POLICY_BUDGET,    .Name = "Budget" },
+    { .Policy = DECISION_ENGINE_POLICY_FIXED,     .Name = "Fixed" },
+};
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Reference signal.
+ *
+ * \param  time:  Time in ms.
+ *
+ * \return The sensor data at the time.
+ *
+ * \note List of notes:
+ *       1. The events start off the grid of the activations, so that no policy samples their
+ *          edges by construction.
+ */
+static float32_t QualityBench_Trace(SIM_TIME_T time)
+{
+    const SIM_TIME_T start = (SIM_TIME_T) QUALITY_BENCH_EVENT_START * SA_UTILS_HOURS_TO_MILLI_S +
+                             (SIM_TIME_T) QUALITY_BENCH_EVENT_OFFSET * SA_UTILS_S_TO_MILLI_S;
+    float64_t cycle;
+
+    cycle = QUALITY_BENCH_MEAN + QUALITY_BENCH_AMPLITUDE *
+            sin(2.0 * M_PI * (float64_t)(time % SA_UTILS_DAYS_TO_MILLI_S) / SA_UTILS_DAYS_TO_MILLI_S);
+    if ((SIM_TIME_T) QUALITY_BENCH_EVENT_HOURS * SA_UTILS_HOURS_TO_MILLI_S >
+        time % ((SIM_TIME_T) QUALITY_BENCH_EVENT_DAYS * SA_UTILS_DAYS_TO_MILLI_S) - start) {
+        cycle += QUALITY_BENCH_EVENT;
+    }
+
+    return (float32_t) SA_UTILS_ROUND(cycle);                                   /* Sensor resolution */
+}
+
+/**
+ * \brief  Computes the RMSE of the baseline, a sink holding the data sampled once per day.
+ *
+ * \param  lifetime:  Time over which the error is accounted, ms.
+ *
+ * \return The RMSE of the baseline.
+ *
+ */
+static float64_t QualityBench_Baseline(SIM_TIME_T lifetime)
+{
+    SIM_TIME_T time;
+    float64_t error, squared = 0.0;
+    float32_t held = 0.0f;
+
+    for (time = 0; time < lifetime; time += QUALITY_BENCH_BASELINE_STEP) {
+        if (0u == time % QUALITY_BENCH_BASELINE_PERIOD) held = QualityBench_Trace(time);
+        error = QualityBench_Trace(time + QUALITY_BENCH_BASELINE_STEP / 2u) - held;
+        squared += error * error;
+    }
+
+    return sqrt(squared * QUALITY_BENCH_BASELINE_STEP / lifetime);
+}
+
+/**
+ * \brief  Replays the reference signal through a node with the policy of a result.
+ *
+ * \param  p_result:  Pointer to the result, with the policy set.
+ *
+ * \return DEF_OK if the node could be simulated; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The information is half a bit when the sink rebuilds the signal as well as the
+ *          baseline, it only tends to 0 when it rebuilds it much worse, and it is only
+ *          infinite when it rebuilds it without error.
+ *       2. The node is not fast-forwarded, as the data held by the trace would be taken as
+ *          steady until the next input, and there are none.
+ */
+static bool_t QualityBench_Replay(QUALITY_BENCH_RESULT_T *p_result)
+{
+    SIM_NODE_CFG_T cfg;
+    SIM_NODE_RESULT_T *p_node = &p_result->Node;
+    float64_t ratio;
+
+    SimNode_DefaultCfg(&cfg);
+    cfg.Horizon = (SIM_TIME_T) QUALITY_BENCH_DAYS * SA_UTILS_DAYS_TO_MILLI_S;
+    cfg.Trace = QualityBench_Trace;
+    cfg.FastForward = DEF_FALSE;                /* The trace changes between the inputs */
+    cfg.Policy = p_result->Policy;
+    cfg.EventLevel = (float32_t) QUALITY_BENCH_EVENT_LEVEL;
+    if ((DEF_FAIL == SimNode_Run(&cfg, p_node)) || (0u == p_node->Lifetime)) return DEF_FAIL;
+
+    p_result->Charge = (p_node->ActiveCharge + p_node->IdleCharge) * SA_UTILS_DAYS_TO_MILLI_S /
+                       p_node->Lifetime;
+    p_result->Baseline = QualityBench_Baseline(p_node->Lifetime);
+    ratio = p_result->Baseline / p_node->Rmse;
+    p_result->Information = 0.5 * log2(1.0 + ratio * ratio);
+    p_result->Kpi = p_result->Charge / p_result->Information;
+
+    return DEF_OK;
+}
+
+/**
+ * \brief  Prints the result of a policy.
+ *
+ * \param  p_result:  Pointer to the result.
+ *
+ */
+static void QualityBench_Print(const QUALITY_BENCH_RESULT_T *p_result)
+{
+    const SIM_NODE_RESULT_T *p_node = &p_result->Node;
+
+    printf("--   %-10s %7.2f %8u %8u %7.4f %7.4f %7.3f %3u/%-3u %10.1f %7.3f %10.1f\n",
+           p_result->Name, (float64_t) p_node->Lifetime / SA_UTILS_DAYS_TO_MILLI_S,
+           p_node->Activations, p_node->Transmissions, p_node->Error, p_node->Rmse,
+           p_node->MaxError, p_node->MissedEvents, p_node->DataEvents, p_result->Charge,
+           p_result->Information, p_result->Kpi);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the information-vs-energy benchmark of the sampling policies.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The checks only cover the measurement, the report tells which policy pays best.
+ */
+bool_t QualityBench_RunTest(void)
+{
+    QUALITY_BENCH_RESULT_T *p_result, *p_best = NULL;
+    const SIM_NODE_RESULT_T *p_fixed = &QualityBench_Results[QUALITY_BENCH_POLICIES - 1u].Node;
+    bool_t run = DEF_TRUE, ordered = DEF_TRUE, events = DEF_TRUE, finite = DEF_TRUE, test = DEF_OK;
+    SIM_TIME_T period;
+    uint8_t policy;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Quality Benchmark     //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    printf("-- Reference: %u days, %u events at or above %.1f, baseline of one sample per day\n",
+           QUALITY_BENCH_DAYS, QUALITY_BENCH_EVENTS, QUALITY_BENCH_EVENT_LEVEL);
+    printf("--   %-10s %7s %8s %8s %7s %7s %7s %7s %10s %7s %10s\n", "Policy", "Days", "Samples",
+           "Sent", "MAE", "RMSE", "Max", "Missed", "Charge/day", "Bits", "Charge/bit");
+
+    for (policy = 0; policy < QUALITY_BENCH_POLICIES; policy++) {
+        p_result = &QualityBench_Results[policy];
+        if (DEF_FAIL == QualityBench_Replay(p_result)) {
+            run = DEF_FALSE;
+            continue;
+        }
+        QualityBench_Print(p_result);
+
+        if ((p_result->Node.Error > p_result->Node.Rmse) || (p_result->Node.Rmse > p_result->Node.MaxError)) {
+            ordered = DEF_FALSE;
+        }
+        if ((QUALITY_BENCH_EVENTS != p_result->Node.DataEvents) ||
+            (p_result->Node.MissedEvents > p_result->Node.DataEvents)) {
+            events = DEF_FALSE;
+        }
+        if ((0 == isfinite(p_result->Information)) || (0.0 >= p_result->Information)) finite = DEF_FALSE;
+        if ((NULL == p_best) || (p_best->Kpi > p_result->Kpi)) p_best = p_result;
+    }
+    if (NULL != p_best) printf("-- Best policy: %s\n", p_best->Name);
+
+    TestUtils_Check(run, "Reference replayed with every policy", &test);
+    TestUtils_Check(ordered, "Mean, RMS and maximum error in order", &test);
+    TestUtils_Check(events, "Events of the reference counted", &test);
+    TestUtils_Check(finite, "Finite information and KPI of every policy", &test);
+    period = TriggerCfg_Periods_Ptr[TRIGGER_CFG_DEFAULT_SAMPLING];
+    TestUtils_Check(p_fixed->Activations == (p_fixed->Lifetime + period - 1u) / period,
+                    "Fixed policy at the default periodicity", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+
+    return test;
+}
+
+/** @} (end addtogroup Quality) */
+/** @} (end addtogroup Tests)   */
@@ -0,0 +1,35 @@
+/**
+ * \file    quality_bench.h
+ *
+ * \brief   Header file for the information-vs-energy benchmark.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __QUALITY_BENCH_H__
+#define __QUALITY_BENCH_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Quality
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t QualityBench_RunTest(void);
+
+
+/** @} (end addtogroup Quality) */
+/** @} (end addtogroup Tests)   */
+
+#endif  /* __QUALITY_BENCH_H__       */
@@ -108,6 +108,7 @@ static void RadioAgentTest_GenerateInputs(RADIO_AGENT_INTERFACE_T *p_int) {
             break;
     }
     p_int->Inputs.Data = data;
+    p_int->Inputs.Batch = 1u;
     printf("-- ::Radio Agent:: Data input: %f\n", data);
 }
 
@@ -133,7 +134,8 @@ void RadioAgentTest_RunTest() {
     printf("////    Radio Agent Test    //////\n");
     printf("//////////////////////////////////\n\n");
 
-    RadioAgent_Init(RadioAgentTest_FakeObservations, RadioAgentTest_FakeActuations);
+    RadioAgent_Init(RadioAgentTest_FakeObservations, RadioAgentTest_FakeActuations, NULL,
+                    DEF_FALSE);
 
     RadioAgentTest_Iterations = 0;
     RADIO_AGENT_INTERFACE_T data;
@@ -0,0 +1,240 @@
+/**
+ * \file    resumable_test.c
+ *
+ * \brief   Main file for the resumable loop test.
+ *          This is not a Unit test, but a functional test where a cooperative scheduler runs
+ *          the resumable self-aware loop. The sensor needs a warm-up and the radio completes
+ *          the transmission asynchronously, so the loop yields on both and the scheduler
+ *          "sleeps" until the loop is resumed.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: ResumableTest_
+ *
+ */
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_pt.h"
+
+#include "../configs/battery_cfg.h"
+#include "../include/power_agent.h"
+#include "../include/radio_agent.h"
+#include "../include/decision_engine.h"
+
+#include "resumable_test.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define RESUMABLE_TEST_ITERATIONS           10u
+#define RESUMABLE_TEST_WARMUP_POLLS          3u     /* Polls until the sensor is ready          */
+#define RESUMABLE_TEST_TX_POLLS              2u     /* Polls until the transmission completes   */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static uint32_t ResumableTest_Iterations;
+static float32_t ResumableTest_ChargeAccum = 0;
+
+static uint8_t ResumableTest_Warmup = RESUMABLE_TEST_WARMUP_POLLS;
+static uint8_t ResumableTest_TxPending = 0;
+static float32_t ResumableTest_Transmitted = 0;
+
+/************************************** Function implementation **********************************/
+/************* Power Agent ******************/
+/**
+ * \brief  Fakes a measurement from the coulomb counter.
+ *
+ * \param  p_obs:  Pointer to the observation data of the power agent.
+ *
+ */
+static void ResumableTest_PowerObs(POWER_AGENT_OBS_T *p_obs)
+{
+    ResumableTest_ChargeAccum += 10.0f;
+    p_obs->Battery.Charge = ResumableTest_ChargeAccum;
+    p_obs->Battery.BatteryVoltage = 0;      /* No voltage measurement   */
+    p_obs->Battery.Temperature = POWER_AGENT_TEMP_REF;
+    p_obs->Battery.Harvested = 0;           /* No harvester             */
+}
+
+/**
+ * \brief  Fakes the actuation of the power agent.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void ResumableTest_PowerActs(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Radio Agent ******************/
+/**
+ * \brief  Fakes the radio observation.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void ResumableTest_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = DEF_FALSE;
+}
+
+/**
+ * \brief  Fakes the start of a radio transmission, which completes asynchronously.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void ResumableTest_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    ResumableTest_TxPending = RESUMABLE_TEST_TX_POLLS;
+    ResumableTest_Transmitted = p_acts->Data;
+    printf("-- ::Radio  :: Transmission started: %f\n", p_acts->Data);
+}
+
+/**
+ * \brief  Fakes the transmission complete event.
+ *
+ * \return DEF_TRUE if the transmission has completed; otherwise DEF_FALSE.
+ *
+ */
+static bool_t ResumableTest_RadioDone(void)
+{
+    if (0u == ResumableTest_TxPending) return DEF_TRUE;
+    ResumableTest_TxPending--;
+    return DEF_FALSE;
+}
+
+/************* Application Agent ************/
+/**
+ * \brief  Fakes a measurement from the sensor.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data.
+ *
+ */
+static void ResumableTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    p_obs->SensorData = 10.0f + ResumableTest_Iterations;
+}
+
+/**
+ * \brief  Fakes the configuration of the sensor, which is powered down until the next warm-up.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void ResumableTest_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+    ResumableTest_Warmup = RESUMABLE_TEST_WARMUP_POLLS;
+}
+
+/**
+ * \brief  Fakes the sensor ready event, after the warm-up.
+ *
+ * \return DEF_TRUE if the sensor is ready; otherwise DEF_FALSE.
+ *
+ */
+static bool_t ResumableTest_SensorReady(void)
+{
+    if (0u == ResumableTest_Warmup) return DEF_TRUE;
+    ResumableTest_Warmup--;
+    return DEF_FALSE;
+}
+
+/**
+ * \brief  Fakes the trigger observation.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void ResumableTest_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Fakes the trigger actuation.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void ResumableTest_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the resumable loop.
+ *
+ * \return DEF_OK if the loop yields on every wait and the data is transmitted; otherwise
+ *         DEF_FAIL.
+ *
+ */
+bool_t ResumableTest_RunTest(void)
+{
+    DECISION_ENGINE_INIT_T init = {
+        .PowerInit.Obs = ResumableTest_PowerObs,
+        .PowerInit.Act = ResumableTest_PowerActs,
+        .PowerInit.Alarm = NULL,
+        .RadioInit.Obs = ResumableTest_RadioObs,
+        .RadioInit.Act = ResumableTest_RadioActs,
+        .RadioInit.Done = ResumableTest_RadioDone,
+        .AppInit.Sensor.Obs = ResumableTest_SensorObs,
+        .AppInit.Sensor.Act = ResumableTest_SensorActs,
+        .AppInit.Sensor.Alarm = NULL,
+        .AppInit.Sensor.Start = NULL,
+        .AppInit.Sensor.Ready = ResumableTest_SensorReady,
+        .AppInit.Trigger.Obs = ResumableTest_TriggerObs,
+        .AppInit.Trigger.Act = ResumableTest_TriggerActs,
+        .AppInit.Trigger.Alarm = NULL,
+        .AppInit.Alarm = NULL
+    };
+    uint32_t sleeps;
+    bool_t result = DEF_OK;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Resumable Loop Test   //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    DecisionEng_Init(&init);
+
+    for (ResumableTest_Iterations = 0; ResumableTest_Iterations < RESUMABLE_TEST_ITERATIONS;
+         ResumableTest_Iterations++) {
+
+        printf("----------------------------------\nIteration: %u\n", ResumableTest_Iterations);
+
+        /* Scheduler: resume the loop until done, sleeping in between   */
+        sleeps = 0;
+        while (SA_PT_WAITING == DecisionEng_LoopPt()) {
+            sleeps++;
+        }
+
+        printf("-- Sleeps: %u\n", sleeps);
+        if ((RESUMABLE_TEST_WARMUP_POLLS + RESUMABLE_TEST_TX_POLLS != sleeps) ||
+            (10.0f + ResumableTest_Iterations != ResumableTest_Transmitted)) {
+            printf("-- Expected %u sleeps and data %f -> FAIL\n",
+                   RESUMABLE_TEST_WARMUP_POLLS + RESUMABLE_TEST_TX_POLLS,
+                   10.0f + ResumableTest_Iterations);
+            result = DEF_FAIL;
+        }
+    }
+
+    printf("-- Result: %s\n", (DEF_OK == result) ? "PASS" : "FAIL");
+
+    return result;
+}
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
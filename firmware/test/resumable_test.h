@@ -0,0 +1,34 @@
+/**
+ * \file    resumable_test.h
+ *
+ * \brief   Header file for the resumable loop test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __RESUMABLE_TEST_H__
+#define __RESUMABLE_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t ResumableTest_RunTest(void);
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
+
+#endif  /* __RESUMABLE_TEST_H__       */
@@ -0,0 +1,256 @@
+/**
+ * \file    sample_store_test.c
+ *
+ * \brief   Main file for the store and forward test.
+ *          This is not a Unit test, but a functional test of the sample store in the NVM file:
+ *          the log is filled, drained and recovered after a reset, and the radio agent stores
+ *          the samples during a link outage and an idle period, and drains them afterwards,
+ *          so every sample is transmitted exactly once, and reports the frames it transmitted
+ *          for the charge predicted by the decision engine.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SampleStoreTest_
+ *
+ */
+
+#include <string.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_nvm.h"
+
+#include "../configs/radio_cfg.h"
+#include "../include/radio_agent.h"
+#include "../include/sample_store.h"
+
+#include "sample_store_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup RadioAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SAMPLE_STORE_TEST_SAMPLES           300u    /* Samples of the log test, over 2 sectors  */
+#define SAMPLE_STORE_TEST_FIRST_DRAIN       32u     /* Samples drained before the reset         */
+#define SAMPLE_STORE_TEST_OVERFLOW          1200u   /* Samples of the full store test           */
+
+#define SAMPLE_STORE_TEST_ITERATIONS        200u    /* Activations of the radio agent test      */
+#define SAMPLE_STORE_TEST_LINK_DOWN         20u     /* First activation without link            */
+#define SAMPLE_STORE_TEST_RESET             70u     /* Activation with a reset of the mote      */
+#define SAMPLE_STORE_TEST_LINK_UP           120u    /* First activation with link               */
+#define SAMPLE_STORE_TEST_IDLE              140u    /* First activation with the radio idled    */
+#define SAMPLE_STORE_TEST_DRAIN             160u    /* First activation with the drain enabled  */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static uint32_t SampleStoreTest_Iterations;
+static uint8_t SampleStoreTest_Received[SAMPLE_STORE_TEST_ITERATIONS];
+static uint32_t SampleStoreTest_Transmissions;
+static uint32_t SampleStoreTest_Drains;
+static uint8_t SampleStoreTest_MaxBatch;
+
+/************************************** Function implementation **********************************/
+/************* Radio Agent ******************/
+/**
+ * \brief  Fakes the radio observation, with a link outage.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void SampleStoreTest_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = DEF_FALSE;
+    p_obs->LinkUp = ((SAMPLE_STORE_TEST_LINK_DOWN <= SampleStoreTest_Iterations) &&
+                     (SAMPLE_STORE_TEST_LINK_UP > SampleStoreTest_Iterations)) ? DEF_FALSE : DEF_TRUE;
+}
+
+/**
+ * \brief  Fakes the radio transmission, counting the samples received by the sink.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void SampleStoreTest_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    uint8_t sample;
+    uint32_t index;
+
+    for (sample = 0; sample < p_acts->BatchSize; sample++) {
+        index = (uint32_t) p_acts->Batch[sample];
+        if (SAMPLE_STORE_TEST_ITERATIONS > index) SampleStoreTest_Received[index]++;
+    }
+    SampleStoreTest_Transmissions++;
+    if (0u != p_acts->Stored) {
+        SampleStoreTest_Drains++;
+        printf("-- ::Radio  :: Drain of %u stored and %u new samples, from %.0f\n", p_acts->Stored,
+               p_acts->BatchSize - p_acts->Stored, p_acts->Batch[0]);
+    }
+    if (p_acts->BatchSize > SampleStoreTest_MaxBatch) SampleStoreTest_MaxBatch = p_acts->BatchSize;
+}
+
+/************* Tools ************************/
+/**
+ * \brief  Erases the sectors of the store, as a new mote.
+ *
+ */
+static void SampleStoreTest_Erase(void)
+{
+    uint16_t sector;
+
+    SaNvm_Init();
+    for (sector = 0; sector < RADIO_CFG_STORE_SECTORS; sector++) {
+        SaNvm_EraseSector(RADIO_CFG_STORE_FIRST_SECTOR + sector);
+    }
+}
+
+/**
+ * \brief  Drains the store, checking that the samples come out in order.
+ *
+ * \param  first:  Expected value of the first sample.
+ *
+ * \return DEF_TRUE if every sample is in order; otherwise DEF_FALSE.
+ *
+ */
+static bool_t SampleStoreTest_Drain(float32_t first)
+{
+    float32_t batch[RADIO_CFG_DRAIN_BATCH];
+    uint16_t count, sample;
+    bool_t ordered = DEF_TRUE;
+
+    while (0u != (count = SampleStore_Peek(batch, RADIO_CFG_DRAIN_BATCH))) {
+        for (sample = 0; sample < count; sample++) {
+            if (first++ != batch[sample]) ordered = DEF_FALSE;
+        }
+        SampleStore_Release(count);
+    }
+    return ordered;
+}
+
+/**
+ * \brief  Prints the status of the store.
+ *
+ * \param  p_status:  Pointer to the status.
+ *
+ */
+static void SampleStoreTest_Print(const SAMPLE_STORE_STATUS_T *p_status)
+{
+    printf("-- Store: pending %u, appended %u, drained %u, dropped %u, discarded %u, reclaimed %u\n",
+           p_status->Pending, p_status->Appended, p_status->Drained, p_status->Dropped,
+           p_status->Discarded, p_status->Reclaimed);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the store and forward.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ */
+bool_t SampleStoreTest_RunTest(void)
+{
+    RADIO_AGENT_INTERFACE_T data;
+    SAMPLE_STORE_STATUS_T status;
+    float32_t batch[RADIO_CFG_DRAIN_BATCH];
+    uint32_t sample, missing, duplicated;
+    uint32_t transmissions, previous = 0, frames = 0;
+    uint16_t count;
+    bool_t result = DEF_OK;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Store and Forward Test //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    /* Log                          */
+    SampleStoreTest_Erase();
+    SampleStore_Init();
+    for (sample = 0; sample < SAMPLE_STORE_TEST_SAMPLES; sample++) {
+        SampleStore_Append((float32_t) sample);
+    }
+    count = SampleStore_Peek(batch, SAMPLE_STORE_TEST_FIRST_DRAIN);
+    TestUtils_Check((SAMPLE_STORE_TEST_FIRST_DRAIN == count) && (0.0f == batch[0]) &&
+                    (SAMPLE_STORE_TEST_FIRST_DRAIN - 1.0f == batch[count - 1u]),
+                    "Peek returns the oldest samples", &result);
+    SampleStore_Release(count);
+
+    /* Reset                        */
+    SampleStore_Init();
+    SampleStore_GetStatus(&status);
+    SampleStoreTest_Print(&status);
+    TestUtils_Check(SAMPLE_STORE_TEST_SAMPLES - SAMPLE_STORE_TEST_FIRST_DRAIN == status.Pending,
+                    "Pending samples recovered after a reset", &result);
+    TestUtils_Check(DEF_TRUE == SampleStoreTest_Drain((float32_t) SAMPLE_STORE_TEST_FIRST_DRAIN),
+                    "Drained in order after a reset", &result);
+    SampleStore_GetStatus(&status);
+    SampleStoreTest_Print(&status);
+    TestUtils_Check((0u == status.Pending) && (2u == status.Reclaimed),
+                    "Drained sectors reclaimed", &result);
+
+    /* Full store                   */
+    for (sample = 0; sample < SAMPLE_STORE_TEST_OVERFLOW; sample++) {
+        SampleStore_Append((float32_t) sample);
+    }
+    SampleStore_GetStatus(&status);
+    SampleStoreTest_Print(&status);
+    TestUtils_Check((0u != status.Dropped) &&
+                    (status.Appended - status.Dropped == status.Pending),
+                    "Oldest samples dropped when full", &result);
+    TestUtils_Check(DEF_TRUE == SampleStoreTest_Drain((float32_t) status.Dropped),
+                    "Newest samples kept in order", &result);
+    SampleStore_GetStatus(&status);
+    TestUtils_Check((0u == status.Pending) && (0u == status.Discarded),
+                    "Store drained", &result);
+
+    /* Radio agent                  */
+    SampleStoreTest_Erase();
+    RadioAgent_Init(SampleStoreTest_RadioObs, SampleStoreTest_RadioActs, NULL, DEF_TRUE);
+    memset(&data, 0x00, sizeof(RADIO_AGENT_INTERFACE_T));
+    for (SampleStoreTest_Iterations = 0; SampleStoreTest_Iterations < SAMPLE_STORE_TEST_ITERATIONS;
+         SampleStoreTest_Iterations++) {
+        if (SAMPLE_STORE_TEST_RESET == SampleStoreTest_Iterations) {
+            RadioAgent_Init(SampleStoreTest_RadioObs, SampleStoreTest_RadioActs, NULL, DEF_TRUE);
+            printf("-- Reset with %u stored samples\n", SampleStore_GetPending());
+        }
+        data.Inputs.Data = (float32_t) SampleStoreTest_Iterations;
+        data.Inputs.Batch = 1u;
+        data.Inputs.Idle = ((SAMPLE_STORE_TEST_IDLE <= SampleStoreTest_Iterations) &&
+                            (SAMPLE_STORE_TEST_DRAIN > SampleStoreTest_Iterations)) ? DEF_TRUE : DEF_FALSE;
+        data.Inputs.Drain = (SAMPLE_STORE_TEST_DRAIN <= SampleStoreTest_Iterations) ? DEF_TRUE : DEF_FALSE;
+        transmissions = SampleStoreTest_Transmissions;
+        RadioAgent_Oda(&data);
+        /* The observation reports the frames of the previous activation */
+        if (transmissions - previous != data.Outputs.Frames) frames++;
+        previous = transmissions;
+    }
+
+    missing = 0;
+    duplicated = 0;
+    for (sample = 0; sample < SAMPLE_STORE_TEST_ITERATIONS; sample++) {
+        if (0u == SampleStoreTest_Received[sample]) missing++;
+        if (1u < SampleStoreTest_Received[sample]) duplicated++;
+    }
+    SampleStore_GetStatus(&status);
+    SampleStoreTest_Print(&status);
+    printf("-- Transmissions %u, drains %u, largest batch %u, missing %u, duplicated %u, frames misreported %u\n",
+           SampleStoreTest_Transmissions, SampleStoreTest_Drains, SampleStoreTest_MaxBatch,
+           missing, duplicated, frames);
+    TestUtils_Check((0u == missing) && (0u == duplicated),
+                    "Every sample transmitted exactly once", &result);
+    TestUtils_Check((0u == status.Pending) && (RADIO_CFG_MAX_BATCH < SampleStoreTest_MaxBatch),
+                    "Store drained in large batches", &result);
+    TestUtils_Check(0u == frames, "Frames reported while storing and draining", &result);
+
+    printf("-- Result: %s\n", (DEF_OK == result) ? "PASS" : "FAIL");
+
+    return result;
+}
+
+/** @} (end addtogroup RadioAgent)   */
+/** @} (end addtogroup Tests)        */
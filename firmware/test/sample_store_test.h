@@ -0,0 +1,35 @@
+/**
+ * \file    sample_store_test.h
+ *
+ * \brief   Header file for the store and forward test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SAMPLE_STORE_TEST_H__
+#define __SAMPLE_STORE_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup RadioAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SampleStoreTest_RunTest(void);
+
+
+/** @} (end addtogroup RadioAgent)   */
+/** @} (end addtogroup Tests)        */
+
+#endif  /* __SAMPLE_STORE_TEST_H__       */
@@ -0,0 +1,295 @@
+/**
+ * \file    sim_test.c
+ *
+ * \brief   Main file for the simulation test.
+ *          This is not a Unit test, but a functional test where the decision engine runs on the
+ *          discrete-event kernel for the whole expected battery life, with a daily sensor trace,
+ *          and the energy accounting of the simulation is checked. With steps of the sensor
+ *          data, the fast-forward of the steady state is checked against the stepped
+ *          simulation. A harvesting node in energy neutral mode is checked to spend its daily
+ *          harvest, and a node that batches its transmissions to learn the true powers.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SimTest_
+ *
+ */
+
+#include <math.h>
+#include <time.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/battery_cfg.h"
+#include "../include/agents_main.h"
+#include "../include/energy_planner.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_node.h"
+#include "../configs/trigger_cfg.h"
+#include "../configs/sensor_cfg.h"
+
+#include "sim_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Simulation
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SIM_TEST_TRACE_MEAN                 20.0f   /* Mean of the daily sensor trace           */
+#define SIM_TEST_TRACE_AMPLITUDE            5.0f    /* Amplitude of the daily sensor trace      */
+#define SIM_TEST_SMALL_CAPACITY             1.0e5   /* Battery depleted before the horizon      */
+#define SIM_TEST_TOLERANCE                  1.0e-6  /* Relative error of the energy accounting  */
+#define SIM_TEST_FAST_CAPACITY              2.0e9   /* Battery for the fastest sampling         */
+#define SIM_TEST_FAST_HORIZON               SA_UTILS_DAYS_TO_MILLI_S
+#define SIM_TEST_FAST_TOLERANCE             0.01    /* Activations missed at the fastest rate   */
+#define SIM_TEST_FF_TOLERANCE               0.02    /* Relative error of the fast-forward       */
+#define SIM_TEST_FF_CAPACITY                2.0e9   /* Battery for the fastest sampling         */
+#define SIM_TEST_FF_HORIZON                 (10u * SA_UTILS_DAYS_TO_MILLI_S)
+#define SIM_TEST_FF_SMALL_CAPACITY          2.7e5   /* Battery depleted with the step inputs    */
+#define SIM_TEST_FF_SPEEDUP                 10u     /* Minimum activations per stepped one      */
+#define SIM_TEST_ERROR_TOLERANCE            0.05    /* Relative error of the sink error         */
+#define SIM_TEST_DAILY_ERROR                (2.0 * SIM_TEST_TRACE_AMPLITUDE / M_PI) /* Mean of |sine|   */
+#define SIM_TEST_HARVEST                    1.0     /* Charge harvested per s in daylight       */
+#define SIM_TEST_DAYLIGHT                   (12u * SA_UTILS_HOURS_TO_MILLI_S)
+#define SIM_TEST_LEARNING_DAYS              20u     /* Days to learn the harvest profile        */
+#define SIM_TEST_NEUTRAL_DAYS               10u     /* Days of the energy neutral check         */
+#define SIM_TEST_NEUTRAL_TOLERANCE          0.02    /* Net drain of a day, of the harvest       */
+#define SIM_TEST_NEUTRAL_SPENT              0.5     /* Minimum part of the stored harvest spent */
+#define SIM_TEST_BATCH                      4u      /* Activations per radio transmission       */
+#define SIM_TEST_BATCH_HORIZON              (10u * SA_UTILS_DAYS_TO_MILLI_S)
+#define SIM_TEST_BATCH_NOISE                0.01    /* Relative noise of the coulomb counter    */
+#define SIM_TEST_BATCH_TOLERANCE            0.1     /* Relative error of the learned powers     */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+/* Steps of the sensor data, a quiet signal with a few events   */
+static const SIM_NODE_INPUT_T SimTest_Inputs[] = {
+    { 0u * SA_UTILS_DAYS_TO_MILLI_S,                                20.0f },
+    { 2u * SA_UTILS_DAYS_TO_MILLI_S,                                26.0f },
+    { 2u * SA_UTILS_DAYS_TO_MILLI_S + SA_UTILS_HOURS_TO_MILLI_S,    20.0f },
+    { 5u * SA_UTILS_DAYS_TO_MILLI_S,                                35.0f },
+    { 8u * SA_UTILS_DAYS_TO_MILLI_S,                                22.0f },
+};
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Daily sensor trace, a sine with a period of a day.
+ *
+ * \param  time:  Virtual time in ms.
+ *
+ * \return Sensor data.
+ *
+ */
+static float32_t SimTest_DailyTrace(SIM_TIME_T time)
+{
+    float64_t phase = (float64_t)(time % SA_UTILS_DAYS_TO_MILLI_S) / SA_UTILS_DAYS_TO_MILLI_S;
+
+    return SIM_TEST_TRACE_MEAN + SIM_TEST_TRACE_AMPLITUDE * (float32_t) sin(2.0 * M_PI * phase);
+}
+
+/**
+ * \brief  Prints the result of a simulation.
+ *
+ * \param  p_result:  Pointer to the result.
+ * \param  wall:      Wall time of the simulation in s.
+ *
+ */
+static void SimTest_Print(const SIM_NODE_RESULT_T *p_result, float64_t wall)
+{
+    DECISION_ENGINE_SKIPS_T skips;
+
+    DecisionEng_GetSkips(&skips);
+    printf("-- Lifetime %.2f days (%s), activations %u, transmissions %u, events %llu\n",
+           (float64_t) p_result->Lifetime / SA_UTILS_DAYS_TO_MILLI_S,
+           (DEF_TRUE == p_result->Depleted) ? "depleted" : "horizon", p_result->Activations,
+           p_result->Transmissions, (unsigned long long) p_result->Events);
+    printf("-- Charge: active %.1f, idle %.1f, leaps %u, skipped %u, wall time %.3f s\n",
+           p_result->ActiveCharge, p_result->IdleCharge, p_result->Leaps, p_result->Skipped, wall);
+    printf("-- Error at the sink %.4f\n", p_result->Error);
+    printf("-- Skipped in %u loops: activations %u, power inputs %u, power updates %u\n",
+           skips.Loops, skips.ActivationsSkipped, skips.PowerInputsSkipped, skips.PredictionsUnchanged);
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the simulation.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ */
+bool_t SimTest_RunTest(void)
+{
+    SIM_NODE_CFG_T cfg;
+    SIM_NODE_RESULT_T result, stepped, again, learnt;
+    float64_t idle, harvest, spent, drain;
+    float32_t base, sensor, datasheet;
+    DECISION_ENGINE_SKIPS_T skips;
+    int8_t relevance, power, neutral, budget;
+    clock_t start;
+    bool_t test = DEF_OK;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Simulation Test       //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    /* Expected battery life        */
+    SimNode_DefaultCfg(&cfg);
+    cfg.Trace = SimTest_DailyTrace;
+    start = clock();
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+
+    idle = cfg.IdleCurrent * (float64_t) result.Lifetime / SA_UTILS_S_TO_MILLI_S;
+    TestUtils_Check((DEF_FALSE == result.Depleted) && (cfg.Horizon == result.Lifetime),
+                    "Expected battery life simulated", &test);
+    TestUtils_Check(SIM_TEST_TOLERANCE * idle >= fabs(idle - result.IdleCharge),
+                    "Idle charge over the whole life", &test);
+    TestUtils_Check(result.Activations - result.Skipped + 1u == result.Events,
+                    "One event per stepped activation", &test);
+
+    /* Restart                      */
+    start = clock();
+    SimNode_Run(&cfg, &again);
+    SimTest_Print(&again, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    TestUtils_Check((result.Activations == again.Activations) &&
+                    (result.ActiveCharge == again.ActiveCharge),
+                    "Same run after a restart", &test);
+
+    /* Depletion                    */
+    cfg.Capacity = SIM_TEST_SMALL_CAPACITY;
+    start = clock();
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    TestUtils_Check((DEF_TRUE == result.Depleted) && (cfg.Horizon > result.Lifetime) &&
+                    (SIM_TEST_TOLERANCE * cfg.Capacity >=
+                     fabs(cfg.Capacity - result.ActiveCharge - result.IdleCharge)),
+                    "Depletion at the capacity", &test);
+    /* Sampled about once a day at the same phase, the sink misses the whole sine   */
+    TestUtils_Check(SIM_TEST_ERROR_TOLERANCE * SIM_TEST_DAILY_ERROR >= fabs(result.Error - SIM_TEST_DAILY_ERROR),
+                    "Sink error of a daily sample", &test);
+
+    /* Fastest sampling             */
+    SimNode_DefaultCfg(&cfg);
+    cfg.Capacity = SIM_TEST_FAST_CAPACITY;
+    cfg.Horizon = SIM_TEST_FAST_HORIZON;
+    start = clock();
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    TestUtils_Check((1.0 - SIM_TEST_FAST_TOLERANCE) * cfg.Horizon /
+                    TriggerCfg_Periods_Ptr[TRIGGER_CFG_MAXIMUM_SAMPLING] <= result.Activations,
+                    "Settles at the fastest sampling", &test);
+
+    /* Fast-forward                 */
+    SimNode_DefaultCfg(&cfg);
+    cfg.Inputs = SimTest_Inputs;
+    cfg.NumInputs = sizeof(SimTest_Inputs) / sizeof(SIM_NODE_INPUT_T);
+    cfg.Capacity = SIM_TEST_FF_CAPACITY;
+    cfg.Horizon = SIM_TEST_FF_HORIZON;
+    cfg.FastForward = DEF_FALSE;
+    start = clock();
+    SimNode_Run(&cfg, &stepped);
+    SimTest_Print(&stepped, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    cfg.FastForward = DEF_TRUE;
+    start = clock();
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    TestUtils_Check(SIM_TEST_FF_TOLERANCE * stepped.ActiveCharge >=
+                    fabs(stepped.ActiveCharge - result.ActiveCharge),
+                    "Fast-forward charge as stepped", &test);
+    TestUtils_Check(SIM_TEST_FF_TOLERANCE * stepped.Activations >=
+                    fabs((float64_t) stepped.Activations - result.Activations),
+                    "Fast-forward activations as stepped", &test);
+    TestUtils_Check(SIM_TEST_FF_TOLERANCE * stepped.Error >= fabs(stepped.Error - result.Error),
+                    "Fast-forward sink error as stepped", &test);
+    TestUtils_Check(SIM_TEST_FF_SPEEDUP * (result.Activations - result.Skipped) <= result.Activations,
+                    "Fast-forward skips the steady state", &test);
+
+    cfg.Capacity = SIM_TEST_FF_SMALL_CAPACITY;
+    cfg.Horizon = SIM_NODE_HORIZON;
+    cfg.FastForward = DEF_FALSE;
+    SimNode_Run(&cfg, &stepped);
+    SimTest_Print(&stepped, 0.0);
+    cfg.FastForward = DEF_TRUE;
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, 0.0);
+    TestUtils_Check((DEF_TRUE == result.Depleted) &&
+                    (SIM_TEST_FF_TOLERANCE * stepped.Lifetime >=
+                     fabs((float64_t) stepped.Lifetime - result.Lifetime)),
+                    "Fast-forward lifetime as stepped", &test);
+
+    /* Energy neutral               */
+    SimNode_DefaultCfg(&cfg);
+    cfg.Trace = SimTest_DailyTrace;
+    cfg.Harvest = SIM_TEST_HARVEST;
+    cfg.Daylight = SIM_TEST_DAYLIGHT;
+    cfg.Policy = DECISION_ENGINE_POLICY_BUDGET;
+    cfg.Horizon = SA_UTILS_HOURS_TO_MILLI_S / 2u;
+    cfg.EnergyNeutral = DEF_FALSE;
+    SimNode_Run(&cfg, &result);
+    budget = EnergyPlanner_GetBudgetIndex();
+    DecisionEng_GetIndexValues(&relevance, &power);
+    cfg.EnergyNeutral = DEF_TRUE;
+    SimNode_Run(&cfg, &result);
+    DecisionEng_GetIndexValues(&relevance, &neutral);
+    printf("-- Before any harvest: budget index %d, power index %d, of the battery life %d, %d\n",
+           EnergyPlanner_GetBudgetIndex(), neutral, budget, power);
+    TestUtils_Check((budget == EnergyPlanner_GetBudgetIndex()) && (power == neutral),
+                    "Battery life plan before any harvest", &test);
+
+    /* The days after the learning of the harvest profile, from two runs   */
+    cfg.Horizon = SIM_TEST_LEARNING_DAYS * SA_UTILS_DAYS_TO_MILLI_S;
+    SimNode_Run(&cfg, &learnt);
+    cfg.Horizon = (SIM_TEST_LEARNING_DAYS + SIM_TEST_NEUTRAL_DAYS) * (SIM_TIME_T) SA_UTILS_DAYS_TO_MILLI_S;
+    start = clock();
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    harvest = cfg.Harvest * (float64_t) cfg.Daylight / SA_UTILS_S_TO_MILLI_S;
+    spent = (result.ActiveCharge + result.IdleCharge - learnt.ActiveCharge - learnt.IdleCharge) /
+            SIM_TEST_NEUTRAL_DAYS;
+    drain = spent - (result.Harvested - learnt.Harvested) / SIM_TEST_NEUTRAL_DAYS;
+    printf("-- Daily harvest %.1f, spent %.1f, net drain %.1f\n", harvest, spent, drain);
+    TestUtils_Check(DEF_FALSE == result.Depleted, "Harvesting node not depleted", &test);
+    TestUtils_Check(SIM_TEST_NEUTRAL_TOLERANCE * harvest >= fabs(drain), "Net daily drain of zero", &test);
+    TestUtils_Check(SIM_TEST_NEUTRAL_SPENT * POWER_AGENT_CHARGE_EFFICIENCY * harvest <= spent,
+                    "Daily harvest spent", &test);
+
+    /* Radio batching, without the idle charge, which the idle power does not scale with the
+       period, so the charge drawn is the one of the true powers of the models              */
+    SimNode_DefaultCfg(&cfg);
+    cfg.IdleCurrent = 0.0;
+    cfg.CounterNoise = SIM_TEST_BATCH_NOISE;
+    cfg.Horizon = SIM_TEST_BATCH_HORIZON;
+    cfg.RadioBatch = SIM_TEST_BATCH;
+    start = clock();
+    SimNode_Run(&cfg, &result);
+    SimTest_Print(&result, (float64_t)(clock() - start) / CLOCKS_PER_SEC);
+    base = DecisionEng_GetBasePowerPtr()->Power;
+    sensor = SensorAgent_GetPower();
+    datasheet = SensorCfg_Configs_Ptr[SensorAgent_GetConfig()].PowerCost.Power;
+    printf("-- Learned base power %.2f of %.2f, sensor power %.2f of %.2f\n", base, cfg.BaseCharge,
+           sensor, datasheet);
+    TestUtils_Check((result.Activations + SIM_TEST_BATCH - 1u) / SIM_TEST_BATCH >= result.Transmissions,
+                    "One transmission per batch", &test);
+    TestUtils_Check((0.0f < base) && (SIM_TEST_BATCH_TOLERANCE * cfg.BaseCharge >= fabs(base - cfg.BaseCharge)),
+                    "Base power learned while batching", &test);
+    TestUtils_Check((0.0f < sensor) && (SIM_TEST_BATCH_TOLERANCE * datasheet >= fabs(sensor - datasheet)),
+                    "Sensor power learned while batching", &test);
+    DecisionEng_GetSkips(&skips);
+    TestUtils_Check(0u < skips.PredictionsUnchanged, "Power updates skipped with a noisy counter", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+
+    return test;
+}
+
+/** @} (end addtogroup Simulation)   */
+/** @} (end addtogroup Tests)        */
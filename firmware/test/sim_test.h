@@ -0,0 +1,35 @@
+/**
+ * \file    sim_test.h
+ *
+ * \brief   Header file for the simulation of a node in virtual time.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SIM_TEST_H__
+#define __SIM_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Simulation
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SimTest_RunTest(void);
+
+
+/** @} (end addtogroup Simulation)   */
+/** @} (end addtogroup Tests)        */
+
+#endif  /* __SIM_TEST_H__       */
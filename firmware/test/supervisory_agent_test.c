@@ -0,0 +1,276 @@
+/**
+ * \file    supervisory_agent_test.c
+ *
+ * \brief   Main file for the supervisory agent test.
+ *          This is not a Unit test, but a functional test that runs the supervised loop through
+ *          the following phases:
+ *            -) Loops over the deadline, which switch to reduced sampling.
+ *            -) Clean loops, which recover the normal mode.
+ *            -) Repeated battery alarms, which switch to reduced sampling and then to radio
+ *               batching.
+ *            -) Battery replaced, which recovers the normal mode.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SupervisoryTest_
+ *
+ */
+
+#include <string.h>
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_timing.h"
+
+#include "../configs/battery_cfg.h"
+#include "../configs/supervisory_cfg.h"
+#include "../include/power_agent.h"
+#include "../include/decision_engine.h"
+#include "../include/supervisory_agent.h"
+
+#include "supervisory_agent_test.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup SupervisoryAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define SUPERVISORY_TEST_ITERATIONS             50u
+
+#define SUPERVISORY_TEST_OVERRUN_START           5u     /* Loops over the deadline          */
+#define SUPERVISORY_TEST_OVERRUN_END             7u
+#define SUPERVISORY_TEST_DRAIN_START            20u     /* Loops that deplete the battery   */
+#define SUPERVISORY_TEST_DRAIN_END              22u
+#define SUPERVISORY_TEST_BATTERY_CHANGE         30u     /* Loop before which the battery is replaced */
+
+#define SUPERVISORY_TEST_CHARGE                 10.0f   /* Charge per loop                  */
+#define SUPERVISORY_TEST_DRAIN_CHARGE         2000.0f   /* Charge per loop while draining   */
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Expected mode after a given loop.
+ *
+ */
+typedef struct {
+    uint32_t Iteration;
+    ERROR_HANDLING_MODE_T Mode;
+} SUPERVISORY_TEST_CHECK_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static const SUPERVISORY_TEST_CHECK_T SupervisoryTest_Checks[] = {
+    {SUPERVISORY_TEST_OVERRUN_START - 1u, ERROR_HANDLING_MODE_NORMAL},
+    {SUPERVISORY_TEST_OVERRUN_END, ERROR_HANDLING_MODE_REDUCED_SAMPLING},
+    {SUPERVISORY_TEST_OVERRUN_END + SUPERVISORY_CFG_RECOVERY_LOOPS, ERROR_HANDLING_MODE_NORMAL},
+    {SUPERVISORY_TEST_BATTERY_CHANGE - 1u, ERROR_HANDLING_MODE_RADIO_BATCHING},
+    {SUPERVISORY_TEST_ITERATIONS - 1u, ERROR_HANDLING_MODE_NORMAL},
+};
+
+static const char *SupervisoryTest_ModeNames[ERROR_HANDLING_MODES] = {
+    "NORMAL", "REDUCED SAMPLING", "RADIO BATCHING",
+};
+
+static uint32_t SupervisoryTest_Iterations;
+static float32_t SupervisoryTest_ChargeAccum = 0;
+static uint32_t SupervisoryTest_Transmissions = 0;
+
+/************************************** Function implementation **********************************/
+/************* Power Agent ******************/
+/**
+ * \brief  Fakes a measurement from the coulomb counter.
+ *
+ * \param  p_obs:  Pointer to the observation data of the power agent.
+ *
+ */
+static void SupervisoryTest_PowerObs(POWER_AGENT_OBS_T *p_obs)
+{
+    if ((SUPERVISORY_TEST_DRAIN_START <= SupervisoryTest_Iterations) &&
+        (SUPERVISORY_TEST_DRAIN_END >= SupervisoryTest_Iterations)) {
+        SupervisoryTest_ChargeAccum += SUPERVISORY_TEST_DRAIN_CHARGE;
+    } else {
+        SupervisoryTest_ChargeAccum += SUPERVISORY_TEST_CHARGE;
+    }
+    p_obs->Battery.Charge = SupervisoryTest_ChargeAccum;
+    p_obs->Battery.BatteryVoltage = 0;      /* No voltage measurement   */
+    p_obs->Battery.Temperature = POWER_AGENT_TEMP_REF;
+    p_obs->Battery.Harvested = 0;           /* No harvester             */
+}
+
+/**
+ * \brief  Fakes the actuation of the power agent.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void SupervisoryTest_PowerActs(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Fakes the power agent alarm function.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void SupervisoryTest_PowerAlarm(POWER_AGENT_ERROR_T error)
+{
+    printf("-- ::Power  :: Alarm = %u\n", error);
+}
+
+/************* Radio Agent ******************/
+/**
+ * \brief  Fakes the radio observation.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void SupervisoryTest_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = DEF_FALSE;
+}
+
+/**
+ * \brief  Fakes the radio transmission.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void SupervisoryTest_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    SupervisoryTest_Transmissions++;
+    printf("-- ::Radio  :: Transmission of %u samples\n", p_acts->BatchSize);
+}
+
+/************* Application Agent ************/
+/**
+ * \brief  Fakes a measurement from the sensor. Overruns the deadline in the overrun phase.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data.
+ *
+ */
+static void SupervisoryTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    uint32_t start;
+
+    if ((SUPERVISORY_TEST_OVERRUN_START <= SupervisoryTest_Iterations) &&
+        (SUPERVISORY_TEST_OVERRUN_END >= SupervisoryTest_Iterations)) {
+        start = SaTiming_GetCycles();
+        while (2u * SUPERVISORY_CFG_LOOP_DEADLINE > SA_TIMING_ELAPSED(start));
+    }
+    p_obs->SensorData = 10.0;
+}
+
+/**
+ * \brief  Fakes the configuration change for the sensor.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void SupervisoryTest_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Fakes the trigger observation.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void SupervisoryTest_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Fakes the trigger actuation.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void SupervisoryTest_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the supervisory agent.
+ *
+ * \return DEF_OK if the modes are the expected ones; otherwise DEF_FAIL.
+ *
+ */
+bool_t SupervisoryTest_RunTest(void)
+{
+    DECISION_ENGINE_INIT_T init = {
+        .PowerInit.Obs = SupervisoryTest_PowerObs,
+        .PowerInit.Act = SupervisoryTest_PowerActs,
+        .PowerInit.Alarm = SupervisoryTest_PowerAlarm,
+        .RadioInit.Obs = SupervisoryTest_RadioObs,
+        .RadioInit.Act = SupervisoryTest_RadioActs,
+        .AppInit.Sensor.Obs = SupervisoryTest_SensorObs,
+        .AppInit.Sensor.Act = SupervisoryTest_SensorActs,
+        .AppInit.Sensor.Alarm = NULL,
+        .AppInit.Trigger.Obs = SupervisoryTest_TriggerObs,
+        .AppInit.Trigger.Act = SupervisoryTest_TriggerActs,
+        .AppInit.Trigger.Alarm = NULL,
+        .AppInit.Alarm = NULL
+    };
+    ERROR_HANDLING_HEALTH_T health;
+    ERROR_HANDLING_MODE_T mode;
+    bool_t result = DEF_OK;
+    uint8_t check = 0;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Supervisory Agent Test  ////\n");
+    printf("//////////////////////////////////\n\n");
+
+    SupervisoryAgent_Init(&init);
+
+    for (SupervisoryTest_Iterations = 0; SupervisoryTest_Iterations < SUPERVISORY_TEST_ITERATIONS;
+         SupervisoryTest_Iterations++) {
+
+        printf("----------------------------------\nIteration: %u\n", SupervisoryTest_Iterations);
+
+        if (SUPERVISORY_TEST_BATTERY_CHANGE == SupervisoryTest_Iterations) {
+            printf("-- Battery replaced\n");
+            PowerAgent_SetBatteryCharge(POWER_AGENT_MAX_BATTERY_MA * POWER_AGENT_EFFECTIVE_CHARGE);
+        }
+
+        SupervisoryAgent_Loop();
+
+        mode = SupervisoryAgent_GetMode();
+        SupervisoryAgent_GetHealth(&health);
+        printf("-- Mode: %s, overruns: %u, power alarms: %u, clean loops: %u\n",
+               SupervisoryTest_ModeNames[mode], health.Overruns,
+               health.Agents[ERROR_HANDLING_POWER_AGENT].Alarms, health.CleanLoops);
+
+        if ((sizeof(SupervisoryTest_Checks) / sizeof(SupervisoryTest_Checks[0]) > check) &&
+            (SupervisoryTest_Checks[check].Iteration == SupervisoryTest_Iterations)) {
+            if (SupervisoryTest_Checks[check].Mode != mode) {
+                printf("-- Expected mode: %s -> FAIL\n",
+                       SupervisoryTest_ModeNames[SupervisoryTest_Checks[check].Mode]);
+                result = DEF_FAIL;
+            }
+            check++;
+        }
+    }
+
+    SupervisoryAgent_GetHealth(&health);
+    printf("\n-- Health record (%u bytes):\n", (uint32_t) sizeof(ERROR_HANDLING_HEALTH_T));
+    printf("--- Loops %u, overruns %u, worst loop %u cycles, escalations %u\n",
+           health.Loops, health.Overruns, health.WorstLoop, health.Escalations);
+    printf("--- Transmissions: %u\n", SupervisoryTest_Transmissions);
+    printf("-- Result: %s\n", (DEF_OK == result) ? "PASS" : "FAIL");
+
+    return result;
+}
+
+/** @} (end addtogroup SupervisoryAgent)    */
+/** @} (end addtogroup Tests)               */
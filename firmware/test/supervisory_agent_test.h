@@ -0,0 +1,34 @@
+/**
+ * \file    supervisory_agent_test.h
+ *
+ * \brief   Header file for the supervisory agent test.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SUPERVISORY_AGENT_TEST_H__
+#define __SUPERVISORY_AGENT_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup SupervisoryAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SupervisoryTest_RunTest(void);
+
+/** @} (end addtogroup SupervisoryAgent)    */
+/** @} (end addtogroup Tests)               */
+
+#endif  /* __SUPERVISORY_AGENT_TEST_H__       */
@@ -0,0 +1,272 @@
+/**
+ * \file    sweep_test.c
+ *
+ * \brief   Main file for the parameter sweep test.
+ *          This is not a Unit test, but a functional test where the tuning parameters of the
+ *          policy are swept at run time against two replayed sensor traces, a quiet day cycle
+ *          and a trace with events. The sweep runs once in this process and once shared
+ *          between worker processes, and the Pareto set of lifetime and information is
+ *          reported and checked.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: SweepTest_
+ *
+ */
+
+#include <string.h>
+#include <math.h>
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../configs/tuning_cfg.h"
+
+#include "../sim/sim_kernel.h"
+#include "../sim/sim_node.h"
+#include "../sim/sim_sweep.h"
+
+#include "sweep_test.h"
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Sweep
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#ifndef SWEEP_TEST_STEPS
+#define SWEEP_TEST_STEPS                    2u      /* Set by make STEPS=, values per parameter */
+#endif
+#ifndef SWEEP_TEST_SAMPLES
+#define SWEEP_TEST_SAMPLES                  16u     /* Set by make SAMPLES=, random points      */
+#endif
+#ifndef SWEEP_TEST_WORKERS
+#define SWEEP_TEST_WORKERS                  0u      /* Set by make WORKERS=, 0 for the default  */
+#endif
+#define SWEEP_TEST_PARALLEL_WORKERS         4u      /* Workers of the parallel run by default   */
+#define SWEEP_TEST_POINTS                   ((SWEEP_TEST_STEPS) * (SWEEP_TEST_STEPS) * (SWEEP_TEST_STEPS) * \
+                                             (SWEEP_TEST_STEPS) * (SWEEP_TEST_STEPS))
+#define SWEEP_TEST_MAX_POINTS               SA_UTILS_MAX(SWEEP_TEST_POINTS, SWEEP_TEST_SAMPLES)
+
+/* Replayed traces, recorded every hour */
+#define SWEEP_TEST_DAYS                     150u    /* Past the expected battery life           */
+#define SWEEP_TEST_INPUTS                   (SWEEP_TEST_DAYS * SA_UTILS_DAYS_TO_HOURS)
+#define SWEEP_TEST_MEAN                     20.0
+#define SWEEP_TEST_AMPLITUDE                2.0     /* Daily cycle                              */
+#define SWEEP_TEST_EVENT                    10.0    /* Step of an event                         */
+#define SWEEP_TEST_EVENT_DAYS               7u      /* Days between the events                  */
+#define SWEEP_TEST_EVENT_HOURS              6u      /* Length of an event                       */
+#define SWEEP_TEST_HORIZON                  ((SIM_TIME_T) SWEEP_TEST_DAYS * SA_UTILS_DAYS_TO_MILLI_S)
+#define SWEEP_TEST_CAPACITY                 5.0e5   /* Battery depleted before the horizon      */
+#define SWEEP_TEST_COUNTER_GAIN             0.05    /* Gain error of the coulomb counter        */
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static SIM_NODE_INPUT_T SweepTest_Quiet[SWEEP_TEST_INPUTS];
+static SIM_NODE_INPUT_T SweepTest_Events[SWEEP_TEST_INPUTS];
+static SIM_NODE_CFG_T SweepTest_Nodes[2];
+static SIM_SWEEP_POINT_T SweepTest_Serial[SWEEP_TEST_MAX_POINTS];
+static SIM_SWEEP_POINT_T SweepTest_Parallel[SWEEP_TEST_MAX_POINTS];
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Records the replayed traces and configures their nodes.
+ *
+ */
+static void SweepTest_Traces(void)
+{
+    uint32_t hour;
+    float64_t cycle;
+
+    for (hour = 0; hour < SWEEP_TEST_INPUTS; hour++) {
+        cycle = SWEEP_TEST_MEAN +
+                SWEEP_TEST_AMPLITUDE * sin(2.0 * M_PI * (hour % SA_UTILS_DAYS_TO_HOURS) / SA_UTILS_DAYS_TO_HOURS);
+        SweepTest_Quiet[hour].Time = (SIM_TIME_T) hour * SA_UTILS_HOURS_TO_MILLI_S;
+        SweepTest_Quiet[hour].Data = (float32_t) SA_UTILS_ROUND(cycle);     /* Sensor resolution */
+        SweepTest_Events[hour] = SweepTest_Quiet[hour];
+        if (SWEEP_TEST_EVENT_HOURS > hour % (SWEEP_TEST_EVENT_DAYS * SA_UTILS_DAYS_TO_HOURS)) {
+            SweepTest_Events[hour].Data += (float32_t) SWEEP_TEST_EVENT;
+        }
+    }
+
+    SimNode_DefaultCfg(&SweepTest_Nodes[0]);
+    SweepTest_Nodes[0].Capacity = SWEEP_TEST_CAPACITY;
+    SweepTest_Nodes[0].CounterGain = SWEEP_TEST_COUNTER_GAIN;
+    SweepTest_Nodes[0].Horizon = SWEEP_TEST_HORIZON;
+    SweepTest_Nodes[0].Inputs = SweepTest_Quiet;
+    SweepTest_Nodes[0].NumInputs = SWEEP_TEST_INPUTS;
+    SweepTest_Nodes[1] = SweepTest_Nodes[0];
+    SweepTest_Nodes[1].Inputs = SweepTest_Events;
+}
+
+/**
+ * \brief  Prints the summary of a sweep.
+ *
+ * \param  p_result:  Pointer to the summary.
+ *
+ */
+static void SweepTest_Print(const SIM_SWEEP_RESULT_T *p_result)
+{
+    printf("-- Points %u, Pareto %u, workers %u, wall time %.3f s, throughput %.1f nodes/s\n",
+           p_result->Points, p_result->Pareto, p_result->Workers, p_result->Wall,
+           p_result->Throughput);
+}
+
+/**
+ * \brief  Prints the Pareto set, from the longest lifetime to the lowest error.
+ *
+ * \param  p_points:  Pointer to the points.
+ * \param  points:    Number of points.
+ *
+ */
+static void SweepTest_PrintPareto(const SIM_SWEEP_POINT_T *p_points, uint32_t points)
+{
+    const SIM_SWEEP_POINT_T *p_point;
+    uint32_t point, next, last = points;
+
+    printf("-- Pareto set: lifetime [days], error, transmissions, gain, step, rate, deviation, average\n");
+    do {
+        /* Next point of the set, by lifetime and then by index */
+        next = points;
+        for (point = 0; point < points; point++) {
+            p_point = &p_points[point];
+            if ((DEF_TRUE == p_point->Pareto) &&
+                ((points == last) || (p_points[last].Lifetime > p_point->Lifetime) ||
+                 ((p_points[last].Lifetime == p_point->Lifetime) && (last < point))) &&
+                ((points == next) || (p_points[next].Lifetime < p_point->Lifetime))) {
+                next = point;
+            }
+        }
+        if (points == next) break;
+        p_point = &p_points[next];
+        printf("--   %7.2f %8.4f %7u %5.2f %3u %5.2f %6.2f %3u\n",
+               p_point->Lifetime / SA_UTILS_DAYS_TO_MILLI_S, p_point->Error, p_point->Transmissions,
+               p_point->Params.PowerLoopGain, p_point->Params.UpdateStep, p_point->Params.MaximumRate,
+               p_point->Params.Deviation, p_point->Params.AverageNum);
+        last = next;
+    } while (DEF_TRUE);
+}
+
+/**
+ * \brief  Checks that the Pareto set is the set of the points not dominated by another one.
+ *
+ * \param  p_points:  Pointer to the points.
+ * \param  points:    Number of points.
+ *
+ * \return DEF_TRUE if the set is right; otherwise DEF_FALSE.
+ *
+ */
+static bool_t SweepTest_CheckPareto(const SIM_SWEEP_POINT_T *p_points, uint32_t points)
+{
+    uint32_t point, other;
+    bool_t dominated;
+
+    for (point = 0; point < points; point++) {
+        dominated = DEF_FALSE;
+        for (other = 0; other < points; other++) {
+            if ((p_points[other].Lifetime >= p_points[point].Lifetime) &&
+                (p_points[other].Error <= p_points[point].Error) &&
+                ((p_points[other].Lifetime > p_points[point].Lifetime) ||
+                 (p_points[other].Error < p_points[point].Error))) {
+                dominated = DEF_TRUE;
+            }
+        }
+        if (dominated == p_points[point].Pareto) return DEF_FALSE;
+    }
+    return DEF_TRUE;
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the functional test for the parameter sweep.
+ *
+ * \return DEF_OK if every check passes; otherwise DEF_FAIL.
+ *
+ */
+bool_t SweepTest_RunTest(void)
+{
+    TUNING_CFG_PARAMS_T params;
+    SIM_SWEEP_CFG_T cfg;
+    SIM_SWEEP_RESULT_T serial, parallel;
+    bool_t run, in_range = DEF_TRUE, test = DEF_OK;
+    uint32_t point, differ = 0;
+    uint8_t param;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Parameter Sweep Test  //////\n");
+    printf("//////////////////////////////////\n\n");
+
+    /* Parameter block              */
+    TuningCfg_Reset();
+    params = TuningCfg_Params;
+    params.UpdateStep = 0u;
+    TestUtils_Check((DEF_FAIL == TuningCfg_Set(&params)) &&
+                    (TRIGGER_CFG_UPDATE_STEP == TuningCfg_Params.UpdateStep),
+                    "Parameters out of range rejected", &test);
+
+    /* Grid                         */
+    SweepTest_Traces();
+    SimSweep_DefaultCfg(&cfg);
+    cfg.Nodes = SweepTest_Nodes;
+    cfg.NumNodes = sizeof(SweepTest_Nodes) / sizeof(SIM_NODE_CFG_T);
+    for (param = 0; param < SIM_SWEEP_PARAMS; param++) {
+        cfg.Ranges[param].Steps = SWEEP_TEST_STEPS;
+    }
+
+    cfg.Workers = 1u;
+    run = SimSweep_Run(&cfg, SweepTest_Serial, &serial);
+    SweepTest_Print(&serial);
+    TestUtils_Check(run && (SWEEP_TEST_POINTS == serial.Points), "Serial grid", &test);
+
+    cfg.Workers = (0u != SWEEP_TEST_WORKERS) ? SWEEP_TEST_WORKERS : SWEEP_TEST_PARALLEL_WORKERS;
+    run = SimSweep_Run(&cfg, SweepTest_Parallel, &parallel);
+    SweepTest_Print(&parallel);
+    SweepTest_PrintPareto(SweepTest_Parallel, parallel.Points);
+    TestUtils_Check(run, "Parallel grid", &test);
+    TestUtils_Check(0 == memcmp(SweepTest_Serial, SweepTest_Parallel, serial.Points * sizeof(SIM_SWEEP_POINT_T)),
+                    "Same points whatever the workers", &test);
+    TestUtils_Check((0u != parallel.Pareto) && SweepTest_CheckPareto(SweepTest_Parallel, parallel.Points),
+                    "Pareto set of the non dominated points", &test);
+
+    for (point = 1; point < parallel.Points; point++) {
+        if ((SweepTest_Parallel[point].Lifetime != SweepTest_Parallel[0].Lifetime) ||
+            (SweepTest_Parallel[point].Error != SweepTest_Parallel[0].Error)) {
+            differ++;
+        }
+    }
+    TestUtils_Check(0u != differ, "Parameters change the policy", &test);
+    TestUtils_Check(TRIGGER_CFG_UPDATE_STEP == TuningCfg_Params.UpdateStep,
+                    "Parameters restored after the sweep", &test);
+
+    /* Random                       */
+    cfg.Mode = SIM_SWEEP_RANDOM;
+    cfg.Samples = SWEEP_TEST_SAMPLES;
+    run = SimSweep_Run(&cfg, SweepTest_Parallel, &parallel);
+    SweepTest_Print(&parallel);
+    SweepTest_PrintPareto(SweepTest_Parallel, parallel.Points);
+    for (point = 0; point < parallel.Points; point++) {
+        params = SweepTest_Parallel[point].Params;
+        if ((cfg.Ranges[SIM_SWEEP_POWER_LOOP_GAIN].Min > params.PowerLoopGain) ||
+            (cfg.Ranges[SIM_SWEEP_POWER_LOOP_GAIN].Max < params.PowerLoopGain) ||
+            (cfg.Ranges[SIM_SWEEP_AVERAGE_NUM].Min > params.AverageNum) ||
+            (cfg.Ranges[SIM_SWEEP_AVERAGE_NUM].Max < params.AverageNum)) {
+            in_range = DEF_FALSE;
+        }
+    }
+    TestUtils_Check(run && (SWEEP_TEST_SAMPLES == parallel.Points) && in_range &&
+                    SweepTest_CheckPareto(SweepTest_Parallel, parallel.Points),
+                    "Random points in the ranges", &test);
+
+    printf("-- Result: %s\n", (DEF_OK == test) ? "PASS" : "FAIL");
+
+    return test;
+}
+
+/** @} (end addtogroup Sweep)   */
+/** @} (end addtogroup Tests)   */
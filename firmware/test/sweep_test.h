@@ -0,0 +1,35 @@
+/**
+ * \file    sweep_test.h
+ *
+ * \brief   Header file for the parameter sweep of the policy.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __SWEEP_TEST_H__
+#define __SWEEP_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup Sweep
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t SweepTest_RunTest(void);
+
+
+/** @} (end addtogroup Sweep)   */
+/** @} (end addtogroup Tests)        */
+
+#endif  /* __SWEEP_TEST_H__       */
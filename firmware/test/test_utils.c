@@ -0,0 +1,46 @@
+/**
+ * \file    test_utils.c
+ *
+ * \brief   Tools shared by the tests.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: TestUtils_
+ *
+ */
+
+#include "../platform/sa_types.h"
+
+#include "test_utils.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function implementation **********************************/
+/**
+ * \brief  Checks a condition of a test and prints its result.
+ *
+ * \param  cond:      Condition.
+ * \param  p_name:    Name of the check.
+ * \param  p_result:  Pointer to the result of the test, set to DEF_FAIL if the check fails.
+ *
+ */
+void TestUtils_Check(bool_t cond, const char *p_name, bool_t *p_result)
+{
+    printf("-- Check: %-44s %s\n", p_name, (DEF_TRUE == cond) ? "PASS" : "FAIL");
+    if (DEF_TRUE != cond) *p_result = DEF_FAIL;
+}
+
+
+/** @} (end addtogroup Tests)       */
@@ -0,0 +1,31 @@
+/**
+ * \file    test_utils.h
+ *
+ * \brief   Header file for the tools shared by the tests.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __TEST_UTILS_H__
+#define __TEST_UTILS_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+void TestUtils_Check(bool_t cond, const char *p_name, bool_t *p_result);
+
+
+/** @} (end addtogroup Tests)        */
+
+#endif  /* __TEST_UTILS_H__       */
@@ -0,0 +1,507 @@
+/**
+ * \file    wcet_test.c
+ *
+ * \brief   Worst case execution time measurement of the decision engine.
+ *          The decision engine is built in WCET mode and run over randomized loops, where the
+ *          inputs are driven by an adversarial generator that mixes random values with edge
+ *          cases (limits of range, zero, denormals and jumps). The report shows the maximum
+ *          cycles of each agent phase and of the whole loop, the input that produced it, and
+ *          the minimum cycles of the replays of that input.
+ *
+ * \version V0.0
+ *
+ * \author  DavidArnaiz
+ *
+ * \note    Module Prefix: WcetTest_
+ *
+ */
+
+#include <string.h>
+
+#include "../platform/sa_types.h"
+#include "../platform/sa_utils.h"
+#include "../platform/sa_timing.h"
+
+#include "../configs/battery_cfg.h"
+#include "../configs/radio_cfg.h"
+#include "../configs/supervisory_cfg.h"
+#include "../include/power_agent.h"
+#include "../include/radio_agent.h"
+#include "../include/decision_engine.h"
+
+#include "wcet_test.h"
+
+#ifdef DECISION_ENGINE_WCET
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+#define WCET_TEST_ITERATIONS            1000000u
+#define WCET_TEST_SEED                         1u
+#define WCET_TEST_REPLAYS                      5u   /* Replays of the input of each maximum     */
+#define WCET_TEST_EDGE_PROBABILITY         0.25f    /* Probability of picking an edge case      */
+#define WCET_TEST_DENORMAL                1.0e-40f  /* Denormal, slow path on some FPUs         */
+#define WCET_TEST_HIST_BINS                 1024u   /* Histogram of the cycles per loop         */
+#define WCET_TEST_HIST_STEP                  512u   /* Cycles per histogram bin                 */
+#define WCET_TEST_PERCENTILE              0.9999f   /* Percentile checked on a host             */
+
+/* Only the DWT counter of the target measures the loop without preemption of an OS,
+ * it is not read under QEMU (SA_TIMING_NO_DWT)                                        */
+#if (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)) && !defined(SA_TIMING_NO_DWT)
+#define WCET_TEST_TRUSTED_MAX               DEF_TRUE
+#else
+#define WCET_TEST_TRUSTED_MAX               DEF_FALSE
+#endif
+
+/* Ranges of the inputs     */
+#define WCET_TEST_MAX_CHARGE_DELTA         50.0f
+#define WCET_TEST_MIN_TEMPERATURE         -40.0f
+#define WCET_TEST_MAX_TEMPERATURE          85.0f
+#define WCET_TEST_MAX_HARVEST_DELTA       500.0f
+#define WCET_TEST_MAX_SENSOR_DATA        1.0e6f
+
+/************************************** Typedef **************************************************/
+/**
+ * \brief  Inputs of one loop, as produced by the generator.
+ *
+ */
+typedef struct {
+    float32_t ChargeDelta;              /* Charge consumed since the previous loop  */
+    float32_t BatteryVoltage;
+    float32_t Temperature;
+    float32_t HarvestDelta;             /* Charge harvested since the previous loop */
+    float32_t SensorData;
+    bool_t    RadioConfigChange;
+    RADIO_CFG_LIST_T RadioConfig;
+} WCET_TEST_INPUT_T;
+
+/**
+ * \brief  Input that produced the maximum of a phase.
+ *
+ */
+typedef struct {
+    WCET_TEST_INPUT_T Input;
+    uint32_t Cycles;
+    uint32_t Loop;                      /* Loop of the maximum                              */
+    uint32_t Replayed;                  /* Minimum cycles of the phase in the replays       */
+    uint32_t ReplayedLoop;              /* Minimum cycles of the whole loop in the replays  */
+} WCET_TEST_REPORT_T;
+
+/************************************** Function prototypes **************************************/
+
+/************************************** Local Var ************************************************/
+static const char *WcetTest_PhaseNames[DECISION_ENGINE_PHASES] = {
+    "App observe", "Radio observe", "Power observe", "Decide",
+    "App act", "Radio act", "Power act", "Loop",
+};
+
+static uint32_t WcetTest_Seed = WCET_TEST_SEED;
+static WCET_TEST_INPUT_T WcetTest_Input;
+static WCET_TEST_REPORT_T WcetTest_Report[DECISION_ENGINE_PHASES];
+
+static float32_t WcetTest_ChargeAccum = 0;
+static float32_t WcetTest_HarvestAccum = 0;
+static uint32_t WcetTest_Replacements = 0;
+static uint32_t WcetTest_Histogram[WCET_TEST_HIST_BINS];
+
+/************************************** Function implementation **********************************/
+/************* Generator ********************/
+/**
+ * \brief  Pseudo random number generator, so the measurement is repeatable.
+ *
+ * \return Random number in [0, 1).
+ *
+ */
+static float32_t WcetTest_Random(void)
+{
+    WcetTest_Seed = WcetTest_Seed * 1664525u + 1013904223u;
+    return (WcetTest_Seed >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * \brief  Picks an adversarial value in a range.
+ *
+ * \param  min:  Minimum value of the range.
+ * \param  max:  Maximum value of the range.
+ *
+ * \return Random value in the range, or one of the edge cases of the range.
+ *
+ */
+static float32_t WcetTest_Pick(float32_t min, float32_t max)
+{
+    float32_t edges[] = {min, max, 0.0f, WCET_TEST_DENORMAL};
+    uint32_t edge;
+
+    if (WCET_TEST_EDGE_PROBABILITY > WcetTest_Random()) {
+        edge = (uint32_t) (WcetTest_Random() * (sizeof(edges) / sizeof(edges[0])));
+        return SA_UTILS_SATURATE(min, max, edges[edge]);
+    }
+    return min + (max - min) * WcetTest_Random();
+}
+
+/**
+ * \brief  Generates the inputs of the next loop, outside of the measured code.
+ *
+ */
+static void WcetTest_GenerateInput(void)
+{
+    WCET_TEST_INPUT_T *p_input = &WcetTest_Input;
+
+    p_input->ChargeDelta = WcetTest_Pick(0.0f, WCET_TEST_MAX_CHARGE_DELTA);
+    p_input->Temperature = WcetTest_Pick(WCET_TEST_MIN_TEMPERATURE, WCET_TEST_MAX_TEMPERATURE);
+    p_input->BatteryVoltage = PowerAgent_GetOcv(WcetTest_Pick(0.0f, 1.0f), p_input->Temperature);
+    p_input->HarvestDelta = WcetTest_Pick(0.0f, WCET_TEST_MAX_HARVEST_DELTA);
+    p_input->SensorData = WcetTest_Pick(-WCET_TEST_MAX_SENSOR_DATA, WCET_TEST_MAX_SENSOR_DATA);
+    p_input->RadioConfigChange = (0.5f > WcetTest_Random()) ? DEF_TRUE : DEF_FALSE;
+    p_input->RadioConfig = (RADIO_CFG_LIST_T) (WcetTest_Random() * RADIO_CFG_CONFIGS_SIZE);
+
+    WcetTest_ChargeAccum += p_input->ChargeDelta;
+    WcetTest_HarvestAccum += p_input->HarvestDelta;
+}
+
+/************* Power Agent ******************/
+/**
+ * \brief  Fakes the battery measurements.
+ *
+ * \param  p_obs:  Pointer to the observation data of the power agent.
+ *
+ */
+static void WcetTest_PowerObs(POWER_AGENT_OBS_T *p_obs)
+{
+    p_obs->Battery.Charge = WcetTest_ChargeAccum;
+    p_obs->Battery.BatteryVoltage = WcetTest_Input.BatteryVoltage;
+    p_obs->Battery.Temperature = WcetTest_Input.Temperature;
+    p_obs->Battery.Harvested = WcetTest_HarvestAccum;
+}
+
+/**
+ * \brief  Fakes the actuation of the power agent.
+ *
+ * \param  p_acts:  Pointer to the actuation data.
+ *
+ */
+static void WcetTest_PowerActs(POWER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Replaces the battery when it is depleted, so the measurement keeps running.
+ *
+ * \param  error:  Error code.
+ *
+ */
+static void WcetTest_PowerAlarm(POWER_AGENT_ERROR_T error)
+{
+    if (POWER_AGENT_BATTERY_DEPLETED == error) {
+        PowerAgent_SetBatteryCharge(POWER_AGENT_MAX_BATTERY_MA * POWER_AGENT_EFFECTIVE_CHARGE);
+        WcetTest_Replacements++;
+    }
+}
+
+/************* Radio Agent ******************/
+/**
+ * \brief  Fakes the radio observation.
+ *
+ * \param  p_obs:  Pointer to the radio observation data.
+ *
+ */
+static void WcetTest_RadioObs(RADIO_AGENT_OBS_T *p_obs)
+{
+    p_obs->ConfigChange = WcetTest_Input.RadioConfigChange;
+    p_obs->Config = WcetTest_Input.RadioConfig;
+}
+
+/**
+ * \brief  Fakes the radio transmission.
+ *
+ * \param  p_acts:  Pointer to the radio actuation data.
+ *
+ */
+static void WcetTest_RadioActs(RADIO_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Application Agent ************/
+/**
+ * \brief  Fakes a measurement from the sensor.
+ *
+ * \param  p_obs:  Pointer to the sensor observation data.
+ *
+ */
+static void WcetTest_SensorObs(SENSOR_AGENT_OBS_T *p_obs)
+{
+    p_obs->SensorData = WcetTest_Input.SensorData;
+}
+
+/**
+ * \brief  Fakes the configuration change for the sensor.
+ *
+ * \param  p_acts:  Pointer to the actuation data of the sensor agent.
+ *
+ */
+static void WcetTest_SensorActs(SENSOR_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/**
+ * \brief  Fakes the trigger observation.
+ *
+ * \param  p_obs:  Pointer to the trigger observation.
+ *
+ */
+static void WcetTest_TriggerObs(TRIGGER_AGENT_OBS_T *p_obs)
+{
+    (void) p_obs;
+}
+
+/**
+ * \brief  Fakes the trigger actuation.
+ *
+ * \param  p_acts:  Pointer to the trigger actuation.
+ *
+ */
+static void WcetTest_TriggerActs(TRIGGER_AGENT_ACTS_T *p_acts)
+{
+    (void) p_acts;
+}
+
+/************* Report ***********************/
+/**
+ * \brief  Saves the input of the last loop for the phases whose maximum was measured in it.
+ *
+ * \param  p_wcet:  Pointer to the times measured by the decision engine.
+ * \param  loop:    Index of the last loop.
+ *
+ */
+static void WcetTest_UpdateReport(const DECISION_ENGINE_WCET_T *p_wcet, uint32_t loop)
+{
+    DECISION_ENGINE_PHASE_T phase;
+
+    for (phase = DECISION_ENGINE_PHASE_APP_OBSERVE; phase < DECISION_ENGINE_PHASES; phase++) {
+        if (loop == p_wcet->Loop[phase]) {
+            WcetTest_Report[phase].Input = WcetTest_Input;
+            WcetTest_Report[phase].Cycles = p_wcet->Cycles[phase];
+            WcetTest_Report[phase].Loop = loop;
+        }
+    }
+}
+
+/**
+ * \brief  Prints the report.
+ *
+ * \param  p_wcet:  Pointer to the times measured by the decision engine.
+ *
+ */
+static void WcetTest_PrintReport(const DECISION_ENGINE_WCET_T *p_wcet)
+{
+    DECISION_ENGINE_PHASE_T phase;
+    WCET_TEST_INPUT_T *p_input;
+
+    printf("-- Loops: %u, battery replacements: %u\n\n", p_wcet->Loops, WcetTest_Replacements);
+    printf("%-14s %10s %8s %8s | %10s %8s %8s %8s %12s %5s\n", "Phase", "WCET", "Loop", "Replayed",
+           "dCharge", "Voltage", "Temp", "dHarvest", "Sensor", "Radio");
+
+    for (phase = DECISION_ENGINE_PHASE_APP_OBSERVE; phase < DECISION_ENGINE_PHASES; phase++) {
+        p_input = &WcetTest_Report[phase].Input;
+        printf("%-14s %10u %8u %8u | %10.3g %8.3f %8.2f %8.3g %12.4g %3s%u\n",
+               WcetTest_PhaseNames[phase], p_wcet->Cycles[phase], p_wcet->Loop[phase],
+               WcetTest_Report[phase].Replayed,
+               p_input->ChargeDelta, p_input->BatteryVoltage, p_input->Temperature,
+               p_input->HarvestDelta, p_input->SensorData,
+               (DEF_TRUE == p_input->RadioConfigChange) ? "->" : "", p_input->RadioConfig);
+    }
+
+}
+
+/**
+ * \brief  Gets a percentile of the cycles per loop from the histogram.
+ *
+ * \param  max_cycles:  Maximum cycles of a loop, used when the percentile is out of the histogram.
+ *
+ * \return Percentile WCET_TEST_PERCENTILE, rounded up to the end of its bin.
+ *
+ */
+static uint32_t WcetTest_Percentile(uint32_t max_cycles)
+{
+    uint32_t count = 0;
+    uint32_t bin;
+
+    for (bin = 0; bin < WCET_TEST_HIST_BINS; bin++) {
+        count += WcetTest_Histogram[bin];
+        if (count >= WCET_TEST_PERCENTILE * WCET_TEST_ITERATIONS) break;
+    }
+    if (WCET_TEST_HIST_BINS - 1 <= bin) return max_cycles;
+    return (bin + 1) * WCET_TEST_HIST_STEP;
+}
+
+/************* Replay ***********************/
+/**
+ * \brief  Initializes the decision engine and restarts the generator from its seed.
+ *
+ * \param  p_init:  Pointer to the initialization data of the decision engine.
+ *
+ */
+static void WcetTest_Restart(DECISION_ENGINE_INIT_T *p_init)
+{
+    DecisionEng_Init(p_init);
+    DecisionEng_ResetWcet();
+    WcetTest_Seed = WCET_TEST_SEED;
+    WcetTest_ChargeAccum = 0;
+    WcetTest_HarvestAccum = 0;
+}
+
+/**
+ * \brief  Replays the inputs that produced the maxima of the report.
+ *
+ * \param  p_init:  Pointer to the initialization data of the decision engine.
+ *
+ * \return DEF_OK if every input was generated again; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. The engine learns from loop to loop, so an input is only replayed in the state in
+ *          which it was measured by running the generator again from its seed up to the loop
+ *          of the input. The loops of the maxima are the only ones timed.
+ *       2. The preemption of the OS only adds cycles, so the minimum of WCET_TEST_REPLAYS
+ *          replays is kept.
+ */
+static bool_t WcetTest_Replay(DECISION_ENGINE_INIT_T *p_init)
+{
+    DECISION_ENGINE_WCET_T wcet;
+    DECISION_ENGINE_PHASE_T phase;
+    WCET_TEST_REPORT_T *p_report;
+    uint32_t replay, loop, last = 0, replacements = WcetTest_Replacements;
+    bool_t timed, result = DEF_OK;
+
+    for (phase = DECISION_ENGINE_PHASE_APP_OBSERVE; phase < DECISION_ENGINE_PHASES; phase++) {
+        last = SA_UTILS_MAX(last, WcetTest_Report[phase].Loop);
+        WcetTest_Report[phase].Replayed = SA_UTILS_MAX_UINT32_T;
+        WcetTest_Report[phase].ReplayedLoop = SA_UTILS_MAX_UINT32_T;
+    }
+
+    for (replay = 0; replay < WCET_TEST_REPLAYS; replay++) {
+        WcetTest_Restart(p_init);
+        for (loop = 0; loop <= last; loop++) {
+            WcetTest_GenerateInput();
+            timed = DEF_FALSE;
+            for (phase = DECISION_ENGINE_PHASE_APP_OBSERVE; phase < DECISION_ENGINE_PHASES; phase++) {
+                if (loop == WcetTest_Report[phase].Loop) timed = DEF_TRUE;
+            }
+            if (DEF_FALSE == timed) {
+                DecisionEng_Loop();
+                continue;
+            }
+
+            DecisionEng_ResetWcet();
+            DecisionEng_Loop();
+            DecisionEng_GetWcet(&wcet);
+            for (phase = DECISION_ENGINE_PHASE_APP_OBSERVE; phase < DECISION_ENGINE_PHASES; phase++) {
+                p_report = &WcetTest_Report[phase];
+                if (loop != p_report->Loop) continue;
+                if (0 != memcmp(&p_report->Input, &WcetTest_Input, sizeof(WCET_TEST_INPUT_T))) {
+                    result = DEF_FAIL;
+                }
+                p_report->Replayed = SA_UTILS_MIN(p_report->Replayed, wcet.Cycles[phase]);
+                p_report->ReplayedLoop = SA_UTILS_MIN(p_report->ReplayedLoop,
+                                                      wcet.Cycles[DECISION_ENGINE_PHASE_LOOP]);
+            }
+        }
+    }
+    WcetTest_Replacements = replacements;
+
+    return result;
+}
+
+/************* Main *************************/
+/**
+ * \brief  Runs the WCET measurement of the decision engine.
+ *
+ * \return DEF_OK if the loop meets the supervisory deadline; otherwise DEF_FAIL.
+ *
+ * \note List of notes:
+ *       1. On a host the maxima include interrupts and preemption of the OS, so they are
+ *          reported as untrusted. The input of each maximum is replayed, and the deadline is
+ *          checked against the slowest of their replayed loops. The deadline is UNVERIFIED
+ *          when an input cannot be replayed or its replays still exceed it.
+ *       2. On a Cortex-M3/M4 target the maxima are the ones to size the awake window, so the
+ *          loop WCET itself is checked against the deadline.
+ */
+bool_t WcetTest_RunTest(void)
+{
+    DECISION_ENGINE_INIT_T init = {
+        .PowerInit.Obs = WcetTest_PowerObs,
+        .PowerInit.Act = WcetTest_PowerActs,
+        .PowerInit.Alarm = WcetTest_PowerAlarm,
+        .RadioInit.Obs = WcetTest_RadioObs,
+        .RadioInit.Act = WcetTest_RadioActs,
+        .AppInit.Sensor.Obs = WcetTest_SensorObs,
+        .AppInit.Sensor.Act = WcetTest_SensorActs,
+        .AppInit.Sensor.Alarm = NULL,
+        .AppInit.Trigger.Obs = WcetTest_TriggerObs,
+        .AppInit.Trigger.Act = WcetTest_TriggerActs,
+        .AppInit.Trigger.Alarm = NULL,
+        .AppInit.Alarm = NULL
+    };
+    DECISION_ENGINE_WCET_T wcet;
+    uint32_t loop, start, cycles;
+    uint32_t max_cycles, percentile_cycles, replayed_cycles = 0;
+    DECISION_ENGINE_PHASE_T phase;
+    bool_t replayed, result;
+
+    printf("//////////////////////////////////\n");
+    printf("////  Decision Engine WCET   /////\n");
+    printf("//////////////////////////////////\n\n");
+
+    WcetTest_Restart(&init);
+    memset(WcetTest_Report, 0x00, sizeof(WcetTest_Report));
+    memset(WcetTest_Histogram, 0x00, sizeof(WcetTest_Histogram));
+    SaTiming_Init();
+
+    for (loop = 0; loop < WCET_TEST_ITERATIONS; loop++) {
+        WcetTest_GenerateInput();
+        start = SaTiming_GetCycles();
+        DecisionEng_Loop();
+        cycles = SA_TIMING_ELAPSED(start);
+        WcetTest_Histogram[SA_UTILS_MIN(cycles / WCET_TEST_HIST_STEP, WCET_TEST_HIST_BINS - 1)]++;
+        DecisionEng_GetWcet(&wcet);
+        WcetTest_UpdateReport(&wcet, loop);
+    }
+
+    replayed = WcetTest_Replay(&init);
+    for (phase = DECISION_ENGINE_PHASE_APP_OBSERVE; phase < DECISION_ENGINE_PHASES; phase++) {
+        replayed_cycles = SA_UTILS_MAX(replayed_cycles, WcetTest_Report[phase].ReplayedLoop);
+    }
+    WcetTest_PrintReport(&wcet);
+
+    max_cycles = wcet.Cycles[DECISION_ENGINE_PHASE_LOOP];
+    percentile_cycles = WcetTest_Percentile(max_cycles);
+    if (DEF_TRUE == WCET_TEST_TRUSTED_MAX) {
+        result = (max_cycles <= SUPERVISORY_CFG_LOOP_DEADLINE) ? DEF_OK : DEF_FAIL;
+        printf("\n-- Loop WCET %u cycles, p%.2f <= %u cycles\n", max_cycles,
+               100.0f * WCET_TEST_PERCENTILE, percentile_cycles);
+        printf("-- Supervisory deadline: %u cycles -> %s\n", SUPERVISORY_CFG_LOOP_DEADLINE,
+               (DEF_OK == result) ? "MET" : "EXCEEDED");
+    } else {
+        result = ((DEF_OK == replayed) && (replayed_cycles <= SUPERVISORY_CFG_LOOP_DEADLINE)) ? DEF_OK : DEF_FAIL;
+        printf("\n-- Loop p%.2f <= %u cycles, maximum %u cycles (untrusted on a host)\n",
+               100.0f * WCET_TEST_PERCENTILE, percentile_cycles, max_cycles);
+        printf("-- Slowest loop of the maxima, minimum of %u replays: %u cycles%s\n", WCET_TEST_REPLAYS,
+               replayed_cycles, (DEF_OK == replayed) ? "" : " (inputs not replayed)");
+        printf("-- Supervisory deadline: %u cycles -> %s\n", SUPERVISORY_CFG_LOOP_DEADLINE,
+               (DEF_OK == result) ? "MET" : "UNVERIFIED");
+    }
+
+    return result;
+}
+
+#endif /* DECISION_ENGINE_WCET  */
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
@@ -0,0 +1,35 @@
+/**
+ * \file    wcet_test.h
+ *
+ * \brief   Header file for the worst case execution time measurement of the decision engine.
+ *
+ * \author  David Arnaiz
+ *
+ */
+
+#ifndef __WCET_TEST_H__
+#define __WCET_TEST_H__
+
+#include "../platform/sa_types.h"
+
+/** \addtogroup Tests
+ *   @{
+ */
+/** \addtogroup DecisionEngineAgent
+ *   @{
+ */
+
+/************************************** Defines **************************************************/
+
+/************************************** Typedef **************************************************/
+
+/************************************** Local Var ************************************************/
+
+/************************************** Function prototypes **************************************/
+bool_t WcetTest_RunTest(void);
+
+
+/** @} (end addtogroup DecisionEngineAgent)  */
+/** @} (end addtogroup Tests)                */
+
+#endif  /* __WCET_TEST_H__       */